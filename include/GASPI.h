@@ -127,12 +127,23 @@ extern "C"
   /**
    * Operations for Collective communication.
    *
+   * The elements of GASPI_OP_MINLOC and GASPI_OP_MAXLOC are pairs of
+   * a value of the datatype and an index of the same size (int for
+   * the 4-byte types, long for the 8-byte types), e.g. struct { double
+   * value; long index; }. On equal values the lowest index is kept.
    */
   typedef enum
     {
       GASPI_OP_MIN = 0, /**< Minimum */
       GASPI_OP_MAX = 1, /**< Maximum */
-      GASPI_OP_SUM = 2  /**< Sum */
+      GASPI_OP_SUM = 2, /**< Sum */
+      GASPI_OP_MINLOC = 3, /**< Minimum and its index (see above) */
+      GASPI_OP_MAXLOC = 4, /**< Maximum and its index (see above) */
+      GASPI_OP_BAND = 5, /**< Bitwise and (integer types) */
+      GASPI_OP_BOR = 6, /**< Bitwise or (integer types) */
+      GASPI_OP_BXOR = 7, /**< Bitwise exclusive or (integer types) */
+      GASPI_OP_LAND = 8, /**< Logical and */
+      GASPI_OP_LOR = 9  /**< Logical or */
     } gaspi_operation_t;
 
   /**
@@ -167,11 +178,19 @@ extern "C"
     {
       GASPI_MEM_UNINITIALIZED = 0, /* Memory will not be initialized */
       GASPI_MEM_INITIALIZED = 1, /* Memory will be initialized (zero-ed) */
-      GASPI_MEM_GPU = 2
+      GASPI_MEM_GPU = 2,
+      GASPI_MEM_HUGE_2M = 4, /* 2 MB huge pages (transparent huge pages if none are reserved) */
+      GASPI_MEM_HUGE_1G = 8, /* 1 GB huge pages (transparent huge pages if none are reserved) */
+      GASPI_MEM_NUMA_LOCAL = 16, /* Bound to the NUMA node of the rank's socket */
+      GASPI_MEM_NUMA_INTERLEAVE = 32 /* Interleaved over all NUMA nodes */
     };
 
 #define GASPI_ALLOC_DEFAULT GASPI_MEM_UNINITIALIZED
 
+/* Number of notifications of a segment, to be combined with the
+   flags above (default: notification_num of the configuration) */
+#define GASPI_MEM_NOTIFICATIONS(num) (((gaspi_alloc_t) (num)) << 32)
+
   /**
    * Topology building strategy.
    *
@@ -204,12 +223,14 @@ extern "C"
     gaspi_number_t group_max;                 /* max number of groups that can be created */
     gaspi_number_t segment_max;               /* max number of segments that can be created */
     gaspi_size_t transfer_size_max            /* maximum size (bytes) of a single data transfer */;
-    gaspi_number_t notification_num;          /* maximum number of allowed notifications */
+    gaspi_number_t notification_num;          /* number of notifications of a segment */
     gaspi_number_t passive_queue_size_max;    /* maximum number of allowed on-going passive requests */
     gaspi_number_t passive_transfer_size_max; /* maximum size (bytes) of a single passive transfer */
     gaspi_size_t allreduce_buf_size;          /* size of internal buffer for gaspi_allreduce_user */
     gaspi_number_t allreduce_elem_max;        /* maximum number of elements in gaspi_allreduce */
     gaspi_topology_t build_infrastructure;    /* whether and how the topology should be built at initialization */
+    gaspi_uint segment_lazy;                  /* flag to get remote segment information on first use instead of at creation */
+    gaspi_uint reg_cache;                     /* number of unused registrations of user memory (gaspi_segment_bind) kept for reuse */
     void* user_defined;                       /* user-defined information */
   } gaspi_config_t;
 
@@ -683,6 +704,8 @@ extern "C"
 
   /** All Reduce collective operation.
    *
+   * Vectors with more than allreduce_elem_max elements are reduced
+   * with a pipelined ring algorithm.
    *
    * @param buffer_send The buffer with data for the operation.
    * @param buffer_receive The buffer to receive the result of the operation.
@@ -1006,6 +1029,9 @@ extern "C"
   /** Get the number of available notification ids. Important to note
    * is that the allowed ids are in [ 0, notification_num ) .
    *
+   * This is the number of notifications of a segment unless another
+   * one is requested with GASPI_MEM_NOTIFICATIONS when creating it.
+   *
    *
    * @param notification_num Output parameter with the number of
    * available notifications ids.
@@ -1033,8 +1059,8 @@ extern "C"
    */
   gaspi_return_t gaspi_allreduce_buf_size (gaspi_size_t * const buf_size);
 
-  /** Get the maximum number of elements allowed in gaspi_allreduce.
-   *
+  /** Get the maximum number of elements allowed in gaspi_allreduce_user
+   * (and reduced with the latency-optimized algorithm in gaspi_allreduce).
    *
    * @param elem_max Output parameter with the maximum number of elements.
    *
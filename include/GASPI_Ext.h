@@ -176,6 +176,863 @@ extern "C"
    */
   gaspi_return_t gaspi_rw_list_elem_max (gaspi_number_t * const elem_max);
 
+  /** Maximum number of stride levels in strided communication
+   * (ie. up to 3-dimensional sub-arrays).
+   */
+#define GASPI_STRIDE_LEVELS_MAX 2
+
+  /** Write a strided (multidimensional) block of data to a rank.
+   *
+   * The data layout is described by counts and strides: count[0] is
+   * the size (in bytes) of a contiguous block, count[1] the number of
+   * blocks in the first dimension and, for 2 stride levels, count[2]
+   * the number of such 2D planes. stride_local[i] and stride_remote[i]
+   * give the distance (in bytes) between the start of consecutive
+   * elements at level i.
+   *
+   * @param segment_id_local The local segment id with the data.
+   * @param offset_local The local offset of the first block.
+   * @param stride_local The list (stride_levels) of local strides.
+   * @param rank The rank where to write the data.
+   * @param segment_id_remote The remote segment id where to write.
+   * @param offset_remote The remote offset of the first block.
+   * @param stride_remote The list (stride_levels) of remote strides.
+   * @param count The list (stride_levels + 1) of counts.
+   * @param stride_levels The number of stride levels (1 or 2).
+   * @param queue The queue where to post the request.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_write_strided (const gaspi_segment_id_t segment_id_local,
+				      const gaspi_offset_t offset_local,
+				      gaspi_offset_t const * const stride_local,
+				      const gaspi_rank_t rank,
+				      const gaspi_segment_id_t segment_id_remote,
+				      const gaspi_offset_t offset_remote,
+				      gaspi_offset_t const * const stride_remote,
+				      gaspi_size_t const * const count,
+				      const gaspi_number_t stride_levels,
+				      const gaspi_queue_id_t queue,
+				      const gaspi_timeout_t timeout_ms);
+
+  /** Read a strided (multidimensional) block of data from a rank.
+   *
+   * The layout description is the same as in gaspi_write_strided.
+   *
+   * @param segment_id_local The local segment id where to read into.
+   * @param offset_local The local offset of the first block.
+   * @param stride_local The list (stride_levels) of local strides.
+   * @param rank The rank from which to read the data.
+   * @param segment_id_remote The remote segment id to read from.
+   * @param offset_remote The remote offset of the first block.
+   * @param stride_remote The list (stride_levels) of remote strides.
+   * @param count The list (stride_levels + 1) of counts.
+   * @param stride_levels The number of stride levels (1 or 2).
+   * @param queue The queue where to post the request.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_read_strided (const gaspi_segment_id_t segment_id_local,
+				     const gaspi_offset_t offset_local,
+				     gaspi_offset_t const * const stride_local,
+				     const gaspi_rank_t rank,
+				     const gaspi_segment_id_t segment_id_remote,
+				     const gaspi_offset_t offset_remote,
+				     gaspi_offset_t const * const stride_remote,
+				     gaspi_size_t const * const count,
+				     const gaspi_number_t stride_levels,
+				     const gaspi_queue_id_t queue,
+				     const gaspi_timeout_t timeout_ms);
+
+  /** Write a strided (multidimensional) block of data to a rank and
+   * notify it.
+   *
+   * The notification is set in the remote segment after the data.
+   *
+   * @param segment_id_local The local segment id with the data.
+   * @param offset_local The local offset of the first block.
+   * @param stride_local The list (stride_levels) of local strides.
+   * @param rank The rank where to write the data.
+   * @param segment_id_remote The remote segment id where to write.
+   * @param offset_remote The remote offset of the first block.
+   * @param stride_remote The list (stride_levels) of remote strides.
+   * @param count The list (stride_levels + 1) of counts.
+   * @param stride_levels The number of stride levels (1 or 2).
+   * @param notification_id The notification identifier to use.
+   * @param notification_value The notification value used.
+   * @param queue The queue where to post the request.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_write_strided_notify (const gaspi_segment_id_t segment_id_local,
+					     const gaspi_offset_t offset_local,
+					     gaspi_offset_t const * const stride_local,
+					     const gaspi_rank_t rank,
+					     const gaspi_segment_id_t segment_id_remote,
+					     const gaspi_offset_t offset_remote,
+					     gaspi_offset_t const * const stride_remote,
+					     gaspi_size_t const * const count,
+					     const gaspi_number_t stride_levels,
+					     const gaspi_notification_id_t notification_id,
+					     const gaspi_notification_t notification_value,
+					     const gaspi_queue_id_t queue,
+					     const gaspi_timeout_t timeout_ms);
+
+
+  /** Bind a communication queue to the calling thread.
+   *
+   * Posting to and waiting on an owned queue skips locking
+   * altogether. Other threads cannot use the queue (they block or
+   * time out) until it is released with gaspi_queue_release. Meant
+   * for codes with one queue per communicating thread.
+   *
+   * @param queue The queue to own.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_queue_own (const gaspi_queue_id_t queue,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Release a communication queue owned by the calling thread.
+   *
+   * @param queue The queue to release.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error (the queue is not owned by the calling thread).
+   */
+  gaspi_return_t gaspi_queue_release (const gaspi_queue_id_t queue);
+
+  /** Write data and notify a list of (possibly different) ranks.
+   *
+   * All operations are validated and posted in one go, under a single
+   * acquisition of the queue. This is the preferred way of posting a
+   * neighbourhood exchange.
+   *
+   * @param num The number of operations (at most
+   * gaspi_write_notify_batch_elem_max).
+   * @param segment_id_local The list of local segments with the data.
+   * @param offset_local The list of local offsets with the data.
+   * @param rank The list of ranks where to write.
+   * @param segment_id_remote The list of remote segments where to write.
+   * @param offset_remote The list of remote offsets where to write.
+   * @param size The list of sizes to write.
+   * @param notification_id The list of notification identifiers (set
+   * on the remote segment after the data) or NULL for plain writes.
+   * @param notification_value The list of notification values. A
+   * value of 0 means no notification for that operation.
+   * @param queue The queue where to post the requests.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_write_notify_batch (const gaspi_number_t num,
+					   gaspi_segment_id_t * const segment_id_local,
+					   gaspi_offset_t * const offset_local,
+					   gaspi_rank_t * const rank,
+					   gaspi_segment_id_t * const segment_id_remote,
+					   gaspi_offset_t * const offset_remote,
+					   gaspi_size_t * const size,
+					   gaspi_notification_id_t * const notification_id,
+					   gaspi_notification_t * const notification_value,
+					   const gaspi_queue_id_t queue,
+					   const gaspi_timeout_t timeout_ms);
+
+  /** Get the maximum number of operations of gaspi_write_notify_batch.
+   *
+   * @param elem_max Output parameter with the maximum number of operations.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_write_notify_batch_elem_max (gaspi_number_t * const elem_max);
+
+  /** Persistent communication plan.
+   *
+   */
+  typedef struct gaspi_plan_desc *gaspi_plan_t;
+
+  /** Create a persistent communication plan.
+   *
+   * A plan records a list of write (and notify) operations, possibly
+   * to different ranks. Arguments are validated, the target ranks are
+   * connected and the device requests are built only once, at
+   * creation. The operations can then be posted repeatedly with
+   * gaspi_plan_start. The segments used by a plan must not be deleted
+   * while the plan exists. When one of them changes (it is resized
+   * or, with lazy registration, created again by its owner), the
+   * requests are built again at the next gaspi_plan_start.
+   *
+   * @param plan Output parameter with the created plan.
+   * @param num The number of operations in the plan.
+   * @param segment_id_local The list of local segments with the data.
+   * @param offset_local The list of local offsets with the data.
+   * @param rank The list of ranks where to write.
+   * @param segment_id_remote The list of remote segments where to write.
+   * @param offset_remote The list of remote offsets where to write.
+   * @param size The list of sizes to write.
+   * @param notification_id The list of notification identifiers (set
+   * on the remote segment after the data) or NULL for plain writes.
+   * @param notification_value The list of notification values. A
+   * value of 0 means no notification for that operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_plan_create (gaspi_plan_t * const plan,
+				    const gaspi_number_t num,
+				    gaspi_segment_id_t * const segment_id_local,
+				    gaspi_offset_t * const offset_local,
+				    gaspi_rank_t * const rank,
+				    gaspi_segment_id_t * const segment_id_remote,
+				    gaspi_offset_t * const offset_remote,
+				    gaspi_size_t * const size,
+				    gaspi_notification_id_t * const notification_id,
+				    gaspi_notification_t * const notification_value,
+				    const gaspi_timeout_t timeout_ms);
+
+  /** Post all operations of a plan.
+   *
+   * Completion is checked as usual with gaspi_wait on the queue. If
+   * the requests are built again (see gaspi_plan_create), the earlier
+   * starts of the plan must be completed and the remote offsets are
+   * checked again.
+   *
+   * @param plan The plan to start.
+   * @param queue The queue where to post the requests.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_INV_REM_OFF
+   * if a remote segment became too small, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_plan_start (const gaspi_plan_t plan,
+				   const gaspi_queue_id_t queue,
+				   const gaspi_timeout_t timeout_ms);
+
+  /** Delete a plan.
+   *
+   * All started operations of the plan must be completed.
+   *
+   * @param plan The plan to delete.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_plan_delete (gaspi_plan_t plan);
+
+  /** Broadcast the contents of a segment to all ranks of a group.
+   *
+   * The data at (segment_id, offset) on the root is copied to
+   * (segment_id, offset) on every other rank of the group. Small
+   * messages use a binomial tree, large ones a pipelined chain.
+   *
+   * @param segment_id The segment with the data.
+   * @param offset The offset in the segment.
+   * @param size The size of the data (in bytes).
+   * @param root The rank broadcasting the data.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_bcast (const gaspi_segment_id_t segment_id,
+			      const gaspi_offset_t offset,
+			      const gaspi_size_t size,
+			      const gaspi_rank_t root,
+			      const gaspi_group_t group,
+			      const gaspi_timeout_t timeout_ms);
+
+  /** Broadcast a buffer to all ranks of a group.
+   *
+   * Same as gaspi_bcast for data outside of segments.
+   *
+   * @param buffer The buffer with the data (root) or to receive it.
+   * @param size The size of the data (in bytes).
+   * @param root The rank broadcasting the data.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_bcast_buf (gaspi_pointer_t const buffer,
+				  const gaspi_size_t size,
+				  const gaspi_rank_t root,
+				  const gaspi_group_t group,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Gather a block from every rank of a group on all ranks.
+   *
+   * The block of size bytes at (segment_id_send, offset_send) of the
+   * i-th rank of the group is written to (segment_id_recv,
+   * offset_recv + i * size) on all ranks of the group. Small blocks
+   * use Bruck's algorithm, large ones a ring.
+   *
+   * @param segment_id_send The segment with the local block.
+   * @param offset_send The offset of the local block.
+   * @param segment_id_recv The segment to receive the blocks.
+   * @param offset_recv The offset where to receive the blocks.
+   * @param size The size of a block (in bytes).
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_allgather (const gaspi_segment_id_t segment_id_send,
+				  const gaspi_offset_t offset_send,
+				  const gaspi_segment_id_t segment_id_recv,
+				  const gaspi_offset_t offset_recv,
+				  const gaspi_size_t size,
+				  const gaspi_group_t group,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Exchange a block between every pair of ranks of a group.
+   *
+   * The block at (segment_id_send, offset_send + i * size) is written
+   * to (segment_id_recv, offset_recv + j * size) on the i-th rank of
+   * the group, where j is the position of the calling rank in the
+   * group. Ranks are paired in steps so that each rank receives from
+   * a single rank at a time.
+   *
+   * @param segment_id_send The segment with the blocks to send.
+   * @param offset_send The offset of the blocks to send.
+   * @param segment_id_recv The segment to receive the blocks.
+   * @param offset_recv The offset where to receive the blocks.
+   * @param size The size of a block (in bytes).
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_alltoall (const gaspi_segment_id_t segment_id_send,
+				 const gaspi_offset_t offset_send,
+				 const gaspi_segment_id_t segment_id_recv,
+				 const gaspi_offset_t offset_recv,
+				 const gaspi_size_t size,
+				 const gaspi_group_t group,
+				 const gaspi_timeout_t timeout_ms);
+
+  /** Exchange blocks of different sizes between every pair of ranks
+   * of a group.
+   *
+   * The lists are indexed by the position of the ranks in the
+   * group. The block of size[i] bytes at (segment_id_send,
+   * offset_send[i]) is written to (segment_id_recv, offset_recv[i])
+   * on the i-th rank of the group. Blocks may be empty.
+   *
+   * @param segment_id_send The segment with the blocks to send.
+   * @param offset_send The list of offsets of the blocks to send.
+   * @param size The list of sizes of the blocks (in bytes).
+   * @param segment_id_recv The segment to receive the blocks.
+   * @param offset_recv The list of offsets on the remote ranks.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_alltoallv (const gaspi_segment_id_t segment_id_send,
+				  gaspi_offset_t * const offset_send,
+				  gaspi_size_t * const size,
+				  const gaspi_segment_id_t segment_id_recv,
+				  gaspi_offset_t * const offset_recv,
+				  const gaspi_group_t group,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Reduce-scatter collective operation.
+   *
+   * The send buffers hold one block of num elements per rank of the
+   * group, ordered by group rank. The blocks are reduced element-wise
+   * over all ranks and the i-th rank of the group receives the i-th
+   * reduced block. Small vectors use a recursive doubling allreduce,
+   * large vectors a pipelined ring that only moves one block per step.
+   *
+   * @param buffer_send The buffer with (group size x num) elements.
+   * @param buffer_receive The buffer to receive the reduced block.
+   * @param num The number of data elements of a block.
+   * @param operation The type of operations (see gaspi_operation_t).
+   * @param datatype Type of data (see gaspi_datatype_t).
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_reduce_scatter (const gaspi_pointer_t buffer_send,
+				       gaspi_pointer_t const buffer_receive,
+				       const gaspi_number_t num,
+				       const gaspi_operation_t operation,
+				       const gaspi_datatype_t datatype,
+				       const gaspi_group_t group,
+				       const gaspi_timeout_t timeout_ms);
+
+  /** Reduce-scatter collective operation with a user-defined reduction.
+   *
+   * As gaspi_reduce_scatter. The reduction must be associative and
+   * commutative.
+   *
+   * @param buffer_send The buffer with (group size x num) elements.
+   * @param buffer_receive The buffer to receive the reduced block.
+   * @param num The number of data elements of a block.
+   * @param element_size The size of a data element (in bytes).
+   * @param reduce_operation The user-defined reduction.
+   * @param reduce_state The state passed to the reduction.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_reduce_scatter_user (const gaspi_pointer_t buffer_send,
+					    gaspi_pointer_t const buffer_receive,
+					    const gaspi_number_t num,
+					    const gaspi_size_t element_size,
+					    gaspi_reduce_operation_t const reduce_operation,
+					    gaspi_state_t const reduce_state,
+					    const gaspi_group_t group,
+					    const gaspi_timeout_t timeout_ms);
+
+  /** Inclusive scan (prefix reduction) collective operation.
+   *
+   * The i-th rank of the group receives the element-wise reduction of
+   * the send buffers of the ranks 0, ..., i of the group. The vector
+   * is limited to allreduce_buf_size bytes.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param operation The type of operations (see gaspi_operation_t).
+   * @param datatype Type of data (see gaspi_datatype_t).
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_scan (const gaspi_pointer_t buffer_send,
+			     gaspi_pointer_t const buffer_receive,
+			     const gaspi_number_t num,
+			     const gaspi_operation_t operation,
+			     const gaspi_datatype_t datatype,
+			     const gaspi_group_t group,
+			     const gaspi_timeout_t timeout_ms);
+
+  /** Inclusive scan collective operation with a user-defined
+   * reduction.
+   *
+   * As gaspi_scan. The reduction must be associative; it is applied
+   * with the operand of the lower ranks first.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param element_size The size of a data element (in bytes).
+   * @param reduce_operation The user-defined reduction.
+   * @param reduce_state The state passed to the reduction.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_scan_user (const gaspi_pointer_t buffer_send,
+				  gaspi_pointer_t const buffer_receive,
+				  const gaspi_number_t num,
+				  const gaspi_size_t element_size,
+				  gaspi_reduce_operation_t const reduce_operation,
+				  gaspi_state_t const reduce_state,
+				  const gaspi_group_t group,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Exclusive scan collective operation.
+   *
+   * The i-th rank of the group receives the element-wise reduction of
+   * the send buffers of the ranks 0, ..., i - 1 of the group. The
+   * receive buffer of the first rank of the group is left
+   * unmodified.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param operation The type of operations (see gaspi_operation_t).
+   * @param datatype Type of data (see gaspi_datatype_t).
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_exscan (const gaspi_pointer_t buffer_send,
+			       gaspi_pointer_t const buffer_receive,
+			       const gaspi_number_t num,
+			       const gaspi_operation_t operation,
+			       const gaspi_datatype_t datatype,
+			       const gaspi_group_t group,
+			       const gaspi_timeout_t timeout_ms);
+
+  /** Exclusive scan collective operation with a user-defined
+   * reduction.
+   *
+   * As gaspi_exscan, with the reduction applied as in gaspi_scan_user.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param element_size The size of a data element (in bytes).
+   * @param reduce_operation The user-defined reduction.
+   * @param reduce_state The state passed to the reduction.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_exscan_user (const gaspi_pointer_t buffer_send,
+				    gaspi_pointer_t const buffer_receive,
+				    const gaspi_number_t num,
+				    const gaspi_size_t element_size,
+				    gaspi_reduce_operation_t const reduce_operation,
+				    gaspi_state_t const reduce_state,
+				    const gaspi_group_t group,
+				    const gaspi_timeout_t timeout_ms);
+
+  /** A vector of a fused allreduce.
+   *
+   * The reduction is given either by operation and datatype or, if
+   * reduce_operation is not NULL, by a user-defined reduction with
+   * element_size and reduce_state.
+   */
+  typedef struct
+  {
+    gaspi_pointer_t buffer_send;
+    gaspi_pointer_t buffer_receive;
+    gaspi_number_t num;
+    gaspi_operation_t operation;
+    gaspi_datatype_t datatype;
+    gaspi_size_t element_size;
+    gaspi_reduce_operation_t reduce_operation;
+    gaspi_state_t reduce_state;
+  } gaspi_allreduce_entry_t;
+
+  /** Fused allreduce of several small vectors.
+   *
+   * All vectors are reduced in a single collective operation, each
+   * one with its own operation and datatype or user-defined
+   * reduction, and the results are copied to their receive
+   * buffers. Packed with each vector padded to 8 bytes, the vectors
+   * must fit in 2040 bytes.
+   *
+   * @param list The vectors to reduce.
+   * @param num The number of vectors in the list.
+   * @param group The group involved in the operation.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_allreduce_multi (gaspi_allreduce_entry_t const * const list,
+					const gaspi_number_t num,
+					const gaspi_group_t group,
+					const gaspi_timeout_t timeout_ms);
+
+  /** Handle of a non-blocking collective operation.
+   *
+   */
+  typedef struct gaspi_coll_request_desc *gaspi_coll_request_t;
+
+  /** Start a non-blocking barrier.
+   *
+   * Up to four non-blocking collectives can be outstanding per group,
+   * independently of the blocking collectives. They must be started
+   * in the same order on all ranks of the group and each one must be
+   * completed with gaspi_coll_wait. The outstanding requests of a
+   * group progress whenever one of them is started or waited for.
+   *
+   * @param group The group involved in the operation.
+   * @param request Output parameter with the request handle.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST)
+   * to wait for the oldest request when all are in use.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_ibarrier (const gaspi_group_t group,
+				 gaspi_coll_request_t * const request,
+				 const gaspi_timeout_t timeout_ms);
+
+  /** Start a non-blocking allreduce.
+   *
+   * The send buffer is copied when the operation starts and can be
+   * re-used right away; the receive buffer holds the result once the
+   * request completed. The same limits as for gaspi_allreduce apply
+   * to the number of elements.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param operation The type of operations (see gaspi_operation_t).
+   * @param datatype Type of data (see gaspi_datatype_t).
+   * @param group The group involved in the operation.
+   * @param request Output parameter with the request handle.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST)
+   * to wait for the oldest request when all are in use.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_iallreduce (const gaspi_pointer_t buffer_send,
+				   gaspi_pointer_t const buffer_receive,
+				   const gaspi_number_t num,
+				   const gaspi_operation_t operation,
+				   const gaspi_datatype_t datatype,
+				   const gaspi_group_t group,
+				   gaspi_coll_request_t * const request,
+				   const gaspi_timeout_t timeout_ms);
+
+  /** Start a non-blocking allreduce with a user-defined reduction.
+   *
+   * As gaspi_iallreduce, with the reduction applied as in
+   * gaspi_allreduce_user.
+   *
+   * @param buffer_send The buffer with data for the operation.
+   * @param buffer_receive The buffer to receive the result of the operation.
+   * @param num The number of data elements in the buffer.
+   * @param element_size The size of a data element (in bytes).
+   * @param reduce_operation The user-defined reduction.
+   * @param reduce_state The state passed to the reduction.
+   * @param group The group involved in the operation.
+   * @param request Output parameter with the request handle.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST)
+   * to wait for the oldest request when all are in use.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_iallreduce_user (const gaspi_pointer_t buffer_send,
+					gaspi_pointer_t const buffer_receive,
+					const gaspi_number_t num,
+					const gaspi_size_t element_size,
+					gaspi_reduce_operation_t const reduce_operation,
+					gaspi_state_t const reduce_state,
+					const gaspi_group_t group,
+					gaspi_coll_request_t * const request,
+					const gaspi_timeout_t timeout_ms);
+
+  /** Wait for the completion of a non-blocking collective.
+   *
+   * With GASPI_TEST it only makes progress and checks for
+   * completion. Once it returned GASPI_SUCCESS the request is
+   * released and the handle must not be used anymore.
+   *
+   * @param request The request to wait for.
+   * @param timeout_ms Timeout in milliseconds (or GASPI_BLOCK/GASPI_TEST).
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error, GASPI_TIMEOUT in case of timeout.
+   */
+  gaspi_return_t gaspi_coll_wait (gaspi_coll_request_t request,
+				  const gaspi_timeout_t timeout_ms);
+
+  /** Set the algorithms used by a collective.
+   *
+   * Overrides the tuning file (GASPI_COLL_TUNING) and the environment
+   * (GASPI_COLL_<COLLECTIVE>) for one collective. The algorithms are
+   * given as a comma-separated list of algorithm[:max_bytes], each
+   * entry starting at the message size where the previous one ended,
+   * e.g. "hierarchical:1024,ring". An algorithm that does not apply
+   * to a call is skipped and "auto" selects the built-in choice.
+   *
+   * The collectives are allreduce (recursive_doubling, hierarchical,
+   * ring), barrier (dissemination, hierarchical), bcast (tree,
+   * chain), allgather (bruck, ring) and reduce_scatter (allreduce,
+   * ring). It must be called alike on all ranks and not while the
+   * collective is in progress.
+   *
+   * @param collective The name of the collective.
+   * @param algorithms The list of algorithms or NULL to remove a
+   * previous setting.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERROR in case of
+   * error.
+   */
+  gaspi_return_t gaspi_coll_algorithm_set (const char * const collective,
+					   const char * const algorithms);
+
+  /** Allocate memory on the symmetric heap of a segment.
+   *
+   * The whole segment is the heap, so it cannot be used with
+   * gaspi_segment_malloc as well. All ranks of the group call it
+   * alike and get the same offset, as long as they created the
+   * segment with the same size and allocate and free in the same
+   * order (verified in debug builds). There is no communication, so
+   * one-sided communication to the "same" memory of another rank
+   * needs no exchange of offsets.
+   *
+   * @param segment_id The segment with the heap.
+   * @param group The group of ranks that allocate together.
+   * @param size The size to allocate.
+   * @param offset Output parameter with the offset of the memory in
+   * the segment.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_MEMALLOC if
+   * the heap is exhausted, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_sym_malloc (const gaspi_segment_id_t segment_id,
+				   const gaspi_group_t group,
+				   const gaspi_size_t size,
+				   gaspi_offset_t * const offset);
+
+  /** Release memory of the symmetric heap of a segment.
+   *
+   * @param segment_id The segment with the heap.
+   * @param group The group of ranks that allocated the memory.
+   * @param offset The offset returned by gaspi_sym_malloc.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_INV_NUM if
+   * the offset was not allocated, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_sym_free (const gaspi_segment_id_t segment_id,
+				 const gaspi_group_t group,
+				 const gaspi_offset_t offset);
+
+  /** Allocate memory inside a segment.
+   *
+   * The whole segment is managed by the allocator, so it cannot be a
+   * symmetric heap as well. Memory is handed out in power-of-two
+   * blocks, aligned to their size up to 64 KB. Small blocks are
+   * cached per thread. It is thread-safe and purely local.
+   *
+   * @param segment_id The segment to allocate from.
+   * @param size The size to allocate.
+   * @param alignment The alignment of the memory (a power of two up
+   * to 64 KB, 0 for none).
+   * @param offset Output parameter with the offset of the memory in
+   * the segment.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_MEMALLOC if
+   * the segment has no space left, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_segment_malloc (const gaspi_segment_id_t segment_id,
+				       const gaspi_size_t size,
+				       const gaspi_size_t alignment,
+				       gaspi_offset_t * const offset);
+
+  /** Release memory allocated with gaspi_segment_malloc.
+   *
+   * @param segment_id The segment of the memory.
+   * @param offset The offset returned by gaspi_segment_malloc.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_INV_NUM if
+   * the offset was not allocated, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_segment_free (const gaspi_segment_id_t segment_id,
+				     const gaspi_offset_t offset);
+
+  /** Fetch the descriptors of a segment on some ranks in advance.
+   *
+   * With lazy segment registration (segment_lazy in the
+   * configuration) the descriptor of a remote segment is fetched
+   * from its owner on the first communication with it. This hints
+   * that the given ranks are about to be used, so that the first
+   * communication does not pay for the fetch. Descriptors that are
+   * already known are not fetched again.
+   *
+   * @param segment_id The segment.
+   * @param rank_list The ranks holding the segment.
+   * @param num The number of ranks in rank_list.
+   * @param timeout_ms The timeout for the operation.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_INV_SEG if a
+   * rank has no such segment, GASPI_TIMEOUT in case of timeout,
+   * GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_segment_prefetch (const gaspi_segment_id_t segment_id,
+					 const gaspi_rank_t * const rank_list,
+					 const gaspi_number_t num,
+					 const gaspi_timeout_t timeout_ms);
+
+  /** Forget the registrations of user memory in a range.
+   *
+   * With the registration cache (reg_cache in the configuration) the
+   * memory of a segment created with gaspi_segment_bind or
+   * gaspi_segment_use stays registered after the segment is deleted,
+   * to be reused when the same memory is bound again. Memory that was
+   * bound must be passed here before it is freed or unmapped.
+   * Registrations of segments still using the range are released
+   * when those segments are deleted.
+   *
+   * @param pointer The begin of the memory.
+   * @param size The size of the memory.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_DEVICE if a
+   * registration could not be released, GASPI_ERROR in case of
+   * error.
+   */
+  gaspi_return_t gaspi_segment_bind_invalidate (gaspi_pointer_t const pointer,
+						gaspi_size_t const size);
+
+  /** Grow a segment, keeping its data and notifications.
+   *
+   * The memory grows in place when the address space behind it is
+   * free and is moved otherwise, so pointers to the segment must be
+   * taken again with gaspi_segment_ptr. Offsets stay valid, also
+   * those of gaspi_segment_malloc and gaspi_sym_malloc, which can
+   * then use the new memory. The new sizes are exchanged within the
+   * group. Ranks outside of it that fetched the segment with lazy
+   * registration fetch it again at their next communication with it,
+   * and the plans that use it are built again at their next start.
+   * All ranks of the group must call it, each with its own
+   * new size (the current size to keep it), and no communication with
+   * the segment may be in flight. Segments of the application
+   * (gaspi_segment_bind, gaspi_segment_use) cannot be resized.
+   *
+   * @param segment_id The segment to grow.
+   * @param new_size The new size of the segment (not smaller than the
+   * current one).
+   * @param group The group of ranks that use the segment.
+   * @param timeout_ms The timeout for the operation.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_ERR_INV_SEGSIZE
+   * if new_size is smaller than the size of the segment,
+   * GASPI_ERR_INV_SEG if the segment cannot be resized,
+   * GASPI_ERR_MEMALLOC or GASPI_ERR_DEVICE if it could not be grown
+   * (after which it must be deleted), GASPI_TIMEOUT in case of
+   * timeout, GASPI_ERROR in case of error.
+   */
+  gaspi_return_t gaspi_segment_resize (const gaspi_segment_id_t segment_id,
+				       const gaspi_size_t new_size,
+				       const gaspi_group_t group,
+				       const gaspi_timeout_t timeout_ms);
+
+  /** Connect to many ranks at once.
+   *
+   * Like gaspi_connect for each rank of the list, but the connection
+   * handshakes with all of them are in flight together and complete
+   * in the order the ranks answer. Ranks already connected are
+   * skipped.
+   *
+   * @param rank_list The ranks to connect to.
+   * @param num The number of ranks in rank_list.
+   * @param timeout_ms The timeout for the operation.
+   *
+   * @return GASPI_SUCCESS in case of success, GASPI_TIMEOUT in case
+   * of timeout (some ranks may be connected), GASPI_ERROR in case of
+   * error.
+   */
+  gaspi_return_t gaspi_connect_many (const gaspi_rank_t * const rank_list,
+				     const gaspi_number_t num,
+				     const gaspi_timeout_t timeout_ms);
 
 #ifdef __cplusplus
 }
@@ -25,6 +25,7 @@ extern "C"
 #endif
 
 #include "GASPI.h"
+#include "GASPI_Ext.h"
 
   gaspi_return_t pgaspi_config_get (gaspi_config_t * const config);
   
@@ -282,6 +283,11 @@ extern "C"
 
   gaspi_return_t pgaspi_queue_delete(const gaspi_queue_id_t queue_id);
 
+  gaspi_return_t pgaspi_queue_own(const gaspi_queue_id_t queue,
+				  const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_queue_release(const gaspi_queue_id_t queue);
+
   gaspi_return_t pgaspi_queue_size_max (gaspi_number_t * const queue_size_max);
 
   gaspi_return_t pgaspi_transfer_size_min (gaspi_size_t *
@@ -300,6 +306,44 @@ extern "C"
 
   gaspi_return_t pgaspi_rw_list_elem_max (gaspi_number_t * const elem_max);
 
+  gaspi_return_t pgaspi_write_strided (const gaspi_segment_id_t segment_id_local,
+				       const gaspi_offset_t offset_local,
+				       gaspi_offset_t const * const stride_local,
+				       const gaspi_rank_t rank,
+				       const gaspi_segment_id_t segment_id_remote,
+				       const gaspi_offset_t offset_remote,
+				       gaspi_offset_t const * const stride_remote,
+				       gaspi_size_t const * const count,
+				       const gaspi_number_t stride_levels,
+				       const gaspi_queue_id_t queue,
+				       const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_read_strided (const gaspi_segment_id_t segment_id_local,
+				      const gaspi_offset_t offset_local,
+				      gaspi_offset_t const * const stride_local,
+				      const gaspi_rank_t rank,
+				      const gaspi_segment_id_t segment_id_remote,
+				      const gaspi_offset_t offset_remote,
+				      gaspi_offset_t const * const stride_remote,
+				      gaspi_size_t const * const count,
+				      const gaspi_number_t stride_levels,
+				      const gaspi_queue_id_t queue,
+				      const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_write_strided_notify (const gaspi_segment_id_t segment_id_local,
+					      const gaspi_offset_t offset_local,
+					      gaspi_offset_t const * const stride_local,
+					      const gaspi_rank_t rank,
+					      const gaspi_segment_id_t segment_id_remote,
+					      const gaspi_offset_t offset_remote,
+					      gaspi_offset_t const * const stride_remote,
+					      gaspi_size_t const * const count,
+					      const gaspi_number_t stride_levels,
+					      const gaspi_notification_id_t notification_id,
+					      const gaspi_notification_t notification_value,
+					      const gaspi_queue_id_t queue,
+					      const gaspi_timeout_t timeout_ms);
+
   gaspi_return_t pgaspi_queue_max(gaspi_number_t * const queue_max);
 
   gaspi_return_t pgaspi_network_type (gaspi_network_t * const network_type);
@@ -346,6 +390,194 @@ extern "C"
   gaspi_return_t pgaspi_statistic_counter_reset (gaspi_statistic_counter_t counter);
 
   gaspi_string_t pgaspi_error_str(gaspi_return_t error_code);
+
+  gaspi_return_t pgaspi_write_notify_batch_elem_max (gaspi_number_t * const elem_max);
+
+  gaspi_return_t pgaspi_write_notify_batch (const gaspi_number_t num,
+					    gaspi_segment_id_t * const segment_id_local,
+					    gaspi_offset_t * const offset_local,
+					    gaspi_rank_t * const rank,
+					    gaspi_segment_id_t * const segment_id_remote,
+					    gaspi_offset_t * const offset_remote,
+					    gaspi_size_t * const size,
+					    gaspi_notification_id_t * const notification_id,
+					    gaspi_notification_t * const notification_value,
+					    const gaspi_queue_id_t queue,
+					    const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_plan_create (gaspi_plan_t * const plan,
+				     const gaspi_number_t num,
+				     gaspi_segment_id_t * const segment_id_local,
+				     gaspi_offset_t * const offset_local,
+				     gaspi_rank_t * const rank,
+				     gaspi_segment_id_t * const segment_id_remote,
+				     gaspi_offset_t * const offset_remote,
+				     gaspi_size_t * const size,
+				     gaspi_notification_id_t * const notification_id,
+				     gaspi_notification_t * const notification_value,
+				     const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_plan_start (const gaspi_plan_t plan,
+				    const gaspi_queue_id_t queue,
+				    const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_plan_delete (gaspi_plan_t plan);
+
+  gaspi_return_t pgaspi_bcast (const gaspi_segment_id_t segment_id,
+			       const gaspi_offset_t offset,
+			       const gaspi_size_t size,
+			       const gaspi_rank_t root,
+			       const gaspi_group_t group,
+			       const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_bcast_buf (gaspi_pointer_t const buffer,
+				   const gaspi_size_t size,
+				   const gaspi_rank_t root,
+				   const gaspi_group_t group,
+				   const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_allgather (const gaspi_segment_id_t segment_id_send,
+				   const gaspi_offset_t offset_send,
+				   const gaspi_segment_id_t segment_id_recv,
+				   const gaspi_offset_t offset_recv,
+				   const gaspi_size_t size,
+				   const gaspi_group_t group,
+				   const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_alltoall (const gaspi_segment_id_t segment_id_send,
+				  const gaspi_offset_t offset_send,
+				  const gaspi_segment_id_t segment_id_recv,
+				  const gaspi_offset_t offset_recv,
+				  const gaspi_size_t size,
+				  const gaspi_group_t group,
+				  const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_alltoallv (const gaspi_segment_id_t segment_id_send,
+				   gaspi_offset_t * const offset_send,
+				   gaspi_size_t * const size,
+				   const gaspi_segment_id_t segment_id_recv,
+				   gaspi_offset_t * const offset_recv,
+				   const gaspi_group_t group,
+				   const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_reduce_scatter (const gaspi_pointer_t buffer_send,
+					gaspi_pointer_t const buffer_receive,
+					const gaspi_number_t num,
+					const gaspi_operation_t operation,
+					const gaspi_datatype_t datatype,
+					const gaspi_group_t group,
+					const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_reduce_scatter_user (const gaspi_pointer_t buffer_send,
+					     gaspi_pointer_t const buffer_receive,
+					     const gaspi_number_t num,
+					     const gaspi_size_t element_size,
+					     gaspi_reduce_operation_t const reduce_operation,
+					     gaspi_state_t const reduce_state,
+					     const gaspi_group_t group,
+					     const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_scan (const gaspi_pointer_t buffer_send,
+			      gaspi_pointer_t const buffer_receive,
+			      const gaspi_number_t num,
+			      const gaspi_operation_t operation,
+			      const gaspi_datatype_t datatype,
+			      const gaspi_group_t group,
+			      const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_scan_user (const gaspi_pointer_t buffer_send,
+				   gaspi_pointer_t const buffer_receive,
+				   const gaspi_number_t num,
+				   const gaspi_size_t element_size,
+				   gaspi_reduce_operation_t const reduce_operation,
+				   gaspi_state_t const reduce_state,
+				   const gaspi_group_t group,
+				   const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_exscan (const gaspi_pointer_t buffer_send,
+				gaspi_pointer_t const buffer_receive,
+				const gaspi_number_t num,
+				const gaspi_operation_t operation,
+				const gaspi_datatype_t datatype,
+				const gaspi_group_t group,
+				const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_exscan_user (const gaspi_pointer_t buffer_send,
+				     gaspi_pointer_t const buffer_receive,
+				     const gaspi_number_t num,
+				     const gaspi_size_t element_size,
+				     gaspi_reduce_operation_t const reduce_operation,
+				     gaspi_state_t const reduce_state,
+				     const gaspi_group_t group,
+				     const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_allreduce_multi (gaspi_allreduce_entry_t const * const list,
+					 const gaspi_number_t num,
+					 const gaspi_group_t group,
+					 const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_ibarrier (const gaspi_group_t group,
+				  gaspi_coll_request_t * const request,
+				  const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_iallreduce (const gaspi_pointer_t buffer_send,
+				    gaspi_pointer_t const buffer_receive,
+				    const gaspi_number_t num,
+				    const gaspi_operation_t operation,
+				    const gaspi_datatype_t datatype,
+				    const gaspi_group_t group,
+				    gaspi_coll_request_t * const request,
+				    const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_iallreduce_user (const gaspi_pointer_t buffer_send,
+					 gaspi_pointer_t const buffer_receive,
+					 const gaspi_number_t num,
+					 const gaspi_size_t element_size,
+					 gaspi_reduce_operation_t const reduce_operation,
+					 gaspi_state_t const reduce_state,
+					 const gaspi_group_t group,
+					 gaspi_coll_request_t * const request,
+					 const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_coll_wait (gaspi_coll_request_t request,
+				   const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_coll_algorithm_set (const char * const collective,
+					    const char * const algorithms);
+
+  gaspi_return_t pgaspi_sym_malloc (const gaspi_segment_id_t segment_id,
+				    const gaspi_group_t group,
+				    const gaspi_size_t size,
+				    gaspi_offset_t * const offset);
+
+  gaspi_return_t pgaspi_sym_free (const gaspi_segment_id_t segment_id,
+				  const gaspi_group_t group,
+				  const gaspi_offset_t offset);
+
+  gaspi_return_t pgaspi_segment_malloc (const gaspi_segment_id_t segment_id,
+					const gaspi_size_t size,
+					const gaspi_size_t alignment,
+					gaspi_offset_t * const offset);
+
+  gaspi_return_t pgaspi_segment_free (const gaspi_segment_id_t segment_id,
+				      const gaspi_offset_t offset);
+
+  gaspi_return_t pgaspi_segment_prefetch (const gaspi_segment_id_t segment_id,
+					  const gaspi_rank_t * const rank_list,
+					  const gaspi_number_t num,
+					  const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_segment_bind_invalidate (gaspi_pointer_t const pointer,
+						 gaspi_size_t const size);
+
+  gaspi_return_t pgaspi_segment_resize (const gaspi_segment_id_t segment_id,
+					const gaspi_size_t new_size,
+					const gaspi_group_t group,
+					const gaspi_timeout_t timeout_ms);
+
+  gaspi_return_t pgaspi_connect_many (const gaspi_rank_t * const rank_list,
+				      const gaspi_number_t num,
+				      const gaspi_timeout_t timeout_ms);
   
 #ifdef __cplusplus
 }
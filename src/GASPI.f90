@@ -83,6 +83,13 @@ module GASPI
       enumerator :: GASPI_OP_MIN=0
       enumerator :: GASPI_OP_MAX=1
       enumerator :: GASPI_OP_SUM=2
+      enumerator :: GASPI_OP_MINLOC=3
+      enumerator :: GASPI_OP_MAXLOC=4
+      enumerator :: GASPI_OP_BAND=5
+      enumerator :: GASPI_OP_BOR=6
+      enumerator :: GASPI_OP_BXOR=7
+      enumerator :: GASPI_OP_LAND=8
+      enumerator :: GASPI_OP_LOR=9
     end enum 
 
     enum, bind(C) !:: gaspi_datatype_t
@@ -102,6 +109,11 @@ module GASPI
     enum, bind(C) !:: gaspi_alloc_policy_flags
       enumerator :: GASPI_MEM_UNINITIALIZED=0
       enumerator :: GASPI_MEM_INITIALIZED=1
+      enumerator :: GASPI_MEM_GPU=2
+      enumerator :: GASPI_MEM_HUGE_2M=4
+      enumerator :: GASPI_MEM_HUGE_1G=8
+      enumerator :: GASPI_MEM_NUMA_LOCAL=16
+      enumerator :: GASPI_MEM_NUMA_INTERLEAVE=32
     end enum 
 
     enum, bind(C) !:: gaspi_statistic_argument_t
@@ -129,6 +141,8 @@ module GASPI
       integer (gaspi_size_t)   :: allreduce_buf_size
       integer (gaspi_number_t) :: allreduce_elem_max
       integer (gaspi_number_t) :: build_infrastructure
+      integer (gaspi_int)      :: segment_lazy
+      integer (gaspi_int)      :: reg_cache
     end type gaspi_config_t
 
     interface ! gaspi_config_get
@@ -30,6 +30,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GPI2_Coll.h"
 #include "GPI2_Env.h"
 #include "GPI2_Dev.h"
+#include "GPI2_SEG.h"
 #include "GPI2_SN.h"
 #include "GPI2_Types.h"
 #include "GPI2_Utility.h"
@@ -135,9 +136,9 @@ pgaspi_init_core(void)
   /* Set number of "created" communication queues */
   gctx->num_queues = glb_gaspi_cfg.queue_num;
 
-  for(i = 0; i < GASPI_MAX_MSEGS; i++)
+  if( gaspi_segment_table_init(gctx) != 0 )
     {
-      gctx->rrmd[i] = NULL;
+      return GASPI_ERR_MEMALLOC;
     }
 
   gctx->ep_conn = (gaspi_endpoint_conn_t *) calloc(gctx->tnc, sizeof(gaspi_endpoint_conn_t));
@@ -146,6 +147,12 @@ pgaspi_init_core(void)
       return GASPI_ERR_MEMALLOC;
     }
 
+  gctx->ep_lock = (gaspi_lock_t *) calloc(gctx->tnc, sizeof(gaspi_lock_t));
+  if( gctx->ep_lock == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
   if( pgaspi_dev_init_core(&glb_gaspi_cfg) != 0 )
     {
       return GASPI_ERR_DEVICE;
@@ -244,6 +251,14 @@ pgaspi_proc_init (const gaspi_timeout_t timeout_ms)
 	  goto errL;
 	}
 
+      //collectives algorithm selection
+      if( gaspi_coll_tune_init() )
+	{
+	  gaspi_print_error("Failed to set up collectives tuning");
+	  eret = GASPI_ERR_ENV;
+	  goto errL;
+	}
+
       //start sn_backend
       if( pthread_create(&gctx->snt, NULL, gaspi_sn_backend, NULL) != 0 )
 	{
@@ -379,12 +394,23 @@ pgaspi_proc_init (const gaspi_timeout_t timeout_ms)
       /* configuration tells us to pre-connect */
       if( GASPI_TOPOLOGY_STATIC == glb_gaspi_cfg.build_infrastructure )
 	{
+	  gaspi_rank_t * const ranks = (gaspi_rank_t *) malloc((gctx->rank + 1) * sizeof(gaspi_rank_t));
+	  if( ranks == NULL )
+	    {
+	      return GASPI_ERR_MEMALLOC;
+	    }
+
 	  for(i = gctx->rank; i >= 0; i--)
 	    {
-	      if( (eret = pgaspi_connect((gaspi_rank_t) i, timeout_ms)) != GASPI_SUCCESS )
-		{
-		  return eret;
-		}
+	      ranks[gctx->rank - i] = (gaspi_rank_t) i;
+	    }
+
+	  eret = pgaspi_connect_many(ranks, gctx->rank + 1, timeout_ms);
+	  free(ranks);
+
+	  if( eret != GASPI_SUCCESS )
+	    {
+	      return eret;
 	    }
 	}
 
@@ -460,11 +486,11 @@ pgaspi_cleanup_core(void)
   gctx->nsrc.data.buf = NULL;
 
   /* Delete segments */
-  for(i = 0; i < GASPI_MAX_MSEGS; i++)
+  for(i = 0; i < (int) gctx->rrmd_size; i++)
     {
       if( gctx->rrmd[i] != NULL )
 	{
-	  if( gctx->rrmd[i][gctx->rank].size )
+	  if( gctx->rrmd[i]->local.size )
 	    {
 	      if( pgaspi_segment_delete(i) != GASPI_SUCCESS )
 		{
@@ -472,11 +498,15 @@ pgaspi_cleanup_core(void)
 		}
 
 	    }
-	  free(gctx->rrmd[i]);
-	  gctx->rrmd[i] = NULL;
+	  pgaspi_segment_free_desc(gctx, i);
 	}
     }
 
+  if( gaspi_segment_reg_cache_flush() != 0 )
+    {
+      gaspi_print_error("Failed to release cached registrations");
+    }
+
   unlock_gaspi (&glb_gaspi_ctx_lock);
 
   /* Delete groups */
@@ -510,6 +540,11 @@ pgaspi_cleanup_core(void)
   free(gctx->ep_conn);
   gctx->ep_conn = NULL;
 
+  free(gctx->ep_lock);
+  gctx->ep_lock = NULL;
+
+  gaspi_segment_table_free(gctx);
+
   for(i = 0; i < GASPI_MAX_QP + 3; i++)
     {
       free (gctx->qp_state_vec[i]);
@@ -133,4 +133,33 @@ unlock_gaspi (gaspi_lock_t * l)
   GASPI_ATOMIC_UNLOCK (&l->lock);
 }
 
+/* Communication queues: the owner of a queue holds its lock until
+   the queue is released and therefore skips locking */
+static inline int
+gaspi_queue_is_owner (const gaspi_queue_id_t queue)
+{
+  return glb_gaspi_ctx.queue_owned[queue]
+    && pthread_equal (glb_gaspi_ctx.queue_owner[queue], pthread_self ());
+}
+
+static inline int
+lock_gaspi_queue (const gaspi_queue_id_t queue, const gaspi_timeout_t timeout_ms)
+{
+  if (gaspi_queue_is_owner (queue))
+    {
+      return 0;
+    }
+
+  return lock_gaspi_tout (&glb_gaspi_ctx.lockC[queue], timeout_ms);
+}
+
+static inline void
+unlock_gaspi_queue (const gaspi_queue_id_t queue)
+{
+  if (!gaspi_queue_is_owner (queue))
+    {
+      unlock_gaspi (&glb_gaspi_ctx.lockC[queue]);
+    }
+}
+
 #endif //_GPI2_H_
@@ -19,6 +19,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "PGASPI.h"
 #include "GPI2.h"
 #include "GPI2_Dev.h"
+#include "GPI2_SEG.h"
 #include "GPI2_Utility.h"
 
 #ifdef GPI2_EXP_VERBS
@@ -44,6 +45,7 @@ pgaspi_atomic_fetch_add (const gaspi_segment_id_t segment_id,
 			 const gaspi_timeout_t timeout_ms)
 {
   gaspi_verify_init("gaspi_atomic_fetch_add");
+  gaspi_segment_remote_require(segment_id, rank, timeout_ms);
   gaspi_verify_remote_off(offset, segment_id, rank, sizeof(gaspi_atomic_value_t));
   gaspi_verify_null_ptr(val_old);
   gaspi_verify_unaligned_off(offset);
@@ -95,6 +97,7 @@ pgaspi_atomic_compare_swap (const gaspi_segment_id_t segment_id,
 			    const gaspi_timeout_t timeout_ms)
 {
   gaspi_verify_init("gaspi_atomic_compare_swap");
+  gaspi_segment_remote_require(segment_id, rank, timeout_ms);
   gaspi_verify_remote_off(offset, segment_id, rank, sizeof(gaspi_atomic_value_t));
   gaspi_verify_null_ptr(val_old);
   gaspi_verify_unaligned_off(offset);
@@ -81,52 +81,171 @@ pgaspi_connect_endpoint_to(const gaspi_rank_t rank, const gaspi_timeout_t timeou
   return eret;
 }
 
-#pragma weak gaspi_connect = pgaspi_connect
-gaspi_return_t
-pgaspi_connect (const gaspi_rank_t rank, const gaspi_timeout_t timeout_ms)
+/* Connect to ranks whose endpoint lock we hold, releasing them. The
+   handshakes run all at once (see gaspi_sn_connect_many). */
+static gaspi_return_t
+_gaspi_connect_locked(const gaspi_rank_t * const ranks,
+		      const int num,
+		      int * const status,
+		      const gaspi_timeout_t timeout_ms)
 {
-  gaspi_return_t eret = GASPI_ERROR;
   gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  gaspi_return_t eret = GASPI_SUCCESS;
+  int ret = 0;
+  int k;
 
-  gaspi_verify_init("gaspi_connect");
+  for(k = 0; k < num; k++)
+    {
+      eret = pgaspi_create_endpoint_to(ranks[k], timeout_ms);
+      if( eret != GASPI_SUCCESS )
+	{
+	  goto endL;
+	}
+    }
 
-  const int i = (int) rank;
+  ret = gaspi_sn_connect_many(ranks, num, status, timeout_ms);
 
-  eret = pgaspi_create_endpoint_to(rank, timeout_ms);
-  if( eret != GASPI_SUCCESS)
+  for(k = 0; k < num; k++)
     {
-      return eret;
+      if( status[k] == 0 )
+	{
+	  const gaspi_return_t cret = pgaspi_connect_endpoint_to(ranks[k], timeout_ms);
+	  if( cret != GASPI_SUCCESS )
+	    {
+	      eret = cret;
+	    }
+	}
+      else if( status[k] < 0 )
+	{
+	  gctx->qp_state_vec[GASPI_SN][ranks[k]] = GASPI_STATE_CORRUPT;
+	  eret = GASPI_ERROR;
+	}
     }
 
-  if( lock_gaspi_tout (&glb_gaspi_ctx_lock, timeout_ms) )
+  if( ret == 1 )
     {
-      return GASPI_TIMEOUT;
+      eret = GASPI_TIMEOUT;
+    }
+  else if( ret == -2 )
+    {
+      eret = GASPI_ERR_EMFILE;
+    }
+  else if( ret != 0 )
+    {
+      eret = GASPI_ERROR;
     }
 
-  if( GASPI_ENDPOINT_CONNECTED == gctx->ep_conn[i].cstat )
+ endL:
+  for(k = 0; k < num; k++)
     {
-      unlock_gaspi(&glb_gaspi_ctx_lock);
-      return GASPI_SUCCESS;
+      unlock_gaspi(&(gctx->ep_lock[ranks[k]]));
     }
 
-  eret = gaspi_sn_command(GASPI_SN_CONNECT, rank, timeout_ms, NULL);
-  if( eret != GASPI_SUCCESS )
+  return eret;
+}
+
+#pragma weak gaspi_connect_many = pgaspi_connect_many
+gaspi_return_t
+pgaspi_connect_many (const gaspi_rank_t * const rank_list,
+		     const gaspi_number_t num,
+		     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_connect_many");
+  gaspi_verify_null_ptr(rank_list);
+
+  gaspi_number_t k;
+#ifdef DEBUG
+  for(k = 0; k < num; k++)
+    {
+      gaspi_verify_rank(rank_list[k]);
+    }
+#endif
+
+  gaspi_rank_t * const ranks = (gaspi_rank_t *) malloc(num * sizeof(gaspi_rank_t));
+  gaspi_rank_t * const busy = (gaspi_rank_t *) malloc(num * sizeof(gaspi_rank_t));
+  int * const status = (int *) malloc(num * sizeof(int));
+  if( ranks == NULL || busy == NULL || status == NULL )
+    {
+      free(ranks);
+      free(busy);
+      free(status);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  /* Ranks another thread is connecting to are waited for later, so
+     that only one endpoint lock is waited for at a time */
+  int nranks = 0, nbusy = 0;
+  for(k = 0; k < num; k++)
     {
-      if( GASPI_ERROR == eret)
+      const gaspi_rank_t r = rank_list[k];
+
+      if( GASPI_ENDPOINT_CONNECTED == gctx->ep_conn[r].cstat )
 	{
-	  gctx->qp_state_vec[GASPI_SN][i] = GASPI_STATE_CORRUPT;
+	  continue;
 	}
 
-      unlock_gaspi(&glb_gaspi_ctx_lock);
-      return eret;
+      if( lock_gaspi_tout(&(gctx->ep_lock[r]), GASPI_TEST) )
+	{
+	  busy[nbusy++] = r;
+	}
+      else if( GASPI_ENDPOINT_CONNECTED == gctx->ep_conn[r].cstat )
+	{
+	  unlock_gaspi(&(gctx->ep_lock[r]));
+	}
+      else
+	{
+	  ranks[nranks++] = r;
+	}
     }
 
-  eret = pgaspi_connect_endpoint_to(rank, timeout_ms);
+  gaspi_return_t eret = GASPI_SUCCESS;
+  if( nranks > 0 )
+    {
+      eret = _gaspi_connect_locked(ranks, nranks, status, timeout_ms);
+    }
+
+  int b;
+  for(b = 0; b < nbusy && eret == GASPI_SUCCESS; b++)
+    {
+      if( lock_gaspi_tout(&(gctx->ep_lock[busy[b]]), timeout_ms) )
+	{
+	  eret = GASPI_TIMEOUT;
+	}
+      else if( GASPI_ENDPOINT_CONNECTED == gctx->ep_conn[busy[b]].cstat )
+	{
+	  unlock_gaspi(&(gctx->ep_lock[busy[b]]));
+	}
+      else
+	{
+	  eret = _gaspi_connect_locked(&busy[b], 1, status, timeout_ms);
+	}
+    }
+
+  free(ranks);
+  free(busy);
+  free(status);
 
-  unlock_gaspi(&glb_gaspi_ctx_lock);
   return eret;
 }
 
+#pragma weak gaspi_connect = pgaspi_connect
+gaspi_return_t
+pgaspi_connect (const gaspi_rank_t rank, const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_connect");
+
+  if( GASPI_ENDPOINT_CONNECTED == gctx->ep_conn[rank].cstat )
+    {
+      return GASPI_SUCCESS;
+    }
+
+  return pgaspi_connect_many(&rank, 1, timeout_ms);
+}
+
 gaspi_return_t
 pgaspi_local_disconnect(const gaspi_rank_t rank, const gaspi_timeout_t timeout_ms)
 {
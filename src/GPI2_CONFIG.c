@@ -51,7 +51,9 @@ gaspi_config_t glb_gaspi_cfg = {
   GASPI_MAX_TSIZE_P,		//passive_transfer_size_max;
   NEXT_OFFSET,			//allreduce_buf_size;
   255,				//allreduce_elem_max;
-  GASPI_TOPOLOGY_STATIC         //build_infrastructure;
+  GASPI_TOPOLOGY_STATIC,        //build_infrastructure;
+  0,				//segment_lazy;
+  0				//reg_cache;
 };
 
 static void
@@ -61,7 +63,7 @@ pgaspi_print_config(gaspi_config_t * const config)
 port_check %u\nuser_net %u\nnetwork %d\nqueue_size_max %u\nqueue_num %u\n \
 group_max %d\nsegment_max %d\ntransfer_size_max %lu\nnotification_num %u\n \
 passive_queue_size_max %u\npassive_transfer_size_max %u\nallreduce_buf_size %lu\n \
-allreduce_elem_max %u\nbuild_infrastructure %d\n",
+allreduce_elem_max %u\nbuild_infrastructure %d\nsegment_lazy %u\nreg_cache %u\n",
 	 config->logger,
 	 config->sn_port,
 	 config->net_info,
@@ -80,7 +82,9 @@ allreduce_elem_max %u\nbuild_infrastructure %d\n",
 	 config->passive_transfer_size_max,
 	 config->allreduce_buf_size,
 	 config->allreduce_elem_max,
-	 config->build_infrastructure);
+	 config->build_infrastructure,
+	 config->segment_lazy,
+	 config->reg_cache);
 }
 
 #pragma weak gaspi_config_get = pgaspi_config_get
@@ -102,6 +106,8 @@ pgaspi_config_set (const gaspi_config_t nconf)
 
   glb_gaspi_cfg.net_info = nconf.net_info;
   glb_gaspi_cfg.build_infrastructure = nconf.build_infrastructure;
+  glb_gaspi_cfg.segment_lazy = nconf.segment_lazy;
+  glb_gaspi_cfg.reg_cache = nconf.reg_cache;
   glb_gaspi_cfg.logger = nconf.logger;
   glb_gaspi_cfg.port_check = nconf.port_check;
 
@@ -141,6 +147,22 @@ pgaspi_config_set (const gaspi_config_t nconf)
 
   glb_gaspi_cfg.queue_size_max = nconf.queue_size_max;
 
+  if( nconf.segment_max > GASPI_MAX_MSEGS_LIMIT || nconf.segment_max < 1 )
+    {
+      gaspi_print_error("Invalid value for parameter segment_max (min=1 and max=GASPI_MAX_MSEGS_LIMIT");
+      return GASPI_ERR_CONFIG;
+    }
+
+  glb_gaspi_cfg.segment_max = nconf.segment_max;
+
+  if( nconf.notification_num > GASPI_MAX_NOTIFICATION || nconf.notification_num < 1 )
+    {
+      gaspi_print_error("Invalid value for parameter notification_num (min=1 and max=GASPI_MAX_NOTIFICATION");
+      return GASPI_ERR_CONFIG;
+    }
+
+  glb_gaspi_cfg.notification_num = nconf.notification_num;
+
   if( nconf.mtu == 0 || nconf.mtu == 1024 || nconf.mtu == 2048 || nconf.mtu == 4096 )
     {
       glb_gaspi_cfg.mtu = nconf.mtu;
@@ -19,348 +19,135 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GPI2_Utility.h"
 
 
-//pre-defined coll. operations
-void
-opMinIntGASPI (void *res, void *localVal, void *dstVal,
-	       const unsigned char cnt)
-{
-  unsigned char i;
-
-  int *rv = (int *) res;
-  int *lv = (int *) localVal;
-  int *dv = (int *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxIntGASPI (void *res, void *localVal, void *dstVal,
-	       const unsigned char cnt)
-{
-  unsigned char i;
-
-  int *rv = (int *) res;
-  int *lv = (int *) localVal;
-  int *dv = (int *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumIntGASPI (void *res, void *localVal, void *dstVal,
-	       const unsigned char cnt)
-{
-  unsigned char i;
-
-  int *rv = (int *) res;
-  int *lv = (int *) localVal;
-  int *dv = (int *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMinUIntGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned int *rv = (unsigned int *) res;
-  unsigned int *lv = (unsigned int *) localVal;
-  unsigned int *dv = (unsigned int *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxUIntGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned int *rv = (unsigned int *) res;
-  unsigned int *lv = (unsigned int *) localVal;
-  unsigned int *dv = (unsigned int *) dstVal;
+/* The pre-defined operations are plain element-wise loops that the
+   compiler vectorizes. On x86-64 each kernel is built for several
+   instruction sets (AVX-512, AVX2, SSE4.2) and the best one for the
+   running CPU is selected once, at load time. */
+#if defined(__x86_64__) && defined(__GNUC__) && (__GNUC__ >= 6) \
+  && !defined(__INTEL_COMPILER) && !defined(__clang__) && !defined(MIC)
+#define GPI2_REDUX_KERNEL \
+  __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default"), optimize("tree-vectorize")))
+#else
+#define GPI2_REDUX_KERNEL
+#endif
+
+/* Result and local value may be the same buffer (element-wise), there
+   are no other dependencies across iterations. */
+#define GPI2_REDUX_OP(name, ctype, expr)				\
+  GPI2_REDUX_KERNEL void						\
+  name (void *res, void *localVal, void *dstVal,			\
+	const gaspi_number_t cnt)					\
+  {									\
+    gaspi_number_t i;							\
+									\
+    ctype *rv = (ctype *) res;						\
+    const ctype *lv = (const ctype *) localVal;				\
+    const ctype *dv = (const ctype *) dstVal;				\
+									\
+    _Pragma("GCC ivdep")						\
+    for (i = 0; i < cnt; i++)						\
+      {									\
+	const ctype l = lv[i];						\
+	const ctype d = dv[i];						\
+	rv[i] = expr;							\
+      }									\
+  }
 
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumUIntGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned int *rv = (unsigned int *) res;
-  unsigned int *lv = (unsigned int *) localVal;
-  unsigned int *dv = (unsigned int *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMinFloatGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  float *rv = (float *) res;
-  float *lv = (float *) localVal;
-  float *dv = (float *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxFloatGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  float *rv = (float *) res;
-  float *lv = (float *) localVal;
-  float *dv = (float *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumFloatGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  float *rv = (float *) res;
-  float *lv = (float *) localVal;
-  float *dv = (float *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMinDoubleGASPI (void *res, void *localVal, void *dstVal,
-		  const unsigned char cnt)
-{
-  unsigned char i;
-
-  double *rv = (double *) res;
-  double *lv = (double *) localVal;
-  double *dv = (double *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxDoubleGASPI (void *res, void *localVal, void *dstVal,
-		  const unsigned char cnt)
-{
-  unsigned char i;
-
-  double *rv = (double *) res;
-  double *lv = (double *) localVal;
-  double *dv = (double *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumDoubleGASPI (void *res, void *localVal, void *dstVal,
-		  const unsigned char cnt)
-{
-  unsigned char i;
-
-  double *rv = (double *) res;
-  double *lv = (double *) localVal;
-  double *dv = (double *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMinLongGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  long *rv = (long *) res;
-  long *lv = (long *) localVal;
-  long *dv = (long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxLongGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  long *rv = (long *) res;
-  long *lv = (long *) localVal;
-  long *dv = (long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumLongGASPI (void *res, void *localVal, void *dstVal,
-		const unsigned char cnt)
-{
-  unsigned char i;
-
-  long *rv = (long *) res;
-  long *lv = (long *) localVal;
-  long *dv = (long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMinULongGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned long *rv = (unsigned long *) res;
-  unsigned long *lv = (unsigned long *) localVal;
-  unsigned long *dv = (unsigned long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MIN (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opMaxULongGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned long *rv = (unsigned long *) res;
-  unsigned long *lv = (unsigned long *) localVal;
-  unsigned long *dv = (unsigned long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = MAX (*lv, *dv);
-      lv++;
-      dv++;
-      rv++;
-    }
-}
-
-void
-opSumULongGASPI (void *res, void *localVal, void *dstVal,
-		 const unsigned char cnt)
-{
-  unsigned char i;
-
-  unsigned long *rv = (unsigned long *) res;
-  unsigned long *lv = (unsigned long *) localVal;
-  unsigned long *dv = (unsigned long *) dstVal;
-
-  for (i = 0; i < cnt; i++)
-    {
-      *rv = *lv + *dv;
-      lv++;
-      dv++;
-      rv++;
-    }
-}
+//pre-defined coll. operations
+GPI2_REDUX_OP(opMinIntGASPI, int, MIN (l, d))
+GPI2_REDUX_OP(opMaxIntGASPI, int, MAX (l, d))
+GPI2_REDUX_OP(opSumIntGASPI, int, l + d)
+
+GPI2_REDUX_OP(opMinUIntGASPI, unsigned int, MIN (l, d))
+GPI2_REDUX_OP(opMaxUIntGASPI, unsigned int, MAX (l, d))
+GPI2_REDUX_OP(opSumUIntGASPI, unsigned int, l + d)
+
+GPI2_REDUX_OP(opMinFloatGASPI, float, MIN (l, d))
+GPI2_REDUX_OP(opMaxFloatGASPI, float, MAX (l, d))
+GPI2_REDUX_OP(opSumFloatGASPI, float, l + d)
+
+GPI2_REDUX_OP(opMinDoubleGASPI, double, MIN (l, d))
+GPI2_REDUX_OP(opMaxDoubleGASPI, double, MAX (l, d))
+GPI2_REDUX_OP(opSumDoubleGASPI, double, l + d)
+
+GPI2_REDUX_OP(opMinLongGASPI, long, MIN (l, d))
+GPI2_REDUX_OP(opMaxLongGASPI, long, MAX (l, d))
+GPI2_REDUX_OP(opSumLongGASPI, long, l + d)
+
+GPI2_REDUX_OP(opMinULongGASPI, unsigned long, MIN (l, d))
+GPI2_REDUX_OP(opMaxULongGASPI, unsigned long, MAX (l, d))
+GPI2_REDUX_OP(opSumULongGASPI, unsigned long, l + d)
+
+#define GPI2_REDUX_INT_OPS(suffix, ctype)				\
+  GPI2_REDUX_OP(opBand##suffix##GASPI, ctype, l & d)			\
+  GPI2_REDUX_OP(opBor##suffix##GASPI, ctype, l | d)			\
+  GPI2_REDUX_OP(opBxor##suffix##GASPI, ctype, l ^ d)
+
+#define GPI2_REDUX_LOGIC_OPS(suffix, ctype)				\
+  GPI2_REDUX_OP(opLand##suffix##GASPI, ctype, (ctype) (l != 0 && d != 0)) \
+  GPI2_REDUX_OP(opLor##suffix##GASPI, ctype, (ctype) (l != 0 || d != 0))
+
+GPI2_REDUX_INT_OPS(Int, int)
+GPI2_REDUX_INT_OPS(UInt, unsigned int)
+GPI2_REDUX_INT_OPS(Long, long)
+GPI2_REDUX_INT_OPS(ULong, unsigned long)
+
+GPI2_REDUX_LOGIC_OPS(Int, int)
+GPI2_REDUX_LOGIC_OPS(UInt, unsigned int)
+GPI2_REDUX_LOGIC_OPS(Float, float)
+GPI2_REDUX_LOGIC_OPS(Double, double)
+GPI2_REDUX_LOGIC_OPS(Long, long)
+GPI2_REDUX_LOGIC_OPS(ULong, unsigned long)
+
+/* MINLOC/MAXLOC elements are (value, index) pairs, the index as wide
+   as the value. On equal values the lower index wins, which makes the
+   result independent of the order of the reduction. */
+#define GPI2_REDUX_LOC(name, ctype, itype, better)			\
+  void									\
+  name (void *res, void *localVal, void *dstVal,			\
+	const gaspi_number_t cnt)					\
+  {									\
+    struct loc { ctype v; itype i; };					\
+    gaspi_number_t k;							\
+									\
+    struct loc *rv = (struct loc *) res;				\
+    const struct loc *lv = (const struct loc *) localVal;		\
+    const struct loc *dv = (const struct loc *) dstVal;		\
+									\
+    for (k = 0; k < cnt; k++)						\
+      {									\
+	const struct loc l = lv[k];					\
+	const struct loc d = dv[k];					\
+	rv[k] = (d.v better l.v || (d.v == l.v && d.i < l.i)) ? d : l;	\
+      }									\
+  }
+
+#define GPI2_REDUX_LOC_OPS(suffix, ctype, itype)			\
+  GPI2_REDUX_LOC(opMinloc##suffix##GASPI, ctype, itype, <)		\
+  GPI2_REDUX_LOC(opMaxloc##suffix##GASPI, ctype, itype, >)
+
+GPI2_REDUX_LOC_OPS(Int, int, int)
+GPI2_REDUX_LOC_OPS(UInt, unsigned int, int)
+GPI2_REDUX_LOC_OPS(Float, float, int)
+GPI2_REDUX_LOC_OPS(Double, double, long)
+GPI2_REDUX_LOC_OPS(Long, long, long)
+GPI2_REDUX_LOC_OPS(ULong, unsigned long, long)
+
+#define GPI2_REDUX_SET(op, type, fct)					\
+  fctArrayGASPI[(op) * GASPI_COLL_TYPES + (type)] = &fct
+
+/* All operations of a kind for every datatype */
+#define GPI2_REDUX_SET_ALL(o, kind)					\
+  do									\
+    {									\
+      GPI2_REDUX_SET(o, GASPI_TYPE_INT, op##kind##IntGASPI);		\
+      GPI2_REDUX_SET(o, GASPI_TYPE_UINT, op##kind##UIntGASPI);		\
+      GPI2_REDUX_SET(o, GASPI_TYPE_FLOAT, op##kind##FloatGASPI);	\
+      GPI2_REDUX_SET(o, GASPI_TYPE_DOUBLE, op##kind##DoubleGASPI);	\
+      GPI2_REDUX_SET(o, GASPI_TYPE_LONG, op##kind##LongGASPI);		\
+      GPI2_REDUX_SET(o, GASPI_TYPE_ULONG, op##kind##ULongGASPI);	\
+    }									\
+  while(0)
 
 void
 gaspi_init_collectives (void)
@@ -378,9 +165,29 @@ gaspi_init_collectives (void)
   fctArrayGASPI[10] = &opMaxLongGASPI;
   fctArrayGASPI[11] = &opMaxULongGASPI;
   fctArrayGASPI[12] = &opSumIntGASPI;
-  fctArrayGASPI[13] = &opSumIntGASPI;
+  fctArrayGASPI[13] = &opSumUIntGASPI;
   fctArrayGASPI[14] = &opSumFloatGASPI;
   fctArrayGASPI[15] = &opSumDoubleGASPI;
   fctArrayGASPI[16] = &opSumLongGASPI;
   fctArrayGASPI[17] = &opSumULongGASPI;
+
+  GPI2_REDUX_SET_ALL(GASPI_OP_MINLOC, Minloc);
+  GPI2_REDUX_SET_ALL(GASPI_OP_MAXLOC, Maxloc);
+  GPI2_REDUX_SET_ALL(GASPI_OP_LAND, Land);
+  GPI2_REDUX_SET_ALL(GASPI_OP_LOR, Lor);
+
+  /* Bitwise operations are only defined for the integer types, the
+     floating point entries stay NULL and are rejected */
+  GPI2_REDUX_SET(GASPI_OP_BAND, GASPI_TYPE_INT, opBandIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BAND, GASPI_TYPE_UINT, opBandUIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BAND, GASPI_TYPE_LONG, opBandLongGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BAND, GASPI_TYPE_ULONG, opBandULongGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BOR, GASPI_TYPE_INT, opBorIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BOR, GASPI_TYPE_UINT, opBorUIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BOR, GASPI_TYPE_LONG, opBorLongGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BOR, GASPI_TYPE_ULONG, opBorULongGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BXOR, GASPI_TYPE_INT, opBxorIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BXOR, GASPI_TYPE_UINT, opBxorUIntGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BXOR, GASPI_TYPE_LONG, opBxorLongGASPI);
+  GPI2_REDUX_SET(GASPI_OP_BXOR, GASPI_TYPE_ULONG, opBxorULongGASPI);
 }
@@ -24,7 +24,11 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GASPI.h"
 
 /* Number of collectives possibilities ( Types x Ops) */
-#define GASPI_COLL_OP_TYPES 18
+#define GASPI_COLL_OPS 10
+#define GASPI_COLL_TYPES 6
+#define GASPI_COLL_OP_TYPES (GASPI_COLL_OPS * GASPI_COLL_TYPES)
+
+#define GASPI_COLL_IS_LOC(op) ((op) == GASPI_OP_MINLOC || (op) == GASPI_OP_MAXLOC)
 
 typedef enum
   {
@@ -54,9 +58,46 @@ struct redux_args
   } f_args;
 };
 
-void (*fctArrayGASPI[GASPI_COLL_OP_TYPES]) (void *, void *, void *, const unsigned char cnt);
+void (*fctArrayGASPI[GASPI_COLL_OP_TYPES]) (void *, void *, void *, const gaspi_number_t cnt);
 
 void
 gaspi_init_collectives (void);
 
+/* Collectives with more than one algorithm */
+typedef enum
+  {
+    GPI2_COLL_ALLREDUCE,
+    GPI2_COLL_BARRIER,
+    GPI2_COLL_BCAST,
+    GPI2_COLL_ALLGATHER,
+    GPI2_COLL_REDUCE_SCATTER,
+    GPI2_COLL_NUM
+  } gaspi_coll_kind_t;
+
+typedef enum
+  {
+    GPI2_ALG_AUTO,
+    GPI2_ALG_RECURSIVE_DOUBLING,
+    GPI2_ALG_DISSEMINATION,
+    GPI2_ALG_HIERARCHICAL,
+    GPI2_ALG_RING,
+    GPI2_ALG_TREE,
+    GPI2_ALG_CHAIN,
+    GPI2_ALG_BRUCK,
+    GPI2_ALG_ALLREDUCE,
+    GPI2_ALG_NUM
+  } gaspi_coll_alg_t;
+
+#define GPI2_ALG_MASK(alg) (1u << (alg))
+
+int
+gaspi_coll_tune_init (void);
+
+gaspi_coll_alg_t
+gaspi_coll_select (const gaspi_coll_kind_t coll,
+		   const gaspi_number_t nranks,
+		   const gaspi_number_t ppn,
+		   const gaspi_size_t bytes,
+		   const unsigned int applicable);
+
 #endif //_GPI2_COLL_H_
@@ -0,0 +1,401 @@
+/*
+Copyright (c) Fraunhofer ITWM - Carsten Lojewski <lojewski@itwm.fhg.de>, 2013-2016
+
+This file is part of GPI-2.
+
+GPI-2 is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License
+version 3 as published by the Free Software Foundation.
+
+GPI-2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PGASPI.h"
+#include "GPI2_Coll.h"
+#include "GPI2_Utility.h"
+
+/* Selection of the collective algorithms. Each collective has a list
+   of rules, tried in order: the ones given for that collective through
+   the environment (GASPI_COLL_<NAME>) or gaspi_coll_algorithm_set,
+   then the ones of the tuning file (GASPI_COLL_TUNING). The first rule
+   that matches the group size, the ranks per node and the message
+   size and whose algorithm applies to the call wins; without one the
+   collective uses its built-in choice.
+
+   A tuning file has one rule per line:
+
+     collective device min_ranks max_ranks min_ppn max_ppn min_bytes max_bytes algorithm
+
+   where device is ib, tcp or *, and * as an upper bound means no
+   bound. Rules for another device are ignored, so the same file can
+   hold the crossover points of several partitions. Lines starting
+   with # are comments.
+
+   A list given for a collective is a comma-separated list of
+   algorithm[:max_bytes], each entry starting where the previous one
+   ended, e.g. GASPI_COLL_ALLREDUCE=hierarchical:1024,ring.
+
+   All ranks of a group must use the same rules. */
+
+#define GPI2_COLL_RULES_MAX (256)
+#define GPI2_COLL_USER_MAX  (16)
+#define GPI2_COLL_NO_BOUND  ((gaspi_size_t) -1)
+
+#ifdef GPI2_DEVICE_IB
+#define GPI2_COLL_DEVICE "ib"
+#else
+#define GPI2_COLL_DEVICE "tcp"
+#endif
+
+typedef struct
+{
+  gaspi_coll_kind_t coll;
+  gaspi_coll_alg_t alg;
+  gaspi_size_t min_ranks, max_ranks;
+  gaspi_size_t min_ppn, max_ppn;
+  gaspi_size_t min_bytes, max_bytes;
+} gaspi_coll_rule_t;
+
+static const char * const gaspi_coll_name[GPI2_COLL_NUM] =
+  {
+    [GPI2_COLL_ALLREDUCE] = "allreduce",
+    [GPI2_COLL_BARRIER] = "barrier",
+    [GPI2_COLL_BCAST] = "bcast",
+    [GPI2_COLL_ALLGATHER] = "allgather",
+    [GPI2_COLL_REDUCE_SCATTER] = "reduce_scatter"
+  };
+
+static const char * const gaspi_coll_alg_name[GPI2_ALG_NUM] =
+  {
+    [GPI2_ALG_AUTO] = "auto",
+    [GPI2_ALG_RECURSIVE_DOUBLING] = "recursive_doubling",
+    [GPI2_ALG_DISSEMINATION] = "dissemination",
+    [GPI2_ALG_HIERARCHICAL] = "hierarchical",
+    [GPI2_ALG_RING] = "ring",
+    [GPI2_ALG_TREE] = "tree",
+    [GPI2_ALG_CHAIN] = "chain",
+    [GPI2_ALG_BRUCK] = "bruck",
+    [GPI2_ALG_ALLREDUCE] = "allreduce"
+  };
+
+/* Algorithms of each collective */
+static const unsigned int gaspi_coll_algs[GPI2_COLL_NUM] =
+  {
+    [GPI2_COLL_ALLREDUCE] = GPI2_ALG_MASK(GPI2_ALG_RECURSIVE_DOUBLING)
+    | GPI2_ALG_MASK(GPI2_ALG_HIERARCHICAL) | GPI2_ALG_MASK(GPI2_ALG_RING),
+    [GPI2_COLL_BARRIER] = GPI2_ALG_MASK(GPI2_ALG_DISSEMINATION) | GPI2_ALG_MASK(GPI2_ALG_HIERARCHICAL),
+    [GPI2_COLL_BCAST] = GPI2_ALG_MASK(GPI2_ALG_TREE) | GPI2_ALG_MASK(GPI2_ALG_CHAIN),
+    [GPI2_COLL_ALLGATHER] = GPI2_ALG_MASK(GPI2_ALG_BRUCK) | GPI2_ALG_MASK(GPI2_ALG_RING),
+    [GPI2_COLL_REDUCE_SCATTER] = GPI2_ALG_MASK(GPI2_ALG_ALLREDUCE) | GPI2_ALG_MASK(GPI2_ALG_RING)
+  };
+
+static gaspi_coll_rule_t gaspi_coll_rules[GPI2_COLL_RULES_MAX];
+static int gaspi_coll_nrules = 0;
+
+static gaspi_coll_rule_t gaspi_coll_user[GPI2_COLL_NUM][GPI2_COLL_USER_MAX];
+static int gaspi_coll_nuser[GPI2_COLL_NUM];
+
+static int
+_gaspi_coll_lookup(const char * const name,
+		   const char * const * const names,
+		   const int n)
+{
+  int i;
+  for(i = 0; i < n; i++)
+    {
+      if( strcmp(name, names[i]) == 0 )
+	{
+	  return i;
+	}
+    }
+
+  return -1;
+}
+
+/* Algorithm of a collective by name, -1 if it has no such one */
+static int
+_gaspi_coll_alg_lookup(const gaspi_coll_kind_t coll,
+		       const char * const name)
+{
+  const int alg = _gaspi_coll_lookup(name, gaspi_coll_alg_name, GPI2_ALG_NUM);
+
+  if( alg < 0 || !((gaspi_coll_algs[coll] | GPI2_ALG_MASK(GPI2_ALG_AUTO)) & GPI2_ALG_MASK(alg)) )
+    {
+      return -1;
+    }
+
+  return alg;
+}
+
+static int
+_gaspi_coll_bound(const char * const s,
+		  gaspi_size_t * const val)
+{
+  if( strcmp(s, "*") == 0 )
+    {
+      *val = GPI2_COLL_NO_BOUND;
+      return 0;
+    }
+
+  char *end;
+  *val = strtoul(s, &end, 10);
+
+  return (*end != '\0') ? -1 : 0;
+}
+
+/* Parse a list of algorithm[:max_bytes] for a collective */
+static int
+_gaspi_coll_set_list(const gaspi_coll_kind_t coll,
+		     const char * const list)
+{
+  char buf[256];
+  char *saveptr = NULL;
+  char *entry;
+  gaspi_size_t min_bytes = 0;
+  int n = 0;
+
+  if( strlen(list) >= sizeof(buf) )
+    {
+      return -1;
+    }
+  strcpy(buf, list);
+
+  for(entry = strtok_r(buf, ",", &saveptr); entry != NULL; entry = strtok_r(NULL, ",", &saveptr))
+    {
+      if( n == GPI2_COLL_USER_MAX )
+	{
+	  return -1;
+	}
+
+      gaspi_coll_rule_t * const r = &gaspi_coll_user[coll][n];
+      char *colon = strchr(entry, ':');
+
+      r->max_bytes = GPI2_COLL_NO_BOUND;
+      if( colon != NULL )
+	{
+	  *colon = '\0';
+	  if( _gaspi_coll_bound(colon + 1, &r->max_bytes) != 0 )
+	    {
+	      return -1;
+	    }
+	}
+
+      const int alg = _gaspi_coll_alg_lookup(coll, entry);
+      if( alg < 0 || r->max_bytes < min_bytes )
+	{
+	  return -1;
+	}
+
+      r->coll = coll;
+      r->alg = (gaspi_coll_alg_t) alg;
+      r->min_ranks = r->min_ppn = 0;
+      r->max_ranks = r->max_ppn = GPI2_COLL_NO_BOUND;
+      r->min_bytes = min_bytes;
+      min_bytes = r->max_bytes + 1;
+      n++;
+
+      if( r->max_bytes == GPI2_COLL_NO_BOUND )
+	{
+	  break;
+	}
+    }
+
+  gaspi_coll_nuser[coll] = n;
+
+  return 0;
+}
+
+static int
+_gaspi_coll_load(const char * const path)
+{
+  FILE *f = fopen(path, "r");
+  if( f == NULL )
+    {
+      gaspi_print_error("Failed to open tuning file %s", path);
+      return -1;
+    }
+
+  char line[512];
+  int lineno = 0;
+
+  while( fgets(line, sizeof(line), f) != NULL )
+    {
+      char coll[64], dev[64], alg[64];
+      char minr[32], maxr[32], minp[32], maxp[32], minb[32], maxb[32];
+
+      lineno++;
+
+      char *p = line;
+      while( *p == ' ' || *p == '\t' )
+	{
+	  p++;
+	}
+
+      if( *p == '#' || *p == '\n' || *p == '\0' )
+	{
+	  continue;
+	}
+
+      if( sscanf(p, "%63s %63s %31s %31s %31s %31s %31s %31s %63s",
+		 coll, dev, minr, maxr, minp, maxp, minb, maxb, alg) != 9 )
+	{
+	  gaspi_print_error("Invalid rule in %s:%d", path, lineno);
+	  fclose(f);
+	  return -1;
+	}
+
+      if( gaspi_coll_nrules == GPI2_COLL_RULES_MAX )
+	{
+	  gaspi_print_error("Too many rules in %s (max %d)", path, GPI2_COLL_RULES_MAX);
+	  fclose(f);
+	  return -1;
+	}
+
+      gaspi_coll_rule_t * const r = &gaspi_coll_rules[gaspi_coll_nrules];
+      const int c = _gaspi_coll_lookup(coll, gaspi_coll_name, GPI2_COLL_NUM);
+      const int a = (c < 0) ? -1 : _gaspi_coll_alg_lookup((gaspi_coll_kind_t) c, alg);
+
+      if( a < 0
+	  || _gaspi_coll_bound(minr, &r->min_ranks) != 0 || _gaspi_coll_bound(maxr, &r->max_ranks) != 0
+	  || _gaspi_coll_bound(minp, &r->min_ppn) != 0 || _gaspi_coll_bound(maxp, &r->max_ppn) != 0
+	  || _gaspi_coll_bound(minb, &r->min_bytes) != 0 || _gaspi_coll_bound(maxb, &r->max_bytes) != 0 )
+	{
+	  gaspi_print_error("Invalid rule in %s:%d", path, lineno);
+	  fclose(f);
+	  return -1;
+	}
+
+      if( strcmp(dev, "*") != 0 && strcmp(dev, GPI2_COLL_DEVICE) != 0 )
+	{
+	  continue;
+	}
+
+      r->coll = (gaspi_coll_kind_t) c;
+      r->alg = (gaspi_coll_alg_t) a;
+      gaspi_coll_nrules++;
+    }
+
+  fclose(f);
+
+  return 0;
+}
+
+int
+gaspi_coll_tune_init (void)
+{
+  int c;
+
+  gaspi_coll_nrules = 0;
+
+  for(c = 0; c < GPI2_COLL_NUM; c++)
+    {
+      char var[64];
+      int i;
+
+      snprintf(var, sizeof(var), "GASPI_COLL_%s", gaspi_coll_name[c]);
+      for(i = 0; var[i] != '\0'; i++)
+	{
+	  var[i] = toupper(var[i]);
+	}
+
+      gaspi_coll_nuser[c] = 0;
+
+      const char * const list = getenv(var);
+      if( list != NULL && _gaspi_coll_set_list((gaspi_coll_kind_t) c, list) != 0 )
+	{
+	  gaspi_print_error("Invalid value for %s (%s)", var, list);
+	  return -1;
+	}
+    }
+
+  const char * const path = getenv("GASPI_COLL_TUNING");
+  if( path != NULL && _gaspi_coll_load(path) != 0 )
+    {
+      return -1;
+    }
+
+  return 0;
+}
+
+static inline int
+_gaspi_coll_match(gaspi_coll_rule_t const * const r,
+		  const gaspi_number_t nranks,
+		  const gaspi_number_t ppn,
+		  const gaspi_size_t bytes,
+		  const unsigned int applicable)
+{
+  return nranks >= r->min_ranks && nranks <= r->max_ranks
+    && ppn >= r->min_ppn && ppn <= r->max_ppn
+    && bytes >= r->min_bytes && bytes <= r->max_bytes
+    && (GPI2_ALG_MASK(r->alg) & (applicable | GPI2_ALG_MASK(GPI2_ALG_AUTO)));
+}
+
+gaspi_coll_alg_t
+gaspi_coll_select (const gaspi_coll_kind_t coll,
+		   const gaspi_number_t nranks,
+		   const gaspi_number_t ppn,
+		   const gaspi_size_t bytes,
+		   const unsigned int applicable)
+{
+  int i;
+
+  for(i = 0; i < gaspi_coll_nuser[coll]; i++)
+    {
+      if( _gaspi_coll_match(&gaspi_coll_user[coll][i], nranks, ppn, bytes, applicable) )
+	{
+	  return gaspi_coll_user[coll][i].alg;
+	}
+    }
+
+  for(i = 0; i < gaspi_coll_nrules; i++)
+    {
+      if( gaspi_coll_rules[i].coll == coll
+	  && _gaspi_coll_match(&gaspi_coll_rules[i], nranks, ppn, bytes, applicable) )
+	{
+	  return gaspi_coll_rules[i].alg;
+	}
+    }
+
+  return GPI2_ALG_AUTO;
+}
+
+#pragma weak gaspi_coll_algorithm_set = pgaspi_coll_algorithm_set
+gaspi_return_t
+pgaspi_coll_algorithm_set (const char * const collective,
+			   const char * const algorithms)
+{
+  gaspi_verify_null_ptr(collective);
+
+  const int c = _gaspi_coll_lookup(collective, gaspi_coll_name, GPI2_COLL_NUM);
+  if( c < 0 )
+    {
+      gaspi_print_error("Unknown collective %s", collective);
+      return GASPI_ERR_INV_NUM;
+    }
+
+  if( algorithms == NULL )
+    {
+      gaspi_coll_nuser[c] = 0;
+      return GASPI_SUCCESS;
+    }
+
+  if( _gaspi_coll_set_list((gaspi_coll_kind_t) c, algorithms) != 0 )
+    {
+      gaspi_print_error("Invalid algorithms for %s (%s)", collective, algorithms);
+      gaspi_coll_nuser[c] = 0;
+      return GASPI_ERR_CONFIG;
+    }
+
+  return GASPI_SUCCESS;
+}
@@ -256,12 +256,12 @@ pgaspi_gpu_write(const gaspi_segment_id_t segment_id_local,
   gaspi_verify_remote_off(offset_remote, segment_id_remote, rank, size);
   gaspi_verify_queue(queue);
   gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
-  /* gaspi_verify_queue_size_max(glb_gaspi_ctx.ne_count_c[queue]); */
+  /* gaspi_verify_queue_size_max(glb_gaspi_ctx.ne_count_c[queue].count); */
 
   gaspi_return_t eret = GASPI_ERROR;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -287,7 +287,7 @@ pgaspi_gpu_write(const gaspi_segment_id_t segment_id_local,
   /* GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size); */
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -309,7 +309,7 @@ pgaspi_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
   gaspi_verify_remote_off(offset_remote, segment_id_remote, rank, size);
   gaspi_verify_queue(queue);
   gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
-  /* gaspi_verify_queue_size_max(glb_gaspi_ctx.ne_count_c[queue]); */
+  /* gaspi_verify_queue_size_max(glb_gaspi_ctx.ne_count_c[queue].count); */
 
   if( notification_value == 0 )
     {
@@ -320,7 +320,7 @@ pgaspi_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
   gaspi_return_t eret = GASPI_ERROR;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -346,7 +346,7 @@ pgaspi_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
   /* GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size); */
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 
 }
@@ -25,18 +25,72 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GPI2_Coll.h"
 #include "GPI2_Dev.h"
 #include "GPI2_GRP.h"
+#include "GPI2_SEG.h"
 #include "GPI2_SN.h"
 #include "GPI2_Utility.h"
 
 #define GPI2_ALLREDUCE_ELEM_MAX ((1 << 8) - 1)
 const unsigned int glb_gaspi_typ_size[6] = { 4, 4, 4, 8, 8, 8 };
 
+/* MINLOC/MAXLOC elements carry an index as wide as the value */
+static inline gaspi_size_t
+_gaspi_redux_esize(const gaspi_operation_t op, const gaspi_datatype_t type)
+{
+  return glb_gaspi_typ_size[type] * (GASPI_COLL_IS_LOC(op) ? 2 : 1);
+}
+
+/* Not every operation is defined for every datatype (no bitwise
+   operations on floating point) */
+static inline int
+_gaspi_redux_valid(const gaspi_operation_t op, const gaspi_datatype_t type)
+{
+  return (unsigned int) op < GASPI_COLL_OPS
+    && (unsigned int) type < GASPI_COLL_TYPES
+    && fctArrayGASPI[op * GASPI_COLL_TYPES + type] != NULL;
+}
+
+static gaspi_return_t
+_gaspi_redux_op_args(struct redux_args * const r_args,
+		     const gaspi_number_t elem_cnt,
+		     const gaspi_operation_t op,
+		     const gaspi_datatype_t type)
+{
+  if( !_gaspi_redux_valid(op, type) )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  r_args->f_type = GASPI_OP;
+  r_args->f_args.op = op;
+  r_args->f_args.type = type;
+  r_args->elem_size = _gaspi_redux_esize(op, type);
+  r_args->elem_cnt = elem_cnt;
+
+  return GASPI_SUCCESS;
+}
+
 static inline gaspi_return_t
 _gaspi_release_group_mem(gaspi_context_t const * const gctx,
 			 const gaspi_group_t group)
 {
   //  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
   gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[group]);
+  int a;
+
+  for(a = 0; a < GPI2_GRP_AREAS; a++)
+    {
+      if( grp_ctx->area[a] != NULL )
+	{
+	  if( pgaspi_dev_unregister_mem(&(grp_ctx->area[a][gctx->rank])) != GASPI_SUCCESS )
+	    {
+	      return GASPI_ERR_DEVICE;
+	    }
+
+	  free(grp_ctx->area[a][gctx->rank].data.ptr);
+	  free(grp_ctx->area[a]);
+	  grp_ctx->area[a] = NULL;
+	}
+    }
 
   if( grp_ctx->rrcd != NULL )
     {
@@ -58,19 +112,134 @@ _gaspi_release_group_mem(gaspi_context_t const * const gctx,
   free(grp_ctx->committed_rank);
   grp_ctx->committed_rank = NULL;
 
+  free(grp_ctx->node_local);
+  grp_ctx->node_local = NULL;
+
+  free(grp_ctx->node_leader);
+  grp_ctx->node_leader = NULL;
+
+  return GASPI_SUCCESS;
+}
+
+static inline size_t
+_gaspi_grp_area_size(gaspi_group_ctx_t const * const grp_ctx,
+		     const int area)
+{
+  switch(area)
+    {
+    case GPI2_AREA_RING:
+      return GPI2_RING_AREA_SIZE;
+    case GPI2_AREA_TREE:
+      return GPI2_TREE_AREA_SIZE;
+    case GPI2_AREA_HIER:
+      return GPI2_HIER_AREA_SIZE(GPI2_HIER_SLOTS(grp_ctx));
+    default:
+      return GPI2_NB_AREA_SIZE(GPI2_HIER_SLOTS(grp_ctx));
+    }
+}
+
+/* Allocate and register an area of the group memory, unless done
+   already. Called with the del lock held. */
+static gaspi_return_t
+_gaspi_grp_area_alloc(gaspi_context_t const * const gctx,
+		      gaspi_group_ctx_t * const grp_ctx,
+		      const int area,
+		      const size_t size)
+{
+  if( grp_ctx->area[area] != NULL )
+    {
+      return GASPI_SUCCESS;
+    }
+
+  gaspi_rc_mseg_t * const desc = (gaspi_rc_mseg_t *) calloc((size_t) gctx->tnc, sizeof(gaspi_rc_mseg_t));
+  if( desc == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  const long page_size = sysconf(_SC_PAGESIZE);
+  if( page_size < 0 || posix_memalign(&(desc[gctx->rank].data.ptr), (size_t) page_size, size) != 0 )
+    {
+      free(desc);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  memset(desc[gctx->rank].data.buf, 0, size);
+  desc[gctx->rank].size = size;
+
+  if( pgaspi_dev_register_mem(&(desc[gctx->rank])) != 0 )
+    {
+      free(desc[gctx->rank].data.ptr);
+      free(desc);
+      return GASPI_ERR_DEVICE;
+    }
+
+  /* Complete before a collective sees it without the lock */
+  __sync_synchronize();
+  grp_ctx->area[area] = desc;
+
   return GASPI_SUCCESS;
 }
 
+/* The area a collective works in, allocated on its first use */
+static inline gaspi_return_t
+_gaspi_grp_area(gaspi_context_t const * const gctx,
+		const gaspi_group_t g,
+		const int area)
+{
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  gaspi_return_t eret = GASPI_SUCCESS;
+
+  if( grp_ctx->area[area] == NULL )
+    {
+      lock_gaspi (&(grp_ctx->del));
+      eret = _gaspi_grp_area_alloc(gctx, grp_ctx, area, _gaspi_grp_area_size(grp_ctx, area));
+      unlock_gaspi (&(grp_ctx->del));
+    }
+
+  return eret;
+}
+
+/* Our area of a group for a peer about to write into it, allocated
+   if the peer is first (SN thread). The peer tells the size since
+   we may not have committed the group yet. */
+gaspi_return_t
+pgaspi_group_area_desc(const gaspi_group_t group,
+		       const int area,
+		       const size_t size,
+		       gaspi_rc_mseg_t * const desc)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  gaspi_return_t eret = GASPI_ERR_INV_GROUP;
+
+  if( group >= GASPI_MAX_GROUPS || area < 0 || area >= GPI2_GRP_AREAS )
+    {
+      return eret;
+    }
+
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[group]);
+
+  lock_gaspi (&(grp_ctx->del));
+  if( grp_ctx->id >= 0
+      && (eret = _gaspi_grp_area_alloc(gctx, grp_ctx, area, size)) == GASPI_SUCCESS )
+    {
+      *desc = grp_ctx->area[area][gctx->rank];
+    }
+  unlock_gaspi (&(grp_ctx->del));
+
+  return eret;
+}
+
 /* Group utilities */
 #pragma weak gaspi_group_create = pgaspi_group_create
 gaspi_return_t
 pgaspi_group_create (gaspi_group_t * const group)
 {
   int i, id = GASPI_MAX_GROUPS;
-  const size_t size = NEXT_OFFSET;
   long page_size;
   gaspi_return_t eret = GASPI_ERROR;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  const size_t size = GPI2_GRP_MEM_SIZE(gctx->tnc);
 
   gaspi_verify_init("gaspi_group_create");
   gaspi_verify_null_ptr(group);
@@ -197,6 +366,7 @@ pgaspi_group_delete (const gaspi_group_t group)
   eret = _gaspi_release_group_mem(gctx, group);
 
   GASPI_RESET_GROUP(glb_gaspi_group_ctx, group);
+  gaspi_sn_allgather_drop(group);
 
   unlock_gaspi (&(grp_ctx->del));
 
@@ -263,6 +433,128 @@ _pgaspi_group_commit_to(const gaspi_group_t group,
   return GASPI_SUCCESS;
 }
 
+/* With node_ranks > 0, every node_ranks consecutive ranks are taken
+   as one node whatever their host */
+static inline int
+_gaspi_same_host(gaspi_context_t const * const gctx,
+		 const int node_ranks,
+		 const int rank_a,
+		 const int rank_b)
+{
+  if( node_ranks > 0 )
+    {
+      return rank_a / node_ranks == rank_b / node_ranks;
+    }
+
+  return strncmp(gctx->hn_poff + rank_a * 64, gctx->hn_poff + rank_b * 64, 64) == 0;
+}
+
+/* Find the ranks of the group on our node and the leader (lowest
+   group rank) of every node. Barrier and allreduce go node-aware
+   when some, but not all, ranks share a node. The levels of the
+   largest node tree and among the leaders size the slots. */
+static gaspi_return_t
+_gaspi_group_set_nodes(gaspi_context_t const * const gctx,
+		       gaspi_group_ctx_t * const grp_ctx)
+{
+  int i, n;
+  int node_ranks = 0;
+
+#ifdef DEBUG
+  /* Node-aware collectives on a single host (for the tests) */
+  const char * const node_ranks_env = getenv("GASPI_DEBUG_NODE_RANKS");
+  if( node_ranks_env != NULL )
+    {
+      node_ranks = atoi(node_ranks_env);
+    }
+#endif
+
+  free(grp_ctx->node_local);
+  free(grp_ctx->node_leader);
+
+  grp_ctx->node_local = (int *) malloc(grp_ctx->tnc * sizeof(int));
+  grp_ctx->node_leader = (int *) malloc(grp_ctx->tnc * sizeof(int));
+  int * const node_size = (int *) calloc(grp_ctx->tnc, sizeof(int));
+  if( grp_ctx->node_local == NULL || grp_ctx->node_leader == NULL || node_size == NULL )
+    {
+      free(node_size);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  grp_ctx->nlocal = 0;
+  grp_ctx->nleaders = 0;
+  grp_ctx->leader_idx = -1;
+
+  for(i = 0; i < grp_ctx->tnc; i++)
+    {
+      const int r = grp_ctx->rank_grp[i];
+
+      for(n = 0; n < grp_ctx->nleaders; n++)
+	{
+	  if( _gaspi_same_host(gctx, node_ranks, r, grp_ctx->rank_grp[grp_ctx->node_leader[n]]) )
+	    {
+	      break;
+	    }
+	}
+
+      if( n == grp_ctx->nleaders )
+	{
+	  if( i == grp_ctx->rank )
+	    {
+	      grp_ctx->leader_idx = n;
+	    }
+	  grp_ctx->node_leader[grp_ctx->nleaders++] = i;
+	}
+      node_size[n]++;
+
+      if( _gaspi_same_host(gctx, node_ranks, r, gctx->rank) )
+	{
+	  if( i == grp_ctx->rank )
+	    {
+	      grp_ctx->local_idx = grp_ctx->nlocal;
+	    }
+	  grp_ctx->node_local[grp_ctx->nlocal++] = i;
+	}
+    }
+
+  grp_ctx->hier = (grp_ctx->nleaders > 1 && grp_ctx->nleaders < grp_ctx->tnc);
+
+  grp_ctx->local_levels = 0;
+  for(n = 0; n < grp_ctx->nleaders; n++)
+    {
+      while( (1 << grp_ctx->local_levels) < node_size[n] )
+	{
+	  grp_ctx->local_levels++;
+	}
+    }
+
+  grp_ctx->leader_levels = 0;
+  while( (2 << grp_ctx->leader_levels) <= grp_ctx->nleaders )
+    {
+      grp_ctx->leader_levels++;
+    }
+
+  free(node_size);
+
+  return GASPI_SUCCESS;
+}
+
+/* Algorithm of a collective call: the tuned one if a rule applies,
+   the built-in default otherwise. The ranks per node are averaged
+   over the group so that all ranks decide alike. */
+static inline gaspi_coll_alg_t
+_gaspi_coll_alg(gaspi_group_ctx_t const * const grp_ctx,
+		const gaspi_coll_kind_t coll,
+		const gaspi_size_t bytes,
+		const unsigned int applicable,
+		const gaspi_coll_alg_t dflt)
+{
+  const gaspi_number_t ppn = (grp_ctx->tnc + grp_ctx->nleaders - 1) / grp_ctx->nleaders;
+  const gaspi_coll_alg_t alg = gaspi_coll_select(coll, grp_ctx->tnc, ppn, bytes, applicable);
+
+  return (alg == GPI2_ALG_AUTO) ? dflt : alg;
+}
+
 /* Internal shortcut for GASPI_GROUP_ALL */
 /* Because we know the GROUP_ALL, we avoid checks, initial remote
    group check and connection. Overall try to do the minimum, mostly
@@ -312,8 +604,10 @@ pgaspi_group_all_local_create(gaspi_context_t const * const gctx,
   grp_all_ctx->next_pof2 >>= 1;
   grp_all_ctx->pof2_exp = (__builtin_clz (grp_all_ctx->next_pof2) ^ 31U);
 
+  eret = _gaspi_group_set_nodes(gctx, grp_all_ctx);
+
   unlock_gaspi (&glb_gaspi_ctx_lock);
-  return GASPI_SUCCESS;
+  return eret;
 }
 
 gaspi_return_t
@@ -394,6 +688,11 @@ pgaspi_group_commit (const gaspi_group_t group,
   group_to_commit->next_pof2 >>= 1;
   group_to_commit->pof2_exp = (__builtin_clz (group_to_commit->next_pof2) ^ 31U);
 
+  if( (eret = _gaspi_group_set_nodes(gctx, group_to_commit)) != GASPI_SUCCESS )
+    {
+      goto endL;
+    }
+
   struct
   {
     gaspi_group_t group;
@@ -558,6 +857,14 @@ _gaspi_sync_wait(gaspi_context_t * const gctx,
 #define GPI2_GRP_REMOTE_SYNC_ADDR(grp_ctx, dst_rank) (grp_ctx->rrcd[dst_rank].data.addr + (TOGGLE_SIZE * grp_ctx->rank + grp_ctx->togle))
 #define GPI2_GRP_SYNC_POLL_ADDR(grp_ctx, src_rank) (grp_ctx->rrcd[gctx->rank].data.buf + (TOGGLE_SIZE * src_rank + grp_ctx->togle))
 
+static gaspi_return_t
+_gaspi_hier_allreduce(gaspi_context_t * const gctx,
+		      const gaspi_pointer_t buf_send,
+		      gaspi_pointer_t const buf_recv,
+		      struct redux_args * const r_args,
+		      const gaspi_group_t g,
+		      const gaspi_timeout_t timeout_ms);
+
 #pragma weak gaspi_barrier = pgaspi_barrier
 gaspi_return_t
 pgaspi_barrier (const gaspi_group_t g, const gaspi_timeout_t timeout_ms)
@@ -583,6 +890,20 @@ pgaspi_barrier (const gaspi_group_t g, const gaspi_timeout_t timeout_ms)
 
   grp_ctx->coll_op = GASPI_BARRIER;
 
+  if( _gaspi_coll_alg(grp_ctx, GPI2_COLL_BARRIER, 0,
+		      GPI2_ALG_MASK(GPI2_ALG_DISSEMINATION) | GPI2_ALG_MASK(GPI2_ALG_HIERARCHICAL),
+		      grp_ctx->hier ? GPI2_ALG_HIERARCHICAL : GPI2_ALG_DISSEMINATION) == GPI2_ALG_HIERARCHICAL )
+    {
+      const gaspi_return_t hret = _gaspi_hier_allreduce(gctx, NULL, NULL, NULL, g, timeout_ms);
+
+      GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_BARRIER, 1);
+      GPI2_STATS_STOP_TIMER(GASPI_BARRIER_TIMER);
+      GPI2_STATS_INC_TIMER(GASPI_STATS_TIME_BARRIER, GPI2_STATS_GET_TIMER(GASPI_BARRIER_TIMER));
+
+      unlock_gaspi (&grp_ctx->gl);
+      return hret;
+    }
+
   if( grp_ctx->lastmask == 0x1 )
     {
       grp_ctx->barrier_cnt++;
@@ -760,8 +1081,7 @@ _gaspi_apply_redux(gaspi_group_t g,
     {
       gaspi_operation_t op = r_args->f_args.op;
       gaspi_datatype_t type = r_args->f_args.type;
-      //TODO: magic number
-      fctArrayGASPI[op * 6 + type] ((void *) *send_ptr, local_val, dst_val, r_args->elem_cnt);
+      fctArrayGASPI[op * GASPI_COLL_TYPES + type] ((void *) *send_ptr, local_val, dst_val, r_args->elem_cnt);
       eret = GASPI_SUCCESS;
     }
   else if( r_args->f_type == GASPI_USER )
@@ -800,7 +1120,7 @@ _gaspi_allreduce (gaspi_context_t * const gctx,
 
   const int rank_in_grp = grp_ctx->rank;
 
-  unsigned char *send_ptr = grp_ctx->rrcd[gctx->rank].data.buf + COLL_MEM_SEND + (grp_ctx->togle * GASPI_COLL_OP_TYPES * GPI2_REDUX_BUF_SIZE);
+  unsigned char *send_ptr = grp_ctx->rrcd[gctx->rank].data.buf + COLL_MEM_SEND + grp_ctx->togle * (COLL_MEM_RECV - COLL_MEM_SEND) / 2;
   unsigned char *recv_ptr = grp_ctx->rrcd[gctx->rank].data.buf + COLL_MEM_RECV;
 
   const int dsize = r_args->elem_size * r_args->elem_cnt;
@@ -930,7 +1250,7 @@ _gaspi_allreduce (gaspi_context_t * const gctx,
 	}
       else
 	{
-	  if( _gaspi_sync_wait(gctx, GPI2_GRP_SYNC_POLL_ADDR(grp_ctx, rank_in_grp), grp_ctx->barrier_cnt, timeout_ms)  != GASPI_SUCCESS )
+	  if( _gaspi_sync_wait(gctx, GPI2_GRP_SYNC_POLL_ADDR(grp_ctx, (rank_in_grp + 1)), grp_ctx->barrier_cnt, timeout_ms)  != GASPI_SUCCESS )
 	    {
 	      return GASPI_TIMEOUT;
 	    }
@@ -959,98 +1279,429 @@ _gaspi_allreduce (gaspi_context_t * const gctx,
   return GASPI_SUCCESS;
 }
 
-#pragma weak gaspi_allreduce = pgaspi_allreduce
-gaspi_return_t
-pgaspi_allreduce (const gaspi_pointer_t buf_send,
-		  gaspi_pointer_t const buf_recv,
-		  const gaspi_number_t elem_cnt,
-		  const gaspi_operation_t op,
-		  const gaspi_datatype_t type,
-		  const gaspi_group_t g,
-		  const gaspi_timeout_t timeout_ms)
+/* Large allreduce: ring reduce-scatter followed by ring allgather,
+   pipelined in chunks through the ring area of the group memory. The
+   vector is processed in rounds of (group size x chunk) bytes. Each
+   message to the right neighbour is flagged with a sequence number
+   and acknowledged once consumed, which gives the credit to re-use
+   its slot two messages later. */
+#define GPI2_RING_DATA_FLAG(base) ((volatile uint32_t *) ((base) + GPI2_RING_FLAGS))
+#define GPI2_RING_ACK_FLAG(base)  ((volatile uint32_t *) ((base) + GPI2_RING_FLAGS + sizeof(uint32_t)))
+#define GPI2_RING_FLAG_SRC(base)  ((uint32_t *) ((base) + GPI2_RING_FLAGS + 2 * sizeof(uint32_t)))
+#define GPI2_RING_ACK_SRC(base)   ((uint32_t *) ((base) + GPI2_RING_FLAGS + 4 * sizeof(uint32_t)))
+
+static inline gaspi_return_t
+_gaspi_seq_wait(gaspi_context_t * const gctx,
+		 volatile uint32_t * const flag,
+		 const uint32_t expected,
+		 const gaspi_timeout_t timeout_ms)
 {
-  gaspi_verify_init("gaspi_allreduce_user");
-  gaspi_verify_null_ptr(buf_send);
-  gaspi_verify_null_ptr(buf_recv);
-  gaspi_verify_group(g);
+  const gaspi_cycles_t s0 = gaspi_get_cycles();
 
-  if( elem_cnt > GPI2_ALLREDUCE_ELEM_MAX )
+  while( (int32_t) (*flag - expected) < 0 )
     {
-      return GASPI_ERR_INV_NUM;
+      const gaspi_cycles_t s1 = gaspi_get_cycles();
+      const gaspi_cycles_t tdelta = s1 - s0;
+      const float ms = (float) tdelta * gctx->cycles_to_msecs;
+
+      if( ms > timeout_ms )
+	{
+	  return GASPI_TIMEOUT;
+	}
     }
 
-  if( lock_gaspi_tout (&glb_gaspi_group_ctx[g].gl, timeout_ms ))
+  return GASPI_SUCCESS;
+}
+
+static inline gaspi_return_t
+_gaspi_grp_connect_to(gaspi_context_t * const gctx,
+		      const gaspi_group_t g,
+		      const gaspi_rank_t dst,
+		      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_SUCCESS;
+
+  if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[dst].cstat )
     {
-      return GASPI_TIMEOUT;
+      if( (eret = pgaspi_connect(dst, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  gaspi_print_error("Failed to connect to rank %u", dst);
+	  return eret;
+	}
     }
 
-  if( !(glb_gaspi_group_ctx[g].coll_op & GASPI_ALLREDUCE) )
+  if( !glb_gaspi_group_ctx[g].committed_rank[dst] )
     {
-      unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
-      return GASPI_ERR_ACTIVE_COLL;
+      if( (eret = _pgaspi_group_commit_to(g, dst, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  gaspi_print_error("Failed to commit to rank %u", dst);
+	  return eret;
+	}
     }
 
-  glb_gaspi_group_ctx[g].coll_op = GASPI_ALLREDUCE;
-
-  struct redux_args r_args;
-  r_args.f_type = GASPI_OP;
-  r_args.f_args.op = op;
-  r_args.f_args.type = type;
-  r_args.elem_size = glb_gaspi_typ_size[type];
-  r_args.elem_cnt = elem_cnt;
-
-  gaspi_return_t eret = GASPI_ERROR;
-  gaspi_context_t * const gctx = &glb_gaspi_ctx;
-
-  eret = _gaspi_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
-
-
-  unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
-
   return eret;
 }
 
-#pragma weak gaspi_allreduce_user = pgaspi_allreduce_user
-gaspi_return_t
-pgaspi_allreduce_user (const gaspi_pointer_t buf_send,
-		       gaspi_pointer_t const buf_recv,
-		       const gaspi_number_t elem_cnt,
-		       const gaspi_size_t elem_size,
-		       gaspi_reduce_operation_t const user_fct,
-		       gaspi_state_t const rstate,
-		       const gaspi_group_t g,
-		       const gaspi_timeout_t timeout_ms)
+static inline gaspi_return_t
+_gaspi_grp_post(gaspi_context_t * const gctx,
+		const gaspi_group_t g,
+		void * const local,
+		const unsigned int size,
+		const gaspi_rank_t dst,
+		const unsigned long remote_off)
 {
-  gaspi_verify_init("gaspi_allreduce_user");
-  gaspi_verify_null_ptr(buf_send);
-  gaspi_verify_null_ptr(buf_recv);
-  gaspi_verify_group(g);
+  void * const remote_addr = (void *) (glb_gaspi_group_ctx[g].rrcd[dst].data.addr + remote_off);
 
-  if( elem_cnt > GPI2_ALLREDUCE_ELEM_MAX )
+  if( pgaspi_dev_post_group_write(local, size, dst, remote_addr, g) != 0 )
     {
-      return GASPI_ERR_INV_NUM;
+      gctx->qp_state_vec[GASPI_COLL_QP][dst] = GASPI_STATE_CORRUPT;
+      return GASPI_ERR_DEVICE;
     }
 
-  if( elem_size * elem_cnt > GPI2_REDUX_BUF_SIZE )
+  return GASPI_SUCCESS;
+}
+
+/* Connect to dst for a collective working in an area of the group
+   memory, which dst allocates if we are the first to use it */
+static inline gaspi_return_t
+_gaspi_grp_area_connect_to(gaspi_context_t * const gctx,
+			   const gaspi_group_t g,
+			   const int area,
+			   const gaspi_rank_t dst,
+			   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t const * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_grp_connect_to(gctx, g, dst, timeout_ms)) != GASPI_SUCCESS )
     {
-      return GASPI_ERR_INV_SIZE;
+      return eret;
     }
 
-  if( lock_gaspi_tout (&glb_gaspi_group_ctx[g].gl, timeout_ms) )
+  if( grp_ctx->area[area][dst].data.addr == 0 )
     {
-      return GASPI_TIMEOUT;
+      struct gaspi_grp_area_req req;
+      req.group = g;
+      req.area = area;
+      req.size = _gaspi_grp_area_size(grp_ctx, area);
+
+      if( (eret = gaspi_sn_command(GASPI_SN_GRP_AREA, dst, timeout_ms, (void *) &req)) != GASPI_SUCCESS )
+	{
+	  gaspi_print_error("Failed to get the group area of rank %u", dst);
+	  return eret;
+	}
     }
 
-  if( !(glb_gaspi_group_ctx[g].coll_op & GASPI_ALLREDUCE_USER) )
+  return GASPI_SUCCESS;
+}
+
+/* As _gaspi_grp_post, between the areas of a collective */
+static inline gaspi_return_t
+_gaspi_grp_area_post(gaspi_context_t * const gctx,
+		     const gaspi_group_t g,
+		     const int area,
+		     void * const local,
+		     const unsigned int size,
+		     const gaspi_rank_t dst,
+		     const unsigned long remote_off)
+{
+  gaspi_rc_mseg_t const * const desc = glb_gaspi_group_ctx[g].area[area];
+  void * const remote_addr = (void *) (desc[dst].data.addr + remote_off);
+
+  if( pgaspi_dev_post_group_mem_write(&(desc[gctx->rank]), local, size, dst, &(desc[dst]), remote_addr) != 0 )
     {
-      unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
-      return GASPI_ERR_ACTIVE_COLL;
+      gctx->qp_state_vec[GASPI_COLL_QP][dst] = GASPI_STATE_CORRUPT;
+      return GASPI_ERR_DEVICE;
     }
 
-  glb_gaspi_group_ctx[g].coll_op = GASPI_ALLREDUCE_USER;
+  return GASPI_SUCCESS;
+}
 
+/* Post message k, staged in its send slot, and its data flag to the
+   right neighbour. The slot is re-used once the neighbour
+   acknowledged k. */
+static inline gaspi_return_t
+_gaspi_ring_send(gaspi_context_t * const gctx,
+		 const gaspi_group_t g,
+		 const gaspi_rank_t right,
+		 const uint32_t k,
+		 const unsigned int bytes)
+{
   gaspi_return_t eret = GASPI_ERROR;
-  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+  unsigned char * const ring = grp_ctx->area[GPI2_AREA_RING][gctx->rank].data.buf;
+  const int slot = k % 2;
+
+  if( bytes > 0 )
+    {
+      if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_RING, ring + GPI2_RING_SEND + slot * GPI2_COLL_CHUNK_SIZE, bytes,
+				       right, GPI2_RING_RECV + slot * GPI2_COLL_CHUNK_SIZE)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  uint32_t * const flag_src = GPI2_RING_FLAG_SRC(base) + slot;
+  *flag_src = k + 1;
+
+  if( (eret = _gaspi_grp_post(gctx, g, flag_src, sizeof(uint32_t), right, GPI2_RING_FLAGS)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  grp_ctx->ring_slot[slot] = k + 1;
+
+  return GASPI_SUCCESS;
+}
+
+/* Acknowledge message k (its receive slot was consumed) to the left
+   neighbour */
+static inline gaspi_return_t
+_gaspi_ring_ack(gaspi_context_t * const gctx,
+		const gaspi_group_t g,
+		const gaspi_rank_t left,
+		const uint32_t k)
+{
+  unsigned char * const base = glb_gaspi_group_ctx[g].rrcd[gctx->rank].data.buf;
+  uint32_t * const ack_src = GPI2_RING_ACK_SRC(base) + k % 2;
+  *ack_src = k + 1;
+
+  return _gaspi_grp_post(gctx, g, ack_src, sizeof(uint32_t), left, GPI2_RING_FLAGS + sizeof(uint32_t));
+}
+
+static gaspi_return_t
+_gaspi_allreduce_ring (gaspi_context_t * const gctx,
+		       const gaspi_pointer_t buf_send,
+		       gaspi_pointer_t const buf_recv,
+		       struct redux_args *r_args,
+		       const gaspi_group_t g,
+		       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const size_t esize = r_args->elem_size;
+  const gaspi_number_t elem_cnt = r_args->elem_cnt;
+
+  unsigned char * const work = (unsigned char *) buf_recv;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  if( grp_ctx->coll_step == 0 && !grp_ctx->coll_phase && buf_send != buf_recv )
+    {
+      memcpy(buf_recv, buf_send, elem_cnt * esize);
+    }
+
+  if( P == 1 )
+    {
+      grp_ctx->coll_op = GASPI_NONE;
+      return GASPI_SUCCESS;
+    }
+
+  const gaspi_rank_t left = grp_ctx->rank_grp[(me + P - 1) % P];
+  const gaspi_rank_t right = grp_ctx->rank_grp[(me + 1) % P];
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_RING)) != GASPI_SUCCESS
+      || (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, right, timeout_ms)) != GASPI_SUCCESS
+      || (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, left, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  unsigned char * const ring = grp_ctx->area[GPI2_AREA_RING][gctx->rank].data.buf;
+
+  const gaspi_number_t round_elems = P * (GPI2_COLL_CHUNK_SIZE / esize);
+  const int rounds = (elem_cnt + round_elems - 1) / round_elems;
+  const int steps_per_round = 2 * (P - 1);
+  const int steps = rounds * steps_per_round;
+
+  int step;
+  for(step = grp_ctx->coll_step; step < steps; step++)
+    {
+      const uint32_t k = grp_ctx->ring_msg + (uint32_t) step;
+      const int slot = k % 2;
+
+      /* Blocks of this round */
+      const gaspi_number_t round_start = (step / steps_per_round) * round_elems;
+      const gaspi_number_t n = MIN(round_elems, elem_cnt - round_start);
+      const gaspi_number_t q = n / P;
+      const gaspi_number_t rem = n % P;
+
+      const int s = step % steps_per_round;
+      const int reduce = (s < P - 1);
+      const int t = reduce ? s : s - (P - 1);
+      const int send_b = (me - t + (reduce ? 0 : 1) + 2 * P) % P;
+      const int recv_b = (me - t - (reduce ? 1 : 0) + 2 * P) % P;
+
+      const gaspi_number_t send_cnt = q + ((gaspi_number_t) send_b < rem);
+      const gaspi_number_t recv_cnt = q + ((gaspi_number_t) recv_b < rem);
+      unsigned char * const send_data = work + (round_start + send_b * q + MIN((gaspi_number_t) send_b, rem)) * esize;
+      unsigned char * const recv_data = work + (round_start + recv_b * q + MIN((gaspi_number_t) recv_b, rem)) * esize;
+
+      if( !grp_ctx->coll_phase )
+	{
+	  /* The right neighbour must have consumed the last message of this slot */
+	  if( _gaspi_seq_wait(gctx, GPI2_RING_ACK_FLAG(base), grp_ctx->ring_slot[slot], timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = step;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  memcpy(ring + GPI2_RING_SEND + slot * GPI2_COLL_CHUNK_SIZE, send_data, send_cnt * esize);
+
+	  if( (eret = _gaspi_ring_send(gctx, g, right, k, send_cnt * esize)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->coll_phase = 1;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_RING_DATA_FLAG(base), k + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = step;
+	  return GASPI_TIMEOUT;
+	}
+
+      unsigned char * const recv_slot = ring + GPI2_RING_RECV + slot * GPI2_COLL_CHUNK_SIZE;
+      if( reduce )
+	{
+	  fctArrayGASPI[r_args->f_args.op * GASPI_COLL_TYPES + r_args->f_args.type] (recv_data, recv_data, recv_slot, recv_cnt);
+	}
+      else
+	{
+	  memcpy(recv_data, recv_slot, recv_cnt * esize);
+	}
+
+      if( (eret = _gaspi_ring_ack(gctx, g, left, k)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      /* Sources of this step are re-used two steps later */
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 0;
+    }
+
+  grp_ctx->ring_msg += (uint32_t) steps;
+  grp_ctx->coll_step = 0;
+  grp_ctx->coll_op = GASPI_NONE;
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_allreduce = pgaspi_allreduce
+gaspi_return_t
+pgaspi_allreduce (const gaspi_pointer_t buf_send,
+		  gaspi_pointer_t const buf_recv,
+		  const gaspi_number_t elem_cnt,
+		  const gaspi_operation_t op,
+		  const gaspi_datatype_t type,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_allreduce_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  if( _gaspi_redux_op_args(&r_args, elem_cnt, op, type) != GASPI_SUCCESS )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  if( lock_gaspi_tout (&glb_gaspi_group_ctx[g].gl, timeout_ms ))
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  if( !(glb_gaspi_group_ctx[g].coll_op & GASPI_ALLREDUCE) )
+    {
+      unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
+      return GASPI_ERR_ACTIVE_COLL;
+    }
+
+  glb_gaspi_group_ctx[g].coll_op = GASPI_ALLREDUCE;
+
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* Large vectors only fit the bandwidth-optimal ring */
+  const int small = (elem_cnt <= GPI2_ALLREDUCE_ELEM_MAX
+		     && elem_cnt * r_args.elem_size <= GPI2_REDUX_BUF_SIZE);
+  const gaspi_coll_alg_t alg =
+    _gaspi_coll_alg(&glb_gaspi_group_ctx[g], GPI2_COLL_ALLREDUCE, elem_cnt * r_args.elem_size,
+		    GPI2_ALG_MASK(GPI2_ALG_RING)
+		    | (small ? GPI2_ALG_MASK(GPI2_ALG_RECURSIVE_DOUBLING) | GPI2_ALG_MASK(GPI2_ALG_HIERARCHICAL) : 0),
+		    !small ? GPI2_ALG_RING
+		    : glb_gaspi_group_ctx[g].hier ? GPI2_ALG_HIERARCHICAL : GPI2_ALG_RECURSIVE_DOUBLING);
+
+  if( alg == GPI2_ALG_RING )
+    {
+      eret = _gaspi_allreduce_ring(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+    }
+  else if( alg == GPI2_ALG_HIERARCHICAL )
+    {
+      eret = _gaspi_hier_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+    }
+  else
+    {
+      eret = _gaspi_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+    }
+
+  unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
+
+  return eret;
+}
+
+#pragma weak gaspi_allreduce_user = pgaspi_allreduce_user
+gaspi_return_t
+pgaspi_allreduce_user (const gaspi_pointer_t buf_send,
+		       gaspi_pointer_t const buf_recv,
+		       const gaspi_number_t elem_cnt,
+		       const gaspi_size_t elem_size,
+		       gaspi_reduce_operation_t const user_fct,
+		       gaspi_state_t const rstate,
+		       const gaspi_group_t g,
+		       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_allreduce_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+
+  if( elem_cnt > GPI2_ALLREDUCE_ELEM_MAX )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  if( elem_size * elem_cnt > GPI2_REDUX_BUF_SIZE )
+    {
+      return GASPI_ERR_INV_SIZE;
+    }
+
+  if( lock_gaspi_tout (&glb_gaspi_group_ctx[g].gl, timeout_ms) )
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  if( !(glb_gaspi_group_ctx[g].coll_op & GASPI_ALLREDUCE_USER) )
+    {
+      unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
+      return GASPI_ERR_ACTIVE_COLL;
+    }
+
+  glb_gaspi_group_ctx[g].coll_op = GASPI_ALLREDUCE_USER;
+
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   struct redux_args r_args;
   r_args.f_type = GASPI_USER;
@@ -1059,9 +1710,2294 @@ pgaspi_allreduce_user (const gaspi_pointer_t buf_send,
   r_args.f_args.user_fct = user_fct;
   r_args.f_args.rstate = rstate;
 
-  eret = _gaspi_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+  if( _gaspi_coll_alg(&glb_gaspi_group_ctx[g], GPI2_COLL_ALLREDUCE, elem_cnt * elem_size,
+		      GPI2_ALG_MASK(GPI2_ALG_RECURSIVE_DOUBLING) | GPI2_ALG_MASK(GPI2_ALG_HIERARCHICAL),
+		      glb_gaspi_group_ctx[g].hier ? GPI2_ALG_HIERARCHICAL : GPI2_ALG_RECURSIVE_DOUBLING)
+      == GPI2_ALG_HIERARCHICAL )
+    {
+      eret = _gaspi_hier_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+    }
+  else
+    {
+      eret = _gaspi_allreduce(gctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+    }
 
   unlock_gaspi (&glb_gaspi_group_ctx[g].gl);
 
   return eret;
 }
+
+/* Fused allreduce of several small vectors. The vectors are packed,
+   each one 8-byte aligned, and reduced at once as a user allreduce
+   whose reduction applies the operation of every vector to its part
+   of the buffer. */
+#define GPI2_MULTI_ALIGN (8)
+#define GPI2_MULTI_ESIZE(e) \
+  (((e)->reduce_operation != NULL) ? (e)->element_size : _gaspi_redux_esize((e)->operation, (e)->datatype))
+#define GPI2_MULTI_SIZE(e) \
+  (((e)->num * GPI2_MULTI_ESIZE(e) + GPI2_MULTI_ALIGN - 1) & ~((gaspi_size_t) GPI2_MULTI_ALIGN - 1))
+
+struct multi_state
+{
+  gaspi_allreduce_entry_t const *list;
+  gaspi_number_t num;
+};
+
+static gaspi_return_t
+_gaspi_allreduce_multi_op(gaspi_pointer_t const op_one,
+			  gaspi_pointer_t const op_two,
+			  gaspi_pointer_t const result,
+			  gaspi_state_t const state,
+			  const gaspi_number_t num,
+			  const gaspi_size_t elem_size,
+			  const gaspi_timeout_t timeout_ms)
+{
+  struct multi_state const * const ms = (struct multi_state *) state;
+  gaspi_size_t off = 0;
+  gaspi_number_t i;
+
+  for(i = 0; i < ms->num; i++)
+    {
+      gaspi_allreduce_entry_t const * const e = &(ms->list[i]);
+
+      unsigned char * const one = (unsigned char *) op_one + off;
+      unsigned char * const two = (unsigned char *) op_two + off;
+      unsigned char * const res = (unsigned char *) result + off;
+
+      if( e->reduce_operation != NULL )
+	{
+	  const gaspi_return_t eret = e->reduce_operation(one, two, res, e->reduce_state,
+							  e->num, e->element_size, timeout_ms);
+	  if( eret != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+	}
+      else
+	{
+	  fctArrayGASPI[e->operation * GASPI_COLL_TYPES + e->datatype] (res, one, two, e->num);
+	}
+
+      off += GPI2_MULTI_SIZE(e);
+    }
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_allreduce_multi = pgaspi_allreduce_multi
+gaspi_return_t
+pgaspi_allreduce_multi (gaspi_allreduce_entry_t const * const list,
+			const gaspi_number_t num,
+			const gaspi_group_t g,
+			const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_allreduce_multi");
+  gaspi_verify_null_ptr(list);
+  gaspi_verify_group(g);
+
+  unsigned char packed_send[GPI2_REDUX_BUF_SIZE];
+  unsigned char packed_recv[GPI2_REDUX_BUF_SIZE];
+  gaspi_size_t total = 0;
+  gaspi_number_t i;
+
+  for(i = 0; i < num; i++)
+    {
+      gaspi_verify_null_ptr(list[i].buffer_send);
+      gaspi_verify_null_ptr(list[i].buffer_receive);
+
+      if( list[i].reduce_operation == NULL && !_gaspi_redux_valid(list[i].operation, list[i].datatype) )
+	{
+	  return GASPI_ERR_INV_NUM;
+	}
+
+      const gaspi_size_t size = GPI2_MULTI_SIZE(&list[i]);
+
+      if( total + size > GPI2_ALLREDUCE_ELEM_MAX * GPI2_MULTI_ALIGN )
+	{
+	  return GASPI_ERR_INV_SIZE;
+	}
+
+      memcpy(packed_send + total, list[i].buffer_send, list[i].num * GPI2_MULTI_ESIZE(&list[i]));
+      total += size;
+    }
+
+  if( total == 0 )
+    {
+      return GASPI_SUCCESS;
+    }
+
+  struct multi_state ms;
+  ms.list = list;
+  ms.num = num;
+
+  const gaspi_return_t eret =
+    pgaspi_allreduce_user(packed_send, packed_recv, total / GPI2_MULTI_ALIGN, GPI2_MULTI_ALIGN,
+			  _gaspi_allreduce_multi_op, &ms, g, timeout_ms);
+  if( eret != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  gaspi_size_t off = 0;
+  for(i = 0; i < num; i++)
+    {
+      memcpy(list[i].buffer_receive, packed_recv + off, list[i].num * GPI2_MULTI_ESIZE(&list[i]));
+      off += GPI2_MULTI_SIZE(&list[i]);
+    }
+
+  return GASPI_SUCCESS;
+}
+
+/* Broadcast. Small messages go down a binomial tree rooted at group
+   rank 0 (the root hands the data to rank 0 first), large messages
+   are pipelined along the ring starting at the root. Both move the
+   data in chunks through the group memory. */
+#define GPI2_TREE_DATA_FLAG(base)  ((volatile uint32_t *) ((base) + GPI2_TREE_FLAGS))
+#define GPI2_TREE_ENTRY_FLAG(base) ((volatile uint32_t *) ((base) + GPI2_TREE_FLAGS + sizeof(uint32_t)))
+#define GPI2_TREE_FLAG_SRC(base)   ((uint32_t *) ((base) + GPI2_TREE_FLAGS + 2 * sizeof(uint32_t)))
+#define GPI2_TREE_ACK_SRC(base)    ((uint32_t *) ((base) + GPI2_TREE_FLAGS + 4 * sizeof(uint32_t)))
+#define GPI2_TREE_ACK_FLAG(base)   ((volatile uint32_t *) ((base) + GPI2_TREE_FLAGS + 8 * sizeof(uint32_t)))
+
+/* Enter/leave a collective that resumes after a timeout */
+static inline gaspi_return_t
+_gaspi_coll_begin(gaspi_group_ctx_t * const grp_ctx,
+		  const gaspi_async_coll_t op,
+		  const gaspi_timeout_t timeout_ms)
+{
+  if( lock_gaspi_tout (&grp_ctx->gl, timeout_ms) )
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  if( !(grp_ctx->coll_op & op) )
+    {
+      unlock_gaspi (&grp_ctx->gl);
+      return GASPI_ERR_ACTIVE_COLL;
+    }
+
+  grp_ctx->coll_op = op;
+
+  return GASPI_SUCCESS;
+}
+
+static inline gaspi_return_t
+_gaspi_coll_end(gaspi_group_ctx_t * const grp_ctx,
+		const gaspi_return_t eret)
+{
+  if( eret != GASPI_TIMEOUT )
+    {
+      grp_ctx->coll_op = GASPI_NONE;
+      grp_ctx->coll_step = 0;
+      grp_ctx->coll_phase = 0;
+    }
+
+  unlock_gaspi (&grp_ctx->gl);
+
+  return eret;
+}
+
+static gaspi_return_t
+_gaspi_bcast_tree(gaspi_context_t * const gctx,
+		  unsigned char * const buf,
+		  const gaspi_size_t size,
+		  const int root,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  /* Children (as bit levels) and position below the parent */
+  int child_lvl[32];
+  int nchild = 0, my_lvl = 0, mask;
+
+  for(mask = 1; mask < P; mask <<= 1, my_lvl++)
+    {
+      if( me & mask )
+	{
+	  break;
+	}
+      if( me + mask < P )
+	{
+	  child_lvl[nchild++] = my_lvl;
+	}
+    }
+
+  const gaspi_rank_t parent = grp_ctx->rank_grp[me & (me - 1)];
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_TREE)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  int c;
+  for(c = 0; c < nchild; c++)
+    {
+      if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_TREE, grp_ctx->rank_grp[me + (1 << child_lvl[c])], timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  if( me != 0 )
+    {
+      if( (eret = _gaspi_grp_connect_to(gctx, g, parent, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  if( me == root && root != 0 )
+    {
+      if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_TREE, grp_ctx->rank_grp[0], timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  unsigned char * const tree = grp_ctx->area[GPI2_AREA_TREE][gctx->rank].data.buf;
+
+  const int nchunks = (size + GPI2_COLL_CHUNK_SIZE - 1) / GPI2_COLL_CHUNK_SIZE;
+
+  for(c = grp_ctx->coll_step; c < nchunks; c++)
+    {
+      const uint32_t k = grp_ctx->tree_msg + (uint32_t) c;
+      const int slot = k % 2;
+      const gaspi_size_t off = (gaspi_size_t) c * GPI2_COLL_CHUNK_SIZE;
+      const unsigned int bytes = MIN(GPI2_COLL_CHUNK_SIZE, size - off);
+
+      uint32_t * const flag_src = GPI2_TREE_FLAG_SRC(base) + slot;
+      unsigned char * const stage = tree + GPI2_TREE_ENTRY + slot * GPI2_COLL_CHUNK_SIZE;
+      unsigned char * const src = (me == 0) ? stage : tree + GPI2_TREE_RECV + slot * GPI2_COLL_CHUNK_SIZE;
+
+      *flag_src = k + 1;
+
+      if( grp_ctx->coll_phase == 0 )
+	{
+	  if( me == root )
+	    {
+	      memcpy(stage, buf + off, bytes);
+
+	      /* Rank 0 consumed the entry slot before we got message k - 1 */
+	      if( me != 0 )
+		{
+		  if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_TREE, stage, bytes, grp_ctx->rank_grp[0],
+						   GPI2_TREE_ENTRY + slot * GPI2_COLL_CHUNK_SIZE)) != GASPI_SUCCESS )
+		    {
+		      return eret;
+		    }
+
+		  if( (eret = _gaspi_grp_post(gctx, g, flag_src, sizeof(uint32_t), grp_ctx->rank_grp[0],
+					      GPI2_TREE_FLAGS + sizeof(uint32_t))) != GASPI_SUCCESS )
+		    {
+		      return eret;
+		    }
+		}
+	    }
+	  grp_ctx->coll_phase = 1;
+	}
+
+      if( grp_ctx->coll_phase == 1 )
+	{
+	  volatile uint32_t * const flag = (me == 0) ? GPI2_TREE_ENTRY_FLAG(base) : GPI2_TREE_DATA_FLAG(base);
+
+	  if( !(me == 0 && root == 0) )
+	    {
+	      if( _gaspi_seq_wait(gctx, flag, k + 1, timeout_ms) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = c;
+		  return GASPI_TIMEOUT;
+		}
+	    }
+	  grp_ctx->coll_phase = 2;
+	}
+
+      /* Forward, largest subtree first */
+      while( grp_ctx->coll_phase - 2 < nchild )
+	{
+	  const int lvl = child_lvl[nchild - 1 - (grp_ctx->coll_phase - 2)];
+	  const gaspi_rank_t child = grp_ctx->rank_grp[me + (1 << lvl)];
+
+	  if( _gaspi_seq_wait(gctx, GPI2_TREE_ACK_FLAG(base) + lvl, k - 1, timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = c;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_TREE, src, bytes, child,
+					   GPI2_TREE_RECV + slot * GPI2_COLL_CHUNK_SIZE)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  if( (eret = _gaspi_grp_post(gctx, g, flag_src, sizeof(uint32_t), child, GPI2_TREE_FLAGS)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->coll_phase++;
+	}
+
+      if( me != root )
+	{
+	  memcpy(buf + off, src, bytes);
+	}
+
+      /* The receive slot is free once forwarded */
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      if( me != 0 )
+	{
+	  uint32_t * const ack_src = GPI2_TREE_ACK_SRC(base) + slot;
+	  *ack_src = k + 1;
+
+	  if( (eret = _gaspi_grp_post(gctx, g, ack_src, sizeof(uint32_t), parent,
+				      GPI2_TREE_FLAGS + (8 + my_lvl) * sizeof(uint32_t))) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+	}
+
+      grp_ctx->coll_phase = 0;
+    }
+
+  if( pgaspi_dev_poll_groups() < 0 )
+    {
+      return GASPI_ERR_DEVICE;
+    }
+
+  grp_ctx->tree_msg += (uint32_t) nchunks;
+  grp_ctx->coll_step = 0;
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_bcast_chain(gaspi_context_t * const gctx,
+		   unsigned char * const buf,
+		   const gaspi_size_t size,
+		   const int root,
+		   const gaspi_group_t g,
+		   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const int rel = (me - root + P) % P;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  const gaspi_rank_t left = grp_ctx->rank_grp[(me + P - 1) % P];
+  const gaspi_rank_t right = grp_ctx->rank_grp[(me + 1) % P];
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_RING)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  if( rel != P - 1 )
+    {
+      if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, right, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  if( rel != 0 )
+    {
+      if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, left, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  unsigned char * const ring = grp_ctx->area[GPI2_AREA_RING][gctx->rank].data.buf;
+
+  const int nchunks = (size + GPI2_COLL_CHUNK_SIZE - 1) / GPI2_COLL_CHUNK_SIZE;
+
+  int c;
+  for(c = grp_ctx->coll_step; c < nchunks; c++)
+    {
+      const uint32_t k = grp_ctx->ring_msg + (uint32_t) c;
+      const int slot = k % 2;
+      const gaspi_size_t off = (gaspi_size_t) c * GPI2_COLL_CHUNK_SIZE;
+      const unsigned int bytes = MIN(GPI2_COLL_CHUNK_SIZE, size - off);
+
+      unsigned char * const send_slot = ring + GPI2_RING_SEND + slot * GPI2_COLL_CHUNK_SIZE;
+      unsigned char * const recv_slot = ring + GPI2_RING_RECV + slot * GPI2_COLL_CHUNK_SIZE;
+
+      if( grp_ctx->coll_phase == 0 )
+	{
+	  if( rel == 0 )
+	    {
+	      memcpy(send_slot, buf + off, bytes);
+	    }
+	  else
+	    {
+	      if( _gaspi_seq_wait(gctx, GPI2_RING_DATA_FLAG(base), k + 1, timeout_ms) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = c;
+		  return GASPI_TIMEOUT;
+		}
+
+	      memcpy(buf + off, recv_slot, bytes);
+	      if( rel != P - 1 )
+		{
+		  memcpy(send_slot, recv_slot, bytes);
+		}
+
+	      uint32_t * const ack_src = GPI2_RING_ACK_SRC(base) + slot;
+	      *ack_src = k + 1;
+
+	      if( (eret = _gaspi_grp_post(gctx, g, ack_src, sizeof(uint32_t), left,
+					  GPI2_RING_FLAGS + sizeof(uint32_t))) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+	    }
+	  grp_ctx->coll_phase = 1;
+	}
+
+      if( rel != P - 1 )
+	{
+	  if( _gaspi_seq_wait(gctx, GPI2_RING_ACK_FLAG(base), grp_ctx->ring_slot[slot], timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = c;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_RING, send_slot, bytes, right,
+					   GPI2_RING_RECV + slot * GPI2_COLL_CHUNK_SIZE)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  uint32_t * const flag_src = GPI2_RING_FLAG_SRC(base) + slot;
+	  *flag_src = k + 1;
+
+	  if( (eret = _gaspi_grp_post(gctx, g, flag_src, sizeof(uint32_t), right, GPI2_RING_FLAGS)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->ring_slot[slot] = k + 1;
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 0;
+    }
+
+  grp_ctx->ring_msg += (uint32_t) nchunks;
+  grp_ctx->coll_step = 0;
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_bcast(gaspi_context_t * const gctx,
+	     unsigned char * const buf,
+	     const gaspi_size_t size,
+	     const gaspi_rank_t root,
+	     const gaspi_group_t g,
+	     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  int root_grp;
+  for(root_grp = 0; root_grp < grp_ctx->tnc; root_grp++)
+    {
+      if( grp_ctx->rank_grp[root_grp] == root )
+	{
+	  break;
+	}
+    }
+
+  if( root_grp == grp_ctx->tnc )
+    {
+      return GASPI_ERR_INV_RANK;
+    }
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_BCAST, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  if( grp_ctx->tnc == 1 || size == 0 )
+    {
+      eret = GASPI_SUCCESS;
+    }
+  else
+    {
+      /* Pick the algorithm with fewer chunk transfer steps: the tree
+	 root sends each chunk depth times, the chain fills P - 1 hops */
+      const gaspi_size_t nchunks = (size + GPI2_COLL_CHUNK_SIZE - 1) / GPI2_COLL_CHUNK_SIZE;
+      gaspi_size_t depth = 0;
+      while( (1 << depth) < grp_ctx->tnc )
+	{
+	  depth++;
+	}
+
+      const gaspi_coll_alg_t dflt =
+	((nchunks + 1) * depth <= nchunks + grp_ctx->tnc - 1) ? GPI2_ALG_TREE : GPI2_ALG_CHAIN;
+
+      if( _gaspi_coll_alg(grp_ctx, GPI2_COLL_BCAST, size,
+			  GPI2_ALG_MASK(GPI2_ALG_TREE) | GPI2_ALG_MASK(GPI2_ALG_CHAIN), dflt) == GPI2_ALG_TREE )
+	{
+	  eret = _gaspi_bcast_tree(gctx, buf, size, root_grp, g, timeout_ms);
+	}
+      else
+	{
+	  eret = _gaspi_bcast_chain(gctx, buf, size, root_grp, g, timeout_ms);
+	}
+    }
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+#pragma weak gaspi_bcast = pgaspi_bcast
+gaspi_return_t
+pgaspi_bcast (const gaspi_segment_id_t segment_id,
+	      const gaspi_offset_t offset,
+	      const gaspi_size_t size,
+	      const gaspi_rank_t root,
+	      const gaspi_group_t g,
+	      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_bcast");
+  gaspi_verify_local_off(offset, segment_id, size);
+  gaspi_verify_group(g);
+
+  unsigned char * const buf = (unsigned char *) gctx->rrmd[segment_id]->local.data.buf + offset;
+
+  return _gaspi_bcast(gctx, buf, size, root, g, timeout_ms);
+}
+
+#pragma weak gaspi_bcast_buf = pgaspi_bcast_buf
+gaspi_return_t
+pgaspi_bcast_buf (gaspi_pointer_t const buf,
+		  const gaspi_size_t size,
+		  const gaspi_rank_t root,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_bcast_buf");
+  gaspi_verify_null_ptr(buf);
+  gaspi_verify_group(g);
+
+  return _gaspi_bcast(&glb_gaspi_ctx, (unsigned char *) buf, size, root, g, timeout_ms);
+}
+
+/* Pairwise collectives (allgather, alltoall). The data is written
+   directly between the segments on the collectives connection, each
+   write followed by a data flag to the target. A rank is written to
+   only after its ready flag announced that it entered the collective,
+   i.e. that its receive region can be overwritten. Blocks are
+   ordered by group rank. */
+#define GPI2_PAIR_READY_SRC(base)     ((uint32_t *) ((base) + GPI2_PAIR_FLAGS))
+#define GPI2_PAIR_DATA_SRC(base)      ((uint32_t *) ((base) + GPI2_PAIR_FLAGS + sizeof(uint32_t)))
+#define GPI2_PAIR_FLAG_OFF(i, data)   (GPI2_PAIR_FLAGS + 64 + (2 * (i) + (data)) * sizeof(uint32_t))
+#define GPI2_PAIR_FLAG(base, i, data) ((volatile uint32_t *) ((base) + GPI2_PAIR_FLAG_OFF(i, data)))
+
+/* Tell (group rank) peer that it may write to us */
+static inline gaspi_return_t
+_gaspi_pair_ready(gaspi_context_t * const gctx,
+		  const gaspi_group_t g,
+		  const int peer,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+  const gaspi_rank_t dst = grp_ctx->rank_grp[peer];
+
+  if( (eret = _gaspi_grp_connect_to(gctx, g, dst, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  *GPI2_PAIR_READY_SRC(base) = grp_ctx->pair_msg + 1;
+
+  return _gaspi_grp_post(gctx, g, GPI2_PAIR_READY_SRC(base), sizeof(uint32_t), dst,
+			 GPI2_PAIR_FLAG_OFF(grp_ctx->rank, 0));
+}
+
+static inline gaspi_return_t
+_gaspi_pair_write(gaspi_context_t * const gctx,
+		  const gaspi_group_t g,
+		  const int peer,
+		  const gaspi_segment_id_t segment_id_local,
+		  const gaspi_offset_t offset_local,
+		  const gaspi_segment_id_t segment_id_remote,
+		  const gaspi_offset_t offset_remote,
+		  const gaspi_size_t size,
+		  const gaspi_timeout_t timeout_ms)
+{
+  const gaspi_rank_t dst = glb_gaspi_group_ctx[g].rank_grp[peer];
+
+  if( size > 0 )
+    {
+      gaspi_segment_remote_require(segment_id_remote, dst, timeout_ms);
+
+      if( pgaspi_dev_post_group_seg_write(segment_id_local, offset_local, dst,
+					  segment_id_remote, offset_remote, size) != 0 )
+	{
+	  gctx->qp_state_vec[GASPI_COLL_QP][dst] = GASPI_STATE_CORRUPT;
+	  return GASPI_ERR_DEVICE;
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+/* Flag the data written so far to (group rank) peer */
+static inline gaspi_return_t
+_gaspi_pair_flag(gaspi_context_t * const gctx,
+		 const gaspi_group_t g,
+		 const int peer,
+		 const uint32_t val)
+{
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  *GPI2_PAIR_DATA_SRC(base) = val;
+
+  return _gaspi_grp_post(gctx, g, GPI2_PAIR_DATA_SRC(base), sizeof(uint32_t), grp_ctx->rank_grp[peer],
+			 GPI2_PAIR_FLAG_OFF(grp_ctx->rank, 1));
+}
+
+/* Small blocks: Bruck. At step k, rank r holds the blocks r, ...,
+   r + 2^k - 1 and passes them to rank r - 2^k. */
+static gaspi_return_t
+_gaspi_allgather_bruck(gaspi_context_t * const gctx,
+		       const gaspi_segment_id_t segment_id,
+		       const gaspi_offset_t offset,
+		       const gaspi_size_t size,
+		       const gaspi_group_t g,
+		       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const uint32_t seq = grp_ctx->pair_msg;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  int nsteps = 0;
+  while( (1 << nsteps) < P )
+    {
+      nsteps++;
+    }
+
+  int k;
+  if( grp_ctx->coll_phase == 0 )
+    {
+      for(k = 0; k < nsteps; k++)
+	{
+	  if( (eret = _gaspi_pair_ready(gctx, g, (me + (1 << k)) % P, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+	}
+      grp_ctx->coll_phase = 1;
+    }
+
+  for(k = grp_ctx->coll_step; k < nsteps; k++)
+    {
+      const int dist = 1 << k;
+      const int dst = (me - dist + P) % P;
+      const int src = (me + dist) % P;
+
+      if( grp_ctx->coll_phase == 1 )
+	{
+	  if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, dst, 0), seq + 1, timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = k;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  if( (eret = _gaspi_grp_connect_to(gctx, g, grp_ctx->rank_grp[dst], timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  /* Blocks me, ..., me + cnt - 1, in at most two ranges */
+	  const int cnt = MIN(dist, P - dist);
+	  const int first = MIN(cnt, P - me);
+
+	  if( (eret = _gaspi_pair_write(gctx, g, dst, segment_id, offset + me * size,
+					segment_id, offset + me * size, first * size, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  if( (eret = _gaspi_pair_write(gctx, g, dst, segment_id, offset,
+					segment_id, offset, (cnt - first) * size, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  if( (eret = _gaspi_pair_flag(gctx, g, dst, seq + k + 1)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->coll_phase = 2;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, src, 1), seq + k + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = k;
+	  return GASPI_TIMEOUT;
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 1;
+    }
+
+  if( pgaspi_dev_poll_groups() < 0 )
+    {
+      return GASPI_ERR_DEVICE;
+    }
+
+  grp_ctx->pair_msg += (uint32_t) nsteps;
+
+  return GASPI_SUCCESS;
+}
+
+/* Large blocks: ring. At step s, rank r passes block r - s to the
+   right. */
+static gaspi_return_t
+_gaspi_allgather_ring(gaspi_context_t * const gctx,
+		      const gaspi_segment_id_t segment_id,
+		      const gaspi_offset_t offset,
+		      const gaspi_size_t size,
+		      const gaspi_group_t g,
+		      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const int left = (me + P - 1) % P;
+  const int right = (me + 1) % P;
+  const uint32_t seq = grp_ctx->pair_msg;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  if( grp_ctx->coll_phase == 0 )
+    {
+      if( (eret = _gaspi_pair_ready(gctx, g, left, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+      grp_ctx->coll_phase = 1;
+    }
+
+  if( grp_ctx->coll_phase == 1 )
+    {
+      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, right, 0), seq + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  return GASPI_TIMEOUT;
+	}
+
+      if( (eret = _gaspi_grp_connect_to(gctx, g, grp_ctx->rank_grp[right], timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+      grp_ctx->coll_phase = 2;
+    }
+
+  int s;
+  for(s = grp_ctx->coll_step; s < P - 1; s++)
+    {
+      const int b = (me - s + P) % P;
+
+      if( grp_ctx->coll_phase == 2 )
+	{
+	  if( (eret = _gaspi_pair_write(gctx, g, right, segment_id, offset + b * size,
+					segment_id, offset + b * size, size, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  if( (eret = _gaspi_pair_flag(gctx, g, right, seq + s + 1)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->coll_phase = 3;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, left, 1), seq + s + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = s;
+	  return GASPI_TIMEOUT;
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 2;
+    }
+
+  grp_ctx->pair_msg += (uint32_t) (P - 1);
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_allgather = pgaspi_allgather
+gaspi_return_t
+pgaspi_allgather (const gaspi_segment_id_t segment_id_send,
+		  const gaspi_offset_t offset_send,
+		  const gaspi_segment_id_t segment_id_recv,
+		  const gaspi_offset_t offset_recv,
+		  const gaspi_size_t size,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  gaspi_return_t eret = GASPI_ERROR;
+
+  gaspi_verify_init("gaspi_allgather");
+  gaspi_verify_group(g);
+  gaspi_verify_local_off(offset_send, segment_id_send, size);
+  gaspi_verify_local_off(offset_recv, segment_id_recv, size * glb_gaspi_group_ctx[g].tnc);
+
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_ALLGATHER, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  if( grp_ctx->coll_step == 0 && grp_ctx->coll_phase == 0 )
+    {
+      memmove(gctx->rrmd[segment_id_recv]->local.data.buf + offset_recv + grp_ctx->rank * size,
+	      gctx->rrmd[segment_id_send]->local.data.buf + offset_send,
+	      size);
+    }
+
+  if( grp_ctx->tnc == 1 || size == 0 )
+    {
+      eret = GASPI_SUCCESS;
+    }
+  else if( _gaspi_coll_alg(grp_ctx, GPI2_COLL_ALLGATHER, size,
+			   GPI2_ALG_MASK(GPI2_ALG_RING)
+			   | (size * grp_ctx->tnc <= GPI2_COLL_CHUNK_SIZE ? GPI2_ALG_MASK(GPI2_ALG_BRUCK) : 0),
+			   size * grp_ctx->tnc <= GPI2_COLL_CHUNK_SIZE ? GPI2_ALG_BRUCK : GPI2_ALG_RING)
+	   == GPI2_ALG_BRUCK )
+    {
+      eret = _gaspi_allgather_bruck(gctx, segment_id_recv, offset_recv, size, g, timeout_ms);
+    }
+  else
+    {
+      eret = _gaspi_allgather_ring(gctx, segment_id_recv, offset_recv, size, g, timeout_ms);
+    }
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+/* Pairwise exchange: at step s, rank r writes to r + s and receives
+   from r - s, so every rank has a single writer at a time. Blocks are
+   given either as vectors (alltoallv) or as (offset, size). */
+static gaspi_return_t
+_gaspi_alltoall_pairwise(gaspi_context_t * const gctx,
+			 const gaspi_segment_id_t segment_id_send,
+			 const gaspi_offset_t * const offset_send_v,
+			 const gaspi_size_t * const size_v,
+			 const gaspi_segment_id_t segment_id_recv,
+			 const gaspi_offset_t * const offset_recv_v,
+			 const gaspi_offset_t offset_send,
+			 const gaspi_offset_t offset_recv,
+			 const gaspi_size_t size,
+			 const gaspi_group_t g,
+			 const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const uint32_t seq = grp_ctx->pair_msg;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  if( grp_ctx->coll_step == 0 )
+    {
+      const gaspi_size_t bytes = size_v ? size_v[me] : size;
+      const gaspi_offset_t off_s = offset_send_v ? offset_send_v[me] : offset_send + me * size;
+      const gaspi_offset_t off_r = offset_recv_v ? offset_recv_v[me] : offset_recv + me * size;
+
+      memmove(gctx->rrmd[segment_id_recv]->local.data.buf + off_r,
+	      gctx->rrmd[segment_id_send]->local.data.buf + off_s,
+	      bytes);
+
+      grp_ctx->coll_step = 1;
+      grp_ctx->coll_phase = 0;
+    }
+
+  /* Steps 1 .. P - 1 write, steps P .. 2P - 2 wait for the data */
+  int s;
+  for(s = grp_ctx->coll_step; s < P; s++)
+    {
+      const int dst = (me + s) % P;
+      const int src = (me - s + P) % P;
+
+      if( grp_ctx->coll_phase == 0 )
+	{
+	  if( (eret = _gaspi_pair_ready(gctx, g, src, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+	  grp_ctx->coll_phase = 1;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, dst, 0), seq + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = s;
+	  return GASPI_TIMEOUT;
+	}
+
+      if( (eret = _gaspi_grp_connect_to(gctx, g, grp_ctx->rank_grp[dst], timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      const gaspi_size_t bytes = size_v ? size_v[dst] : size;
+      const gaspi_offset_t off_s = offset_send_v ? offset_send_v[dst] : offset_send + dst * size;
+      const gaspi_offset_t off_r = offset_recv_v ? offset_recv_v[dst] : offset_recv + me * size;
+
+      if( (eret = _gaspi_pair_write(gctx, g, dst, segment_id_send, off_s,
+				    segment_id_recv, off_r, bytes, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      if( (eret = _gaspi_pair_flag(gctx, g, dst, seq + 1)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 0;
+    }
+
+  for(; s < 2 * P - 1; s++)
+    {
+      const int src = (me - (s - P + 1) + P) % P;
+
+      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, src, 1), seq + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = s;
+	  return GASPI_TIMEOUT;
+	}
+    }
+
+  grp_ctx->pair_msg += 1;
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_alltoall = pgaspi_alltoall
+gaspi_return_t
+pgaspi_alltoall (const gaspi_segment_id_t segment_id_send,
+		 const gaspi_offset_t offset_send,
+		 const gaspi_segment_id_t segment_id_recv,
+		 const gaspi_offset_t offset_recv,
+		 const gaspi_size_t size,
+		 const gaspi_group_t g,
+		 const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+
+  gaspi_verify_init("gaspi_alltoall");
+  gaspi_verify_group(g);
+  gaspi_verify_local_off(offset_send, segment_id_send, size * glb_gaspi_group_ctx[g].tnc);
+  gaspi_verify_local_off(offset_recv, segment_id_recv, size * glb_gaspi_group_ctx[g].tnc);
+
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_ALLTOALL, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  eret = _gaspi_alltoall_pairwise(&glb_gaspi_ctx, segment_id_send, NULL, NULL, segment_id_recv, NULL,
+				  offset_send, offset_recv, size, g, timeout_ms);
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+#pragma weak gaspi_alltoallv = pgaspi_alltoallv
+gaspi_return_t
+pgaspi_alltoallv (const gaspi_segment_id_t segment_id_send,
+		  gaspi_offset_t * const offset_send,
+		  gaspi_size_t * const size,
+		  const gaspi_segment_id_t segment_id_recv,
+		  gaspi_offset_t * const offset_recv,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+
+  gaspi_verify_init("gaspi_alltoallv");
+  gaspi_verify_group(g);
+  gaspi_verify_null_ptr(offset_send);
+  gaspi_verify_null_ptr(size);
+  gaspi_verify_null_ptr(offset_recv);
+
+#ifdef DEBUG
+  int i;
+  for(i = 0; i < glb_gaspi_group_ctx[g].tnc; i++)
+    {
+      gaspi_segment_remote_require(segment_id_recv, glb_gaspi_group_ctx[g].rank_grp[i], timeout_ms);
+      gaspi_verify_local_off(offset_send[i], segment_id_send, size[i]);
+      gaspi_verify_remote_off(offset_recv[i], segment_id_recv, glb_gaspi_group_ctx[g].rank_grp[i], size[i]);
+    }
+#endif
+
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_ALLTOALL, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  eret = _gaspi_alltoall_pairwise(&glb_gaspi_ctx, segment_id_send, offset_send, size, segment_id_recv, offset_recv,
+				  0, 0, 0, g, timeout_ms);
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+/* Reduce-scatter and scan */
+
+/* res = local op dst, with the default or a user reduction */
+static inline gaspi_return_t
+_gaspi_redux_apply(struct redux_args * const r_args,
+		   void * const res,
+		   void * const local,
+		   void * const dst,
+		   const gaspi_number_t cnt,
+		   const gaspi_timeout_t timeout_ms)
+{
+  if( r_args->f_type == GASPI_OP )
+    {
+      fctArrayGASPI[r_args->f_args.op * GASPI_COLL_TYPES + r_args->f_args.type] (res, local, dst, cnt);
+      return GASPI_SUCCESS;
+    }
+
+  return r_args->f_args.user_fct(local, dst, res, r_args->f_args.rstate,
+				 cnt, r_args->elem_size, timeout_ms);
+}
+
+/* Large vectors: ring. Each block is reduced while it travels P - 1
+   hops to its owner, one chunk of every block per round. At step s,
+   rank r sends block r - s - 1 and receives block r - s - 2, which
+   it combines with its own contribution directly into the send slot
+   of the next step, or into the receive buffer at the last step. */
+static gaspi_return_t
+_gaspi_reduce_scatter_ring(gaspi_context_t * const gctx,
+			   const gaspi_pointer_t buf_send,
+			   gaspi_pointer_t const buf_recv,
+			   struct redux_args * const r_args,
+			   const gaspi_group_t g,
+			   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const size_t esize = r_args->elem_size;
+  const gaspi_number_t num = r_args->elem_cnt;
+
+  unsigned char * const src = (unsigned char *) buf_send;
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+
+  const gaspi_rank_t left = grp_ctx->rank_grp[(me + P - 1) % P];
+  const gaspi_rank_t right = grp_ctx->rank_grp[(me + 1) % P];
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_RING)) != GASPI_SUCCESS
+      || (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, right, timeout_ms)) != GASPI_SUCCESS
+      || (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_RING, left, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  unsigned char * const ring = grp_ctx->area[GPI2_AREA_RING][gctx->rank].data.buf;
+
+  const gaspi_number_t chunk_elems = GPI2_COLL_CHUNK_SIZE / esize;
+  const int rounds = (num + chunk_elems - 1) / chunk_elems;
+  const int steps = rounds * (P - 1);
+
+  int step;
+  for(step = grp_ctx->coll_step; step < steps; step++)
+    {
+      const uint32_t k = grp_ctx->ring_msg + (uint32_t) step;
+      const int s = step % (P - 1);
+      const int last = (s == P - 2);
+
+      const gaspi_number_t first = (step / (P - 1)) * chunk_elems;
+      const gaspi_number_t cnt = MIN(chunk_elems, num - first);
+
+      if( !grp_ctx->coll_phase )
+	{
+	  /* Later steps forward what the previous one staged */
+	  if( s == 0 )
+	    {
+	      if( _gaspi_seq_wait(gctx, GPI2_RING_ACK_FLAG(base), grp_ctx->ring_slot[k % 2], timeout_ms) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = step;
+		  return GASPI_TIMEOUT;
+		}
+
+	      const int send_b = (me + P - 1) % P;
+	      memcpy(ring + GPI2_RING_SEND + (k % 2) * GPI2_COLL_CHUNK_SIZE,
+		     src + (send_b * num + first) * esize,
+		     cnt * esize);
+	    }
+
+	  if( (eret = _gaspi_ring_send(gctx, g, right, k, cnt * esize)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  grp_ctx->coll_phase = 1;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_RING_DATA_FLAG(base), k + 1, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = step;
+	  return GASPI_TIMEOUT;
+	}
+
+      unsigned char * res = (unsigned char *) buf_recv + first * esize;
+      if( !last )
+	{
+	  /* The next message is reduced straight into its slot */
+	  if( _gaspi_seq_wait(gctx, GPI2_RING_ACK_FLAG(base), grp_ctx->ring_slot[(k + 1) % 2], timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = step;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  res = ring + GPI2_RING_SEND + ((k + 1) % 2) * GPI2_COLL_CHUNK_SIZE;
+	}
+
+      const int recv_b = (me - s - 2 + 2 * P) % P;
+      if( (eret = _gaspi_redux_apply(r_args, res,
+				     src + (recv_b * num + first) * esize,
+				     ring + GPI2_RING_RECV + (k % 2) * GPI2_COLL_CHUNK_SIZE,
+				     cnt, timeout_ms)) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = step;
+	  return eret;
+	}
+
+      if( (eret = _gaspi_ring_ack(gctx, g, left, k)) != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 0;
+    }
+
+  grp_ctx->ring_msg += (uint32_t) steps;
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_reduce_scatter(gaspi_context_t * const gctx,
+		      const gaspi_pointer_t buf_send,
+		      gaspi_pointer_t const buf_recv,
+		      struct redux_args * const r_args,
+		      const gaspi_group_t g,
+		      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const gaspi_size_t bsize = r_args->elem_cnt * r_args->elem_size;
+
+  if( P == 1 )
+    {
+      memmove(buf_recv, buf_send, bsize);
+      return GASPI_SUCCESS;
+    }
+
+  /* Small vectors: recursive doubling allreduce of all blocks, which
+     only copies its result out once done */
+  const int small = (P * r_args->elem_cnt <= GPI2_ALLREDUCE_ELEM_MAX
+		     && P * bsize <= GPI2_REDUX_BUF_SIZE);
+
+  if( _gaspi_coll_alg(grp_ctx, GPI2_COLL_REDUCE_SCATTER, bsize,
+		      GPI2_ALG_MASK(GPI2_ALG_RING) | (small ? GPI2_ALG_MASK(GPI2_ALG_ALLREDUCE) : 0),
+		      small ? GPI2_ALG_ALLREDUCE : GPI2_ALG_RING) == GPI2_ALG_ALLREDUCE )
+    {
+      unsigned char all[GPI2_REDUX_BUF_SIZE];
+      struct redux_args all_args = *r_args;
+      all_args.elem_cnt = P * r_args->elem_cnt;
+
+      eret = _gaspi_allreduce(gctx, buf_send, all, &all_args, g, timeout_ms);
+      if( eret == GASPI_SUCCESS )
+	{
+	  memcpy(buf_recv, all + grp_ctx->rank * bsize, bsize);
+	}
+
+      return eret;
+    }
+
+  return _gaspi_reduce_scatter_ring(gctx, buf_send, buf_recv, r_args, g, timeout_ms);
+}
+
+#pragma weak gaspi_reduce_scatter = pgaspi_reduce_scatter
+gaspi_return_t
+pgaspi_reduce_scatter (const gaspi_pointer_t buf_send,
+		       gaspi_pointer_t const buf_recv,
+		       const gaspi_number_t elem_cnt,
+		       const gaspi_operation_t op,
+		       const gaspi_datatype_t type,
+		       const gaspi_group_t g,
+		       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_reduce_scatter");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  if( _gaspi_redux_op_args(&r_args, elem_cnt, op, type) != GASPI_SUCCESS )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_REDUCE_SCATTER, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  eret = _gaspi_reduce_scatter(&glb_gaspi_ctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+#pragma weak gaspi_reduce_scatter_user = pgaspi_reduce_scatter_user
+gaspi_return_t
+pgaspi_reduce_scatter_user (const gaspi_pointer_t buf_send,
+			    gaspi_pointer_t const buf_recv,
+			    const gaspi_number_t elem_cnt,
+			    const gaspi_size_t elem_size,
+			    gaspi_reduce_operation_t const user_fct,
+			    gaspi_state_t const rstate,
+			    const gaspi_group_t g,
+			    const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_reduce_scatter_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_null_ptr(user_fct);
+  gaspi_verify_group(g);
+
+  if( elem_size == 0 || elem_size > GPI2_COLL_CHUNK_SIZE )
+    {
+      return GASPI_ERR_INV_SIZE;
+    }
+
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_REDUCE_SCATTER, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  struct redux_args r_args;
+  r_args.f_type = GASPI_USER;
+  r_args.elem_size = elem_size;
+  r_args.elem_cnt = elem_cnt;
+  r_args.f_args.user_fct = user_fct;
+  r_args.f_args.rstate = rstate;
+
+  eret = _gaspi_reduce_scatter(&glb_gaspi_ctx, buf_send, buf_recv, &r_args, g, timeout_ms);
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+/* Scan: Hillis-Steele on the pairwise flags. At step k, rank r
+   passes its inclusive partial result to r + 2^k and prepends the
+   one of r - 2^k to its own. Messages go through a receive slot per
+   step in the scan area, which also keeps the partial results across
+   a timeout. */
+static gaspi_return_t
+_gaspi_scan(gaspi_context_t * const gctx,
+	    const gaspi_pointer_t buf_send,
+	    gaspi_pointer_t const buf_recv,
+	    struct redux_args * const r_args,
+	    const int exclusive,
+	    const gaspi_group_t g,
+	    const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const int P = grp_ctx->tnc;
+  const int me = grp_ctx->rank;
+  const uint32_t seq = grp_ctx->pair_msg;
+  const unsigned int dsize = r_args->elem_cnt * r_args->elem_size;
+
+  unsigned char * const base = grp_ctx->rrcd[gctx->rank].data.buf;
+  unsigned char * const incl = base + GPI2_SCAN_STATE;
+  unsigned char * const excl = incl + GPI2_REDUX_BUF_SIZE;
+
+  int nsteps = 0;
+  while( (1 << nsteps) < P )
+    {
+      nsteps++;
+    }
+
+  int k;
+  if( grp_ctx->coll_step == 0 && grp_ctx->coll_phase == 0 )
+    {
+      memcpy(incl, buf_send, dsize);
+
+      for(k = 0; k < nsteps && me >= (1 << k); k++)
+	{
+	  if( (eret = _gaspi_pair_ready(gctx, g, me - (1 << k), timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+	}
+      grp_ctx->coll_phase = 1;
+    }
+
+  for(k = grp_ctx->coll_step; k < nsteps; k++)
+    {
+      const int dist = 1 << k;
+
+      if( grp_ctx->coll_phase == 1 )
+	{
+	  if( me + dist < P )
+	    {
+	      const int dst = me + dist;
+
+	      if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, dst, 0), seq + 1, timeout_ms) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = k;
+		  return GASPI_TIMEOUT;
+		}
+
+	      if( (eret = _gaspi_grp_connect_to(gctx, g, grp_ctx->rank_grp[dst], timeout_ms)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+
+	      unsigned char * const stage = base + GPI2_SCAN_SEND + k * GPI2_REDUX_BUF_SIZE;
+	      memcpy(stage, incl, dsize);
+
+	      if( (eret = _gaspi_grp_post(gctx, g, stage, dsize, grp_ctx->rank_grp[dst],
+					  GPI2_SCAN_RECV + k * GPI2_REDUX_BUF_SIZE)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+
+	      if( (eret = _gaspi_pair_flag(gctx, g, dst, seq + k + 1)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+	    }
+
+	  grp_ctx->coll_phase = 2;
+	}
+
+      if( me >= dist )
+	{
+	  if( _gaspi_seq_wait(gctx, GPI2_PAIR_FLAG(base, me - dist, 1), seq + k + 1, timeout_ms) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = k;
+	      return GASPI_TIMEOUT;
+	    }
+
+	  unsigned char * const recv = base + GPI2_SCAN_RECV + k * GPI2_REDUX_BUF_SIZE;
+	  unsigned char tmp[GPI2_REDUX_BUF_SIZE];
+
+	  /* The exclusive result starts with the first message */
+	  if( k == 0 )
+	    {
+	      memcpy(excl, recv, dsize);
+	    }
+	  else
+	    {
+	      if( (eret = _gaspi_redux_apply(r_args, tmp, recv, excl, r_args->elem_cnt, timeout_ms)) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = k;
+		  return eret;
+		}
+	      memcpy(excl, tmp, dsize);
+	    }
+
+	  if( (eret = _gaspi_redux_apply(r_args, tmp, recv, incl, r_args->elem_cnt, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      grp_ctx->coll_step = k;
+	      return eret;
+	    }
+	  memcpy(incl, tmp, dsize);
+	}
+
+      if( pgaspi_dev_poll_groups() < 0 )
+	{
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grp_ctx->coll_phase = 1;
+    }
+
+  grp_ctx->pair_msg += (uint32_t) nsteps;
+
+  if( !exclusive )
+    {
+      memcpy(buf_recv, incl, dsize);
+    }
+  else if( me > 0 )
+    {
+      memcpy(buf_recv, excl, dsize);
+    }
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_scan_run(const gaspi_pointer_t buf_send,
+		gaspi_pointer_t const buf_recv,
+		struct redux_args * const r_args,
+		const int exclusive,
+		const gaspi_group_t g,
+		const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( r_args->elem_cnt * r_args->elem_size > GPI2_REDUX_BUF_SIZE )
+    {
+      return GASPI_ERR_INV_SIZE;
+    }
+
+  if( (eret = _gaspi_coll_begin(grp_ctx, GASPI_SCAN, timeout_ms)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  eret = _gaspi_scan(&glb_gaspi_ctx, buf_send, buf_recv, r_args, exclusive, g, timeout_ms);
+
+  return _gaspi_coll_end(grp_ctx, eret);
+}
+
+#pragma weak gaspi_scan = pgaspi_scan
+gaspi_return_t
+pgaspi_scan (const gaspi_pointer_t buf_send,
+	     gaspi_pointer_t const buf_recv,
+	     const gaspi_number_t elem_cnt,
+	     const gaspi_operation_t op,
+	     const gaspi_datatype_t type,
+	     const gaspi_group_t g,
+	     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_scan");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  if( _gaspi_redux_op_args(&r_args, elem_cnt, op, type) != GASPI_SUCCESS )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  return _gaspi_scan_run(buf_send, buf_recv, &r_args, 0, g, timeout_ms);
+}
+
+#pragma weak gaspi_scan_user = pgaspi_scan_user
+gaspi_return_t
+pgaspi_scan_user (const gaspi_pointer_t buf_send,
+		  gaspi_pointer_t const buf_recv,
+		  const gaspi_number_t elem_cnt,
+		  const gaspi_size_t elem_size,
+		  gaspi_reduce_operation_t const user_fct,
+		  gaspi_state_t const rstate,
+		  const gaspi_group_t g,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_scan_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_null_ptr(user_fct);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  r_args.f_type = GASPI_USER;
+  r_args.elem_size = elem_size;
+  r_args.elem_cnt = elem_cnt;
+  r_args.f_args.user_fct = user_fct;
+  r_args.f_args.rstate = rstate;
+
+  return _gaspi_scan_run(buf_send, buf_recv, &r_args, 0, g, timeout_ms);
+}
+
+#pragma weak gaspi_exscan = pgaspi_exscan
+gaspi_return_t
+pgaspi_exscan (const gaspi_pointer_t buf_send,
+	       gaspi_pointer_t const buf_recv,
+	       const gaspi_number_t elem_cnt,
+	       const gaspi_operation_t op,
+	       const gaspi_datatype_t type,
+	       const gaspi_group_t g,
+	       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_exscan");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  if( _gaspi_redux_op_args(&r_args, elem_cnt, op, type) != GASPI_SUCCESS )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  return _gaspi_scan_run(buf_send, buf_recv, &r_args, 1, g, timeout_ms);
+}
+
+#pragma weak gaspi_exscan_user = pgaspi_exscan_user
+gaspi_return_t
+pgaspi_exscan_user (const gaspi_pointer_t buf_send,
+		    gaspi_pointer_t const buf_recv,
+		    const gaspi_number_t elem_cnt,
+		    const gaspi_size_t elem_size,
+		    gaspi_reduce_operation_t const user_fct,
+		    gaspi_state_t const rstate,
+		    const gaspi_group_t g,
+		    const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_exscan_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_null_ptr(user_fct);
+  gaspi_verify_group(g);
+
+  struct redux_args r_args;
+  r_args.f_type = GASPI_USER;
+  r_args.elem_size = elem_size;
+  r_args.elem_cnt = elem_cnt;
+  r_args.f_args.user_fct = user_fct;
+  r_args.f_args.rstate = rstate;
+
+  return _gaspi_scan_run(buf_send, buf_recv, &r_args, 1, g, timeout_ms);
+}
+
+/* Node-aware barrier and allreduce. The ranks of a node reduce to
+   their leader along a binomial tree, the leaders run a recursive
+   doubling among themselves and the result goes back down the
+   tree. Only the leaders communicate across nodes, log2(nodes)
+   messages instead of log2(ranks) per rank. Every message has its
+   own slot in the hierarchical area and is flagged with the sequence
+   number of the collective. A leader may already be one collective
+   ahead of its recursive doubling partner, so these slots alternate
+   between consecutive collectives. A barrier is an allreduce without
+   data. */
+#define GPI2_HIER_UP_SLOT(l)                 (l)
+#define GPI2_HIER_FOLD_SLOT(grp_ctx)         ((grp_ctx)->local_levels)
+#define GPI2_HIER_UNFOLD_SLOT(grp_ctx)       ((grp_ctx)->local_levels + 1)
+#define GPI2_HIER_PAIR_SLOT(grp_ctx, l, seq) ((grp_ctx)->local_levels + 2 + 2 * (l) + (seq) % 2)
+#define GPI2_HIER_DOWN_SLOT(grp_ctx, l)      ((grp_ctx)->local_levels + 2 + 2 * (grp_ctx)->leader_levels + (l))
+#define GPI2_HIER_PLAN_MAX         (72)
+#define GPI2_HIER_FLAG_SRC(base)   ((uint32_t *) ((base) + GPI2_HIER_FLAGS))
+#define GPI2_HIER_FLAG_OFF(slot)   (GPI2_HIER_FLAGS + 64 + (slot) * sizeof(uint32_t))
+#define GPI2_HIER_FLAG(base, slot) ((volatile uint32_t *) ((base) + GPI2_HIER_FLAG_OFF(slot)))
+
+typedef enum
+{
+  GPI2_HIER_SEND_TO,    /* send the partial result */
+  GPI2_HIER_RECV_FIRST, /* result = received op result */
+  GPI2_HIER_RECV_LAST,  /* result = result op received */
+  GPI2_HIER_RECV_COPY   /* result = received */
+} gaspi_hier_kind_t;
+
+typedef struct
+{
+  gaspi_hier_kind_t kind;
+  int peer; /* group rank to send to or receive from */
+  int slot;
+} gaspi_hier_action_t;
+
+static inline void
+_gaspi_hier_add(gaspi_hier_action_t * const plan,
+		int * const n,
+		const gaspi_hier_kind_t kind,
+		const int peer,
+		const int slot)
+{
+  plan[*n].kind = kind;
+  plan[*n].peer = peer;
+  plan[*n].slot = slot;
+  (*n)++;
+}
+
+/* The sequence of sends and receives of this rank */
+static int
+_gaspi_hier_plan(gaspi_group_ctx_t const * const grp_ctx,
+		 const uint32_t seq,
+		 gaspi_hier_action_t * const plan)
+{
+  int n = 0, mask, l;
+  const int * const local = grp_ctx->node_local;
+  const int nl = grp_ctx->nlocal;
+  const int li = grp_ctx->local_idx;
+
+  /* Up the node tree */
+  for(mask = 1, l = 0; mask < nl; mask <<= 1, l++)
+    {
+      if( li & mask )
+	{
+	  _gaspi_hier_add(plan, &n, GPI2_HIER_SEND_TO, local[li - mask], GPI2_HIER_UP_SLOT(l));
+	  break;
+	}
+
+      if( li + mask < nl )
+	{
+	  _gaspi_hier_add(plan, &n, GPI2_HIER_RECV_LAST, local[li + mask], GPI2_HIER_UP_SLOT(l));
+	}
+    }
+
+  /* Among the leaders, folding the ones beyond a power of two */
+  if( li == 0 )
+    {
+      const int * const leader = grp_ctx->node_leader;
+      const int nld = grp_ctx->nleaders;
+      const int me = grp_ctx->leader_idx;
+
+      int pof2 = 1;
+      while( 2 * pof2 <= nld )
+	{
+	  pof2 <<= 1;
+	}
+
+      const int rest = nld - pof2;
+      int vme = me - rest;
+
+      if( me < 2 * rest )
+	{
+	  if( me % 2 == 0 )
+	    {
+	      _gaspi_hier_add(plan, &n, GPI2_HIER_SEND_TO, leader[me + 1], GPI2_HIER_FOLD_SLOT(grp_ctx));
+	      vme = -1;
+	    }
+	  else
+	    {
+	      _gaspi_hier_add(plan, &n, GPI2_HIER_RECV_FIRST, leader[me - 1], GPI2_HIER_FOLD_SLOT(grp_ctx));
+	      vme = me / 2;
+	    }
+	}
+
+      if( vme >= 0 )
+	{
+	  for(mask = 1, l = 0; mask < pof2; mask <<= 1, l++)
+	    {
+	      const int vpeer = vme ^ mask;
+	      const int peer = (vpeer < rest) ? 2 * vpeer + 1 : vpeer + rest;
+
+	      _gaspi_hier_add(plan, &n, GPI2_HIER_SEND_TO, leader[peer], GPI2_HIER_PAIR_SLOT(grp_ctx, l, seq));
+	      _gaspi_hier_add(plan, &n, (vpeer < vme) ? GPI2_HIER_RECV_FIRST : GPI2_HIER_RECV_LAST,
+			      leader[peer], GPI2_HIER_PAIR_SLOT(grp_ctx, l, seq));
+	    }
+	}
+
+      if( me < 2 * rest )
+	{
+	  if( me % 2 )
+	    {
+	      _gaspi_hier_add(plan, &n, GPI2_HIER_SEND_TO, leader[me - 1], GPI2_HIER_UNFOLD_SLOT(grp_ctx));
+	    }
+	  else
+	    {
+	      _gaspi_hier_add(plan, &n, GPI2_HIER_RECV_COPY, leader[me + 1], GPI2_HIER_UNFOLD_SLOT(grp_ctx));
+	    }
+	}
+    }
+
+  /* Down the node tree, one slot per level */
+  int top = li & -li;
+  for(l = 0; (1 << l) < top; l++);
+
+  if( li == 0 )
+    {
+      for(top = 1, l = 0; top < nl; top <<= 1, l++);
+    }
+  else
+    {
+      _gaspi_hier_add(plan, &n, GPI2_HIER_RECV_COPY, local[li - top], GPI2_HIER_DOWN_SLOT(grp_ctx, l));
+    }
+
+  for(mask = top >> 1, l--; mask > 0; mask >>= 1, l--)
+    {
+      if( li + mask < nl )
+	{
+	  _gaspi_hier_add(plan, &n, GPI2_HIER_SEND_TO, local[li + mask], GPI2_HIER_DOWN_SLOT(grp_ctx, l));
+	}
+    }
+
+  return n;
+}
+
+static gaspi_return_t
+_gaspi_hier_allreduce(gaspi_context_t * const gctx,
+		      const gaspi_pointer_t buf_send,
+		      gaspi_pointer_t const buf_recv,
+		      struct redux_args * const r_args,
+		      const gaspi_group_t g,
+		      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  const unsigned int dsize = (r_args != NULL) ? r_args->elem_cnt * r_args->elem_size : 0;
+  const uint32_t seq = grp_ctx->hier_msg + 1;
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_HIER)) != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  const int slots = GPI2_HIER_SLOTS(grp_ctx);
+  unsigned char * const base = grp_ctx->area[GPI2_AREA_HIER][gctx->rank].data.buf;
+  unsigned char * const acc = base + GPI2_HIER_ACC(slots);
+
+  gaspi_hier_action_t plan[GPI2_HIER_PLAN_MAX];
+  const int nactions = _gaspi_hier_plan(grp_ctx, seq, plan);
+
+  if( grp_ctx->coll_step == 0 && grp_ctx->coll_phase == 0 )
+    {
+      if( dsize > 0 )
+	{
+	  memcpy(acc, buf_send, dsize);
+	}
+      *GPI2_HIER_FLAG_SRC(base) = seq;
+      grp_ctx->coll_phase = 1;
+    }
+
+  /* Each partial result is staged in its own buffer */
+  int a, nrecv = 0;
+  for(a = 0; a < grp_ctx->coll_step; a++)
+    {
+      nrecv += (plan[a].kind != GPI2_HIER_SEND_TO);
+    }
+
+  for(a = grp_ctx->coll_step; a < nactions; a++)
+    {
+      gaspi_hier_action_t const * const act = &plan[a];
+
+      if( act->kind == GPI2_HIER_SEND_TO )
+	{
+	  const gaspi_rank_t dst = grp_ctx->rank_grp[act->peer];
+
+	  if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_HIER, dst, timeout_ms)) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  if( dsize > 0 )
+	    {
+	      unsigned char * const stage = base + GPI2_HIER_SEND(slots) + nrecv * GPI2_REDUX_BUF_SIZE;
+	      memcpy(stage, acc, dsize);
+
+	      if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_HIER, stage, dsize, dst,
+					       GPI2_HIER_RECV(slots) + act->slot * GPI2_REDUX_BUF_SIZE)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+	    }
+
+	  if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_HIER, GPI2_HIER_FLAG_SRC(base), sizeof(uint32_t), dst,
+					   GPI2_HIER_FLAG_OFF(act->slot))) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  continue;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_HIER_FLAG(base, act->slot), seq, timeout_ms) != GASPI_SUCCESS )
+	{
+	  grp_ctx->coll_step = a;
+	  return GASPI_TIMEOUT;
+	}
+
+      if( dsize > 0 )
+	{
+	  unsigned char * const recv = base + GPI2_HIER_RECV(slots) + act->slot * GPI2_REDUX_BUF_SIZE;
+	  unsigned char tmp[GPI2_REDUX_BUF_SIZE];
+
+	  if( act->kind == GPI2_HIER_RECV_COPY )
+	    {
+	      memcpy(acc, recv, dsize);
+	    }
+	  else
+	    {
+	      const int first = (act->kind == GPI2_HIER_RECV_FIRST);
+
+	      if( (eret = _gaspi_redux_apply(r_args, tmp, first ? recv : acc, first ? acc : recv,
+					     r_args->elem_cnt, timeout_ms)) != GASPI_SUCCESS )
+		{
+		  grp_ctx->coll_step = a;
+		  return eret;
+		}
+	      memcpy(acc, tmp, dsize);
+	    }
+	}
+
+      nrecv++;
+    }
+
+  if( pgaspi_dev_poll_groups() < 0 )
+    {
+      return GASPI_ERR_DEVICE;
+    }
+
+  if( dsize > 0 )
+    {
+      memcpy(buf_recv, acc, dsize);
+    }
+
+  grp_ctx->hier_msg++;
+  grp_ctx->coll_step = 0;
+  grp_ctx->coll_phase = 0;
+  grp_ctx->coll_op = GASPI_NONE;
+
+  return GASPI_SUCCESS;
+}
+
+/* Non-blocking barrier and allreduce. A request follows the same plan
+   as the hierarchical collectives but in its own region of the
+   non-blocking area, selected by its sequence number, so that up to
+   GPI2_NB_REQS requests per group can be outstanding. A rank only
+   writes into a region of a peer once the peer flagged it ready for
+   that request, i.e. once the peer completed the previous request in
+   that region. Requests progress whenever one of them is started or
+   waited for. */
+#define GPI2_NB_READY_OFF(slots, slot)   (GPI2_HIER_FLAG_OFF(slots) + (slot) * sizeof(uint32_t))
+#define GPI2_NB_READY(base, slots, slot) ((volatile uint32_t *) ((base) + GPI2_NB_READY_OFF(slots, slot)))
+
+struct gaspi_coll_request_desc
+{
+  gaspi_group_t group;
+  uint32_t seq;
+  int step, nrecv, nactions;
+  int done;
+  gaspi_hier_action_t plan[GPI2_HIER_PLAN_MAX];
+  struct redux_args r_args; /* no elements for a barrier */
+  gaspi_pointer_t buf_recv;
+};
+
+static gaspi_return_t
+_gaspi_nb_progress(gaspi_context_t * const gctx,
+		   struct gaspi_coll_request_desc * const req,
+		   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  const gaspi_group_t g = req->group;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  struct redux_args * const r_args = &(req->r_args);
+
+  const unsigned int dsize = r_args->elem_cnt * r_args->elem_size;
+  const uint32_t seq = req->seq;
+  const int slots = GPI2_HIER_SLOTS(grp_ctx);
+  const unsigned long region = GPI2_NB_REGION(slots, seq);
+
+  unsigned char * const base = grp_ctx->area[GPI2_AREA_NB][gctx->rank].data.buf + region;
+  unsigned char * const acc = base + GPI2_HIER_ACC(slots);
+
+  for(; req->step < req->nactions; req->step++)
+    {
+      gaspi_hier_action_t const * const act = &(req->plan[req->step]);
+
+      if( act->kind == GPI2_HIER_SEND_TO )
+	{
+	  const gaspi_rank_t dst = grp_ctx->rank_grp[act->peer];
+
+	  if( _gaspi_seq_wait(gctx, GPI2_NB_READY(base, slots, act->slot), seq, timeout_ms) != GASPI_SUCCESS )
+	    {
+	      return GASPI_TIMEOUT;
+	    }
+
+	  if( dsize > 0 )
+	    {
+	      unsigned char * const stage = base + GPI2_HIER_SEND(slots) + req->nrecv * GPI2_REDUX_BUF_SIZE;
+	      memcpy(stage, acc, dsize);
+
+	      if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_NB, stage, dsize, dst,
+					       region + GPI2_HIER_RECV(slots) + act->slot * GPI2_REDUX_BUF_SIZE)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+	    }
+
+	  if( (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_NB, GPI2_HIER_FLAG_SRC(base), sizeof(uint32_t), dst,
+					   region + GPI2_HIER_FLAG_OFF(act->slot))) != GASPI_SUCCESS )
+	    {
+	      return eret;
+	    }
+
+	  continue;
+	}
+
+      if( _gaspi_seq_wait(gctx, GPI2_HIER_FLAG(base, act->slot), seq, timeout_ms) != GASPI_SUCCESS )
+	{
+	  return GASPI_TIMEOUT;
+	}
+
+      if( dsize > 0 )
+	{
+	  unsigned char * const recv = base + GPI2_HIER_RECV(slots) + act->slot * GPI2_REDUX_BUF_SIZE;
+	  unsigned char tmp[GPI2_REDUX_BUF_SIZE];
+
+	  if( act->kind == GPI2_HIER_RECV_COPY )
+	    {
+	      memcpy(acc, recv, dsize);
+	    }
+	  else
+	    {
+	      const int first = (act->kind == GPI2_HIER_RECV_FIRST);
+
+	      if( (eret = _gaspi_redux_apply(r_args, tmp, first ? recv : acc, first ? acc : recv,
+					     r_args->elem_cnt, timeout_ms)) != GASPI_SUCCESS )
+		{
+		  return eret;
+		}
+	      memcpy(acc, tmp, dsize);
+	    }
+	}
+
+      req->nrecv++;
+    }
+
+  if( pgaspi_dev_poll_groups() < 0 )
+    {
+      return GASPI_ERR_DEVICE;
+    }
+
+  if( dsize > 0 )
+    {
+      memcpy(req->buf_recv, acc, dsize);
+    }
+
+  req->done = 1;
+  grp_ctx->nb_req[seq % GPI2_NB_REQS] = NULL;
+
+  return GASPI_SUCCESS;
+}
+
+/* Give every outstanding request of the group a chance to progress,
+   oldest first */
+static gaspi_return_t
+_gaspi_nb_progress_all(gaspi_context_t * const gctx,
+		       const gaspi_group_t g)
+{
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+  int i;
+
+  for(i = GPI2_NB_REQS - 1; i >= 0; i--)
+    {
+      struct gaspi_coll_request_desc * const req = grp_ctx->nb_req[(grp_ctx->nb_msg - i) % GPI2_NB_REQS];
+
+      if( req != NULL )
+	{
+	  const gaspi_return_t eret = _gaspi_nb_progress(gctx, req, GASPI_TEST);
+	  if( eret != GASPI_SUCCESS && eret != GASPI_TIMEOUT )
+	    {
+	      return eret;
+	    }
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_nb_complete(gaspi_context_t * const gctx,
+		   struct gaspi_coll_request_desc * const req,
+		   const gaspi_timeout_t timeout_ms)
+{
+  const gaspi_cycles_t s0 = gaspi_get_cycles();
+
+  while( !req->done )
+    {
+      const gaspi_return_t eret = _gaspi_nb_progress_all(gctx, req->group);
+      if( eret != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+
+      const gaspi_cycles_t s1 = gaspi_get_cycles();
+      const float ms = (float) (s1 - s0) * gctx->cycles_to_msecs;
+
+      if( !req->done && ms > timeout_ms )
+	{
+	  return GASPI_TIMEOUT;
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_nb_start(gaspi_context_t * const gctx,
+		const gaspi_pointer_t buf_send,
+		gaspi_pointer_t const buf_recv,
+		struct redux_args const * const r_args,
+		const gaspi_group_t g,
+		gaspi_coll_request_t * const request,
+		const gaspi_timeout_t timeout_ms)
+{
+  gaspi_return_t eret = GASPI_ERROR;
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[g]);
+
+  if( lock_gaspi_tout (&grp_ctx->gl, timeout_ms) )
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  if( (eret = _gaspi_grp_area(gctx, g, GPI2_AREA_NB)) != GASPI_SUCCESS )
+    {
+      goto endL;
+    }
+
+  const uint32_t seq = grp_ctx->nb_msg + 1;
+
+  /* The region is still in use by an older request */
+  struct gaspi_coll_request_desc * const busy = grp_ctx->nb_req[seq % GPI2_NB_REQS];
+  if( busy != NULL && (eret = _gaspi_nb_complete(gctx, busy, timeout_ms)) != GASPI_SUCCESS )
+    {
+      goto endL;
+    }
+
+  struct gaspi_coll_request_desc * const req = calloc(1, sizeof(struct gaspi_coll_request_desc));
+  if( req == NULL )
+    {
+      eret = GASPI_ERR_MEMALLOC;
+      goto endL;
+    }
+
+  req->group = g;
+  req->seq = seq;
+  req->nactions = _gaspi_hier_plan(grp_ctx, seq, req->plan);
+  req->buf_recv = buf_recv;
+  if( r_args != NULL )
+    {
+      req->r_args = *r_args;
+    }
+
+  const int slots = GPI2_HIER_SLOTS(grp_ctx);
+  const unsigned long region = GPI2_NB_REGION(slots, seq);
+  unsigned char * const base = grp_ctx->area[GPI2_AREA_NB][gctx->rank].data.buf + region;
+
+  if( r_args != NULL )
+    {
+      memcpy(base + GPI2_HIER_ACC(slots), buf_send, r_args->elem_cnt * r_args->elem_size);
+    }
+  *GPI2_HIER_FLAG_SRC(base) = seq;
+
+  /* Our region is free: tell the peers we receive from */
+  int a;
+  for(a = 0; a < req->nactions; a++)
+    {
+      gaspi_hier_action_t const * const act = &(req->plan[a]);
+
+      if( act->kind == GPI2_HIER_SEND_TO )
+	{
+	  continue;
+	}
+
+      const gaspi_rank_t src = grp_ctx->rank_grp[act->peer];
+
+      if( (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_NB, src, timeout_ms)) != GASPI_SUCCESS
+	  || (eret = _gaspi_grp_area_post(gctx, g, GPI2_AREA_NB, GPI2_HIER_FLAG_SRC(base), sizeof(uint32_t), src,
+					  region + GPI2_NB_READY_OFF(slots, act->slot))) != GASPI_SUCCESS )
+	{
+	  free(req);
+	  goto endL;
+	}
+    }
+
+  for(a = 0; a < req->nactions; a++)
+    {
+      gaspi_hier_action_t const * const act = &(req->plan[a]);
+
+      if( act->kind == GPI2_HIER_SEND_TO
+	  && (eret = _gaspi_grp_area_connect_to(gctx, g, GPI2_AREA_NB, grp_ctx->rank_grp[act->peer], timeout_ms)) != GASPI_SUCCESS )
+	{
+	  free(req);
+	  goto endL;
+	}
+    }
+
+  grp_ctx->nb_req[seq % GPI2_NB_REQS] = req;
+  grp_ctx->nb_msg++;
+  *request = req;
+
+  eret = _gaspi_nb_progress(gctx, req, GASPI_TEST);
+  if( eret == GASPI_TIMEOUT )
+    {
+      eret = GASPI_SUCCESS;
+    }
+
+ endL:
+  unlock_gaspi (&grp_ctx->gl);
+  return eret;
+}
+
+#pragma weak gaspi_ibarrier = pgaspi_ibarrier
+gaspi_return_t
+pgaspi_ibarrier (const gaspi_group_t g,
+		 gaspi_coll_request_t * const request,
+		 const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_ibarrier");
+  gaspi_verify_group(g);
+  gaspi_verify_null_ptr(request);
+
+  return _gaspi_nb_start(&glb_gaspi_ctx, NULL, NULL, NULL, g, request, timeout_ms);
+}
+
+#pragma weak gaspi_iallreduce = pgaspi_iallreduce
+gaspi_return_t
+pgaspi_iallreduce (const gaspi_pointer_t buf_send,
+		   gaspi_pointer_t const buf_recv,
+		   const gaspi_number_t elem_cnt,
+		   const gaspi_operation_t op,
+		   const gaspi_datatype_t type,
+		   const gaspi_group_t g,
+		   gaspi_coll_request_t * const request,
+		   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_iallreduce");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+  gaspi_verify_null_ptr(request);
+
+  if( elem_cnt > GPI2_ALLREDUCE_ELEM_MAX )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  struct redux_args r_args;
+  if( _gaspi_redux_op_args(&r_args, elem_cnt, op, type) != GASPI_SUCCESS )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  if( elem_cnt * r_args.elem_size > GPI2_REDUX_BUF_SIZE )
+    {
+      return GASPI_ERR_INV_SIZE;
+    }
+
+  return _gaspi_nb_start(&glb_gaspi_ctx, buf_send, buf_recv, &r_args, g, request, timeout_ms);
+}
+
+#pragma weak gaspi_iallreduce_user = pgaspi_iallreduce_user
+gaspi_return_t
+pgaspi_iallreduce_user (const gaspi_pointer_t buf_send,
+			gaspi_pointer_t const buf_recv,
+			const gaspi_number_t elem_cnt,
+			const gaspi_size_t elem_size,
+			gaspi_reduce_operation_t const user_fct,
+			gaspi_state_t const rstate,
+			const gaspi_group_t g,
+			gaspi_coll_request_t * const request,
+			const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_iallreduce_user");
+  gaspi_verify_null_ptr(buf_send);
+  gaspi_verify_null_ptr(buf_recv);
+  gaspi_verify_group(g);
+  gaspi_verify_null_ptr(request);
+
+  if( elem_cnt > GPI2_ALLREDUCE_ELEM_MAX )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  if( elem_size * elem_cnt > GPI2_REDUX_BUF_SIZE )
+    {
+      return GASPI_ERR_INV_SIZE;
+    }
+
+  struct redux_args r_args;
+  r_args.f_type = GASPI_USER;
+  r_args.elem_size = elem_size;
+  r_args.elem_cnt = elem_cnt;
+  r_args.f_args.user_fct = user_fct;
+  r_args.f_args.rstate = rstate;
+
+  return _gaspi_nb_start(&glb_gaspi_ctx, buf_send, buf_recv, &r_args, g, request, timeout_ms);
+}
+
+#pragma weak gaspi_coll_wait = pgaspi_coll_wait
+gaspi_return_t
+pgaspi_coll_wait (gaspi_coll_request_t request,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_coll_wait");
+  gaspi_verify_null_ptr(request);
+
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[request->group]);
+
+  if( lock_gaspi_tout (&grp_ctx->gl, timeout_ms) )
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  const gaspi_return_t eret = _gaspi_nb_complete(&glb_gaspi_ctx, request, timeout_ms);
+
+  unlock_gaspi (&grp_ctx->gl);
+
+  if( eret == GASPI_SUCCESS )
+    {
+      free(request);
+    }
+
+  return eret;
+}
@@ -23,11 +23,84 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 
 #define GPI2_REDUX_BUF_SIZE 2048
 
+/* Flags of the large collectives (ring, then tree), the data goes
+   through areas of their own, see below */
+#define GPI2_RING_FLAGS      (NEXT_OFFSET)
+#define GPI2_TREE_FLAGS      (GPI2_RING_FLAGS + 64)
+
+/* Scan area: a receive and a send buffer per step, followed by the
+   inclusive and exclusive partial results */
+#define GPI2_SCAN_STEPS_MAX  (16)
+#define GPI2_SCAN_RECV       (GPI2_TREE_FLAGS + 256)
+#define GPI2_SCAN_SEND       (GPI2_SCAN_RECV + GPI2_SCAN_STEPS_MAX * GPI2_REDUX_BUF_SIZE)
+#define GPI2_SCAN_STATE      (GPI2_SCAN_SEND + GPI2_SCAN_STEPS_MAX * GPI2_REDUX_BUF_SIZE)
+
+/* Pairwise (allgather, alltoall, scan) area: flag sources, followed
+   by a ready and a data flag per rank */
+#define GPI2_PAIR_FLAGS      (GPI2_SCAN_STATE + 2 * GPI2_REDUX_BUF_SIZE)
+#define GPI2_GRP_MEM_SIZE(nranks) (GPI2_PAIR_FLAGS + 64 + 2 * sizeof(uint32_t) * (nranks))
+
+/* Areas of the group memory that are only allocated and registered
+   once a collective needs them, by this rank or by a peer about to
+   write into them */
+enum gaspi_grp_area
+  {
+    GPI2_AREA_RING = 0,
+    GPI2_AREA_TREE,
+    GPI2_AREA_HIER,
+    GPI2_AREA_NB,
+    GPI2_GRP_AREAS
+  };
+
+/* Ring area: two send and two receive chunks */
+#define GPI2_COLL_CHUNK_SIZE (131072)
+#define GPI2_RING_SEND       (0)
+#define GPI2_RING_RECV       (GPI2_RING_SEND + 2 * GPI2_COLL_CHUNK_SIZE)
+#define GPI2_RING_AREA_SIZE  (GPI2_RING_RECV + 2 * GPI2_COLL_CHUNK_SIZE)
+
+/* Tree (broadcast) area: two receive chunks and two entry chunks
+   (root to tree root), the latter also stage the chunks of the root */
+#define GPI2_TREE_RECV       (0)
+#define GPI2_TREE_ENTRY      (GPI2_TREE_RECV + 2 * GPI2_COLL_CHUNK_SIZE)
+#define GPI2_TREE_AREA_SIZE  (GPI2_TREE_ENTRY + 2 * GPI2_COLL_CHUNK_SIZE)
+
+/* Hierarchical (node-aware) area, sized by the slots of the group:
+   flag source, a flag and a ready flag per slot, followed by a
+   receive and a staging buffer per slot and the partial result */
+#define GPI2_HIER_FLAGS         (0)
+#define GPI2_HIER_RECV(slots)   ((64 + 2 * sizeof(uint32_t) * (slots) + 63) & ~63UL)
+#define GPI2_HIER_SEND(slots)   (GPI2_HIER_RECV(slots) + (slots) * GPI2_REDUX_BUF_SIZE)
+#define GPI2_HIER_ACC(slots)    (GPI2_HIER_SEND(slots) + (slots) * GPI2_REDUX_BUF_SIZE)
+#define GPI2_HIER_AREA_SIZE(slots) (GPI2_HIER_ACC(slots) + GPI2_REDUX_BUF_SIZE)
+
+/* Slots of a group: one up and one down per level of the node
+   trees, fold and unfold, and two per level among the leaders */
+#define GPI2_HIER_SLOTS(grp_ctx) (2 * (grp_ctx)->local_levels + 2 + 2 * (grp_ctx)->leader_levels)
+
+/* Non-blocking collectives area: one region per outstanding request,
+   laid out as the hierarchical area */
+#define GPI2_NB_REQS         (4)
+#define GPI2_NB_REGION(slots, seq) (((seq) % GPI2_NB_REQS) * GPI2_HIER_AREA_SIZE(slots))
+#define GPI2_NB_AREA_SIZE(slots)   (GPI2_NB_REQS * GPI2_HIER_AREA_SIZE(slots))
+
+/* Argument of the GASPI_SN_GRP_AREA command */
+struct gaspi_grp_area_req
+{
+  gaspi_group_t group;
+  int area;
+  size_t size;
+};
+
 typedef enum {
   GASPI_BARRIER = 1,
   GASPI_ALLREDUCE = 2,
   GASPI_ALLREDUCE_USER = 4,
-  GASPI_NONE = 7
+  GASPI_BCAST = 8,
+  GASPI_ALLGATHER = 16,
+  GASPI_ALLTOALL = 32,
+  GASPI_REDUCE_SCATTER = 64,
+  GASPI_SCAN = 128,
+  GASPI_NONE = 255
 } gaspi_async_coll_t;
 
 typedef struct
@@ -43,9 +116,25 @@ typedef struct
   int rank, tnc;
   int next_pof2;
   int pof2_exp;
+  unsigned int ring_msg; /* ring messages of completed collectives */
+  unsigned int ring_slot[2]; /* last message sent through each ring slot */
+  unsigned int tree_msg; /* tree messages of completed collectives */
+  unsigned int pair_msg; /* pairwise steps of completed collectives */
+  int coll_step, coll_phase; /* progress of pipelined collectives */
+  int hier; /* node-aware barrier and allreduce */
+  int *node_local; /* group ranks on this node, leader first */
+  int nlocal, local_idx;
+  int *node_leader; /* group rank of the leader of each node */
+  int nleaders, leader_idx;
+  int local_levels, leader_levels; /* of the node trees and among the leaders */
+  unsigned int hier_msg; /* hierarchical collectives completed */
+  unsigned int nb_msg; /* non-blocking collectives started */
+  unsigned int sn_msg; /* SN allgathers started */
+  struct gaspi_coll_request_desc *nb_req[GPI2_NB_REQS]; /* outstanding, by region */
   int *rank_grp;
   int *committed_rank;
   gaspi_rc_mseg_t *rrcd;
+  gaspi_rc_mseg_t *area[GPI2_GRP_AREAS]; /* by rank, NULL until first use */
 } gaspi_group_ctx_t;
 
 #define GASPI_RESET_GROUP(group_ctx, i)					\
@@ -66,6 +155,27 @@ typedef struct
     group_ctx[i].dsize = 0;						\
     group_ctx[i].next_pof2 = 0;						\
     group_ctx[i].pof2_exp = 0;						\
+    group_ctx[i].ring_msg = 0;						\
+    group_ctx[i].ring_slot[0] = 0;					\
+    group_ctx[i].ring_slot[1] = 0;					\
+    group_ctx[i].tree_msg = 0;						\
+    group_ctx[i].pair_msg = 0;						\
+    group_ctx[i].coll_step = 0;						\
+    group_ctx[i].coll_phase = 0;					\
+    group_ctx[i].hier = 0;						\
+    group_ctx[i].node_local = NULL;					\
+    group_ctx[i].nlocal = 0;						\
+    group_ctx[i].local_idx = 0;						\
+    group_ctx[i].node_leader = NULL;					\
+    group_ctx[i].nleaders = 0;						\
+    group_ctx[i].leader_idx = -1;					\
+    group_ctx[i].local_levels = 0;					\
+    group_ctx[i].leader_levels = 0;					\
+    group_ctx[i].hier_msg = 0;						\
+    group_ctx[i].nb_msg = 0;						\
+    group_ctx[i].sn_msg = 0;						\
+    memset(group_ctx[i].nb_req, 0, sizeof(group_ctx[i].nb_req));	\
+    memset(group_ctx[i].area, 0, sizeof(group_ctx[i].area));		\
   }  while(0);
 
 gaspi_return_t
@@ -75,4 +185,10 @@ pgaspi_group_all_local_create(gaspi_context_t const * const gctx,
 gaspi_return_t
 pgaspi_group_all_delete(gaspi_context_t * const gctx);
 
+gaspi_return_t
+pgaspi_group_area_desc(const gaspi_group_t group,
+		       const int area,
+		       const size_t size,
+		       gaspi_rc_mseg_t * const desc);
+
 #endif /* GPI2_GRP_H_ */
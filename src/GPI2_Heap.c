@@ -0,0 +1,635 @@
+/*
+Copyright (c) Fraunhofer ITWM - Carsten Lojewski <lojewski@itwm.fhg.de>, 2013-2016
+
+This file is part of GPI-2.
+
+GPI-2 is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License
+version 3 as published by the Free Software Foundation.
+
+GPI-2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PGASPI.h"
+#include "GPI2.h"
+#include "GPI2_Heap.h"
+#include "GPI2_Utility.h"
+
+/* Arena: pool allocator over the offsets of a segment.
+
+   The arena is divided into pages. A page either holds blocks of one
+   size class below the page size or is the first page of a block of
+   one or more pages. Freed blocks are kept per size class and reused
+   last-in first-out; pages are never given back. Every operation is
+   O(1) (amortized, for growing a free list) and the result only
+   depends on the sequence of operations, not on timing. */
+
+static inline unsigned int
+_gaspi_arena_class(const gaspi_size_t size)
+{
+  if( size <= (1UL << GPI2_HEAP_MIN_SHIFT) )
+    {
+      return GPI2_HEAP_MIN_SHIFT;
+    }
+
+  return (unsigned int) (8 * sizeof(unsigned long) - __builtin_clzl(size - 1));
+}
+
+static int
+_gaspi_arena_init(struct gaspi_arena * const arena, const gaspi_size_t size)
+{
+  memset(arena, 0, sizeof(*arena));
+
+  /* Small segments use smaller pages */
+  arena->page_shift = GPI2_HEAP_PAGE_SHIFT;
+  while( arena->page_shift > GPI2_HEAP_MIN_SHIFT && (1UL << arena->page_shift) > size )
+    {
+      arena->page_shift--;
+    }
+
+  arena->size = size & ~((1UL << arena->page_shift) - 1);
+
+  const size_t npages = (arena->size >> arena->page_shift);
+  arena->page_class = calloc(npages + 1, sizeof(unsigned char));
+
+  return (arena->page_class == NULL) ? -1 : 0;
+}
+
+/* The pages added by a grown segment (the page size stays) */
+static int
+_gaspi_arena_grow(struct gaspi_arena * const arena, const gaspi_size_t size)
+{
+  const gaspi_size_t nsize = size & ~((1UL << arena->page_shift) - 1);
+  if( nsize <= arena->size )
+    {
+      return 0;
+    }
+
+  const size_t npages = (arena->size >> arena->page_shift);
+  const size_t nnpages = (nsize >> arena->page_shift);
+
+  unsigned char * const page_class = realloc(arena->page_class, nnpages + 1);
+  if( page_class == NULL )
+    {
+      return -1;
+    }
+
+  memset(page_class + npages + 1, 0, nnpages - npages);
+  arena->page_class = page_class;
+  arena->size = nsize;
+
+  return 0;
+}
+
+static void
+_gaspi_arena_fini(struct gaspi_arena * const arena)
+{
+  int c;
+
+  for(c = 0; c < GPI2_HEAP_CLASSES; c++)
+    {
+      free(arena->free[c].off);
+    }
+
+  free(arena->page_class);
+  memset(arena, 0, sizeof(*arena));
+}
+
+static gaspi_return_t
+_gaspi_arena_alloc(struct gaspi_arena * const arena,
+		   const gaspi_size_t size,
+		   gaspi_offset_t * const offset)
+{
+  if( size > arena->size )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  const unsigned int c = _gaspi_arena_class(size);
+  const gaspi_size_t bsize = 1UL << c;
+  const gaspi_size_t page = 1UL << arena->page_shift;
+
+  struct gaspi_arena_free * const f = &(arena->free[c]);
+  if( f->num > 0 )
+    {
+      *offset = f->off[--f->num];
+      return GASPI_SUCCESS;
+    }
+
+  if( c < arena->page_shift )
+    {
+      /* Next block of the current page of the class, if any is left */
+      if( (arena->carve[c] & (page - 1)) == 0 )
+	{
+	  if( arena->top + page > arena->size )
+	    {
+	      return GASPI_ERR_MEMALLOC;
+	    }
+
+	  arena->page_class[arena->top >> arena->page_shift] = (unsigned char) c;
+	  arena->carve[c] = arena->top;
+	  arena->top += page;
+	}
+
+      *offset = arena->carve[c];
+      arena->carve[c] += bsize;
+
+      return GASPI_SUCCESS;
+    }
+
+  if( arena->top + bsize > arena->size )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  arena->page_class[arena->top >> arena->page_shift] = (unsigned char) c;
+  *offset = arena->top;
+  arena->top += bsize;
+
+  return GASPI_SUCCESS;
+}
+
+static gaspi_return_t
+_gaspi_arena_free(struct gaspi_arena * const arena, const gaspi_offset_t offset)
+{
+  if( offset >= arena->top )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  const unsigned int c = arena->page_class[offset >> arena->page_shift];
+
+  /* Only the start of a block (continuation pages have no class) */
+  if( c == 0 || (offset & ((1UL << MIN(c, arena->page_shift)) - 1)) != 0 )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  struct gaspi_arena_free * const f = &(arena->free[c]);
+  if( f->num == f->max )
+    {
+      const size_t max = (f->max == 0) ? 16 : 2 * f->max;
+      gaspi_offset_t * const off = realloc(f->off, max * sizeof(gaspi_offset_t));
+      if( off == NULL )
+	{
+	  return GASPI_ERR_MEMALLOC;
+	}
+
+      f->off = off;
+      f->max = max;
+    }
+
+  f->off[f->num++] = offset;
+
+  return GASPI_SUCCESS;
+}
+
+/* Symmetric heap: an arena per segment. Ranks that create the segment
+   with the same size and allocate in the same order get the same
+   offsets, without any communication. */
+static struct gaspi_sym_heap *
+_gaspi_sym_heap(gaspi_context_t * const gctx, const gaspi_segment_id_t segment_id)
+{
+  gaspi_rc_mseg_t * const seg = &(gctx->rrmd[segment_id]->local);
+
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  /* A segment is either a symmetric heap or sub-allocated */
+  if( seg->sym_heap == NULL && seg->pool == NULL )
+    {
+      struct gaspi_sym_heap * const heap = calloc(1, sizeof(struct gaspi_sym_heap));
+      if( heap != NULL )
+	{
+	  if( _gaspi_arena_init(&(heap->arena), seg->size) != 0 )
+	    {
+	      free(heap);
+	    }
+	  else
+	    {
+	      seg->sym_heap = heap;
+	    }
+	}
+    }
+
+  unlock_gaspi(&gaspi_mseg_lock);
+
+  return seg->sym_heap;
+}
+
+void
+gaspi_sym_heap_destroy(struct gaspi_sym_heap *heap)
+{
+  if( heap != NULL )
+    {
+      _gaspi_arena_fini(&(heap->arena));
+      free(heap);
+    }
+}
+
+int
+gaspi_sym_heap_grow(struct gaspi_sym_heap *heap, const gaspi_size_t size)
+{
+  int ret = 0;
+
+  if( heap != NULL )
+    {
+      lock_gaspi_tout(&(heap->lock), GASPI_BLOCK);
+      ret = _gaspi_arena_grow(&(heap->arena), size);
+      unlock_gaspi(&(heap->lock));
+    }
+
+  return ret;
+}
+
+#ifdef DEBUG
+/* All ranks of the group must end up with the same offset */
+static gaspi_return_t
+_gaspi_sym_verify(const gaspi_group_t group, const gaspi_offset_t offset,
+		  const char * const fname)
+{
+  unsigned long val[2] = { offset, ~offset };
+  unsigned long res[2];
+
+  if( pgaspi_allreduce(val, res, 2, GASPI_OP_MAX, GASPI_TYPE_ULONG, group, GASPI_BLOCK)
+      != GASPI_SUCCESS )
+    {
+      return GASPI_ERROR;
+    }
+
+  if( res[0] != offset || res[1] != ~offset )
+    {
+      gaspi_print_error("Ranks of group %u called %s in different order (offset %lu)",
+			group, fname, offset);
+      return GASPI_ERROR;
+    }
+
+  return GASPI_SUCCESS;
+}
+#endif
+
+#pragma weak gaspi_sym_malloc = pgaspi_sym_malloc
+gaspi_return_t
+pgaspi_sym_malloc (const gaspi_segment_id_t segment_id,
+		   const gaspi_group_t group,
+		   const gaspi_size_t size,
+		   gaspi_offset_t * const offset)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_sym_malloc");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_segment_desc(segment_id);
+  gaspi_verify_segment_size(gctx->rrmd[segment_id]->local.size);
+  gaspi_verify_group(group);
+  gaspi_verify_null_ptr(offset);
+
+  struct gaspi_sym_heap * const heap = _gaspi_sym_heap(gctx, segment_id);
+  if( heap == NULL )
+    {
+      return (gctx->rrmd[segment_id]->local.pool != NULL) ? GASPI_ERR_INV_SEG : GASPI_ERR_MEMALLOC;
+    }
+
+  lock_gaspi_tout(&(heap->lock), GASPI_BLOCK);
+  gaspi_return_t eret = _gaspi_arena_alloc(&(heap->arena), size, offset);
+  unlock_gaspi(&(heap->lock));
+
+#ifdef DEBUG
+  if( _gaspi_sym_verify(group, (eret == GASPI_SUCCESS) ? *offset : ~0UL, "gaspi_sym_malloc")
+      != GASPI_SUCCESS )
+    {
+      return GASPI_ERROR;
+    }
+#endif
+
+  return eret;
+}
+
+#pragma weak gaspi_sym_free = pgaspi_sym_free
+gaspi_return_t
+pgaspi_sym_free (const gaspi_segment_id_t segment_id,
+		 const gaspi_group_t group,
+		 const gaspi_offset_t offset)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_sym_free");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_segment_desc(segment_id);
+  gaspi_verify_group(group);
+
+  struct gaspi_sym_heap * const heap = gctx->rrmd[segment_id]->local.sym_heap;
+  if( heap == NULL )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+#ifdef DEBUG
+  if( _gaspi_sym_verify(group, offset, "gaspi_sym_free") != GASPI_SUCCESS )
+    {
+      return GASPI_ERROR;
+    }
+#endif
+
+  lock_gaspi_tout(&(heap->lock), GASPI_BLOCK);
+  const gaspi_return_t eret = _gaspi_arena_free(&(heap->arena), offset);
+  unlock_gaspi(&(heap->lock));
+
+  return eret;
+}
+
+/* Sub-allocator: an arena per segment shared by the threads of the
+   rank. Blocks below the page size go through a small cache per
+   thread and segment, so that most allocations and frees do not take
+   the lock of the pool. A cache belongs to one instance of the pool
+   (its id); caches of a deleted segment are dropped. */
+struct gaspi_pool_cache
+{
+  unsigned long pool_id;
+  unsigned int num[GPI2_POOL_CACHE_CLASSES];
+  gaspi_offset_t off[GPI2_POOL_CACHE_CLASSES][GPI2_POOL_CACHE_SIZE];
+};
+
+static __thread struct gaspi_pool_cache *gaspi_pool_caches[GASPI_MAX_MSEGS_LIMIT];
+
+static unsigned long gaspi_pool_ids = 0;
+static pthread_key_t gaspi_pool_key;
+static pthread_once_t gaspi_pool_key_once = PTHREAD_ONCE_INIT;
+
+/* At thread exit, the cached blocks go back to their pools */
+static void
+_gaspi_pool_thread_exit(void *arg)
+{
+  struct gaspi_pool_cache ** const caches = (struct gaspi_pool_cache **) arg;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  int s;
+  unsigned int c, k;
+
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  for(s = 0; s < GASPI_MAX_MSEGS_LIMIT; s++)
+    {
+      struct gaspi_pool_cache * const cache = caches[s];
+      if( cache == NULL )
+	{
+	  continue;
+	}
+
+      struct gaspi_seg_pool * const pool =
+	(s < (int) gctx->rrmd_size && gctx->rrmd[s] != NULL)
+	? gctx->rrmd[s]->local.pool : NULL;
+
+      if( pool != NULL && pool->id == cache->pool_id )
+	{
+	  lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+	  for(c = 0; c < GPI2_POOL_CACHE_CLASSES; c++)
+	    {
+	      for(k = 0; k < cache->num[c]; k++)
+		{
+		  _gaspi_arena_free(&(pool->arena), cache->off[c][k]);
+		}
+	    }
+	  unlock_gaspi(&(pool->lock));
+	}
+
+      free(cache);
+      caches[s] = NULL;
+    }
+
+  unlock_gaspi(&gaspi_mseg_lock);
+}
+
+static void
+_gaspi_pool_key_create(void)
+{
+  pthread_key_create(&gaspi_pool_key, _gaspi_pool_thread_exit);
+}
+
+static struct gaspi_pool_cache *
+_gaspi_pool_cache(struct gaspi_seg_pool * const pool)
+{
+  struct gaspi_pool_cache *cache = gaspi_pool_caches[pool->segment_id];
+
+  if( cache == NULL )
+    {
+      cache = malloc(sizeof(struct gaspi_pool_cache));
+      if( cache == NULL )
+	{
+	  return NULL;
+	}
+
+      pthread_once(&gaspi_pool_key_once, _gaspi_pool_key_create);
+      pthread_setspecific(gaspi_pool_key, gaspi_pool_caches);
+
+      cache->pool_id = 0;
+      gaspi_pool_caches[pool->segment_id] = cache;
+    }
+
+  /* A new instance of the segment */
+  if( cache->pool_id != pool->id )
+    {
+      memset(cache->num, 0, sizeof(cache->num));
+      cache->pool_id = pool->id;
+    }
+
+  return cache;
+}
+
+static struct gaspi_seg_pool *
+_gaspi_seg_pool(gaspi_context_t * const gctx, const gaspi_segment_id_t segment_id)
+{
+  gaspi_rc_mseg_t * const seg = &(gctx->rrmd[segment_id]->local);
+
+  if( seg->pool != NULL )
+    {
+      return seg->pool;
+    }
+
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  if( seg->pool == NULL && seg->sym_heap == NULL )
+    {
+      struct gaspi_seg_pool * const pool = calloc(1, sizeof(struct gaspi_seg_pool));
+      if( pool != NULL )
+	{
+	  if( _gaspi_arena_init(&(pool->arena), seg->size) != 0 )
+	    {
+	      free(pool);
+	    }
+	  else
+	    {
+	      pool->id = __sync_add_and_fetch(&gaspi_pool_ids, 1);
+	      pool->segment_id = segment_id;
+	      __sync_synchronize();
+	      seg->pool = pool;
+	    }
+	}
+    }
+
+  unlock_gaspi(&gaspi_mseg_lock);
+
+  return seg->pool;
+}
+
+void
+gaspi_seg_pool_destroy(struct gaspi_seg_pool *pool)
+{
+  if( pool != NULL )
+    {
+      _gaspi_arena_fini(&(pool->arena));
+      free(pool);
+    }
+}
+
+int
+gaspi_seg_pool_grow(struct gaspi_seg_pool *pool, const gaspi_size_t size)
+{
+  int ret = 0;
+
+  if( pool != NULL )
+    {
+      lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+      ret = _gaspi_arena_grow(&(pool->arena), size);
+      unlock_gaspi(&(pool->lock));
+    }
+
+  return ret;
+}
+
+#pragma weak gaspi_segment_malloc = pgaspi_segment_malloc
+gaspi_return_t
+pgaspi_segment_malloc (const gaspi_segment_id_t segment_id,
+		       const gaspi_size_t size,
+		       const gaspi_size_t alignment,
+		       gaspi_offset_t * const offset)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_segment_malloc");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_segment_desc(segment_id);
+  gaspi_verify_segment_size(gctx->rrmd[segment_id]->local.size);
+  gaspi_verify_null_ptr(offset);
+
+  /* Blocks are aligned to their size, up to the page size */
+  if( (alignment & (alignment - 1)) != 0 || alignment > GPI2_HEAP_PAGE_SIZE )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  struct gaspi_seg_pool * const pool = _gaspi_seg_pool(gctx, segment_id);
+  if( pool == NULL )
+    {
+      return (gctx->rrmd[segment_id]->local.sym_heap != NULL) ? GASPI_ERR_INV_SEG : GASPI_ERR_MEMALLOC;
+    }
+
+  const gaspi_size_t bsize = MAX(size, alignment);
+  if( bsize > pool->arena.size || alignment > (1UL << pool->arena.page_shift) )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  const unsigned int c = _gaspi_arena_class(bsize);
+
+  if( c >= pool->arena.page_shift )
+    {
+      lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+      const gaspi_return_t eret = _gaspi_arena_alloc(&(pool->arena), bsize, offset);
+      unlock_gaspi(&(pool->lock));
+
+      return eret;
+    }
+
+  struct gaspi_pool_cache * const cache = _gaspi_pool_cache(pool);
+  if( cache == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  /* Refill half of the cache at once */
+  if( cache->num[c] == 0 )
+    {
+      gaspi_return_t eret = GASPI_SUCCESS;
+
+      lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+      while( cache->num[c] < GPI2_POOL_CACHE_SIZE / 2 && eret == GASPI_SUCCESS )
+	{
+	  eret = _gaspi_arena_alloc(&(pool->arena), bsize, &(cache->off[c][cache->num[c]]));
+	  if( eret == GASPI_SUCCESS )
+	    {
+	      cache->num[c]++;
+	    }
+	}
+      unlock_gaspi(&(pool->lock));
+
+      if( cache->num[c] == 0 )
+	{
+	  return eret;
+	}
+    }
+
+  *offset = cache->off[c][--cache->num[c]];
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_segment_free = pgaspi_segment_free
+gaspi_return_t
+pgaspi_segment_free (const gaspi_segment_id_t segment_id,
+		     const gaspi_offset_t offset)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_segment_free");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_segment_desc(segment_id);
+
+  struct gaspi_seg_pool * const pool = gctx->rrmd[segment_id]->local.pool;
+  if( pool == NULL )
+    {
+      return GASPI_ERR_INV_NUM;
+    }
+
+  /* A resize may reallocate page_class under the lock */
+  lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+  if( offset >= pool->arena.size )
+    {
+      unlock_gaspi(&(pool->lock));
+      return GASPI_ERR_INV_NUM;
+    }
+  const unsigned int c = pool->arena.page_class[offset >> pool->arena.page_shift];
+  unlock_gaspi(&(pool->lock));
+
+  struct gaspi_pool_cache * const cache =
+    (c != 0 && c < pool->arena.page_shift && (offset & ((1UL << c) - 1)) == 0)
+    ? _gaspi_pool_cache(pool) : NULL;
+
+  if( cache != NULL && cache->num[c] < GPI2_POOL_CACHE_SIZE )
+    {
+      cache->off[c][cache->num[c]++] = offset;
+      return GASPI_SUCCESS;
+    }
+
+  gaspi_return_t eret;
+
+  lock_gaspi_tout(&(pool->lock), GASPI_BLOCK);
+  eret = _gaspi_arena_free(&(pool->arena), offset);
+
+  /* Full cache: return half of it as well */
+  while( cache != NULL && eret == GASPI_SUCCESS && cache->num[c] > GPI2_POOL_CACHE_SIZE / 2 )
+    {
+      eret = _gaspi_arena_free(&(pool->arena), cache->off[c][--cache->num[c]]);
+    }
+  unlock_gaspi(&(pool->lock));
+
+  return eret;
+}
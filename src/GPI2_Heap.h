@@ -0,0 +1,84 @@
+/*
+Copyright (c) Fraunhofer ITWM - Carsten Lojewski <lojewski@itwm.fhg.de>, 2013-2016
+
+This file is part of GPI-2.
+
+GPI-2 is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License
+version 3 as published by the Free Software Foundation.
+
+GPI-2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GPI2_HEAP_H_
+#define _GPI2_HEAP_H_ 1
+
+#include "GPI2_Types.h"
+
+/* Allocators of memory inside segments. They hand out offsets and
+   keep all their bookkeeping outside the (remotely accessible)
+   segment memory. */
+
+/* Blocks are powers of two, at least 64 bytes. Blocks smaller than a
+   page are carved out of pages of their size class, larger ones take
+   whole pages. */
+#define GPI2_HEAP_MIN_SHIFT (6)
+#define GPI2_HEAP_PAGE_SHIFT (16)
+#define GPI2_HEAP_PAGE_SIZE (1UL << GPI2_HEAP_PAGE_SHIFT)
+#define GPI2_HEAP_CLASSES (64)
+
+struct gaspi_arena_free
+{
+  gaspi_offset_t *off;
+  size_t num;
+  size_t max;
+};
+
+struct gaspi_arena
+{
+  gaspi_size_t size;
+  gaspi_offset_t top;
+  unsigned int page_shift;
+  unsigned char *page_class;
+  gaspi_offset_t carve[GPI2_HEAP_CLASSES];
+  struct gaspi_arena_free free[GPI2_HEAP_CLASSES];
+};
+
+struct gaspi_sym_heap
+{
+  gaspi_lock_t lock;
+  struct gaspi_arena arena;
+};
+
+void
+gaspi_sym_heap_destroy(struct gaspi_sym_heap *heap);
+
+/* Take in the rest of a grown segment */
+int
+gaspi_sym_heap_grow(struct gaspi_sym_heap *heap, const gaspi_size_t size);
+
+/* Blocks below the page size are cached per thread */
+#define GPI2_POOL_CACHE_CLASSES (GPI2_HEAP_PAGE_SHIFT)
+#define GPI2_POOL_CACHE_SIZE (16)
+
+struct gaspi_seg_pool
+{
+  gaspi_lock_t lock;
+  struct gaspi_arena arena;
+  unsigned long id;
+  gaspi_segment_id_t segment_id;
+};
+
+void
+gaspi_seg_pool_destroy(struct gaspi_seg_pool *pool);
+
+int
+gaspi_seg_pool_grow(struct gaspi_seg_pool *pool, const gaspi_size_t size);
+
+#endif //_GPI2_HEAP_H_
@@ -19,6 +19,7 @@
 #include "PGASPI.h"
 #include "GPI2.h"
 #include "GPI2_Dev.h"
+#include "GPI2_SEG.h"
 #include "GPI2_Utility.h"
 
 #include "GPI2_SN.h"
@@ -35,7 +36,7 @@ pgaspi_queue_size (const gaspi_queue_id_t queue,
   gaspi_verify_null_ptr(queue_size);
   gaspi_context_t const * const gctx = &glb_gaspi_ctx;
 
-  *queue_size = (gaspi_number_t) gctx->ne_count_c[queue];
+  *queue_size = (gaspi_number_t) gctx->ne_count_c[queue].count;
 
   return GASPI_SUCCESS;
 }
@@ -88,7 +89,7 @@ pgaspi_notification_num (gaspi_number_t * const notification_num)
 {
   gaspi_verify_null_ptr(notification_num);
 
-  *notification_num = GASPI_MAX_NOTIFICATION;
+  *notification_num = glb_gaspi_cfg.notification_num;
 
   return GASPI_SUCCESS;
 }
@@ -203,22 +204,64 @@ pgaspi_queue_delete(const gaspi_queue_id_t queue_id)
   return GASPI_SUCCESS;
 }
 
+#pragma weak gaspi_queue_own = pgaspi_queue_own
+gaspi_return_t
+pgaspi_queue_own(const gaspi_queue_id_t queue, const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_queue_own");
+  gaspi_verify_queue(queue);
+
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( gaspi_queue_is_owner(queue) )
+    return GASPI_SUCCESS;
+
+  /* The lock is kept until the queue is released */
+  if( lock_gaspi_tout (&gctx->lockC[queue], timeout_ms) )
+    return GASPI_TIMEOUT;
+
+  gctx->queue_owner[queue] = pthread_self();
+  gctx->queue_owned[queue] = 1;
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_queue_release = pgaspi_queue_release
+gaspi_return_t
+pgaspi_queue_release(const gaspi_queue_id_t queue)
+{
+  gaspi_verify_init("gaspi_queue_release");
+  gaspi_verify_queue(queue);
+
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( !gaspi_queue_is_owner(queue) )
+    {
+      gaspi_print_error("Queue %u is not owned by the calling thread", queue);
+      return GASPI_ERROR;
+    }
+
+  gctx->queue_owned[queue] = 0;
+  unlock_gaspi (&gctx->lockC[queue]);
+
+  return GASPI_SUCCESS;
+}
+
 #pragma weak gaspi_queue_purge = pgaspi_queue_purge
 gaspi_return_t
 pgaspi_queue_purge(const gaspi_queue_id_t queue, const gaspi_timeout_t timeout_ms)
 {
   gaspi_verify_init("gaspi_queue_purge");
   gaspi_verify_queue(queue);
-  gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   eret = pgaspi_dev_purge(queue, timeout_ms);
 
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
 
   return eret;
 }
@@ -242,15 +285,16 @@ pgaspi_write (const gaspi_segment_id_t segment_id_local,
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   gaspi_verify_init("gaspi_write");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
   gaspi_verify_local_off(offset_local, segment_id_local, size);
   gaspi_verify_remote_off(offset_remote, segment_id_remote, rank, size);
   gaspi_verify_queue(queue);
   gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -276,7 +320,7 @@ pgaspi_write (const gaspi_segment_id_t segment_id_local,
   GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size);
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -294,15 +338,16 @@ pgaspi_read (const gaspi_segment_id_t segment_id_local,
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   gaspi_verify_init("gaspi_read");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
   gaspi_verify_local_off(offset_local, segment_id_local, size);
   gaspi_verify_remote_off(offset_remote, segment_id_remote, rank, size);
   gaspi_verify_queue(queue);
   gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -327,7 +372,7 @@ pgaspi_read (const gaspi_segment_id_t segment_id_local,
   GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_READ, 1);
   GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_READ, size);
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -344,9 +389,8 @@ pgaspi_wait (const gaspi_queue_id_t queue,
   GPI2_STATS_START_TIMER(GASPI_WAIT_TIMER);
 
   gaspi_return_t eret = GASPI_ERROR;
-  gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   eret = pgaspi_dev_wait(queue, timeout_ms);
@@ -359,7 +403,7 @@ pgaspi_wait (const gaspi_queue_id_t queue,
   GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_WAIT, 1);
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
 
   GPI2_STATS_STOP_TIMER(GASPI_WAIT_TIMER);
   GPI2_STATS_INC_TIMER( GASPI_STATS_TIME_WAIT,
@@ -385,10 +429,19 @@ pgaspi_write_list (const gaspi_number_t num,
   if(num == 0)
     return GASPI_ERR_INV_NUM;
 
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      gaspi_number_t l;
+      for(l = 0; l < num; l++)
+	{
+	  gaspi_segment_remote_require(segment_id_remote[l], rank, timeout_ms);
+	}
+    }
+
 #ifdef DEBUG
   gaspi_verify_init("gaspi_write_list");
   gaspi_verify_queue(queue);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   gaspi_number_t n;
   for(n = 0; n < num; n++)
@@ -402,7 +455,7 @@ pgaspi_write_list (const gaspi_number_t num,
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -425,7 +478,7 @@ pgaspi_write_list (const gaspi_number_t num,
     }
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -446,10 +499,19 @@ pgaspi_read_list (const gaspi_number_t num,
   if(num == 0)
     return GASPI_ERR_INV_NUM;
 
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      gaspi_number_t l;
+      for(l = 0; l < num; l++)
+	{
+	  gaspi_segment_remote_require(segment_id_remote[l], rank, timeout_ms);
+	}
+    }
+
 #ifdef DEBUG
   gaspi_verify_init("gaspi_read_list");
   gaspi_verify_queue(queue);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   gaspi_number_t n;
   for( n = 0; n < num; n++ )
@@ -462,7 +524,7 @@ pgaspi_read_list (const gaspi_number_t num,
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if( lock_gaspi_tout (&gctx->lockC[queue], timeout_ms) )
+  if( lock_gaspi_queue (queue, timeout_ms) )
     {
       return GASPI_TIMEOUT;
     }
@@ -487,7 +549,7 @@ pgaspi_read_list (const gaspi_number_t num,
     }
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -503,11 +565,13 @@ pgaspi_notify (const gaspi_segment_id_t segment_id_remote,
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   gaspi_verify_init("gaspi_notify");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
   gaspi_verify_segment(segment_id_remote);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id_remote]);
+  gaspi_verify_segment_desc(segment_id_remote);
   gaspi_verify_rank(rank);
+  gaspi_verify_remote_notification(segment_id_remote, rank, notification_id);
   gaspi_verify_queue(queue);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   if(notification_value == 0)
     {
@@ -517,7 +581,7 @@ pgaspi_notify (const gaspi_segment_id_t segment_id_remote,
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -540,7 +604,7 @@ pgaspi_notify (const gaspi_segment_id_t segment_id_remote,
     }
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -556,7 +620,7 @@ pgaspi_notify_waitsome (const gaspi_segment_id_t segment_id_local,
 
   gaspi_verify_init("gaspi_notify_waitsome");
   gaspi_verify_segment(segment_id_local);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id_local]);
+  gaspi_verify_segment_desc(segment_id_local);
   gaspi_verify_null_ptr(first_id);
 
   /* We need to start timing before the lock to include contention in
@@ -574,15 +638,7 @@ pgaspi_notify_waitsome (const gaspi_segment_id_t segment_id_local,
       gaspi_print_warning("Waiting for 0 notifications (gaspi_notify_waitsome).");
     }
 
-  if( notification_begin >= GASPI_MAX_NOTIFICATION )
-    {
-      return GASPI_ERR_INV_NOTIF_ID;
-    }
-
-  if( notification_begin + (gaspi_notification_id_t) num >= GASPI_MAX_NOTIFICATION )
-    {
-      return GASPI_ERR_INV_NOTIF_ID;
-    }
+  gaspi_verify_local_notification(segment_id_local, notification_begin, num);
 #endif
 
   volatile unsigned char *segPtr;
@@ -593,14 +649,14 @@ pgaspi_notify_waitsome (const gaspi_segment_id_t segment_id_local,
     return GASPI_SUCCESS;
 
 #ifdef GPI2_CUDA
-  if(gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id >=0 )
+  if(gctx->rrmd[segment_id_local]->local.cuda_dev_id >=0 )
     {
-      segPtr =  (volatile unsigned char*)gctx->rrmd[segment_id_local][gctx->rank].host_addr;
+      segPtr =  (volatile unsigned char*)gctx->rrmd[segment_id_local]->local.host_addr;
     }
   else
 #endif
 
-  segPtr = (volatile unsigned char *) gctx->rrmd[segment_id_local][gctx->rank].notif_spc.addr;
+  segPtr = (volatile unsigned char *) gctx->rrmd[segment_id_local]->local.notif_spc.addr;
 
   volatile unsigned int *p = (volatile unsigned int *) segPtr;
 
@@ -689,7 +745,8 @@ pgaspi_notify_reset (const gaspi_segment_id_t segment_id_local,
 
   gaspi_verify_init("gaspi_notify_reset");
   gaspi_verify_segment(segment_id_local);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id_local]);
+  gaspi_verify_segment_desc(segment_id_local);
+  gaspi_verify_local_notification(segment_id_local, notification_id, 1);
 
 #ifdef DEBUG
   if(old_notification_val == NULL)
@@ -701,12 +758,12 @@ pgaspi_notify_reset (const gaspi_segment_id_t segment_id_local,
   volatile unsigned char *segPtr;
 
 #ifdef GPI2_CUDA
-  if(gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id >= 0)
-    segPtr =  (volatile unsigned char*)gctx->rrmd[segment_id_local][gctx->rank].host_addr;
+  if(gctx->rrmd[segment_id_local]->local.cuda_dev_id >= 0)
+    segPtr =  (volatile unsigned char*)gctx->rrmd[segment_id_local]->local.host_addr;
   else
 #endif
     segPtr = (volatile unsigned char *)
-	gctx->rrmd[segment_id_local][gctx->rank].notif_spc.addr;
+	gctx->rrmd[segment_id_local]->local.notif_spc.addr;
 
   volatile unsigned int *p = (volatile unsigned int *) segPtr;
 
@@ -737,11 +794,13 @@ pgaspi_write_notify (const gaspi_segment_id_t segment_id_local,
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
   gaspi_verify_init("gaspi_write_notify");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
   gaspi_verify_local_off(offset_local, segment_id_local, size);
   gaspi_verify_remote_off(offset_remote, segment_id_remote, rank, size);
   gaspi_verify_queue(queue);
   gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_remote_notification(segment_id_remote, rank, notification_id);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   if(notification_value == 0)
     {
@@ -751,7 +810,7 @@ pgaspi_write_notify (const gaspi_segment_id_t segment_id_local,
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -778,7 +837,7 @@ pgaspi_write_notify (const gaspi_segment_id_t segment_id_local,
   GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size);
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
   return eret;
 }
 
@@ -809,10 +868,20 @@ pgaspi_write_list_notify (const gaspi_number_t num,
       return GASPI_ERR_INV_NOTIF_VAL;
     }
 
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      gaspi_number_t l;
+      for(l = 0; l < num; l++)
+	{
+	  gaspi_segment_remote_require(segment_id_remote[l], rank, timeout_ms);
+	}
+      gaspi_segment_remote_require(segment_id_notification, rank, timeout_ms);
+    }
+
 #ifdef DEBUG
   gaspi_verify_init("gaspi_write_list_notify");
   gaspi_verify_queue(queue);
-  gaspi_verify_queue_size_max(gctx->ne_count_c[queue]);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
 
   gaspi_number_t n;
   for(n = 0; n < num; n++)
@@ -822,11 +891,15 @@ pgaspi_write_list_notify (const gaspi_number_t num,
       gaspi_verify_comm_size(size[n], segment_id_local[n], segment_id_remote[n], rank, GASPI_MAX_TSIZE_C);
     }
 
+  gaspi_verify_segment(segment_id_notification);
+  gaspi_verify_segment_desc(segment_id_notification);
+  gaspi_verify_remote_notification(segment_id_notification, rank, notification_id);
+
 #endif
 
   gaspi_return_t eret = GASPI_ERROR;
 
-  if(lock_gaspi_tout (&gctx->lockC[queue], timeout_ms))
+  if(lock_gaspi_queue (queue, timeout_ms))
     return GASPI_TIMEOUT;
 
   if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
@@ -851,6 +924,625 @@ pgaspi_write_list_notify (const gaspi_number_t num,
     }
 
  endL:
-  unlock_gaspi (&gctx->lockC[queue]);
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+/* Strided communication */
+#ifdef DEBUG
+static inline gaspi_size_t
+_gaspi_strided_extent(gaspi_offset_t const * const stride,
+		      gaspi_size_t const * const count,
+		      const gaspi_number_t stride_levels)
+{
+  gaspi_size_t extent = count[0];
+  gaspi_number_t l;
+
+  for(l = 0; l < stride_levels; l++)
+    {
+      extent += (count[l + 1] - 1) * stride[l];
+    }
+
+  return extent;
+}
+
+#define gaspi_verify_strided(stride_local, stride_remote, count, stride_levels) \
+  {									\
+    gaspi_verify_null_ptr(stride_local);				\
+    gaspi_verify_null_ptr(stride_remote);				\
+    gaspi_verify_null_ptr(count);					\
+    gaspi_number_t l;							\
+    for(l = 0; l <= stride_levels; l++)					\
+      {									\
+	if( count[l] == 0 )						\
+	  return GASPI_ERR_INV_NUM;					\
+      }									\
+    for(l = 0; l < stride_levels; l++)					\
+      {									\
+	if( stride_local[l] < (l == 0 ? count[0] : count[l] * stride_local[l - 1]) \
+	    || stride_remote[l] < (l == 0 ? count[0] : count[l] * stride_remote[l - 1]) ) \
+	  return GASPI_ERR_INV_SIZE;					\
+      }									\
+  }
+#else
+#define gaspi_verify_strided(stride_local, stride_remote, count, stride_levels)
+#endif
+
+#pragma weak gaspi_write_strided = pgaspi_write_strided
+gaspi_return_t
+pgaspi_write_strided (const gaspi_segment_id_t segment_id_local,
+		      const gaspi_offset_t offset_local,
+		      gaspi_offset_t const * const stride_local,
+		      const gaspi_rank_t rank,
+		      const gaspi_segment_id_t segment_id_remote,
+		      const gaspi_offset_t offset_remote,
+		      gaspi_offset_t const * const stride_remote,
+		      gaspi_size_t const * const count,
+		      const gaspi_number_t stride_levels,
+		      const gaspi_queue_id_t queue,
+		      const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( stride_levels == 0 || stride_levels > GASPI_STRIDE_LEVELS_MAX )
+    return GASPI_ERR_INV_NUM;
+
+  gaspi_verify_init("gaspi_write_strided");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
+  gaspi_verify_strided(stride_local, stride_remote, count, stride_levels);
+  gaspi_verify_local_off(offset_local, segment_id_local,
+			 _gaspi_strided_extent(stride_local, count, stride_levels));
+  gaspi_verify_remote_off(offset_remote, segment_id_remote, rank,
+			  _gaspi_strided_extent(stride_remote, count, stride_levels));
+  gaspi_verify_queue(queue);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
+
+  gaspi_size_t size = count[0] * count[1];
+  if( stride_levels > 1 )
+    size *= count[2];
+
+  gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
+
+  gaspi_return_t eret = GASPI_ERROR;
+
+  if(lock_gaspi_queue (queue, timeout_ms))
+    return GASPI_TIMEOUT;
+
+  if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
+    {
+      eret = pgaspi_connect((gaspi_rank_t) rank, timeout_ms);
+      if( eret != GASPI_SUCCESS)
+	{
+	  goto endL;
+	}
+    }
+
+  eret = pgaspi_dev_write_strided(segment_id_local, offset_local, stride_local,
+				  rank,
+				  segment_id_remote, offset_remote, stride_remote,
+				  count, stride_levels,
+				  queue);
+
+  if( eret != GASPI_SUCCESS )
+    {
+      /* A full queue leaves it usable */
+      if( eret != GASPI_ERR_MANY_Q_REQS )
+	{
+	  gctx->qp_state_vec[queue][rank] = GASPI_STATE_CORRUPT;
+	}
+      goto endL;
+    }
+
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_WRITE, 1);
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size);
+
+ endL:
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+#pragma weak gaspi_read_strided = pgaspi_read_strided
+gaspi_return_t
+pgaspi_read_strided (const gaspi_segment_id_t segment_id_local,
+		     const gaspi_offset_t offset_local,
+		     gaspi_offset_t const * const stride_local,
+		     const gaspi_rank_t rank,
+		     const gaspi_segment_id_t segment_id_remote,
+		     const gaspi_offset_t offset_remote,
+		     gaspi_offset_t const * const stride_remote,
+		     gaspi_size_t const * const count,
+		     const gaspi_number_t stride_levels,
+		     const gaspi_queue_id_t queue,
+		     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( stride_levels == 0 || stride_levels > GASPI_STRIDE_LEVELS_MAX )
+    return GASPI_ERR_INV_NUM;
+
+  gaspi_verify_init("gaspi_read_strided");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
+  gaspi_verify_strided(stride_local, stride_remote, count, stride_levels);
+  gaspi_verify_local_off(offset_local, segment_id_local,
+			 _gaspi_strided_extent(stride_local, count, stride_levels));
+  gaspi_verify_remote_off(offset_remote, segment_id_remote, rank,
+			  _gaspi_strided_extent(stride_remote, count, stride_levels));
+  gaspi_verify_queue(queue);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
+
+  gaspi_size_t size = count[0] * count[1];
+  if( stride_levels > 1 )
+    size *= count[2];
+
+  gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
+
+  gaspi_return_t eret = GASPI_ERROR;
+
+  if(lock_gaspi_queue (queue, timeout_ms))
+    return GASPI_TIMEOUT;
+
+  if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
+    {
+      eret = pgaspi_connect((gaspi_rank_t) rank, timeout_ms);
+      if( eret != GASPI_SUCCESS)
+	{
+	  goto endL;
+	}
+    }
+
+  eret = pgaspi_dev_read_strided(segment_id_local, offset_local, stride_local,
+				 rank,
+				 segment_id_remote, offset_remote, stride_remote,
+				 count, stride_levels,
+				 queue);
+
+  if( eret != GASPI_SUCCESS )
+    {
+      /* A full queue leaves it usable */
+      if( eret != GASPI_ERR_MANY_Q_REQS )
+	{
+	  gctx->qp_state_vec[queue][rank] = GASPI_STATE_CORRUPT;
+	}
+      goto endL;
+    }
+
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_READ, 1);
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_READ, size);
+
+ endL:
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+#pragma weak gaspi_write_strided_notify = pgaspi_write_strided_notify
+gaspi_return_t
+pgaspi_write_strided_notify (const gaspi_segment_id_t segment_id_local,
+			     const gaspi_offset_t offset_local,
+			     gaspi_offset_t const * const stride_local,
+			     const gaspi_rank_t rank,
+			     const gaspi_segment_id_t segment_id_remote,
+			     const gaspi_offset_t offset_remote,
+			     gaspi_offset_t const * const stride_remote,
+			     gaspi_size_t const * const count,
+			     const gaspi_number_t stride_levels,
+			     const gaspi_notification_id_t notification_id,
+			     const gaspi_notification_t notification_value,
+			     const gaspi_queue_id_t queue,
+			     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( stride_levels == 0 || stride_levels > GASPI_STRIDE_LEVELS_MAX )
+    return GASPI_ERR_INV_NUM;
+
+  if(notification_value == 0)
+    {
+      gaspi_printf("Zero is not allowed as notification value.");
+      return GASPI_ERR_INV_NOTIF_VAL;
+    }
+
+  gaspi_verify_init("gaspi_write_strided_notify");
+  gaspi_segment_remote_require(segment_id_remote, rank, timeout_ms);
+  gaspi_verify_strided(stride_local, stride_remote, count, stride_levels);
+  gaspi_verify_local_off(offset_local, segment_id_local,
+			 _gaspi_strided_extent(stride_local, count, stride_levels));
+  gaspi_verify_remote_off(offset_remote, segment_id_remote, rank,
+			  _gaspi_strided_extent(stride_remote, count, stride_levels));
+  gaspi_verify_remote_notification(segment_id_remote, rank, notification_id);
+  gaspi_verify_queue(queue);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count);
+
+  gaspi_size_t size = count[0] * count[1];
+  if( stride_levels > 1 )
+    size *= count[2];
+
+  gaspi_verify_comm_size(size, segment_id_local, segment_id_remote, rank, GASPI_MAX_TSIZE_C);
+
+  gaspi_return_t eret = GASPI_ERROR;
+
+  if(lock_gaspi_queue (queue, timeout_ms))
+    return GASPI_TIMEOUT;
+
+  if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
+    {
+      eret = pgaspi_connect((gaspi_rank_t) rank, timeout_ms);
+      if( eret != GASPI_SUCCESS)
+	{
+	  goto endL;
+	}
+    }
+
+  eret = pgaspi_dev_write_strided_notify(segment_id_local, offset_local, stride_local,
+					 rank,
+					 segment_id_remote, offset_remote, stride_remote,
+					 count, stride_levels,
+					 notification_id, notification_value,
+					 queue);
+
+  if( eret != GASPI_SUCCESS )
+    {
+      /* A full queue leaves it usable */
+      if( eret != GASPI_ERR_MANY_Q_REQS )
+	{
+	  gctx->qp_state_vec[queue][rank] = GASPI_STATE_CORRUPT;
+	}
+      goto endL;
+    }
+
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_WRITE_NOT, 1);
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, size);
+
+ endL:
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+/* Batched submission */
+#pragma weak gaspi_write_notify_batch_elem_max = pgaspi_write_notify_batch_elem_max
+gaspi_return_t
+pgaspi_write_notify_batch_elem_max (gaspi_number_t * const elem_max)
+{
+  gaspi_verify_null_ptr(elem_max);
+
+  *elem_max = GASPI_MAX_BATCH;
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_write_notify_batch = pgaspi_write_notify_batch
+gaspi_return_t
+pgaspi_write_notify_batch (const gaspi_number_t num,
+			   gaspi_segment_id_t * const segment_id_local,
+			   gaspi_offset_t * const offset_local,
+			   gaspi_rank_t * const rank,
+			   gaspi_segment_id_t * const segment_id_remote,
+			   gaspi_offset_t * const offset_remote,
+			   gaspi_size_t * const size,
+			   gaspi_notification_id_t * const notification_id,
+			   gaspi_notification_t * const notification_value,
+			   const gaspi_queue_id_t queue,
+			   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  gaspi_number_t n;
+
+  if( num == 0 || num > GASPI_MAX_BATCH )
+    return GASPI_ERR_INV_NUM;
+
+  if( (notification_id == NULL) != (notification_value == NULL) )
+    return GASPI_ERR_NULLPTR;
+
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      gaspi_number_t l;
+      for(l = 0; l < num; l++)
+	{
+	  gaspi_segment_remote_require(segment_id_remote[l], rank[l], timeout_ms);
+	}
+    }
+
+#ifdef DEBUG
+  gaspi_verify_init("gaspi_write_notify_batch");
+  gaspi_verify_queue(queue);
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count + 2 * num - 1);
+
+  for(n = 0; n < num; n++)
+    {
+      gaspi_verify_local_off(offset_local[n], segment_id_local[n], size[n]);
+      gaspi_verify_remote_off(offset_remote[n], segment_id_remote[n], rank[n], size[n]);
+      gaspi_verify_comm_size(size[n], segment_id_local[n], segment_id_remote[n], rank[n], GASPI_MAX_TSIZE_C);
+      if( notification_id != NULL && notification_value[n] != 0 )
+	{
+	  gaspi_verify_remote_notification(segment_id_remote[n], rank[n], notification_id[n]);
+	}
+    }
+#endif
+
+  gaspi_return_t eret = GASPI_ERROR;
+
+  if(lock_gaspi_queue (queue, timeout_ms))
+    return GASPI_TIMEOUT;
+
+  gaspi_size_t bytes = 0;
+  for(n = 0; n < num; n++)
+    {
+      if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank[n]].cstat )
+	{
+	  eret = pgaspi_connect(rank[n], timeout_ms);
+	  if( eret != GASPI_SUCCESS )
+	    {
+	      goto endL;
+	    }
+	}
+      bytes += size[n];
+    }
+
+  gaspi_rank_t rank_failed = rank[0];
+  eret = pgaspi_dev_write_notify_batch(num,
+				       segment_id_local, offset_local, rank,
+				       segment_id_remote, offset_remote, size,
+				       notification_id, notification_value,
+				       queue, &rank_failed);
+
+  if( eret != GASPI_SUCCESS )
+    {
+      /* The requests to the other ranks were posted */
+      gctx->qp_state_vec[queue][rank_failed] = GASPI_STATE_CORRUPT;
+      goto endL;
+    }
+
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_WRITE_NOT, num);
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_BYTES_WRITE, bytes);
+
+ endL:
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+/* Persistent plans */
+static void
+_gaspi_plan_free(struct gaspi_plan_desc * const p)
+{
+  free(p->rank);
+  free(p->segment_id_local);
+  free(p->offset_local);
+  free(p->segment_id_remote);
+  free(p->offset_remote);
+  free(p->size);
+  free(p->notification_id);
+  free(p->notification_value);
+  free(p);
+}
+
+/* Build the device requests of a plan from the segment descriptors
+   of now. Done again at the start once a descriptor changed (a
+   segment was resized or created again), as the requests hold the
+   addresses and keys. */
+static gaspi_return_t
+_gaspi_plan_build(struct gaspi_plan_desc * const p,
+		  const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* Read before the descriptors: a later change builds it again */
+  const unsigned int epoch = gctx->seg_epoch;
+  __sync_synchronize();
+
+  /* Connect all targets now; the remote segments must be known */
+  gaspi_number_t n;
+  for(n = 0; n < p->num; n++)
+    {
+      const gaspi_rank_t rank = p->rank[n];
+      const gaspi_segment_id_t sr = p->segment_id_remote[n];
+      gaspi_return_t eret;
+
+      if( glb_gaspi_cfg.segment_lazy )
+	{
+	  eret = gaspi_segment_remote_get(sr, rank, timeout_ms);
+	  if( eret != GASPI_SUCCESS )
+	    return eret;
+	}
+
+      if( GASPI_ENDPOINT_DISCONNECTED == gctx->ep_conn[rank].cstat )
+	{
+	  eret = pgaspi_connect(rank, timeout_ms);
+	  if( eret != GASPI_SUCCESS )
+	    return eret;
+	}
+
+      if( p->offset_remote[n] + p->size[n] > gctx->rrmd[sr]->remote[rank].size )
+	return GASPI_ERR_INV_REM_OFF;
+
+      if( p->notification_id != NULL
+	  && p->notification_value[n] != 0
+	  && p->notification_id[n] >= gctx->rrmd[sr]->remote[rank].notif_num )
+	return GASPI_ERR_INV_NOTIF_ID;
+    }
+
+  const gaspi_return_t eret =
+    pgaspi_dev_plan_create(p,
+			   p->segment_id_local, p->offset_local,
+			   p->segment_id_remote, p->offset_remote, p->size,
+			   p->notification_id, p->notification_value);
+  if( eret != GASPI_SUCCESS )
+    return eret;
+
+  p->epoch = epoch;
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_plan_create = pgaspi_plan_create
+gaspi_return_t
+pgaspi_plan_create (gaspi_plan_t * const plan,
+		    const gaspi_number_t num,
+		    gaspi_segment_id_t * const segment_id_local,
+		    gaspi_offset_t * const offset_local,
+		    gaspi_rank_t * const rank,
+		    gaspi_segment_id_t * const segment_id_remote,
+		    gaspi_offset_t * const offset_remote,
+		    gaspi_size_t * const size,
+		    gaspi_notification_id_t * const notification_id,
+		    gaspi_notification_t * const notification_value,
+		    const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_plan_create");
+  gaspi_verify_null_ptr(plan);
+
+  if( num == 0 )
+    return GASPI_ERR_INV_NUM;
+
+  if( segment_id_local == NULL || offset_local == NULL || rank == NULL
+      || segment_id_remote == NULL || offset_remote == NULL || size == NULL )
+    return GASPI_ERR_NULLPTR;
+
+  if( (notification_id == NULL) != (notification_value == NULL) )
+    return GASPI_ERR_NULLPTR;
+
+  /* Plans are built once and started many times: always check the
+     arguments here so that the start path needs no checks at all */
+  gaspi_number_t n;
+  for(n = 0; n < num; n++)
+    {
+      const gaspi_segment_id_t sl = segment_id_local[n];
+      const gaspi_segment_id_t sr = segment_id_remote[n];
+
+      if( rank[n] >= gctx->tnc )
+	return GASPI_ERR_INV_RANK;
+
+      if( sl >= gctx->rrmd_size || sr >= gctx->rrmd_size
+	  || gctx->rrmd[sl] == NULL || gctx->rrmd[sr] == NULL )
+	return GASPI_ERR_INV_SEG;
+
+      if( size[n] < 1 || size[n] > GASPI_MAX_TSIZE_C )
+	return GASPI_ERR_INV_COMMSIZE;
+
+      if( offset_local[n] + size[n] > gctx->rrmd[sl]->local.size )
+	return GASPI_ERR_INV_LOC_OFF;
+
+      if( notification_id != NULL
+	  && notification_value[n] != 0
+	  && notification_id[n] >= GASPI_MAX_NOTIFICATION )
+	return GASPI_ERR_INV_NUM;
+    }
+
+  struct gaspi_plan_desc *p = calloc(1, sizeof(struct gaspi_plan_desc));
+  if( p == NULL )
+    return GASPI_ERR_MEMALLOC;
+
+  /* Kept to build the requests again (see _gaspi_plan_build) */
+  p->num = num;
+  p->rank = malloc(num * sizeof(gaspi_rank_t));
+  p->segment_id_local = malloc(num * sizeof(gaspi_segment_id_t));
+  p->offset_local = malloc(num * sizeof(gaspi_offset_t));
+  p->segment_id_remote = malloc(num * sizeof(gaspi_segment_id_t));
+  p->offset_remote = malloc(num * sizeof(gaspi_offset_t));
+  p->size = malloc(num * sizeof(gaspi_size_t));
+  if( notification_id != NULL )
+    {
+      p->notification_id = malloc(num * sizeof(gaspi_notification_id_t));
+      p->notification_value = malloc(num * sizeof(gaspi_notification_t));
+    }
+
+  gaspi_return_t eret = GASPI_ERR_MEMALLOC;
+
+  if( p->rank == NULL || p->segment_id_local == NULL || p->offset_local == NULL
+      || p->segment_id_remote == NULL || p->offset_remote == NULL || p->size == NULL
+      || (notification_id != NULL
+	  && (p->notification_id == NULL || p->notification_value == NULL)) )
+    goto errL;
+
+  memcpy(p->rank, rank, num * sizeof(gaspi_rank_t));
+  memcpy(p->segment_id_local, segment_id_local, num * sizeof(gaspi_segment_id_t));
+  memcpy(p->offset_local, offset_local, num * sizeof(gaspi_offset_t));
+  memcpy(p->segment_id_remote, segment_id_remote, num * sizeof(gaspi_segment_id_t));
+  memcpy(p->offset_remote, offset_remote, num * sizeof(gaspi_offset_t));
+  memcpy(p->size, size, num * sizeof(gaspi_size_t));
+  if( notification_id != NULL )
+    {
+      memcpy(p->notification_id, notification_id, num * sizeof(gaspi_notification_id_t));
+      memcpy(p->notification_value, notification_value, num * sizeof(gaspi_notification_t));
+    }
+
+  eret = _gaspi_plan_build(p, timeout_ms);
+  if( eret != GASPI_SUCCESS )
+    goto errL;
+
+  *plan = p;
+
+  return GASPI_SUCCESS;
+
+ errL:
+  _gaspi_plan_free(p);
+
+  return eret;
+}
+
+#pragma weak gaspi_plan_start = pgaspi_plan_start
+gaspi_return_t
+pgaspi_plan_start (const gaspi_plan_t plan,
+		   const gaspi_queue_id_t queue,
+		   const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_plan_start");
+  gaspi_verify_null_ptr(plan);
+  gaspi_verify_queue(queue);
+
+  gaspi_return_t eret = GASPI_ERROR;
+
+  /* A segment of the plan may have moved */
+  if( plan->epoch != gctx->seg_epoch )
+    {
+      if( plan->dev_plan != NULL )
+	{
+	  pgaspi_dev_plan_delete(plan);
+	  plan->dev_plan = NULL;
+	}
+
+      eret = _gaspi_plan_build(plan, timeout_ms);
+      if( eret != GASPI_SUCCESS )
+	return eret;
+    }
+
+  gaspi_verify_queue_size_max(gctx->ne_count_c[queue].count + plan->num_wr - 1);
+
+  if(lock_gaspi_queue (queue, timeout_ms))
+    return GASPI_TIMEOUT;
+
+  gaspi_rank_t rank_failed = plan->rank[0];
+  eret = pgaspi_dev_plan_start(plan, queue, &rank_failed);
+
+  if( eret != GASPI_SUCCESS )
+    {
+      /* The requests to the other ranks were posted */
+      gctx->qp_state_vec[queue][rank_failed] = GASPI_STATE_CORRUPT;
+      goto endL;
+    }
+
+  GPI2_STATS_INC_COUNT(GASPI_STATS_COUNTER_NUM_WRITE, plan->num);
+
+ endL:
+  unlock_gaspi_queue (queue);
+  return eret;
+}
+
+#pragma weak gaspi_plan_delete = pgaspi_plan_delete
+gaspi_return_t
+pgaspi_plan_delete (gaspi_plan_t plan)
+{
+  gaspi_verify_init("gaspi_plan_delete");
+  gaspi_verify_null_ptr(plan);
+
+  gaspi_return_t eret = GASPI_SUCCESS;
+  if( plan->dev_plan != NULL )
+    {
+      eret = pgaspi_dev_plan_delete(plan);
+    }
+
+  _gaspi_plan_free(plan);
+
   return eret;
 }
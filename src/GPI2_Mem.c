@@ -16,7 +16,29 @@ You should have received a copy of the GNU General Public License
 along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
 #include "GPI2_Mem.h"
+#include "GPI2_Utility.h"
+
+#define GPI2_PAGE_2M (1UL << 21)
+#define GPI2_PAGE_1G (1UL << 30)
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+/* Memory policies of mbind(2), to not depend on libnuma */
+#define GPI2_MPOL_BIND 2
+#define GPI2_MPOL_INTERLEAVE 3
+#define GPI2_MPOL_MF_MOVE (1 << 1)
+
+/* Minimum amount of memory zeroed by each thread */
+#define GPI2_MEM_ZERO_CHUNK (64UL << 20)
+#define GPI2_MEM_ZERO_THREADS_MAX 64
 
 gaspi_size_t
 gaspi_get_system_mem(void)
@@ -82,3 +104,279 @@ gaspi_get_mem_in_use(void)
 
   return (gaspi_size_t) (rss * page_size);
 }
+
+#define GPI2_ROUND_UP(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+static void
+_gaspi_mem_bind(void * const ptr, const size_t len,
+		const gaspi_alloc_t policy, const int socket)
+{
+#ifdef SYS_mbind
+  unsigned long nodemask;
+  int mode;
+
+  if( policy & GASPI_MEM_NUMA_INTERLEAVE )
+    {
+      mode = GPI2_MPOL_INTERLEAVE;
+      nodemask = ~0UL;
+    }
+  else
+    {
+      if( socket < 0 || socket >= (int) (8 * sizeof(nodemask)) )
+	{
+	  return;
+	}
+
+      mode = GPI2_MPOL_BIND;
+      nodemask = 1UL << socket;
+    }
+
+  /* Only the nodes with memory the rank is allowed to use are taken */
+  if( syscall(SYS_mbind, ptr, len, mode, &nodemask, 8 * sizeof(nodemask) + 1,
+	      GPI2_MPOL_MF_MOVE) != 0 )
+    {
+      gaspi_print_warning("Failed to set NUMA placement of segment memory (node %d)", socket);
+    }
+#else
+  gaspi_print_warning("NUMA placement of segment memory not supported");
+#endif
+}
+
+void *
+gaspi_mem_alloc(const size_t size, const gaspi_alloc_t policy,
+		const int socket, size_t * const mapped)
+{
+  void *ptr = NULL;
+  size_t len = size;
+
+  *mapped = 0;
+
+  if( policy & (GASPI_MEM_HUGE_2M | GASPI_MEM_HUGE_1G) )
+    {
+      const size_t hpage = (policy & GASPI_MEM_HUGE_1G) ? GPI2_PAGE_1G : GPI2_PAGE_2M;
+      const int hflag = (policy & GASPI_MEM_HUGE_1G) ? (30 << MAP_HUGE_SHIFT) : (21 << MAP_HUGE_SHIFT);
+
+      len = GPI2_ROUND_UP(size, hpage);
+
+#ifdef MAP_HUGETLB
+      ptr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | hflag, -1, 0);
+#else
+      ptr = MAP_FAILED;
+#endif
+      if( ptr != MAP_FAILED )
+	{
+	  *mapped = len;
+	}
+      else
+	{
+	  /* No huge pages reserved: transparent huge pages */
+	  len = GPI2_ROUND_UP(size, GPI2_PAGE_2M);
+
+	  if( posix_memalign(&ptr, GPI2_PAGE_2M, len) != 0 )
+	    {
+	      return NULL;
+	    }
+#ifdef MADV_HUGEPAGE
+	  if( madvise(ptr, len, MADV_HUGEPAGE) != 0 )
+	    {
+	      gaspi_print_warning("Failed to enable transparent huge pages for segment memory");
+	    }
+#endif
+	}
+    }
+  else
+    {
+      const long page_size = sysconf (_SC_PAGESIZE);
+
+      if( page_size < 0 )
+	{
+	  gaspi_print_error ("Failed to get system's page size.");
+	  return NULL;
+	}
+
+      if( posix_memalign(&ptr, page_size, size) != 0 )
+	{
+	  return NULL;
+	}
+    }
+
+  if( policy & (GASPI_MEM_NUMA_LOCAL | GASPI_MEM_NUMA_INTERLEAVE) )
+    {
+      _gaspi_mem_bind(ptr, len, policy, socket);
+    }
+
+  return ptr;
+}
+
+void
+gaspi_mem_free(void * const ptr, const size_t mapped)
+{
+  if( mapped )
+    {
+      munmap(ptr, mapped);
+    }
+  else
+    {
+      free(ptr);
+    }
+}
+
+/* Mapped memory is grown with mremap: in place if the address space
+   behind it is free, moved by the kernel otherwise. Memory on the heap
+   (and huge pages that cannot be remapped) is copied, to a mapping
+   unless huge pages were asked for, so the next growth can be in
+   place. */
+void *
+gaspi_mem_grow(void * const ptr, const size_t size, const size_t new_size,
+	       const gaspi_alloc_t policy, const int socket,
+	       size_t * const mapped)
+{
+  const long page_size = sysconf (_SC_PAGESIZE);
+
+  if( page_size < 0 )
+    {
+      gaspi_print_error ("Failed to get system's page size.");
+      return NULL;
+    }
+
+  size_t align = (size_t) page_size;
+  if( policy & GASPI_MEM_HUGE_1G )
+    {
+      align = GPI2_PAGE_1G;
+    }
+  else if( policy & GASPI_MEM_HUGE_2M )
+    {
+      align = GPI2_PAGE_2M;
+    }
+
+  const size_t len = GPI2_ROUND_UP(new_size, align);
+  void *nptr = MAP_FAILED;
+
+  if( *mapped )
+    {
+      if( len <= *mapped )
+	{
+	  return ptr;
+	}
+
+      nptr = mremap(ptr, *mapped, len, 0);
+      if( nptr == MAP_FAILED )
+	{
+	  nptr = mremap(ptr, *mapped, len, MREMAP_MAYMOVE);
+	}
+
+      if( nptr != MAP_FAILED )
+	{
+	  *mapped = len;
+	  if( policy & (GASPI_MEM_NUMA_LOCAL | GASPI_MEM_NUMA_INTERLEAVE) )
+	    {
+	      _gaspi_mem_bind(nptr, len, policy, socket);
+	    }
+	  return nptr;
+	}
+    }
+
+  size_t nmapped = 0;
+
+  if( policy & (GASPI_MEM_HUGE_2M | GASPI_MEM_HUGE_1G) )
+    {
+      nptr = gaspi_mem_alloc(new_size, policy, socket, &nmapped);
+      if( nptr == NULL )
+	{
+	  return NULL;
+	}
+    }
+  else
+    {
+      nptr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if( nptr == MAP_FAILED )
+	{
+	  return NULL;
+	}
+
+      nmapped = len;
+      if( policy & (GASPI_MEM_NUMA_LOCAL | GASPI_MEM_NUMA_INTERLEAVE) )
+	{
+	  _gaspi_mem_bind(nptr, len, policy, socket);
+	}
+    }
+
+  memcpy(nptr, ptr, size);
+  gaspi_mem_free(ptr, *mapped);
+  *mapped = nmapped;
+
+  return nptr;
+}
+
+struct mem_zero_part
+{
+  unsigned char *ptr;
+  size_t len;
+};
+
+static void *
+_gaspi_mem_zero_part(void *arg)
+{
+  struct mem_zero_part const * const part = (struct mem_zero_part *) arg;
+
+  memset(part->ptr, 0, part->len);
+
+  return NULL;
+}
+
+void
+gaspi_mem_zero(void * const ptr, const size_t len)
+{
+  pthread_t tid[GPI2_MEM_ZERO_THREADS_MAX];
+  struct mem_zero_part part[GPI2_MEM_ZERO_THREADS_MAX];
+  int created[GPI2_MEM_ZERO_THREADS_MAX];
+  cpu_set_t cpus;
+  int nthreads = 1;
+  int t;
+
+  /* The threads inherit the affinity of the rank */
+  if( sched_getaffinity(0, sizeof(cpus), &cpus) == 0 )
+    {
+      nthreads = CPU_COUNT(&cpus);
+    }
+
+  nthreads = MIN(nthreads, (int) MIN(len / GPI2_MEM_ZERO_CHUNK, GPI2_MEM_ZERO_THREADS_MAX));
+
+  if( nthreads <= 1 )
+    {
+      memset(ptr, 0, len);
+      return;
+    }
+
+  /* Whole (huge) pages per thread */
+  const size_t chunk = GPI2_ROUND_UP(len / nthreads, GPI2_PAGE_2M);
+  size_t off = 0;
+
+  for(t = 0; t < nthreads; t++)
+    {
+      part[t].ptr = (unsigned char *) ptr + off;
+      part[t].len = MIN(chunk, len - off);
+      off += part[t].len;
+
+      created[t] = (t > 0 && part[t].len > 0
+		    && pthread_create(&tid[t], NULL, _gaspi_mem_zero_part, &part[t]) == 0);
+    }
+
+  for(t = 0; t < nthreads; t++)
+    {
+      if( !created[t] )
+	{
+	  _gaspi_mem_zero_part(&part[t]);
+	}
+    }
+
+  for(t = 1; t < nthreads; t++)
+    {
+      if( created[t] )
+	{
+	  pthread_join(tid[t], NULL);
+	}
+    }
+}
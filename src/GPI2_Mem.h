@@ -30,3 +30,26 @@ gaspi_size_t gaspi_get_system_mem(void);
 gaspi_size_t gaspi_get_mem_peak(void);
 
 gaspi_size_t gaspi_get_mem_in_use(void);
+
+/* Segment memory according to the allocation policy (huge pages,
+   NUMA placement). Memory that was mapped sets *mapped to the mapped
+   length, which is needed to release it. */
+void *
+gaspi_mem_alloc(const size_t size, const gaspi_alloc_t policy,
+		const int socket, size_t * const mapped);
+
+void
+gaspi_mem_free(void * const ptr, const size_t mapped);
+
+/* Grow memory of gaspi_mem_alloc from size to new_size, keeping its
+   content. Returns the (possibly moved) memory or NULL, in which case
+   the old memory is untouched. */
+void *
+gaspi_mem_grow(void * const ptr, const size_t size, const size_t new_size,
+	       const gaspi_alloc_t policy, const int socket,
+	       size_t * const mapped);
+
+/* Zero memory with several threads, which also places the pages
+   (first touch) on the NUMA nodes of the rank */
+void
+gaspi_mem_zero(void * const ptr, const size_t len);
@@ -22,19 +22,108 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "PGASPI.h"
 #include "GPI2.h"
 #include "GPI2_Dev.h"
+#include "GPI2_Heap.h"
+#include "GPI2_Mem.h"
 #include "GPI2_Utility.h"
 #include "GPI2_SN.h"
 #include "GPI2_SEG.h"
 
 extern gaspi_config_t glb_gaspi_cfg;
 
+/* The segment table starts with GASPI_MAX_MSEGS entries and grows
+   (under gaspi_mseg_lock) when a larger segment id shows up, locally
+   or from a remote rank. Communication paths index it without
+   locking, so a grown table is published only once filled and the
+   tables it replaces are kept until gaspi_proc_term. Each growth at
+   least doubles the table. */
+#define GPI2_SEG_TABLES (8)
+
+static gaspi_rc_seg_t **gaspi_seg_tables[GPI2_SEG_TABLES];
+static int gaspi_seg_tables_num = 0;
+
+int
+gaspi_segment_table_init(gaspi_context_t * const gctx)
+{
+  gctx->rrmd = (gaspi_rc_seg_t **) calloc(GASPI_MAX_MSEGS, sizeof(gaspi_rc_seg_t *));
+  if( gctx->rrmd == NULL )
+    {
+      return -1;
+    }
+
+  gaspi_seg_tables[0] = gctx->rrmd;
+  gaspi_seg_tables_num = 1;
+  gctx->rrmd_size = GASPI_MAX_MSEGS;
+
+  return 0;
+}
+
+int
+gaspi_segment_table_grow(gaspi_context_t * const gctx,
+			 const gaspi_segment_id_t segment_id)
+{
+  if( segment_id < gctx->rrmd_size )
+    {
+      return 0;
+    }
+
+  if( gaspi_seg_tables_num == GPI2_SEG_TABLES )
+    {
+      return -1;
+    }
+
+  gaspi_number_t size = gctx->rrmd_size;
+  while( size <= segment_id )
+    {
+      size *= 2;
+    }
+
+  if( size > GASPI_MAX_MSEGS_LIMIT )
+    {
+      size = GASPI_MAX_MSEGS_LIMIT;
+    }
+
+  gaspi_rc_seg_t **table = (gaspi_rc_seg_t **) calloc(size, sizeof(gaspi_rc_seg_t *));
+  if( table == NULL )
+    {
+      return -1;
+    }
+
+  memcpy(table, gctx->rrmd, gctx->rrmd_size * sizeof(gaspi_rc_seg_t *));
+
+  gaspi_seg_tables[gaspi_seg_tables_num++] = table;
+
+  /* Table before its size: a reader that sees the new size also
+     sees the new table */
+  __sync_synchronize();
+  gctx->rrmd = table;
+  __sync_synchronize();
+  gctx->rrmd_size = size;
+
+  return 0;
+}
+
+void
+gaspi_segment_table_free(gaspi_context_t * const gctx)
+{
+  int t;
+  for(t = 0; t < gaspi_seg_tables_num; t++)
+    {
+      free(gaspi_seg_tables[t]);
+      gaspi_seg_tables[t] = NULL;
+    }
+
+  gaspi_seg_tables_num = 0;
+  gctx->rrmd = NULL;
+  gctx->rrmd_size = 0;
+}
+
 #pragma weak gaspi_segment_max = pgaspi_segment_max
 gaspi_return_t
 pgaspi_segment_max (gaspi_number_t * const segment_max)
 {
   gaspi_verify_null_ptr(segment_max);
 
-  *segment_max = GASPI_MAX_MSEGS;
+  *segment_max = glb_gaspi_cfg.segment_max;
 
   return GASPI_SUCCESS;
 }
@@ -49,10 +138,11 @@ pgaspi_segment_size (const gaspi_segment_id_t segment_id,
 
   gaspi_verify_init("gaspi_segment_size");
   gaspi_verify_segment(segment_id);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id]);
+  gaspi_verify_segment_desc(segment_id);
   gaspi_verify_null_ptr(size);
+  gaspi_segment_remote_require(segment_id, rank, GASPI_BLOCK);
 
-  gaspi_size_t seg_size = gctx->rrmd[segment_id][rank].size;
+  gaspi_size_t seg_size = gctx->rrmd[segment_id]->remote[rank].size;
 
   gaspi_verify_segment_size(seg_size);
 
@@ -69,12 +159,12 @@ pgaspi_segment_ptr (const gaspi_segment_id_t segment_id, gaspi_pointer_t * ptr)
 
   gaspi_verify_init("gaspi_segment_ptr");
   gaspi_verify_segment(segment_id);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id]);
+  gaspi_verify_segment_desc(segment_id);
   gaspi_verify_null_ptr(ptr);
 
-  gaspi_verify_segment_size(gctx->rrmd[segment_id][gctx->rank].size);
+  gaspi_verify_segment_size(gctx->rrmd[segment_id]->local.size);
 
-  *ptr = gctx->rrmd[segment_id][gctx->rank].data.buf;
+  *ptr = gctx->rrmd[segment_id]->local.data.buf;
 
   return GASPI_SUCCESS;
 }
@@ -90,11 +180,11 @@ pgaspi_segment_list (const gaspi_number_t num,
   gaspi_verify_init("gaspi_segment_list");
   gaspi_verify_null_ptr(segment_id_list);
 
-  for(i = 0; i < GASPI_MAX_MSEGS; i++)
+  for(i = 0; i < (int) gctx->rrmd_size; i++)
     {
       if( gctx->rrmd[(gaspi_segment_id_t) i] != NULL )
 	{
-	  if( gctx->rrmd[(gaspi_segment_id_t) i][gctx->rank].trans )
+	  if( gctx->rrmd[(gaspi_segment_id_t) i]->trans[gctx->rank] )
 	    {
 	      segment_id_list[idx++] = (gaspi_segment_id_t) i;
 	    }
@@ -180,23 +270,116 @@ pgaspi_segment_avail_local (gaspi_segment_id_t * const avail_seg_id)
   return GASPI_SUCCESS;
 }
 
-static inline int
+/* The local segment is described in full, the other ranks only by
+   the dense array of small remote descriptors used on the
+   communication paths. */
+int
 pgaspi_segment_create_desc( gaspi_context_t * const gctx,
 			    const gaspi_segment_id_t segment_id)
 {
+  if( gaspi_segment_table_grow(gctx, segment_id) != 0 )
+    {
+      return 1;
+    }
+
   if( gctx->rrmd[segment_id] == NULL)
     {
-      gctx->rrmd[segment_id] = (gaspi_rc_mseg_t *) calloc (gctx->tnc, sizeof (gaspi_rc_mseg_t));
+      gaspi_rc_seg_t * const seg = (gaspi_rc_seg_t *) calloc (1, sizeof (gaspi_rc_seg_t));
+      if( seg == NULL )
+	{
+	  return 1;
+	}
 
-      if( gctx->rrmd[segment_id] == NULL)
+      seg->remote = (gaspi_rc_rseg_t *) calloc (gctx->tnc, sizeof (gaspi_rc_rseg_t));
+      seg->trans = (unsigned char *) calloc (gctx->tnc, sizeof (unsigned char));
+
+      if( seg->remote == NULL || seg->trans == NULL )
 	{
+	  free(seg->remote);
+	  free(seg->trans);
+	  free(seg);
 	  return 1;
 	}
+
+      gctx->rrmd[segment_id] = seg;
     }
 
   return 0;
 }
 
+void
+pgaspi_segment_free_desc( gaspi_context_t * const gctx,
+			  const gaspi_segment_id_t segment_id)
+{
+  gaspi_rc_seg_t * const seg = gctx->rrmd[segment_id];
+
+  if( seg != NULL )
+    {
+      gctx->rrmd[segment_id] = NULL;
+
+      free(seg->remote);
+      free(seg->trans);
+      free(seg);
+    }
+}
+
+/* The notification area in front of the segment data: as many
+   notifications as requested with GASPI_MEM_NOTIFICATIONS (or in the
+   configuration), rounded up to whole pages so that the data stays
+   page aligned. 0 if the number is invalid. */
+size_t
+gaspi_segment_notif_size(const gaspi_alloc_t alloc_policy)
+{
+  gaspi_number_t num = (gaspi_number_t) (alloc_policy >> 32);
+  if( num == 0 )
+    {
+      num = glb_gaspi_cfg.notification_num;
+    }
+
+  const long page_size = sysconf (_SC_PAGESIZE);
+  if( num > GASPI_MAX_NOTIFICATION || page_size < 0 )
+    {
+      return 0;
+    }
+
+  const size_t size = num * sizeof(gaspi_notification_t);
+
+  return (size + page_size - 1) / page_size * page_size;
+}
+
+/* Generation of the last segment (re)allocated, bound or grown */
+static unsigned int gaspi_segment_gen = 0;
+
+/* Our own entry in the remote descriptors, for communication with
+   ourselves. The memory of the segment is new (or has moved): it
+   gets a new generation (with gaspi_mseg_lock held). */
+static void
+pgaspi_segment_set_own_desc( gaspi_context_t * const gctx,
+			     const gaspi_segment_id_t segment_id)
+{
+  gaspi_rc_mseg_t * const local = &(gctx->rrmd[segment_id]->local);
+  gaspi_rc_rseg_t * const own = &(gctx->rrmd[segment_id]->remote[gctx->rank]);
+
+  local->gen = ++gaspi_segment_gen;
+
+  own->addr = local->data.addr;
+  own->notif_addr = local->notif_spc.addr;
+  own->notif_num = local->notif_spc_size / sizeof(gaspi_notification_t);
+  own->gen = local->gen;
+  own->size = local->size;
+
+#ifdef GPI2_DEVICE_IB
+  own->rkey[0] = local->rkey[0];
+  own->rkey[1] = local->rkey[1];
+#endif
+
+#ifdef GPI2_CUDA
+  own->cuda_dev_id = local->cuda_dev_id;
+  own->host_rkey = local->host_rkey;
+  own->host_addr = local->host_addr;
+#endif
+}
+
 #pragma weak gaspi_segment_alloc = pgaspi_segment_alloc
 gaspi_return_t
 pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
@@ -209,7 +392,7 @@ pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
   gaspi_verify_segment_size(size);
   gaspi_verify_segment(segment_id);
 
-  if( gctx->mseg_cnt >= GASPI_MAX_MSEGS )
+  if( gctx->mseg_cnt >= (int) glb_gaspi_cfg.segment_max )
     {
       return GASPI_ERR_MANY_SEG;
     }
@@ -220,6 +403,13 @@ pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
 
   /*  TODO: for now like this, but we need to change this */
 #ifndef GPI2_CUDA
+  const size_t notif_size = gaspi_segment_notif_size(alloc_policy);
+  if( notif_size == 0 )
+    {
+      eret = GASPI_ERR_INV_NUM;
+      goto endL;
+    }
+
   if( pgaspi_segment_create_desc(gctx, segment_id) != 0)
     {
       eret = GASPI_ERR_MEMALLOC;
@@ -228,43 +418,40 @@ pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
 
   /* Already exists?*/
   /* TODO: not really the right way */
-  if( gctx->rrmd[segment_id][gctx->rank].size )
+  if( gctx->rrmd[segment_id]->local.size )
     {
       eret = GASPI_SUCCESS;
       goto endL;
     }
 
-  const long page_size = sysconf (_SC_PAGESIZE);
+  gctx->rrmd[segment_id]->local.data.ptr =
+    gaspi_mem_alloc(size + notif_size, alloc_policy, gctx->localSocket,
+		    &(gctx->rrmd[segment_id]->local.mapped));
 
-  if( page_size < 0 )
+  if( gctx->rrmd[segment_id]->local.data.ptr == NULL )
     {
-      gaspi_print_error ("Failed to get system's page size.");
+      gaspi_print_error ("Memory allocation failed");
+      eret = GASPI_ERR_MEMALLOC;
       goto endL;
     }
 
-  if( posix_memalign((void **) &gctx->rrmd[segment_id][gctx->rank].data.ptr,
-		     page_size,
-		     size + NOTIFY_OFFSET) != 0 )
+  if( alloc_policy & GASPI_MEM_INITIALIZED )
     {
-      gaspi_print_error ("Memory allocation (posix_memalign) failed");
-      eret = GASPI_ERR_MEMALLOC;
-      goto endL;
+      gaspi_mem_zero(gctx->rrmd[segment_id]->local.data.ptr, size + notif_size);
     }
-
-  memset(gctx->rrmd[segment_id][gctx->rank].data.ptr, 0, NOTIFY_OFFSET);
-
-  if( alloc_policy == GASPI_MEM_INITIALIZED)
+  else
     {
-      memset (gctx->rrmd[segment_id][gctx->rank].data.ptr, 0, size + NOTIFY_OFFSET);
+      memset(gctx->rrmd[segment_id]->local.data.ptr, 0, notif_size);
     }
 
-  gctx->rrmd[segment_id][gctx->rank].size = size;
-  gctx->rrmd[segment_id][gctx->rank].notif_spc_size = NOTIFY_OFFSET;
-  gctx->rrmd[segment_id][gctx->rank].notif_spc.addr = gctx->rrmd[segment_id][gctx->rank].data.addr;
-  gctx->rrmd[segment_id][gctx->rank].data.addr += NOTIFY_OFFSET;
-  gctx->rrmd[segment_id][gctx->rank].user_provided = 0;
+  gctx->rrmd[segment_id]->local.size = size;
+  gctx->rrmd[segment_id]->local.notif_spc_size = notif_size;
+  gctx->rrmd[segment_id]->local.notif_spc.addr = gctx->rrmd[segment_id]->local.data.addr;
+  gctx->rrmd[segment_id]->local.data.addr += notif_size;
+  gctx->rrmd[segment_id]->local.user_provided = 0;
+  gctx->rrmd[segment_id]->local.alloc_policy = alloc_policy;
 
-  if( pgaspi_dev_register_mem(&(gctx->rrmd[segment_id][gctx->rank])) < 0 )
+  if( pgaspi_dev_register_mem(&(gctx->rrmd[segment_id]->local)) < 0 )
     {
       goto endL;
     }
@@ -275,6 +462,8 @@ pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
     goto endL;
 #endif /* GPI2_CUDA */
 
+  pgaspi_segment_set_own_desc(gctx, segment_id);
+
   gctx->mseg_cnt++;
 
   eret = GASPI_SUCCESS;
@@ -284,6 +473,264 @@ pgaspi_segment_alloc (const gaspi_segment_id_t segment_id,
 
 }
 
+/* Registration cache for user memory (gaspi_segment_bind/use).
+   Registrations outlive their segments and are reused for memory
+   inside a registered range. Up to reg_cache unused ones are kept;
+   beyond that the least recently used are released in a batch, down
+   to half of it. gaspi_segment_bind_invalidate drops the ones of
+   memory about to be freed. All under gaspi_mseg_lock. */
+struct gaspi_reg_entry
+{
+  struct gaspi_reg_entry *next;
+  gaspi_rc_mseg_t reg;
+  unsigned int refs;
+  int stale;
+  unsigned long last_use;
+};
+
+static struct gaspi_reg_entry *gaspi_reg_cache = NULL;
+static unsigned int gaspi_reg_cache_unused = 0;
+static unsigned long gaspi_reg_cache_clock = 0;
+
+static int
+_gaspi_reg_cache_drop(struct gaspi_reg_entry * const entry)
+{
+  const int ret = pgaspi_dev_unregister_mem(&(entry->reg));
+
+  gaspi_reg_cache_unused--;
+  free(entry);
+
+  return ret;
+}
+
+/* Release the unused stale registrations and the least recently used
+   ones beyond keep */
+static int
+_gaspi_reg_cache_trim(const unsigned int keep)
+{
+  struct gaspi_reg_entry **prev = &gaspi_reg_cache;
+  int ret = 0;
+
+  while( *prev != NULL )
+    {
+      struct gaspi_reg_entry * const entry = *prev;
+      if( entry->refs == 0 && entry->stale )
+	{
+	  *prev = entry->next;
+	  ret |= _gaspi_reg_cache_drop(entry);
+	}
+      else
+	{
+	  prev = &(entry->next);
+	}
+    }
+
+  while( gaspi_reg_cache_unused > keep )
+    {
+      struct gaspi_reg_entry **oldest = NULL;
+      for(prev = &gaspi_reg_cache; *prev != NULL; prev = &((*prev)->next))
+	{
+	  if( (*prev)->refs == 0
+	      && (oldest == NULL || (*prev)->last_use < (*oldest)->last_use) )
+	    {
+	      oldest = prev;
+	    }
+	}
+
+      struct gaspi_reg_entry * const entry = *oldest;
+      *oldest = entry->next;
+      ret |= _gaspi_reg_cache_drop(entry);
+    }
+
+  return ret;
+}
+
+static int
+_gaspi_reg_cache_acquire(gaspi_rc_mseg_t * const seg)
+{
+  struct gaspi_reg_entry *entry;
+
+  for(entry = gaspi_reg_cache; entry != NULL; entry = entry->next)
+    {
+      if( !entry->stale
+	  && seg->data.addr >= entry->reg.data.addr
+	  && seg->data.addr + seg->size <= entry->reg.data.addr + entry->reg.size )
+	{
+	  if( entry->refs++ == 0 )
+	    {
+	      gaspi_reg_cache_unused--;
+	    }
+	  goto foundL;
+	}
+    }
+
+  entry = (struct gaspi_reg_entry *) calloc(1, sizeof(struct gaspi_reg_entry));
+  if( entry == NULL )
+    {
+      return -1;
+    }
+
+  entry->reg.data.buf = seg->data.buf;
+  entry->reg.size = seg->size;
+
+  if( pgaspi_dev_register_mem(&(entry->reg)) < 0 )
+    {
+      free(entry);
+      return -1;
+    }
+
+  entry->refs = 1;
+  entry->next = gaspi_reg_cache;
+  gaspi_reg_cache = entry;
+
+ foundL:
+  seg->reg = entry;
+  seg->mr[0] = entry->reg.mr[0];
+#ifdef GPI2_DEVICE_IB
+  seg->rkey[0] = entry->reg.rkey[0];
+#endif
+
+  return 0;
+}
+
+static int
+_gaspi_reg_cache_release(gaspi_rc_mseg_t * const seg)
+{
+  struct gaspi_reg_entry * const entry = seg->reg;
+
+  seg->reg = NULL;
+  seg->mr[0] = NULL;
+
+  if( --entry->refs > 0 )
+    {
+      return 0;
+    }
+
+  entry->last_use = ++gaspi_reg_cache_clock;
+  gaspi_reg_cache_unused++;
+
+  if( entry->stale )
+    {
+      return _gaspi_reg_cache_trim(gaspi_reg_cache_unused);
+    }
+
+  if( gaspi_reg_cache_unused > glb_gaspi_cfg.reg_cache )
+    {
+      return _gaspi_reg_cache_trim(glb_gaspi_cfg.reg_cache / 2);
+    }
+
+  return 0;
+}
+
+int
+gaspi_segment_reg_cache_flush(void)
+{
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+  const int ret = _gaspi_reg_cache_trim(0);
+  unlock_gaspi(&gaspi_mseg_lock);
+
+  return ret;
+}
+
+#pragma weak gaspi_segment_bind_invalidate = pgaspi_segment_bind_invalidate
+gaspi_return_t
+pgaspi_segment_bind_invalidate(gaspi_pointer_t const pointer,
+			       gaspi_size_t const size)
+{
+  gaspi_verify_null_ptr(pointer);
+
+  const unsigned long begin = (unsigned long) pointer;
+  struct gaspi_reg_entry *entry;
+
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  for(entry = gaspi_reg_cache; entry != NULL; entry = entry->next)
+    {
+      if( begin < entry->reg.data.addr + entry->reg.size
+	  && entry->reg.data.addr < begin + size )
+	{
+	  entry->stale = 1;
+	}
+    }
+
+  const int ret = _gaspi_reg_cache_trim(gaspi_reg_cache_unused);
+
+  unlock_gaspi(&gaspi_mseg_lock);
+
+  return ret == 0 ? GASPI_SUCCESS : GASPI_ERR_DEVICE;
+}
+
+/* Register a user-provided segment: the data through the cache, the
+   notifications (always our own) on their own */
+static int
+_gaspi_segment_register_user(gaspi_rc_mseg_t * const seg)
+{
+  if( _gaspi_reg_cache_acquire(seg) != 0 )
+    {
+      return -1;
+    }
+
+  gaspi_rc_mseg_t notif;
+  memset(&notif, 0, sizeof(notif));
+  notif.data.buf = seg->notif_spc.buf;
+  notif.size = seg->notif_spc_size;
+
+  if( pgaspi_dev_register_mem(&notif) < 0 )
+    {
+      _gaspi_reg_cache_release(seg);
+      return -1;
+    }
+
+  seg->mr[1] = notif.mr[0];
+#ifdef GPI2_DEVICE_IB
+  seg->rkey[1] = notif.rkey[0];
+#endif
+
+  return 0;
+}
+
+static int
+_gaspi_segment_unregister_user(gaspi_rc_mseg_t * const seg)
+{
+  gaspi_rc_mseg_t notif;
+  memset(&notif, 0, sizeof(notif));
+  notif.mr[0] = seg->mr[1];
+
+  int ret = pgaspi_dev_unregister_mem(&notif);
+  seg->mr[1] = NULL;
+
+  if( _gaspi_reg_cache_release(seg) != 0 )
+    {
+      ret = -1;
+    }
+
+  return ret;
+}
+
+/* Tell the ranks that fetched a segment (lazy registration) that
+   this generation of it is gone. A rank that cannot be reached (e.g.
+   it terminated) has nothing to forget. */
+static void
+_gaspi_segment_drop_fetched(gaspi_segment_descriptor_t const * const gone,
+			    gaspi_rank_t const * const fetched,
+			    const int nfetched)
+{
+  if( nfetched == 0 )
+    {
+      return;
+    }
+
+  lock_gaspi_tout(&glb_gaspi_ctx_lock, GASPI_BLOCK);
+
+  int f;
+  for(f = 0; f < nfetched; f++)
+    {
+      gaspi_sn_command(GASPI_SN_SEG_DROP, fetched[f], GASPI_BLOCK, (void *) gone);
+    }
+
+  unlock_gaspi(&glb_gaspi_ctx_lock);
+}
+
 #pragma weak gaspi_segment_delete = pgaspi_segment_delete
 gaspi_return_t
 pgaspi_segment_delete (const gaspi_segment_id_t segment_id)
@@ -292,19 +739,31 @@ pgaspi_segment_delete (const gaspi_segment_id_t segment_id)
 
   gaspi_verify_init("gaspi_segment_delete");
   gaspi_verify_segment(segment_id);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id]);
+  gaspi_verify_segment_desc(segment_id);
 
-  gaspi_verify_segment_size(gctx->rrmd[segment_id][gctx->rank].size);
+  gaspi_verify_segment_size(gctx->rrmd[segment_id]->local.size);
 
   gaspi_return_t eret = GASPI_ERROR;
 
+  /* Ranks that fetched the segment (lazy registration) */
+  gaspi_rank_t *fetched = NULL;
+  int nfetched = 0;
+
+  gaspi_segment_descriptor_t gone;
+  memset(&gone, 0, sizeof(gone));
+  gone.seg_id = segment_id;
+
   lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
 
   /*  TODO: for now like this but we need a better solution */
 #ifdef GPI2_CUDA
   eret = pgaspi_dev_segment_delete(segment_id);
 #else
-  if(pgaspi_dev_unregister_mem(&(gctx->rrmd[segment_id][gctx->rank])) < 0)
+  const int unreg = gctx->rrmd[segment_id]->local.reg != NULL
+    ? _gaspi_segment_unregister_user(&(gctx->rrmd[segment_id]->local))
+    : pgaspi_dev_unregister_mem(&(gctx->rrmd[segment_id]->local));
+
+  if( unreg < 0 )
     {
       unlock_gaspi (&gaspi_mseg_lock);
       return GASPI_ERR_DEVICE;
@@ -313,26 +772,56 @@ pgaspi_segment_delete (const gaspi_segment_id_t segment_id)
   /* For both "normal" and user-provided segments, the notif_spc
      points to begin of memory and only the size changes.
   */
-  free (gctx->rrmd[segment_id][gctx->rank].notif_spc.buf);
-
-  gctx->rrmd[segment_id][gctx->rank].data.buf = NULL;
-  gctx->rrmd[segment_id][gctx->rank].notif_spc.buf = NULL;
-  gctx->rrmd[segment_id][gctx->rank].size = 0;
-  gctx->rrmd[segment_id][gctx->rank].notif_spc_size = 0;
-  gctx->rrmd[segment_id][gctx->rank].trans = 0;
-  gctx->rrmd[segment_id][gctx->rank].mr[0] = NULL;
-  gctx->rrmd[segment_id][gctx->rank].mr[1] = NULL;
+  gaspi_mem_free(gctx->rrmd[segment_id]->local.notif_spc.buf,
+		 gctx->rrmd[segment_id]->local.mapped);
+
+  gctx->rrmd[segment_id]->local.data.buf = NULL;
+  gctx->rrmd[segment_id]->local.notif_spc.buf = NULL;
+  gctx->rrmd[segment_id]->local.size = 0;
+  gctx->rrmd[segment_id]->local.notif_spc_size = 0;
+  gctx->rrmd[segment_id]->local.mapped = 0;
+  gctx->rrmd[segment_id]->local.alloc_policy = 0;
+  gaspi_sym_heap_destroy(gctx->rrmd[segment_id]->local.sym_heap);
+  gctx->rrmd[segment_id]->local.sym_heap = NULL;
+  gaspi_seg_pool_destroy(gctx->rrmd[segment_id]->local.pool);
+  gctx->rrmd[segment_id]->local.pool = NULL;
+  gctx->rrmd[segment_id]->trans[gctx->rank] = 0;
+  gctx->rrmd[segment_id]->local.mr[0] = NULL;
+  gctx->rrmd[segment_id]->local.mr[1] = NULL;
 #ifdef GPI2_DEVICE_IB
-  gctx->rrmd[segment_id][gctx->rank].rkey[0] = 0;
-  gctx->rrmd[segment_id][gctx->rank].rkey[1] = 0;
+  gctx->rrmd[segment_id]->local.rkey[0] = 0;
+  gctx->rrmd[segment_id]->local.rkey[1] = 0;
 #endif
-  gctx->rrmd[segment_id][gctx->rank].user_provided = 0;
+  gctx->rrmd[segment_id]->local.user_provided = 0;
+
+  /* Lazily fetched descriptors are stale once the segment is gone,
+     ours and those of the segment on others */
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      memset(gctx->rrmd[segment_id]->remote, 0, gctx->tnc * sizeof(gaspi_rc_rseg_t));
+
+      gone.gen = gctx->rrmd[segment_id]->local.gen;
+      fetched = (gaspi_rank_t *) malloc(gctx->tnc * sizeof(gaspi_rank_t));
+
+      int r;
+      for(r = 0; fetched != NULL && r < gctx->tnc; r++)
+	{
+	  if( r != gctx->rank && gctx->rrmd[segment_id]->trans[r] )
+	    {
+	      fetched[nfetched++] = (gaspi_rank_t) r;
+	    }
+	}
+    }
+  else
+    {
+      memset(&(gctx->rrmd[segment_id]->remote[gctx->rank]), 0, sizeof(gaspi_rc_rseg_t));
+    }
 
   /* Reset trans info flag for all ranks */
   int r;
   for(r = 0; r < gctx->tnc; r++)
     {
-      gctx->rrmd[segment_id][r].trans = 0;
+      gctx->rrmd[segment_id]->trans[r] = 0;
     }
 
   eret = GASPI_SUCCESS;
@@ -342,6 +831,10 @@ pgaspi_segment_delete (const gaspi_segment_id_t segment_id)
 
   unlock_gaspi (&gaspi_mseg_lock);
 
+  /* Done before the id can be used again */
+  _gaspi_segment_drop_fetched(&gone, fetched, nfetched);
+  free(fetched);
+
   return eret;
 }
 
@@ -355,14 +848,14 @@ pgaspi_segment_register(const gaspi_segment_id_t segment_id,
 
   gaspi_verify_init("gaspi_segment_register");
   gaspi_verify_segment(segment_id);
-  gaspi_verify_null_ptr(gctx->rrmd[segment_id]);
+  gaspi_verify_segment_desc(segment_id);
   gaspi_verify_rank(rank);
 
-  gaspi_verify_segment_size(gctx->rrmd[segment_id][gctx->rank].size);
+  gaspi_verify_segment_size(gctx->rrmd[segment_id]->local.size);
 
   if( rank == gctx->rank )
     {
-      gctx->rrmd[segment_id][rank].trans = 1;
+      gctx->rrmd[segment_id]->trans[rank] = 1;
       return GASPI_SUCCESS;
     }
 
@@ -373,7 +866,7 @@ pgaspi_segment_register(const gaspi_segment_id_t segment_id,
 
   gaspi_return_t eret = gaspi_sn_command(GASPI_SN_SEG_REGISTER, rank, timeout_ms, (void *) &segment_id);
 
-  gctx->rrmd[segment_id][rank].trans = 1;
+  gctx->rrmd[segment_id]->trans[rank] = 1;
 
   unlock_gaspi(&glb_gaspi_ctx_lock);
 
@@ -391,51 +884,150 @@ gaspi_segment_set(const gaspi_segment_descriptor_t snp)
       return -1;
     }
 
-  if( snp.seg_id < 0 || snp.seg_id >= GASPI_MAX_MSEGS )
+  if( snp.seg_id < 0 || snp.seg_id >= GASPI_MAX_MSEGS_LIMIT )
     {
       return -1;
     }
 
   lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
 
-  //TODO: use segment_create_desc
-  if( gctx->rrmd[snp.seg_id] == NULL )
+  if( pgaspi_segment_create_desc(gctx, (gaspi_segment_id_t) snp.seg_id) != 0 )
     {
-      gctx->rrmd[snp.seg_id] = (gaspi_rc_mseg_t *) calloc (gctx->tnc, sizeof (gaspi_rc_mseg_t));
-
-      if( gctx->rrmd[snp.seg_id] == NULL )
-	{
-	  unlock_gaspi(&gaspi_mseg_lock);
-	  return -1;
-	}
+      unlock_gaspi(&gaspi_mseg_lock);
+      return -1;
     }
 
   /* TODO: don't allow re-registration? */
   /* for now we allow re-registration */
-  /* if(gctx->rrmd[snp.seg_id][snp.rem_rank].size) -> re-registration error case */
-  gctx->rrmd[snp.seg_id][snp.rank].data.addr = snp.addr;
-  gctx->rrmd[snp.seg_id][snp.rank].notif_spc.addr = snp.notif_addr;
-  gctx->rrmd[snp.seg_id][snp.rank].size = snp.size;
+  /* if(gctx->rrmd[snp.seg_id]->remote[snp.rem_rank].size) -> re-registration error case */
+  const int changed = gctx->rrmd[snp.seg_id]->remote[snp.rank].size != 0
+    && gctx->rrmd[snp.seg_id]->remote[snp.rank].gen != snp.gen;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].addr = snp.addr;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].notif_addr = snp.notif_addr;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].notif_num = snp.notif_num;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].gen = snp.gen;
 
 #ifdef GPI2_DEVICE_IB
-  gctx->rrmd[snp.seg_id][snp.rank].rkey[0] = snp.rkey[0];
-  gctx->rrmd[snp.seg_id][snp.rank].rkey[1] = snp.rkey[1];
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].rkey[0] = snp.rkey[0];
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].rkey[1] = snp.rkey[1];
 #endif
 
 #ifdef GPI2_CUDA
-  gctx->rrmd[snp.seg_id][snp.rank].host_rkey = snp.host_rkey;
-  gctx->rrmd[snp.seg_id][snp.rank].host_addr = snp.host_addr;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].host_rkey = snp.host_rkey;
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].host_addr = snp.host_addr;
 
   if(snp.host_addr != 0 )
-    gctx->rrmd[snp.seg_id][snp.rank].cuda_dev_id = 1;
+    gctx->rrmd[snp.seg_id]->remote[snp.rank].cuda_dev_id = 1;
   else
-    gctx->rrmd[snp.seg_id][snp.rank].cuda_dev_id = -1;
+    gctx->rrmd[snp.seg_id]->remote[snp.rank].cuda_dev_id = -1;
 #endif
 
+  /* A non-zero size marks the descriptor as known (see
+     gaspi_segment_remote_get): publish it last */
+  __sync_synchronize();
+  gctx->rrmd[snp.seg_id]->remote[snp.rank].size = snp.size;
+
+  if( changed )
+    {
+      gctx->seg_epoch++;
+    }
+
+  unlock_gaspi(&gaspi_mseg_lock);
+  return 0;
+}
+
+int
+gaspi_segment_unset(const gaspi_segment_descriptor_t snp)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( snp.seg_id < 0 || snp.rank < 0 || snp.rank >= gctx->tnc )
+    {
+      return -1;
+    }
+
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  if( (gaspi_number_t) snp.seg_id < gctx->rrmd_size
+      && gctx->rrmd[snp.seg_id] != NULL
+      && gctx->rrmd[snp.seg_id]->remote[snp.rank].gen == snp.gen )
+    {
+      memset(&(gctx->rrmd[snp.seg_id]->remote[snp.rank]), 0, sizeof(gaspi_rc_rseg_t));
+      gctx->seg_epoch++;
+    }
+
   unlock_gaspi(&gaspi_mseg_lock);
   return 0;
 }
 
+/* Get the descriptor of a remote segment from its owner (lazy
+   registration) */
+gaspi_return_t
+pgaspi_segment_fetch(const gaspi_segment_id_t segment_id,
+		     const gaspi_rank_t rank,
+		     const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+
+  if( rank >= gctx->tnc )
+    {
+      return GASPI_ERR_INV_RANK;
+    }
+
+  /* Our own descriptor is set when the segment is allocated */
+  if( rank == gctx->rank )
+    {
+      return GASPI_ERR_INV_SEG;
+    }
+
+  if( lock_gaspi_tout(&glb_gaspi_ctx_lock, timeout_ms) )
+    {
+      return GASPI_TIMEOUT;
+    }
+
+  /* Someone else might have fetched it in the meantime */
+  if( gaspi_segment_remote_known(gctx, segment_id, rank) )
+    {
+      unlock_gaspi(&glb_gaspi_ctx_lock);
+      return GASPI_SUCCESS;
+    }
+
+  gaspi_return_t eret = gaspi_sn_command(GASPI_SN_SEG_FETCH, rank, timeout_ms, (void *) &segment_id);
+
+  unlock_gaspi(&glb_gaspi_ctx_lock);
+
+  if( eret == GASPI_SUCCESS && !gaspi_segment_remote_known(gctx, segment_id, rank) )
+    {
+      return GASPI_ERR_INV_SEG;
+    }
+
+  return eret;
+}
+
+#pragma weak gaspi_segment_prefetch = pgaspi_segment_prefetch
+gaspi_return_t
+pgaspi_segment_prefetch(const gaspi_segment_id_t segment_id,
+			const gaspi_rank_t * const rank_list,
+			const gaspi_number_t num,
+			const gaspi_timeout_t timeout_ms)
+{
+  gaspi_verify_init("gaspi_segment_prefetch");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_null_ptr(rank_list);
+
+  gaspi_number_t n;
+  for(n = 0; n < num; n++)
+    {
+      gaspi_return_t eret = gaspi_segment_remote_get(segment_id, rank_list[n], timeout_ms);
+      if( eret != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
 static gaspi_return_t
 pgaspi_segment_register_group(gaspi_context_t const * const gctx,
 			      const gaspi_segment_id_t segment_id,
@@ -451,13 +1043,15 @@ pgaspi_segment_register_group(gaspi_context_t const * const gctx,
   gaspi_segment_descriptor_t cdh;
   memset(&cdh, 0, sizeof(cdh));
 
-  gaspi_rc_mseg_t const * const mseg_info = &(gctx->rrmd[segment_id][gctx->rank]);
+  gaspi_rc_mseg_t const * const mseg_info = &(gctx->rrmd[segment_id]->local);
 
   cdh.rank = gctx->rank;
   cdh.seg_id = segment_id;
   cdh.addr = mseg_info->data.addr;
   cdh.notif_addr = mseg_info->notif_spc.addr;
+  cdh.notif_num = mseg_info->notif_spc_size / sizeof(gaspi_notification_t);
   cdh.size = mseg_info->size;
+  cdh.gen = mseg_info->gen;
 
 #ifdef GPI2_CUDA
   cdh.host_rkey = mseg_info->host_rkey;
@@ -493,7 +1087,7 @@ pgaspi_segment_register_group(gaspi_context_t const * const gctx,
 	  return GASPI_ERROR;
 	}
 
-      gctx->rrmd[segment_id][r].trans = 1;
+      gctx->rrmd[segment_id]->trans[r] = 1;
     }
 
   free(result);
@@ -524,23 +1118,43 @@ pgaspi_segment_create(const gaspi_segment_id_t segment_id,
     {
       return eret;
     }
-  eret = pgaspi_segment_register_group(gctx, segment_id, group, timeout_ms);
-  if( eret != GASPI_SUCCESS )
+  if( glb_gaspi_cfg.segment_lazy )
     {
-      unlock_gaspi(&glb_gaspi_ctx_lock);
-      return eret;
+      gctx->rrmd[segment_id]->trans[gctx->rank] = 1;
+    }
+  else
+    {
+      eret = pgaspi_segment_register_group(gctx, segment_id, group, timeout_ms);
+      if( eret != GASPI_SUCCESS )
+	{
+	  unlock_gaspi(&glb_gaspi_ctx_lock);
+	  return eret;
+	}
     }
 
   if( GASPI_TOPOLOGY_STATIC == glb_gaspi_cfg.build_infrastructure )
     {
+      const int first = glb_gaspi_group_ctx[group].rank;
+      const int num = glb_gaspi_group_ctx[group].tnc - first;
+
+      gaspi_rank_t * const ranks = (gaspi_rank_t *) malloc(num * sizeof(gaspi_rank_t));
+      if( ranks == NULL )
+	{
+	  return GASPI_ERR_MEMALLOC;
+	}
+
       int r;
-      for(r = glb_gaspi_group_ctx[group].rank; r < glb_gaspi_group_ctx[group].tnc; r++)
+      for(r = 0; r < num; r++)
 	{
-	  eret = pgaspi_connect(glb_gaspi_group_ctx[group].rank_grp[r], timeout_ms);
-	  if( eret != GASPI_SUCCESS )
-	    {
-	      return eret;
-	    }
+	  ranks[r] = (gaspi_rank_t) glb_gaspi_group_ctx[group].rank_grp[first + r];
+	}
+
+      eret = pgaspi_connect_many(ranks, num, timeout_ms);
+      free(ranks);
+
+      if( eret != GASPI_SUCCESS )
+	{
+	  return eret;
 	}
     }
 
@@ -567,9 +1181,7 @@ pgaspi_segment_bind ( gaspi_segment_id_t const segment_id,
   gaspi_verify_segment_size(size);
   gaspi_verify_segment(segment_id);
 
-  const int myrank = (int) gctx->rank;
-
-  if( gctx->mseg_cnt >= GASPI_MAX_MSEGS )
+  if( gctx->mseg_cnt >= (int) glb_gaspi_cfg.segment_max )
     {
       return GASPI_ERR_MANY_SEG;
     }
@@ -584,7 +1196,7 @@ pgaspi_segment_bind ( gaspi_segment_id_t const segment_id,
       goto endL;
     }
 
-  if( gctx->rrmd[segment_id][myrank].size )
+  if( gctx->rrmd[segment_id]->local.size )
     {
       eret = GASPI_SUCCESS;
       goto endL;
@@ -599,35 +1211,45 @@ pgaspi_segment_bind ( gaspi_segment_id_t const segment_id,
       goto endL;
     }
 
-  if( posix_memalign( (void **) &gctx->rrmd[segment_id][myrank].notif_spc.ptr,
+  const size_t notif_size = gaspi_segment_notif_size(GASPI_ALLOC_DEFAULT);
+
+  if( posix_memalign( (void **) &gctx->rrmd[segment_id]->local.notif_spc.ptr,
 		      page_size,
-		      NOTIFY_OFFSET) != 0 )
+		      notif_size) != 0 )
     {
       gaspi_print_error ("Memory allocation failed.");
       eret = GASPI_ERR_MEMALLOC;
       goto endL;
     }
 
-  memset (gctx->rrmd[segment_id][myrank].notif_spc.ptr, 0, NOTIFY_OFFSET);
+  memset (gctx->rrmd[segment_id]->local.notif_spc.ptr, 0, notif_size);
 
   /* Set the segment data pointer and size */
-  gctx->rrmd[segment_id][myrank].data.ptr = pointer;
-  gctx->rrmd[segment_id][myrank].size = size;
+  gctx->rrmd[segment_id]->local.data.ptr = pointer;
+  gctx->rrmd[segment_id]->local.size = size;
 
-  gctx->rrmd[segment_id][myrank].notif_spc_size = NOTIFY_OFFSET;
+  gctx->rrmd[segment_id]->local.notif_spc_size = notif_size;
 
-  gctx->rrmd[segment_id][glb_gaspi_ctx.rank].user_provided = 1;
+  gctx->rrmd[segment_id]->local.user_provided = 1;
 
   /* TODO: what to do with the memory description?? */
-  gctx->rrmd[segment_id][myrank].desc = memory_description;
+  gctx->rrmd[segment_id]->local.desc = memory_description;
 
   /* Register segment with the device */
-  if( pgaspi_dev_register_mem( &(gctx->rrmd[segment_id][myrank])) < 0)
+  if( _gaspi_segment_register_user(&(gctx->rrmd[segment_id]->local)) != 0 )
     {
+      free(gctx->rrmd[segment_id]->local.notif_spc.ptr);
+      gctx->rrmd[segment_id]->local.notif_spc.ptr = NULL;
+      gctx->rrmd[segment_id]->local.data.ptr = NULL;
+      gctx->rrmd[segment_id]->local.size = 0;
+      gctx->rrmd[segment_id]->local.notif_spc_size = 0;
+      gctx->rrmd[segment_id]->local.user_provided = 0;
       eret = GASPI_ERR_DEVICE;
       goto endL;
     }
 
+  pgaspi_segment_set_own_desc(gctx, segment_id);
+
   gctx->mseg_cnt++;
 
   eret = GASPI_SUCCESS;
@@ -654,11 +1276,201 @@ pgaspi_segment_use ( gaspi_segment_id_t const segment_id,
       return ret;
     }
 
-  gaspi_return_t eret = pgaspi_segment_register_group(gctx, segment_id, group, timeout);
+  if( glb_gaspi_cfg.segment_lazy )
+    {
+      gctx->rrmd[segment_id]->trans[gctx->rank] = 1;
+    }
+  else
+    {
+      gaspi_return_t eret = pgaspi_segment_register_group(gctx, segment_id, group, timeout);
+      if( eret != GASPI_SUCCESS )
+	{
+	  return eret;
+	}
+    }
+
+  return gaspi_barrier( group, timeout);
+}
+
+/* Grow the memory of a segment (under gaspi_mseg_lock). The data keeps
+   its offset behind the notifications. If the memory stayed in place
+   only the data needs a new registration, otherwise the whole
+   segment. */
+static gaspi_return_t
+_gaspi_segment_grow(gaspi_context_t * const gctx,
+		    const gaspi_segment_id_t segment_id,
+		    const gaspi_size_t new_size)
+{
+  gaspi_rc_mseg_t * const local = &(gctx->rrmd[segment_id]->local);
+  gaspi_rc_mseg_t grown = *local;
+
+  void * const mem = gaspi_mem_grow(local->notif_spc.ptr,
+				    local->notif_spc_size + local->size,
+				    local->notif_spc_size + new_size,
+				    local->alloc_policy, gctx->localSocket,
+				    &(grown.mapped));
+  if( mem == NULL )
+    {
+      gaspi_print_error("Failed to grow segment %d", segment_id);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  grown.notif_spc.ptr = mem;
+  grown.data.addr = grown.notif_spc.addr + local->notif_spc_size;
+  grown.size = new_size;
+
+  if( local->alloc_policy & GASPI_MEM_INITIALIZED )
+    {
+      memset(grown.data.buf + local->size, 0, new_size - local->size);
+    }
+
+  gaspi_rc_mseg_t old;
+  memset(&old, 0, sizeof(old));
+  old.mr[0] = local->mr[0];
+
+  if( mem == local->notif_spc.ptr )
+    {
+      gaspi_rc_mseg_t data;
+      memset(&data, 0, sizeof(data));
+      data.data.buf = grown.data.buf;
+      data.size = new_size;
+
+      if( pgaspi_dev_register_mem(&data) < 0 )
+	{
+	  local->mapped = grown.mapped;
+	  return GASPI_ERR_DEVICE;
+	}
+
+      grown.mr[0] = data.mr[0];
+#ifdef GPI2_DEVICE_IB
+      grown.rkey[0] = data.rkey[0];
+#endif
+    }
+  else
+    {
+      old.mr[1] = local->mr[1];
+
+      if( pgaspi_dev_register_mem(&grown) < 0 )
+	{
+	  /* The old memory is gone */
+	  *local = grown;
+	  return GASPI_ERR_DEVICE;
+	}
+    }
+
+  *local = grown;
+
+  if( pgaspi_dev_unregister_mem(&old) < 0 )
+    {
+      return GASPI_ERR_DEVICE;
+    }
+
+  if( gaspi_sym_heap_grow(local->sym_heap, new_size) != 0
+      || gaspi_seg_pool_grow(local->pool, new_size) != 0 )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  return GASPI_SUCCESS;
+}
+
+#pragma weak gaspi_segment_resize = pgaspi_segment_resize
+gaspi_return_t
+pgaspi_segment_resize (const gaspi_segment_id_t segment_id,
+		       const gaspi_size_t new_size,
+		       const gaspi_group_t group,
+		       const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  gaspi_verify_init("gaspi_segment_resize");
+  gaspi_verify_segment(segment_id);
+  gaspi_verify_segment_desc(segment_id);
+  gaspi_verify_segment_size(new_size);
+  gaspi_verify_group(group);
+
+#ifdef GPI2_CUDA
+  return GASPI_ERROR;
+#else
+  lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+
+  gaspi_rc_mseg_t * const local = &(gctx->rrmd[segment_id]->local);
+
+  /* Memory of the application cannot be grown by us */
+  if( local->size == 0 || local->user_provided )
+    {
+      unlock_gaspi(&gaspi_mseg_lock);
+      return GASPI_ERR_INV_SEG;
+    }
+
+  if( new_size < local->size )
+    {
+      unlock_gaspi(&gaspi_mseg_lock);
+      return GASPI_ERR_INV_SEGSIZE;
+    }
+
+  /* Ranks outside the group that fetched the segment (lazy
+     registration) forget it and fetch it again */
+  gaspi_rank_t *fetched = NULL;
+  int nfetched = 0;
+
+  gaspi_segment_descriptor_t gone;
+  memset(&gone, 0, sizeof(gone));
+  gone.seg_id = segment_id;
+  gone.gen = local->gen;
+
+  if( new_size > local->size )
+    {
+      if( glb_gaspi_cfg.segment_lazy )
+	{
+	  gaspi_group_ctx_t const * const grp_ctx = &(glb_gaspi_group_ctx[group]);
+	  unsigned char * const in_group = calloc(gctx->tnc, sizeof(unsigned char));
+	  fetched = (gaspi_rank_t *) malloc(gctx->tnc * sizeof(gaspi_rank_t));
+
+	  int r;
+	  for(r = 0; in_group != NULL && r < grp_ctx->tnc; r++)
+	    {
+	      in_group[grp_ctx->rank_grp[r]] = 1;
+	    }
+
+	  for(r = 0; in_group != NULL && fetched != NULL && r < gctx->tnc; r++)
+	    {
+	      if( !in_group[r] && gctx->rrmd[segment_id]->trans[r] )
+		{
+		  fetched[nfetched++] = (gaspi_rank_t) r;
+		}
+	    }
+
+	  free(in_group);
+	}
+
+      const gaspi_return_t eret = _gaspi_segment_grow(gctx, segment_id, new_size);
+      if( eret != GASPI_SUCCESS )
+	{
+	  unlock_gaspi(&gaspi_mseg_lock);
+	  free(fetched);
+	  return eret;
+	}
+
+      pgaspi_segment_set_own_desc(gctx, segment_id);
+
+      /* Plans with the segment are built again */
+      gctx->seg_epoch++;
+    }
+
+  unlock_gaspi(&gaspi_mseg_lock);
+
+  _gaspi_segment_drop_fetched(&gone, fetched, nfetched);
+  free(fetched);
+
+  /* The new descriptors, also of the ranks whose segment did not
+     change */
+  const gaspi_return_t eret = pgaspi_segment_register_group(gctx, segment_id, group, timeout_ms);
   if( eret != GASPI_SUCCESS )
     {
       return eret;
     }
 
-  return gaspi_barrier( group, timeout);
+  return gaspi_barrier(group, timeout_ms);
+#endif
 }
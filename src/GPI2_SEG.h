@@ -19,6 +19,9 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #ifndef _GPI2_SEG_H_
 #define _GPI2_SEG_H_ 1
 
+#include "GPI2.h"
+#include "GPI2_Types.h"
+
 typedef struct
 {
   int rank;
@@ -27,6 +30,8 @@ typedef struct
   unsigned long addr;
   unsigned long size;
   unsigned long notif_addr;
+  unsigned int notif_num;
+  unsigned int gen;
 
 #ifdef GPI2_CUDA
   int host_rkey;
@@ -42,4 +47,83 @@ typedef struct
 int
 gaspi_segment_set(const gaspi_segment_descriptor_t snp);
 
+/* Forget the descriptor of a remote segment if it is still the given
+   generation (its owner deleted it) */
+int
+gaspi_segment_unset(const gaspi_segment_descriptor_t snp);
+
+size_t
+gaspi_segment_notif_size(const gaspi_alloc_t alloc_policy);
+
+int
+gaspi_segment_table_init(gaspi_context_t * const gctx);
+
+/* Make room for segment_id (with gaspi_mseg_lock held) */
+int
+gaspi_segment_table_grow(gaspi_context_t * const gctx,
+			 const gaspi_segment_id_t segment_id);
+
+void
+gaspi_segment_table_free(gaspi_context_t * const gctx);
+
+/* Release the cached registrations of user memory no longer in use */
+int
+gaspi_segment_reg_cache_flush(void);
+
+int
+pgaspi_segment_create_desc(gaspi_context_t * const gctx,
+			   const gaspi_segment_id_t segment_id);
+
+void
+pgaspi_segment_free_desc(gaspi_context_t * const gctx,
+			 const gaspi_segment_id_t segment_id);
+
+gaspi_return_t
+pgaspi_segment_fetch(const gaspi_segment_id_t segment_id,
+		     const gaspi_rank_t rank,
+		     const gaspi_timeout_t timeout_ms);
+
+static inline int
+gaspi_segment_remote_known(gaspi_context_t const * const gctx,
+			   const gaspi_segment_id_t segment_id,
+			   const gaspi_rank_t rank)
+{
+  return segment_id < gctx->rrmd_size
+    && gctx->rrmd[segment_id] != NULL
+    && gctx->rrmd[segment_id]->remote[rank].size != 0;
+}
+
+extern gaspi_config_t glb_gaspi_cfg;
+
+/* With lazy registration (segment_lazy) the descriptor of a remote
+   segment is fetched from its owner on first use and kept until the
+   segment is deleted, here or by its owner. */
+static inline gaspi_return_t
+gaspi_segment_remote_get(const gaspi_segment_id_t segment_id,
+			 const gaspi_rank_t rank,
+			 const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+
+  if( rank < gctx->tnc && gaspi_segment_remote_known(gctx, segment_id, rank) )
+    {
+      return GASPI_SUCCESS;
+    }
+
+  return pgaspi_segment_fetch(segment_id, rank, timeout_ms);
+}
+
+#define gaspi_segment_remote_require(seg, rank, timeout_ms)		\
+  {									\
+    if( glb_gaspi_cfg.segment_lazy )					\
+      {									\
+	const gaspi_return_t _eret =					\
+	  gaspi_segment_remote_get(seg, rank, timeout_ms);		\
+	if( _eret != GASPI_SUCCESS )					\
+	  {								\
+	    return _eret;						\
+	  }								\
+      }									\
+  }
+
 #endif //_GPI2_SEG_H_
@@ -20,6 +20,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <signal.h>
 #include <sys/resource.h>
 #include <sys/socket.h>
@@ -593,6 +594,8 @@ gaspi_sn_segment_register(const gaspi_cd_header snp)
   seg_desc.addr = snp.addr;
   seg_desc.size = snp.size;
   seg_desc.notif_addr = snp.notif_addr;
+  seg_desc.notif_num = snp.notif_num;
+  seg_desc.gen = (unsigned int) snp.seg_gen;
 
 #ifdef GPI2_CUDA
   seg_desc.host_rkey = snp.host_rkey;
@@ -645,8 +648,9 @@ gaspi_sn_connect_to_rank(const gaspi_rank_t rank, const gaspi_timeout_t timeout_
   return GASPI_SUCCESS;
 }
 
-static inline int
-_gaspi_sn_connect_command(const gaspi_rank_t rank)
+/* Our connection info to rank, to be answered with its own */
+static int
+_gaspi_sn_connect_request(const int sockfd, const gaspi_rank_t rank)
 {
   gaspi_context_t const * const gctx = &glb_gaspi_ctx;
   const int i = (int) rank;
@@ -659,34 +663,304 @@ _gaspi_sn_connect_command(const gaspi_rank_t rank)
   cdh.op = GASPI_SN_CONNECT;
   cdh.rank = gctx->rank;
 
+  ssize_t ret = gaspi_sn_writen(sockfd, &cdh, sizeof(gaspi_cd_header));
+  if(ret != sizeof(gaspi_cd_header))
+    {
+      gaspi_print_error("Failed to write to %d", i);
+      return -1;
+    }
+
+  ret = gaspi_sn_writen(sockfd, pgaspi_dev_get_lrcd(i), rc_size);
+  if(ret != (ssize_t) rc_size)
+    {
+      gaspi_print_error("Failed to write to %d", i);
+      return -1;
+    }
+
+  return 0;
+}
+
+static int
+_gaspi_sn_connect_reply(const int sockfd, const gaspi_rank_t rank)
+{
+  const size_t rc_size = pgaspi_dev_get_sizeof_rc();
+  char *remote_info = pgaspi_dev_get_rrcd((int) rank);
+
+  ssize_t rret = gaspi_sn_readn(sockfd, remote_info, rc_size);
+  if( rret != (ssize_t) rc_size )
+    {
+      gaspi_print_error("Failed to read from %u", rank);
+      return -1;
+    }
+
+  return 0;
+}
+
+static inline int
+_gaspi_sn_connect_command(const gaspi_rank_t rank)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  const int i = (int) rank;
+
   /* if we have something to exchange */
-  if(rc_size > 0 )
+  if( pgaspi_dev_get_sizeof_rc() > 0 )
     {
-      ssize_t ret = gaspi_sn_writen(gctx->sockfd[i], &cdh, sizeof(gaspi_cd_header));
-      if(ret != sizeof(gaspi_cd_header))
+      if( _gaspi_sn_connect_request(gctx->sockfd[i], rank) != 0 )
 	{
-	  gaspi_print_error("Failed to write to %d", i);
 	  return -1;
 	}
 
-      ret = gaspi_sn_writen(gctx->sockfd[i], pgaspi_dev_get_lrcd(i), rc_size);
-      if(ret != (ssize_t) rc_size)
+      if( _gaspi_sn_connect_reply(gctx->sockfd[i], rank) != 0 )
 	{
-	  gaspi_print_error("Failed to write to %d", i);
 	  return -1;
 	}
+    }
 
-      char *remote_info = pgaspi_dev_get_rrcd(i);
+  return 0;
+}
 
-      ssize_t rret = gaspi_sn_readn(gctx->sockfd[i], remote_info, rc_size);
-      if( rret != (ssize_t) rc_size )
+/* Start a connection to the SN of rank without waiting for it.
+   Returns the socket, -3 if the SN of rank does not accept connections
+   (yet), -2 if out of file descriptors and -1 on any other error. */
+static int
+_gaspi_sn_connect_start(const gaspi_rank_t rank)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  struct sockaddr_in host;
+  struct hostent *server_data;
+
+  int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  if( -1 == sockfd )
+    {
+      if( errno == EMFILE && 0 == _gaspi_check_set_ofile_limit() )
 	{
-	  gaspi_print_error("Failed to read from %d", i);
-	  return -1;
+	  sockfd = socket(AF_INET, SOCK_STREAM, 0);
+	}
+
+      if( -1 == sockfd )
+	{
+	  return (errno == EMFILE) ? -2 : -1;
 	}
     }
 
-  return 0;
+  host.sin_family = AF_INET;
+  host.sin_port = htons(glb_gaspi_cfg.sn_port + gctx->poff[rank]);
+
+  if( (server_data = gethostbyname(pgaspi_gethostname(rank))) == NULL )
+    {
+      close(sockfd);
+      return -1;
+    }
+
+  memcpy(&host.sin_addr, server_data->h_addr, server_data->h_length);
+
+  if( gaspi_sn_set_non_blocking(sockfd) != 0 )
+    {
+      close(sockfd);
+      return -1;
+    }
+
+  if( connect(sockfd, (struct sockaddr *) &host, sizeof(host)) != 0
+      && errno != EINPROGRESS )
+    {
+      const int refused = (errno == ECONNREFUSED);
+      close(sockfd);
+      return refused ? -3 : -1;
+    }
+
+  return sockfd;
+}
+
+/* Connection handshakes with many ranks at once. Each one has its own
+   socket, closed when done, so that the persistent SN sockets (and
+   glb_gaspi_ctx_lock guarding them) are not involved. Up to
+   GASPI_SN_CONNECT_WINDOW handshakes are in flight and are completed
+   in the order the ranks answer; a rank whose SN does not accept
+   connections yet is tried again, any other error fails it at once.
+   status[k] is 0 once the handshake
+   with ranks[k] is done, -1 if it failed and 1 if it did not finish
+   before the timeout. */
+#define GASPI_SN_CONNECT_WINDOW (64)
+
+int
+gaspi_sn_connect_many(const gaspi_rank_t * const ranks,
+		      const int num,
+		      int * const status,
+		      const gaspi_timeout_t timeout_ms)
+{
+  struct pollfd fds[GASPI_SN_CONNECT_WINDOW];
+  int which[GASPI_SN_CONNECT_WINDOW];
+  int sent[GASPI_SN_CONNECT_WINDOW];
+  int nfds = 0;
+  int k;
+
+  for(k = 0; k < num; k++)
+    {
+      status[k] = 1;
+    }
+
+  if( pgaspi_dev_get_sizeof_rc() == 0 )
+    {
+      for(k = 0; k < num; k++)
+	{
+	  status[k] = 0;
+	}
+      return 0;
+    }
+
+  /* Ranks still to start, in a ring since refused ones come back */
+  int * const todo = (int *) malloc(num * sizeof(int));
+  if( todo == NULL )
+    {
+      return -1;
+    }
+
+  for(k = 0; k < num; k++)
+    {
+      todo[k] = k;
+    }
+
+  int todo_head = 0, todo_num = num, left = num, ret = 0;
+
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  const gaspi_cycles_t s0 = gaspi_get_cycles();
+
+  while( left > 0 )
+    {
+      int tries = todo_num;
+      while( nfds < GASPI_SN_CONNECT_WINDOW && tries-- > 0 )
+	{
+	  const int idx = todo[todo_head];
+	  todo_head = (todo_head + 1) % num;
+	  todo_num--;
+
+	  const int fd = _gaspi_sn_connect_start(ranks[idx]);
+	  if( fd == -2 )
+	    {
+	      ret = -2;
+	      goto endL;
+	    }
+
+	  if( fd == -3 )
+	    {
+	      todo[(todo_head + todo_num) % num] = idx;
+	      todo_num++;
+	      continue;
+	    }
+
+	  if( fd < 0 )
+	    {
+	      status[idx] = -1;
+	      left--;
+	      continue;
+	    }
+
+	  fds[nfds].fd = fd;
+	  fds[nfds].events = POLLOUT;
+	  fds[nfds].revents = 0;
+	  which[nfds] = idx;
+	  sent[nfds] = 0;
+	  nfds++;
+	}
+
+      if( nfds > 0 && poll(fds, nfds, 10) < 0 && errno != EINTR )
+	{
+	  ret = -1;
+	  goto endL;
+	}
+
+      int s;
+      for(s = nfds - 1; s >= 0; s--)
+	{
+	  if( fds[s].revents == 0 )
+	    {
+	      continue;
+	    }
+
+	  const int idx = which[s];
+	  int finished = 0;
+
+	  if( !sent[s] )
+	    {
+	      int err = 0;
+	      socklen_t len = sizeof(err);
+
+	      if( getsockopt(fds[s].fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 )
+		{
+		  err = errno;
+		}
+
+	      if( err == ECONNREFUSED )
+		{
+		  /* Not listening (yet): again later */
+		  todo[(todo_head + todo_num) % num] = idx;
+		  todo_num++;
+		  finished = 1;
+		}
+	      else if( err != 0 )
+		{
+		  status[idx] = -1;
+		  left--;
+		  finished = 1;
+		}
+	      else if( gaspi_sn_set_blocking(fds[s].fd) != 0
+		       || gaspi_sn_set_default_opts(fds[s].fd) != 0
+		       || _gaspi_sn_connect_request(fds[s].fd, ranks[idx]) != 0 )
+		{
+		  status[idx] = -1;
+		  left--;
+		  finished = 1;
+		}
+	      else
+		{
+		  sent[s] = 1;
+		  fds[s].events = POLLIN;
+		}
+	    }
+	  else
+	    {
+	      status[idx] = _gaspi_sn_connect_reply(fds[s].fd, ranks[idx]);
+	      left--;
+	      finished = 1;
+	    }
+
+	  if( finished )
+	    {
+	      close(fds[s].fd);
+	      nfds--;
+	      fds[s] = fds[nfds];
+	      which[s] = which[nfds];
+	      sent[s] = sent[nfds];
+	    }
+	}
+
+      if( left > 0 )
+	{
+	  const gaspi_cycles_t s1 = gaspi_get_cycles();
+	  const float ms = (float) (s1 - s0) * gctx->cycles_to_msecs;
+
+	  if( ms > (float) timeout_ms )
+	    {
+	      ret = 1;
+	      goto endL;
+	    }
+
+	  if( nfds == 0 )
+	    {
+	      gaspi_delay();
+	    }
+	}
+    }
+
+ endL:
+  for(k = 0; k < nfds; k++)
+    {
+      close(fds[k].fd);
+    }
+
+  free(todo);
+
+  return ret;
 }
 static inline int
 _gaspi_sn_queue_create_command(const gaspi_rank_t rank, const void * const arg)
@@ -767,21 +1041,14 @@ _gaspi_sn_single_command(const gaspi_rank_t rank, const enum gaspi_sn_ops op)
 }
 
 
-/*
-  An allgather operation: each rank in group contributes with its part
-  (src) of size (size). The result will be in recv buffer (size of
-  this buffer needs to be size * elements in group.
-
-  NOTE that atm NO ordering of data is guaranteed in the recv buffer
-  ie. that data of rank 0 is in recv[0], rank 1 in recv[1].
-
-*/
-int
-gaspi_sn_allgather(gaspi_context_t const * const gctx,
-		   void const * const src,
-		   void  *const recv, size_t size,
-		   gaspi_group_t group,
-		   gaspi_timeout_t timeout_ms)
+/* Allgather in a ring of fresh connections. The data is NOT ordered
+   by rank in recv. */
+static int
+_gaspi_sn_allgather_ring(gaspi_context_t const * const gctx,
+			 void const * const src,
+			 void  *const recv, size_t size,
+			 gaspi_group_t group,
+			 gaspi_timeout_t timeout_ms)
 {
   int left_sock = -1, right_sock = -1;
 
@@ -899,33 +1166,318 @@ gaspi_sn_allgather(gaspi_context_t const * const gctx,
   return 0;
 }
 
-static inline int
-_gaspi_sn_segment_register_command(const gaspi_rank_t rank, const void * const arg)
+/* Blocks sent to us during an allgather, kept by the SN thread until
+   the application thread takes them (in order of arrival). seq tells
+   the allgathers on a group apart: blocks left from an earlier one
+   (e.g. after a timeout) are dropped instead of being taken. */
+struct gaspi_sn_block
+{
+  struct gaspi_sn_block *next;
+  int group;
+  int round;
+  int rank;
+  unsigned int seq;
+  size_t len;
+  char data[];
+};
+
+static struct gaspi_sn_block *gaspi_sn_blocks = NULL;
+static struct gaspi_sn_block **gaspi_sn_blocks_tail = &gaspi_sn_blocks;
+static gaspi_lock_t gaspi_sn_blocks_lock;
+
+static void
+_gaspi_sn_block_put(struct gaspi_sn_block * const block)
+{
+  lock_gaspi_tout(&gaspi_sn_blocks_lock, GASPI_BLOCK);
+
+  block->next = NULL;
+  *gaspi_sn_blocks_tail = block;
+  gaspi_sn_blocks_tail = &block->next;
+
+  unlock_gaspi(&gaspi_sn_blocks_lock);
+}
+
+/* Unlink the block *prev points to (lock held) */
+static struct gaspi_sn_block *
+_gaspi_sn_block_unlink(struct gaspi_sn_block ** const prev)
+{
+  struct gaspi_sn_block * const block = *prev;
+
+  *prev = block->next;
+  if( gaspi_sn_blocks_tail == &block->next )
+    {
+      gaspi_sn_blocks_tail = prev;
+    }
+
+  return block;
+}
+
+static struct gaspi_sn_block *
+_gaspi_sn_block_take(const int group, const unsigned int seq,
+		     const int round, const int rank)
+{
+  struct gaspi_sn_block **prev = &gaspi_sn_blocks;
+  struct gaspi_sn_block *block = NULL;
+
+  lock_gaspi_tout(&gaspi_sn_blocks_lock, GASPI_BLOCK);
+
+  while( *prev != NULL )
+    {
+      if( (*prev)->group != group )
+	{
+	  prev = &(*prev)->next;
+	}
+      else if( (int) ((*prev)->seq - seq) < 0 )
+	{
+	  free(_gaspi_sn_block_unlink(prev));
+	}
+      else if( (*prev)->seq == seq && (*prev)->round == round && (*prev)->rank == rank )
+	{
+	  block = _gaspi_sn_block_unlink(prev);
+	  break;
+	}
+      else
+	{
+	  prev = &(*prev)->next;
+	}
+    }
+
+  unlock_gaspi(&gaspi_sn_blocks_lock);
+
+  return block;
+}
+
+/* Forget the blocks of a group that is deleted */
+void
+gaspi_sn_allgather_drop(const gaspi_group_t group)
+{
+  struct gaspi_sn_block **prev = &gaspi_sn_blocks;
+
+  lock_gaspi_tout(&gaspi_sn_blocks_lock, GASPI_BLOCK);
+
+  while( *prev != NULL )
+    {
+      if( (*prev)->group == group )
+	{
+	  free(_gaspi_sn_block_unlink(prev));
+	}
+      else
+	{
+	  prev = &(*prev)->next;
+	}
+    }
+
+  unlock_gaspi(&gaspi_sn_blocks_lock);
+}
+
+static int
+_gaspi_sn_allgather_send(const gaspi_rank_t rank,
+			 const gaspi_group_t group,
+			 const unsigned int seq,
+			 const int round,
+			 void const * const buf,
+			 const size_t len,
+			 const gaspi_timeout_t timeout_ms)
 {
   gaspi_context_t const * const gctx = &glb_gaspi_ctx;
-  const gaspi_segment_id_t segment_id = * (gaspi_segment_id_t *) arg;
 
-  //TODO: move code to own function (e.g. create_segment_registration_descriptor)
+  if( gaspi_sn_connect_to_rank(rank, timeout_ms) != GASPI_SUCCESS )
+    {
+      gaspi_print_error("Failed to connect to %u.", rank);
+      return -1;
+    }
+
   gaspi_cd_header cdh;
   memset(&cdh, 0, sizeof(gaspi_cd_header));
 
-  cdh.op_len = 0; /* in-place */
-  cdh.op = GASPI_SN_SEG_REGISTER;
+  cdh.op_len = (int) len;
+  cdh.op = GASPI_SN_ALLGATHER;
   cdh.rank = gctx->rank;
-  cdh.seg_id = segment_id;
-  cdh.addr = gctx->rrmd[segment_id][gctx->rank].data.addr;
-  cdh.notif_addr = gctx->rrmd[segment_id][gctx->rank].notif_spc.addr;
-  cdh.size = gctx->rrmd[segment_id][gctx->rank].size;
+  cdh.group = group;
+  cdh.round = round;
+  cdh.seq = (int) seq;
+
+  if( gaspi_sn_writen(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header)) != sizeof(gaspi_cd_header) )
+    {
+      gaspi_print_error("Failed to write to %u.", rank);
+      return -1;
+    }
+
+  if( gaspi_sn_writen(gctx->sockfd[rank], buf, len) != (ssize_t) len )
+    {
+      gaspi_print_error("Failed to write to %u.", rank);
+      return -1;
+    }
+
+  int result = -1;
+  if( gaspi_sn_readn(gctx->sockfd[rank], &result, sizeof(int)) != sizeof(int) )
+    {
+      gaspi_print_error("Failed to read from %u.", rank);
+      return -1;
+    }
+
+  return result;
+}
+
+static int
+_gaspi_sn_allgather_recv(const gaspi_rank_t rank,
+			 const gaspi_group_t group,
+			 const unsigned int seq,
+			 const int round,
+			 void * const buf,
+			 const size_t len,
+			 const gaspi_timeout_t timeout_ms)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  struct gaspi_sn_block *block;
+  const gaspi_cycles_t s0 = gaspi_get_cycles();
+
+  while( (block = _gaspi_sn_block_take(group, seq, round, rank)) == NULL )
+    {
+      const gaspi_cycles_t s1 = gaspi_get_cycles();
+      const float ms = (float) (s1 - s0) * gctx->cycles_to_msecs;
+
+      if( ms > (float) timeout_ms )
+	{
+	  return -1;
+	}
+
+      gaspi_delay();
+    }
+
+  int ret = 0;
+  if( block->len != len )
+    {
+      gaspi_print_error("Unexpected data from %u (%lu instead of %lu).",
+			rank, block->len, len);
+      ret = -1;
+    }
+  else
+    {
+      memcpy(buf, block->data, len);
+    }
+
+  free(block);
+
+  return ret;
+}
+
+/* Up to this size, the ring needs no more steps than the logarithmic
+   algorithm and does not go through the SN thread. */
+#define GASPI_SN_ALLGATHER_RING_MAX (3)
+
+/*
+  An allgather operation: each rank in group contributes with its part
+  (src) of size (size). The result will be in recv buffer (size of
+  this buffer needs to be size * elements in group.
+
+  NOTE that NO ordering of data is guaranteed in the recv buffer ie.
+  that data of rank 0 is in recv[0], rank 1 in recv[1].
+
+  Bruck's algorithm over the SN connections: in round k every rank
+  sends all it has (up to 2^k blocks) to the rank 2^k below it, so
+  ceil(log2(tnc)) rounds are needed instead of tnc - 1 ring steps.
+*/
+int
+gaspi_sn_allgather(gaspi_context_t const * const gctx,
+		   void const * const src,
+		   void  *const recv, size_t size,
+		   gaspi_group_t group,
+		   gaspi_timeout_t timeout_ms)
+{
+  gaspi_group_ctx_t * const grp_ctx = &(glb_gaspi_group_ctx[group]);
+  const int tnc = grp_ctx->tnc;
+  const int rank = grp_ctx->rank;
+  const unsigned int seq = grp_ctx->sn_msg++;
+
+  if( tnc <= GASPI_SN_ALLGATHER_RING_MAX )
+    {
+      return _gaspi_sn_allgather_ring(gctx, src, recv, size, group, timeout_ms);
+    }
+
+  /* tmp[i] is the block of group rank (rank + i) % tnc */
+  char * const tmp = malloc(tnc * size);
+  if( tmp == NULL )
+    {
+      gaspi_print_error("Memory allocation failed.");
+      return -1;
+    }
+
+  memcpy(tmp, src, size);
+
+  int cnt = 1;
+  int round, dist;
+  for(round = 0, dist = 1; dist < tnc; round++, dist <<= 1)
+    {
+      const int n = MIN(cnt, tnc - cnt);
+      const gaspi_rank_t dst = grp_ctx->rank_grp[(rank - dist + tnc) % tnc];
+      const gaspi_rank_t from = grp_ctx->rank_grp[(rank + dist) % tnc];
+
+      if( _gaspi_sn_allgather_send(dst, group, seq, round, tmp, n * size, timeout_ms) != 0 )
+	{
+	  free(tmp);
+	  return -1;
+	}
+
+      if( _gaspi_sn_allgather_recv(from, group, seq, round, tmp + cnt * size, n * size, timeout_ms) != 0 )
+	{
+	  gaspi_print_error("Failed to receive from %u.", from);
+	  free(tmp);
+	  return -1;
+	}
+
+      cnt += n;
+    }
+
+  char * const recv_buf = (char *) recv;
+  int i;
+  for(i = 0; i < tnc; i++)
+    {
+      memcpy(recv_buf + ((rank + i) % tnc) * size, tmp + i * size, size);
+    }
+
+  free(tmp);
+
+  return 0;
+}
+
+/* Describe a local segment to another rank */
+static void
+_gaspi_sn_segment_desc(gaspi_context_t const * const gctx,
+		       const gaspi_segment_id_t segment_id,
+		       gaspi_cd_header * const cdh)
+{
+  cdh->rank = gctx->rank;
+  cdh->seg_id = segment_id;
+  cdh->addr = gctx->rrmd[segment_id]->local.data.addr;
+  cdh->notif_addr = gctx->rrmd[segment_id]->local.notif_spc.addr;
+  cdh->notif_num = gctx->rrmd[segment_id]->local.notif_spc_size / sizeof(gaspi_notification_t);
+  cdh->size = gctx->rrmd[segment_id]->local.size;
+  cdh->seg_gen = (int) gctx->rrmd[segment_id]->local.gen;
 
 #ifdef GPI2_CUDA
-  cdh.host_rkey = gctx->rrmd[segment_id][gctx->rank].host_rkey;
-  cdh.host_addr = gctx->rrmd[segment_id][gctx->rank].host_addr;
+  cdh->host_rkey = gctx->rrmd[segment_id]->local.host_rkey;
+  cdh->host_addr = gctx->rrmd[segment_id]->local.host_addr;
 #endif
 
 #ifdef GPI2_DEVICE_IB
-  cdh.rkey[0] = gctx->rrmd[segment_id][gctx->rank].rkey[0];
-  cdh.rkey[1] = gctx->rrmd[segment_id][gctx->rank].rkey[1];
+  cdh->rkey[0] = gctx->rrmd[segment_id]->local.rkey[0];
+  cdh->rkey[1] = gctx->rrmd[segment_id]->local.rkey[1];
 #endif
+}
+
+static inline int
+_gaspi_sn_segment_register_command(const gaspi_rank_t rank, const void * const arg)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  const gaspi_segment_id_t segment_id = * (gaspi_segment_id_t *) arg;
+
+  gaspi_cd_header cdh;
+  memset(&cdh, 0, sizeof(gaspi_cd_header));
+
+  cdh.op_len = 0; /* in-place */
+  cdh.op = GASPI_SN_SEG_REGISTER;
+  _gaspi_sn_segment_desc(gctx, segment_id, &cdh);
 
   ssize_t ret = gaspi_sn_writen(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header));
   if(ret != sizeof(gaspi_cd_header))
@@ -957,6 +1509,82 @@ _gaspi_sn_segment_register_command(const gaspi_rank_t rank, const void * const a
   return 0;
 }
 
+/* Ask rank for its segment (lazy registration) */
+static inline int
+_gaspi_sn_segment_fetch_command(const gaspi_rank_t rank, const void * const arg)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  const gaspi_segment_id_t segment_id = * (gaspi_segment_id_t *) arg;
+
+  gaspi_cd_header cdh;
+  memset(&cdh, 0, sizeof(gaspi_cd_header));
+
+  cdh.op_len = 0; /* in-place */
+  cdh.op = GASPI_SN_SEG_FETCH;
+  cdh.rank = gctx->rank;
+  cdh.seg_id = segment_id;
+
+  ssize_t ret = gaspi_sn_writen(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header));
+  if(ret != sizeof(gaspi_cd_header))
+    {
+      gaspi_print_error("Failed to write to rank %u (args: %d %p %lu)",
+			rank,
+			gctx->sockfd[rank],
+			&cdh,
+			sizeof(gaspi_cd_header));
+      return -1;
+    }
+
+  ssize_t rret = gaspi_sn_readn(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header));
+  if( rret != sizeof(gaspi_cd_header) )
+    {
+      gaspi_print_error("Failed to read from rank %u (args: %d %p %lu)",
+			rank,
+			gctx->sockfd[rank],
+			&cdh,
+			sizeof(gaspi_cd_header));
+      return -1;
+    }
+
+  /* No such segment on the remote side */
+  if( cdh.ret != 0 )
+    return -1;
+
+  return gaspi_sn_segment_register(cdh);
+}
+
+/* Tell rank that our segment is gone (lazy registration) */
+static inline int
+_gaspi_sn_segment_drop_command(const gaspi_rank_t rank, const void * const arg)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  gaspi_segment_descriptor_t const * const desc = (gaspi_segment_descriptor_t const *) arg;
+
+  gaspi_cd_header cdh;
+  memset(&cdh, 0, sizeof(gaspi_cd_header));
+
+  cdh.op_len = 0; /* in-place */
+  cdh.op = GASPI_SN_SEG_DROP;
+  cdh.rank = gctx->rank;
+  cdh.seg_id = desc->seg_id;
+  cdh.seg_gen = (int) desc->gen;
+
+  if( gaspi_sn_writen(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header)) != sizeof(gaspi_cd_header) )
+    {
+      gaspi_print_error("Failed to write to rank %u", rank);
+      return -1;
+    }
+
+  int result = -1;
+  if( gaspi_sn_readn(gctx->sockfd[rank], &result, sizeof(int)) != sizeof(int) )
+    {
+      gaspi_print_error("Failed to read from rank %u", rank);
+      return -1;
+    }
+
+  return result;
+}
+
 struct group_desc
 {
   gaspi_group_t group;
@@ -1081,6 +1709,50 @@ _gaspi_sn_group_connect(const gaspi_rank_t rank, const void * const arg)
   return 0;
 }
 
+/* Get (and have allocated) an area of the group memory of rank */
+static inline int
+_gaspi_sn_group_area_command(const gaspi_rank_t rank, const void * const arg)
+{
+  gaspi_context_t const * const gctx = &glb_gaspi_ctx;
+  struct gaspi_grp_area_req const * const req = (struct gaspi_grp_area_req const *) arg;
+
+  gaspi_cd_header cdh;
+  memset(&cdh, 0, sizeof(gaspi_cd_header));
+
+  cdh.op_len = 0; /* in-place */
+  cdh.op = GASPI_SN_GRP_AREA;
+  cdh.rank = gctx->rank;
+  cdh.group = req->group;
+  cdh.seg_id = req->area;
+  cdh.size = req->size;
+
+  if( gaspi_sn_writen(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header)) != sizeof(gaspi_cd_header) )
+    {
+      gaspi_print_error("Failed to write to rank %u", rank);
+      return -1;
+    }
+
+  if( gaspi_sn_readn(gctx->sockfd[rank], &cdh, sizeof(gaspi_cd_header)) != sizeof(gaspi_cd_header) )
+    {
+      gaspi_print_error("Failed to read from rank %u", rank);
+      return -1;
+    }
+
+  if( cdh.ret != 0 )
+    {
+      return -1;
+    }
+
+  gaspi_rc_mseg_t * const desc = &(glb_gaspi_group_ctx[req->group].area[req->area][rank]);
+
+  desc->size = cdh.size;
+#ifdef GPI2_DEVICE_IB
+  desc->rkey[0] = cdh.rkey[0];
+#endif
+  desc->data.addr = cdh.addr;
+
+  return 0;
+}
 
 gaspi_return_t
 gaspi_sn_command(const enum gaspi_sn_ops op, const gaspi_rank_t rank, const gaspi_timeout_t timeout_ms, const void * const arg)
@@ -1115,6 +1787,16 @@ gaspi_sn_command(const enum gaspi_sn_ops op, const gaspi_rank_t rank, const gasp
 	ret = _gaspi_sn_segment_register_command(rank, arg);
 	break;
       }
+    case GASPI_SN_SEG_FETCH:
+      {
+	ret = _gaspi_sn_segment_fetch_command(rank, arg);
+	break;
+      }
+    case GASPI_SN_SEG_DROP:
+      {
+	ret = _gaspi_sn_segment_drop_command(rank, arg);
+	break;
+      }
     case GASPI_SN_GRP_CHECK:
       {
 	ret = _gaspi_sn_group_check(rank, timeout_ms, arg);
@@ -1130,6 +1812,11 @@ gaspi_sn_command(const enum gaspi_sn_ops op, const gaspi_rank_t rank, const gasp
 	ret = _gaspi_sn_queue_create_command(rank, arg);
 	break;
       }
+    case GASPI_SN_GRP_AREA:
+      {
+	ret = _gaspi_sn_group_area_command(rank, arg);
+	break;
+      }
 
     default:
       {
@@ -1263,6 +1950,7 @@ gaspi_sn_backend(void *arg)
 
   ev_mgmt = ev.data.ptr;
   ev_mgmt->fd = lsock;
+  ev_mgmt->data = NULL;
   ev.events = EPOLLIN;
 
   if(epoll_ctl(esock, EPOLL_CTL_ADD, lsock, &ev) < 0)
@@ -1304,6 +1992,7 @@ gaspi_sn_backend(void *arg)
 	      gaspi_print_error( "Erroneous event." );
 	      shutdown(mgmt->fd, SHUT_RDWR);
 	      close(mgmt->fd);
+	      free(mgmt->data);
 	      free(mgmt);
 	      continue;
 	    }
@@ -1368,6 +2057,7 @@ gaspi_sn_backend(void *arg)
 
 	      ev_mgmt = ev.data.ptr;
 	      ev_mgmt->fd = nsock;
+	      ev_mgmt->data = NULL;
 	      ev_mgmt->blen = sizeof(gaspi_cd_header);
 	      ev_mgmt->bdone = 0;
 	      ev_mgmt->op = GASPI_SN_HEADER;
@@ -1419,6 +2109,11 @@ gaspi_sn_backend(void *arg)
 			  ptr = pgaspi_dev_get_rrcd(mgmt->cdh.rank);
 			  rcount = read( mgmt->fd, ptr + mgmt->bdone, rsize );
 			}
+		      else if( mgmt->op == GASPI_SN_ALLGATHER )
+			{
+			  ptr = ((struct gaspi_sn_block *) mgmt->data)->data;
+			  rcount = read( mgmt->fd, ptr + mgmt->bdone, rsize );
+			}
 
 		      /* errno==EAGAIN => we have read all data */
 		      int errsv = errno;
@@ -1532,6 +2227,35 @@ gaspi_sn_backend(void *arg)
 
 				      GASPI_SN_RESET_EVENT( mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
 				    }
+				  else if(mgmt->cdh.op == GASPI_SN_GRP_AREA)
+				    {
+				      gaspi_rc_mseg_t desc;
+
+				      gaspi_cd_header reply;
+				      memset(&reply, 0, sizeof(gaspi_cd_header));
+				      reply.op = GASPI_SN_GRP_AREA;
+				      reply.ret = -1;
+
+				      if( pgaspi_group_area_desc((gaspi_group_t) mgmt->cdh.group, mgmt->cdh.seg_id,
+								 (size_t) mgmt->cdh.size, &desc) == GASPI_SUCCESS )
+					{
+					  reply.addr = desc.data.addr;
+					  reply.size = desc.size;
+#ifdef GPI2_DEVICE_IB
+					  reply.rkey[0] = desc.rkey[0];
+#endif
+					  reply.ret = 0;
+					}
+
+				      if(gaspi_sn_writen( mgmt->fd, &reply, sizeof(gaspi_cd_header) ) < 0 )
+					{
+					  gaspi_print_error("Failed response to group area.");
+					  io_err = 1;
+					  break;
+					}
+
+				      GASPI_SN_RESET_EVENT(mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
+				    }
 				  else if(mgmt->cdh.op == GASPI_SN_SEG_REGISTER)
 				    {
 				      int rret = gaspi_sn_segment_register(mgmt->cdh);
@@ -1544,10 +2268,87 @@ gaspi_sn_backend(void *arg)
 					  break;
 					}
 
+				      GASPI_SN_RESET_EVENT(mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
+				    }
+				  else if(mgmt->cdh.op == GASPI_SN_SEG_FETCH)
+				    {
+				      const gaspi_segment_id_t seg = (gaspi_segment_id_t) mgmt->cdh.seg_id;
+
+				      gaspi_cd_header reply;
+				      memset(&reply, 0, sizeof(gaspi_cd_header));
+				      reply.op = GASPI_SN_SEG_FETCH;
+				      reply.ret = -1;
+
+				      lock_gaspi_tout(&gaspi_mseg_lock, GASPI_BLOCK);
+				      if( seg < gctx->rrmd_size && gctx->rrmd[seg] != NULL
+					  && gctx->rrmd[seg]->local.size )
+					{
+					  _gaspi_sn_segment_desc(gctx, seg, &reply);
+					  reply.ret = 0;
+
+					  /* To be told when it is deleted */
+					  if( mgmt->cdh.rank >= 0 && mgmt->cdh.rank < gctx->tnc )
+					    {
+					      gctx->rrmd[seg]->trans[mgmt->cdh.rank] = 1;
+					    }
+					}
+				      unlock_gaspi(&gaspi_mseg_lock);
+
+				      if(gaspi_sn_writen( mgmt->fd, &reply, sizeof(gaspi_cd_header) ) < 0 )
+					{
+					  gaspi_print_error("Failed response to segment fetch.");
+					  io_err = 1;
+					  break;
+					}
+
+				      GASPI_SN_RESET_EVENT(mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
+				    }
+				  else if(mgmt->cdh.op == GASPI_SN_SEG_DROP)
+				    {
+				      gaspi_segment_descriptor_t desc;
+				      memset(&desc, 0, sizeof(desc));
+				      desc.rank = mgmt->cdh.rank;
+				      desc.seg_id = mgmt->cdh.seg_id;
+				      desc.gen = (unsigned int) mgmt->cdh.seg_gen;
+
+				      int rret = gaspi_segment_unset(desc);
+
+				      if(gaspi_sn_writen( mgmt->fd, &rret, sizeof(int) ) < 0 )
+					{
+					  gaspi_print_error("Failed response to segment drop.");
+					  io_err = 1;
+					  break;
+					}
+
 				      GASPI_SN_RESET_EVENT(mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
 				    }
 				  else if(mgmt->cdh.op == GASPI_SN_QUEUE_CREATE)
 				    {
+				      GASPI_SN_RESET_EVENT( mgmt, mgmt->cdh.op_len, mgmt->cdh.op );
+				    }
+				  else if(mgmt->cdh.op == GASPI_SN_ALLGATHER)
+				    {
+				      struct gaspi_sn_block *block = NULL;
+
+				      if( mgmt->cdh.op_len > 0 )
+					{
+					  block = malloc(sizeof(struct gaspi_sn_block) + mgmt->cdh.op_len);
+					}
+
+				      if( block == NULL )
+					{
+					  gaspi_print_error("Failed to allocate memory.");
+					  io_err = 1;
+					  break;
+					}
+
+				      block->group = mgmt->cdh.group;
+				      block->round = mgmt->cdh.round;
+				      block->rank = mgmt->cdh.rank;
+				      block->seq = (unsigned int) mgmt->cdh.seq;
+				      block->len = mgmt->cdh.op_len;
+				      mgmt->data = block;
+
 				      GASPI_SN_RESET_EVENT( mgmt, mgmt->cdh.op_len, mgmt->cdh.op );
 				    }
 				}/* !header */
@@ -1601,6 +2402,22 @@ gaspi_sn_backend(void *arg)
 					  break;
 				    }
 
+				  GASPI_SN_RESET_EVENT( mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
+				}
+			      else if( mgmt->op == GASPI_SN_ALLGATHER )
+				{
+				  int rret = 0;
+
+				  _gaspi_sn_block_put(mgmt->data);
+				  mgmt->data = NULL;
+
+				  if(gaspi_sn_writen( mgmt->fd, &rret, sizeof(int) ) < 0 )
+				    {
+				      gaspi_print_error("Failed ack allgather data.");
+				      io_err = 1;
+				      break;
+				    }
+
 				  GASPI_SN_RESET_EVENT( mgmt, sizeof(gaspi_cd_header), GASPI_SN_HEADER );
 				}
 			      else
@@ -1619,6 +2436,7 @@ gaspi_sn_backend(void *arg)
 		{
 		  shutdown(mgmt->fd, SHUT_RDWR);
 		  close(mgmt->fd);
+		  free(mgmt->data);
 		  free(mgmt);
 		}
 	    }
@@ -35,7 +35,11 @@ enum gaspi_sn_ops
     GASPI_SN_GRP_CONNECT= 20,
     GASPI_SN_SEG_REGISTER = 22,
     GASPI_SN_QUEUE_CREATE = 23,
-    GASPI_SN_PROC_PING = 24
+    GASPI_SN_PROC_PING = 24,
+    GASPI_SN_SEG_FETCH = 25,
+    GASPI_SN_ALLGATHER = 26,
+    GASPI_SN_SEG_DROP = 27,
+    GASPI_SN_GRP_AREA = 28
   };
 
 enum gaspi_sn_status
@@ -48,7 +52,8 @@ enum gaspi_sn_status
 typedef struct
 {
   int op, op_len, rank, tnc;
-  int ret, seg_id;
+  int ret, seg_id, notif_num, seg_gen;
+  int group, round, seq; /* block of a GASPI_SN_ALLGATHER */
   unsigned long addr, size, notif_addr;
 
 #ifdef GPI2_CUDA
@@ -65,6 +70,7 @@ typedef struct
 {
   int fd, op, rank, blen, bdone;
   gaspi_cd_header cdh;
+  void *data;
 } gaspi_mgmt_header;
 
 extern volatile enum gaspi_sn_status gaspi_sn_status;
@@ -80,12 +86,22 @@ gaspi_sn_allgather(gaspi_context_t const * const gctx,
 		   size_t size,
 		   gaspi_group_t group,
 		   gaspi_timeout_t timeout_ms);
+
+void
+gaspi_sn_allgather_drop(const gaspi_group_t group);
+
 gaspi_return_t
 gaspi_sn_command(const enum gaspi_sn_ops op,
 		 const gaspi_rank_t rank,
 		 const gaspi_timeout_t timeout_ms,
 		 const void * const arg);
 
+int
+gaspi_sn_connect_many(const gaspi_rank_t * const ranks,
+		      const int num,
+		      int * const status,
+		      const gaspi_timeout_t timeout_ms);
+
 enum gaspi_sn_status
 gaspi_sn_status_get(void);
 
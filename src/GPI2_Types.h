@@ -34,7 +34,8 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 
 #define GASPI_MAX_GROUPS  (32)
 #define GASPI_MAX_MSEGS   (32)
-#define GASPI_MAX_QP      (16)
+#define GASPI_MAX_MSEGS_LIMIT (256)
+#define GASPI_MAX_QP      (64)
 #define GASPI_COLL_QP     (GASPI_MAX_QP)
 #define GASPI_PASSIVE_QP  (GASPI_MAX_QP+1)
 #define GASPI_SN          (GASPI_MAX_QP+2)
@@ -42,6 +43,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define GASPI_MAX_TSIZE_P ((1ul<<16ul)-1ul)
 #define GASPI_MAX_QSIZE   (4096)
 #define GASPI_MAX_NOTIFICATION  (65536)
+#define GASPI_MAX_BATCH   ((1 << 8) - 1) /* operations of gaspi_write_notify_batch */
 #define GASPI_MAX_NUMAS   (4)
 
 typedef struct
@@ -50,6 +52,13 @@ typedef struct
   char dummy[63];
 } gaspi_lock_t;
 
+/* Communication queue counter (one cache line per queue) */
+typedef struct
+{
+  ALIGN64 int count;
+  char dummy[60];
+} gaspi_queue_counter_t;
+
 typedef struct
 {
   union
@@ -74,9 +83,14 @@ typedef struct
 
   unsigned long size;
   size_t notif_spc_size;
-  int trans; /* info transmitted */
+  unsigned int gen; /* changes with the memory or its keys */
 
   int user_provided;
+  size_t mapped; /* length of mapped (huge page) memory, 0 if on the heap */
+  gaspi_alloc_t alloc_policy;
+  struct gaspi_sym_heap *sym_heap; /* symmetric heap, see GPI2_Heap.c */
+  struct gaspi_seg_pool *pool; /* sub-allocator, see GPI2_Heap.c */
+  struct gaspi_reg_entry *reg; /* cached registration of user memory, see GPI2_SEG.c */
   gaspi_memory_description_t desc;
 
 #ifdef GPI2_CUDA
@@ -91,6 +105,34 @@ typedef struct
 #endif
 } gaspi_rc_mseg_t;
 
+/* What is needed to access the segment of another rank, kept small
+   since there is one per rank and segment */
+typedef struct
+{
+  unsigned long addr;
+  unsigned long notif_addr;
+  unsigned long size;
+  unsigned int notif_num;
+  unsigned int gen; /* of the segment at its owner */
+
+#ifdef GPI2_DEVICE_IB
+  unsigned int rkey[2];
+#endif
+
+#ifdef GPI2_CUDA
+  int cuda_dev_id;
+  unsigned int host_rkey;
+  unsigned long host_addr;
+#endif
+} gaspi_rc_rseg_t;
+
+typedef struct
+{
+  gaspi_rc_mseg_t local;
+  gaspi_rc_rseg_t *remote; /* all ranks, own one included */
+  unsigned char *trans; /* info transmitted, per rank */
+} gaspi_rc_seg_t;
+
 typedef struct
 {
   int localSocket; //TODO: rename?
@@ -110,6 +152,10 @@ typedef struct
   gaspi_lock_t lockPS;
   gaspi_lock_t lockPR;
   gaspi_lock_t lockC[GASPI_MAX_QP];
+
+  /* Queues owned by a single thread (no locking) */
+  volatile unsigned char queue_owned[GASPI_MAX_QP];
+  pthread_t queue_owner[GASPI_MAX_QP];
   pthread_t snt;
 
 #ifdef GPI2_CUDA
@@ -118,18 +164,42 @@ typedef struct
 #endif
 
   gaspi_rc_mseg_t nsrc;
-  gaspi_rc_mseg_t* rrmd[GASPI_MAX_MSEGS];
+  /* Segment table: grows on demand, read without locking */
+  gaspi_rc_seg_t** volatile rrmd;
+  volatile gaspi_number_t rrmd_size;
+  /* Changes when a segment descriptor in use changes (see plans) */
+  volatile unsigned int seg_epoch;
 
   gaspi_endpoint_conn_t *ep_conn;
+  gaspi_lock_t *ep_lock; /* per endpoint, held while connecting to it */
 
   /* Number of "created" communication queues */
   gaspi_number_t num_queues;
 
   /* Comm counters  */
   int ne_count_grp;
-  int ne_count_c[GASPI_MAX_QP];
+  gaspi_queue_counter_t ne_count_c[GASPI_MAX_QP];
   unsigned char ne_count_p[8192]; //TODO: dynamic size
 
 } gaspi_context_t;
 
+/* Persistent communication plan. The operations are kept to build the
+   device requests again when a segment descriptor changed (seg_epoch)
+   since they were built. */
+struct gaspi_plan_desc
+{
+  gaspi_number_t num;    /* number of operations */
+  gaspi_number_t num_wr; /* number of requests posted at each start */
+  gaspi_rank_t *rank;    /* target rank of each operation */
+  gaspi_segment_id_t *segment_id_local;
+  gaspi_offset_t *offset_local;
+  gaspi_segment_id_t *segment_id_remote;
+  gaspi_offset_t *offset_remote;
+  gaspi_size_t *size;
+  gaspi_notification_id_t *notification_id; /* NULL for plain writes */
+  gaspi_notification_t *notification_value;
+  unsigned int epoch;    /* seg_epoch the requests were built at */
+  void *dev_plan;        /* pre-built device requests */
+};
+
 #endif /* _GPI2_TYPES_H_ */
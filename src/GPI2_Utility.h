@@ -38,6 +38,9 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 
 #ifdef DEBUG
 #include "GPI2.h"
+
+extern gaspi_config_t glb_gaspi_cfg;
+
 #define gaspi_print_error(msg, ...)					\
   {									\
     int gaspi_debug_errsv = errno;					\
@@ -93,12 +96,21 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
       }								\
   }
 
-#define gaspi_verify_segment(seg_id)		\
-  {						\
-    if( seg_id >= GASPI_MAX_MSEGS)		\
-      {						\
-	return GASPI_ERR_INV_SEG;		\
-      }						\
+#define gaspi_verify_segment(seg_id)			\
+  {							\
+    if( seg_id >= glb_gaspi_cfg.segment_max)		\
+      {							\
+	return GASPI_ERR_INV_SEG;			\
+      }							\
+  }
+
+#define gaspi_verify_segment_desc(seg_id)		\
+  {							\
+    if( seg_id >= glb_gaspi_ctx.rrmd_size)		\
+      {							\
+	return GASPI_ERR_INV_SEG;			\
+      }							\
+    gaspi_verify_null_ptr(glb_gaspi_ctx.rrmd[seg_id]);	\
   }
 
 #define gaspi_verify_unaligned_off(offset)	\
@@ -112,12 +124,12 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define gaspi_verify_local_off(off, seg_id, sz)				\
   {									\
     gaspi_verify_segment(seg_id);					\
-    gaspi_verify_null_ptr(glb_gaspi_ctx.rrmd[seg_id]);			\
-    if( off >= glb_gaspi_ctx.rrmd[seg_id][glb_gaspi_ctx.rank].size )	\
+    gaspi_verify_segment_desc(seg_id);					\
+    if( off >= glb_gaspi_ctx.rrmd[seg_id]->local.size )			\
       {									\
 	return GASPI_ERR_INV_LOC_OFF;					\
       }									\
-    if( off + sz > glb_gaspi_ctx.rrmd[seg_id][glb_gaspi_ctx.rank].size ) \
+    if( off + sz > glb_gaspi_ctx.rrmd[seg_id]->local.size )		\
       {									\
 	return GASPI_ERR_INV_COMMSIZE;					\
       }									\
@@ -126,22 +138,39 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define gaspi_verify_remote_off(off, seg_id, rank, sz)		\
   {								\
     gaspi_verify_segment(seg_id);				\
-    gaspi_verify_null_ptr(glb_gaspi_ctx.rrmd[seg_id]);		\
+    gaspi_verify_segment_desc(seg_id);				\
     gaspi_verify_rank(rank);					\
-    if( off >= glb_gaspi_ctx.rrmd[seg_id][rank].size )		\
+    if( off >= glb_gaspi_ctx.rrmd[seg_id]->remote[rank].size )	\
       return GASPI_ERR_INV_REM_OFF;				\
-    if( off + sz > glb_gaspi_ctx.rrmd[seg_id][rank].size )	\
+    if( off + sz > glb_gaspi_ctx.rrmd[seg_id]->remote[rank].size ) \
       {								\
 	return GASPI_ERR_INV_COMMSIZE;				\
       }								\
   }
 
+#define gaspi_verify_remote_notification(seg_id, rank, id)		\
+  {									\
+    if( id >= glb_gaspi_ctx.rrmd[seg_id]->remote[rank].notif_num )	\
+      {									\
+	return GASPI_ERR_INV_NOTIF_ID;					\
+      }									\
+  }
+
+#define gaspi_verify_local_notification(seg_id, id, num)		\
+  {									\
+    if( (size_t) (id) + (num) >						\
+	glb_gaspi_ctx.rrmd[seg_id]->local.notif_spc_size / sizeof(gaspi_notification_t) ) \
+      {									\
+	return GASPI_ERR_INV_NOTIF_ID;					\
+      }									\
+  }
+
 #define gaspi_verify_comm_size(sz, seg_id_loc, seg_id_rem, rnk, max)	\
   {									\
     if( sz < 1								\
 	|| sz > max							\
-	|| sz > glb_gaspi_ctx.rrmd[seg_id_rem][rnk].size		\
-	|| sz > glb_gaspi_ctx.rrmd[seg_id_loc][glb_gaspi_ctx.rank].size) \
+	|| sz > glb_gaspi_ctx.rrmd[seg_id_rem]->remote[rnk].size	\
+	|| sz > glb_gaspi_ctx.rrmd[seg_id_loc]->local.size)		\
       {									\
 	return GASPI_ERR_INV_COMMSIZE;					\
       }									\
@@ -181,9 +210,12 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define gaspi_verify_queue(queue)
 #define gaspi_verify_queue_size_max(depth)
 #define gaspi_verify_segment(seg_id)
+#define gaspi_verify_segment_desc(seg_id)
 #define gaspi_verify_unaligned_off(offset)
 #define gaspi_verify_local_off(off, seg_id, sz)
 #define gaspi_verify_remote_off(off, seg_id, rank, sz)
+#define gaspi_verify_remote_notification(seg_id, rank, id)
+#define gaspi_verify_local_notification(seg_id, id, num)
 #define gaspi_verify_comm_size(size, seg_id_loc, seg_id_rem, rank, max)
 #define gaspi_verify_segment_size(size)
 #define gaspi_verify_init(funcname)
@@ -197,6 +197,7 @@ pgaspi_dev_init_core (gaspi_config_t *gaspi_cfg)
 
   glb_gaspi_ctx_ib.card_type = glb_gaspi_ctx_ib.device_attr.vendor_part_id;
   glb_gaspi_ctx_ib.max_rd_atomic = glb_gaspi_ctx_ib.device_attr.max_qp_rd_atom;
+  glb_gaspi_ctx_ib.max_send_sge = MIN (glb_gaspi_ctx_ib.device_attr.max_sge, MAX_SEND_SGE);
 
 
   for(p = 0; p < MIN (glb_gaspi_ctx_ib.device_attr.phys_port_cnt, 2); p++)
@@ -538,7 +539,7 @@ _pgaspi_dev_create_qp(struct ibv_cq *send_cq, struct ibv_cq *recv_cq, struct ibv
   memset (&qpi_attr, 0, sizeof (struct ibv_qp_init_attr));
   qpi_attr.cap.max_send_wr = glb_gaspi_cfg.queue_size_max;
   qpi_attr.cap.max_recv_wr = glb_gaspi_cfg.queue_size_max;
-  qpi_attr.cap.max_send_sge = 1;
+  qpi_attr.cap.max_send_sge = glb_gaspi_ctx_ib.max_send_sge;
   qpi_attr.cap.max_recv_sge = 1;
   qpi_attr.cap.max_inline_data = MAX_INLINE_BYTES;
   qpi_attr.qp_type = IBV_QPT_RC;
@@ -599,7 +600,7 @@ _pgaspi_dev_create_qp_exp(struct ibv_cq *send_cq, struct ibv_cq *recv_cq, struct
   attr.cap.max_send_wr = glb_gaspi_cfg.queue_size_max;
   attr.cap.max_recv_wr = glb_gaspi_cfg.queue_size_max;
   attr.cap.max_send_wr  = glb_gaspi_cfg.queue_size_max;
-  attr.cap.max_send_sge = 1;
+  attr.cap.max_send_sge = glb_gaspi_ctx_ib.max_send_sge;
   attr.cap.max_inline_data = MAX_INLINE_BYTES;
 
   attr.comp_mask = IBV_EXP_QP_INIT_ATTR_PD | IBV_EXP_QP_INIT_ATTR_CREATE_FLAGS;
@@ -28,6 +28,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define GASPI_GID_INDEX   (0)
 #define PORT_LINK_UP      (5)
 #define MAX_INLINE_BYTES  (128)
+#define MAX_SEND_SGE      (16)
 #define GASPI_QP_TIMEOUT  (20)
 #define GASPI_QP_RETRY    (7)
 
@@ -47,6 +48,7 @@ typedef struct
   int card_type;
   int num_dev;
   int max_rd_atomic;
+  int max_send_sge;
   int ib_port;
   int num_queues;
 
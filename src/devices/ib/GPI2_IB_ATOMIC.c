@@ -45,8 +45,8 @@ pgaspi_dev_atomic_fetch_add (const gaspi_segment_id_t segment_id,
   swr.send_flags = IBV_SEND_SIGNALED;
 #endif
 
-  swr.wr.atomic.remote_addr = gctx->rrmd[segment_id][rank].data.addr + offset;
-  swr.wr.atomic.rkey = gctx->rrmd[segment_id][rank].rkey[0];
+  swr.wr.atomic.remote_addr = gctx->rrmd[segment_id]->remote[rank].addr + offset;
+  swr.wr.atomic.rkey = gctx->rrmd[segment_id]->remote[rank].rkey[0];
   swr.wr.atomic.compare_add = val_add;
 
   swr.wr_id = rank;
@@ -121,8 +121,8 @@ pgaspi_dev_atomic_compare_swap (const gaspi_segment_id_t segment_id,
   swr.send_flags = IBV_SEND_SIGNALED;
 #endif
 
-  swr.wr.atomic.remote_addr = gctx->rrmd[segment_id][rank].data.addr + offset;
-  swr.wr.atomic.rkey = gctx->rrmd[segment_id][rank].rkey[0];
+  swr.wr.atomic.remote_addr = gctx->rrmd[segment_id]->remote[rank].addr + offset;
+  swr.wr.atomic.rkey = gctx->rrmd[segment_id]->remote[rank].rkey[0];
   swr.wr.atomic.compare_add = comparator;
   swr.wr.atomic.swap = val_new;
 
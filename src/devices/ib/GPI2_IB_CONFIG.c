@@ -39,7 +39,9 @@ gaspi_config_t glb_gaspi_cfg = {
   GASPI_MAX_TSIZE_P,		//passive_transfer_size_max;
   NEXT_OFFSET,			//allreduce_buf_size;
   255,				//allreduce_elem_max;
-  1				//build_infrastructure;
+  1,				//build_infrastructure;
+  0,				//segment_lazy;
+  0				//reg_cache;
 };
 
 
@@ -56,6 +58,8 @@ pgaspi_config_set (const gaspi_config_t nconf)
 {
   glb_gaspi_cfg.net_info = nconf.net_info;
   glb_gaspi_cfg.build_infrastructure = nconf.build_infrastructure;
+  glb_gaspi_cfg.segment_lazy = nconf.segment_lazy;
+  glb_gaspi_cfg.reg_cache = nconf.reg_cache;
   glb_gaspi_cfg.logger = nconf.logger;
   glb_gaspi_cfg.port_check = nconf.port_check;
 
@@ -59,9 +59,13 @@ pgaspi_dev_poll_groups(void)
 }
 
 int
-pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_addr, unsigned char group)
+pgaspi_dev_post_group_mem_write(const gaspi_rc_mseg_t * const local_mem,
+				void *local_addr,
+				int length,
+				int dst,
+				const gaspi_rc_mseg_t * const remote_mem,
+				void *remote_addr)
 {
-
   struct ibv_sge slist;
   struct ibv_send_wr swr;
   struct ibv_send_wr *bad_wr_send;
@@ -69,7 +73,7 @@ pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_
 
   slist.addr = (uintptr_t) local_addr;
   slist.length = length;
-  slist.lkey = ((struct ibv_mr *)glb_gaspi_group_ctx[group].rrcd[gctx->rank].mr[0])->lkey;
+  slist.lkey = ((struct ibv_mr *) local_mem->mr[0])->lkey;
 
   swr.sg_list = &slist;
   swr.num_sge = 1;
@@ -78,7 +82,53 @@ pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_
   swr.next = NULL;
 
   swr.wr.rdma.remote_addr = (uint64_t) remote_addr;
-  swr.wr.rdma.rkey = glb_gaspi_group_ctx[group].rrcd[dst].rkey[0];
+  swr.wr.rdma.rkey = remote_mem->rkey[0];
+  swr.wr_id = dst;
+
+  if (ibv_post_send ((struct ibv_qp *) glb_gaspi_ctx_ib.qpGroups[dst], &swr, &bad_wr_send))
+    {
+      return 1;
+    }
+
+  gctx->ne_count_grp++;
+
+  return 0;
+}
+
+int
+pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_addr, unsigned char group)
+{
+  gaspi_rc_mseg_t const * const rrcd = glb_gaspi_group_ctx[group].rrcd;
+
+  return pgaspi_dev_post_group_mem_write(&rrcd[glb_gaspi_ctx.rank], local_addr, length,
+					 dst, &rrcd[dst], remote_addr);
+}
+
+int
+pgaspi_dev_post_group_seg_write(const gaspi_segment_id_t segment_id_local,
+				const gaspi_offset_t offset_local,
+				const int dst,
+				const gaspi_segment_id_t segment_id_remote,
+				const gaspi_offset_t offset_remote,
+				const unsigned int length)
+{
+  struct ibv_sge slist;
+  struct ibv_send_wr swr;
+  struct ibv_send_wr *bad_wr_send;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr + offset_local);
+  slist.length = length;
+  slist.lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
+
+  swr.sg_list = &slist;
+  swr.num_sge = 1;
+  swr.opcode = IBV_WR_RDMA_WRITE;
+  swr.send_flags = IBV_SEND_SIGNALED;
+  swr.next = NULL;
+
+  swr.wr.rdma.remote_addr = gctx->rrmd[segment_id_remote]->remote[dst].addr + offset_remote;
+  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[dst].rkey[0];
   swr.wr_id = dst;
 
   if (ibv_post_send ((struct ibv_qp *) glb_gaspi_ctx_ib.qpGroups[dst], &swr, &bad_wr_send))
@@ -24,6 +24,8 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include <cuda.h>
 #endif
 
+extern gaspi_config_t glb_gaspi_cfg;
+
 /* Communication functions */
 gaspi_return_t
 pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
@@ -41,7 +43,7 @@ pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
 #ifdef GPI2_CUDA
-  if( gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id >= 0 )
+  if( gctx->rrmd[segment_id_local]->local.cuda_dev_id >= 0 )
     {
       sf = IBV_SEND_SIGNALED;
     }
@@ -51,15 +53,15 @@ pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
       sf = (size > MAX_INLINE_BYTES) ? IBV_SEND_SIGNALED : IBV_SEND_SIGNALED |	IBV_SEND_INLINE;
     }
 
-  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr +
+  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr +
 			    offset_local);
 
   slist.length = size;
-  slist.lkey =  ((struct ibv_mr *)gctx->rrmd[segment_id_local][gctx->rank].mr[0])->lkey;
+  slist.lkey =  ((struct ibv_mr *)gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
 
-  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].data.addr +  offset_remote);
+  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].addr +  offset_remote);
 
-  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[0];
+  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[0];
   swr.sg_list = &slist;
   swr.num_sge = 1;
   swr.wr_id = rank;
@@ -72,7 +74,7 @@ pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -91,16 +93,16 @@ pgaspi_dev_read (const gaspi_segment_id_t segment_id_local,
   struct ibv_send_wr swr;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr +
+  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr +
 		   offset_local);
 
   slist.length = size;
-  slist.lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local][gctx->rank].mr[0])->lkey;
+  slist.lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
 
-  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].data.addr +
+  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].addr +
 			     offset_remote);
 
-  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[0];
+  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[0];
   swr.sg_list = &slist;
   swr.num_sge = 1;
   swr.wr_id = rank;
@@ -113,7 +115,7 @@ pgaspi_dev_read (const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -126,7 +128,7 @@ pgaspi_dev_purge (const gaspi_queue_id_t queue,
   struct ibv_wc wc;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  const int nr = gctx->ne_count_c[queue];
+  const int nr = gctx->ne_count_c[queue].count;
   const gaspi_cycles_t s0 = gaspi_get_cycles ();
 
   for (i = 0; i < nr; i++)
@@ -134,7 +136,7 @@ pgaspi_dev_purge (const gaspi_queue_id_t queue,
       do
 	{
 	  ne = ibv_poll_cq (glb_gaspi_ctx_ib.scqC[queue], 1, &wc);
-	  gctx->ne_count_c[queue] -= ne;
+	  gctx->ne_count_c[queue].count -= ne;
 
 	  if (ne == 0)
 	    {
@@ -172,7 +174,7 @@ pgaspi_dev_wait (const gaspi_queue_id_t queue,
   struct ibv_wc wc;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  const int nr = gctx->ne_count_c[queue];
+  const int nr = gctx->ne_count_c[queue].count;
   const gaspi_cycles_t s0 = gaspi_get_cycles ();
 
   for (i = 0; i < nr; i++)
@@ -180,7 +182,7 @@ pgaspi_dev_wait (const gaspi_queue_id_t queue,
       do
 	{
 	  ne = ibv_poll_cq (glb_gaspi_ctx_ib.scqC[queue], 1, &wc);
-	  gctx->ne_count_c[queue] -= ne; //TODO: this should be done below, when ne > 0
+	  gctx->ne_count_c[queue].count -= ne; //TODO: this should be done below, when ne > 0
 
 	  if (ne == 0)
 	    {
@@ -240,16 +242,16 @@ pgaspi_dev_write_list (const gaspi_number_t num,
 
   for (i = 0; i < num; i++)
     {
-      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]][gctx->rank].data.addr +
+      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]]->local.data.addr +
 				   offset_local[i]);
 
       slist[i].length = size[i];
-      slist[i].lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local[i]][gctx->rank].mr[0])->lkey;
+      slist[i].lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local[i]]->local.mr[0])->lkey;
 
-      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]][rank].data.addr +
+      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]]->remote[rank].addr +
 				    offset_remote[i]);
 
-      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]][rank].rkey[0];
+      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]]->remote[rank].rkey[0];
       swr[i].sg_list = &slist[i];
       swr[i].num_sge = 1;
       swr[i].wr_id = rank;
@@ -267,7 +269,7 @@ pgaspi_dev_write_list (const gaspi_number_t num,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue] +=  num;
+  gctx->ne_count_c[queue].count +=  num;
 
   return GASPI_SUCCESS;
 }
@@ -292,16 +294,16 @@ pgaspi_dev_read_list (const gaspi_number_t num,
 
   for (i = 0; i < num; i++)
     {
-      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]][gctx->rank].data.addr +
+      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]]->local.data.addr +
 				     offset_local[i]);
 
       slist[i].length = size[i];
-      slist[i].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[i]][gctx->rank].mr[0])->lkey;
+      slist[i].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[i]]->local.mr[0])->lkey;
 
-      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]][rank].data.addr +
+      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]]->remote[rank].addr +
 				    offset_remote[i]);
 
-      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]][rank].rkey[0];
+      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]]->remote[rank].rkey[0];
       swr[i].sg_list = &slist[i];
       swr[i].num_sge = 1;
       swr[i].wr_id = rank;
@@ -318,7 +320,7 @@ pgaspi_dev_read_list (const gaspi_number_t num,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue] += num;
+  gctx->ne_count_c[queue].count += num;
 
   return GASPI_SUCCESS;
 }
@@ -344,16 +346,16 @@ pgaspi_dev_notify (const gaspi_segment_id_t segment_id_remote,
   slistN.lkey = ((struct ibv_mr *) gctx->nsrc.mr[1])->lkey;
 
 #ifdef GPI2_CUDA
-  if( gctx->rrmd[segment_id_remote][rank].cuda_dev_id >= 0)
+  if( gctx->rrmd[segment_id_remote]->remote[rank].cuda_dev_id >= 0)
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].host_addr + notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].host_rkey;
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].host_addr + notification_id * sizeof(gaspi_notification_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].host_rkey;
     }
   else
 #endif
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].notif_spc.addr + notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[1];
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].notif_addr + notification_id * sizeof(gaspi_notification_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[1];
     }
 
   swrN.sg_list = &slistN;
@@ -368,7 +370,7 @@ pgaspi_dev_notify (const gaspi_segment_id_t segment_id_remote,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -389,16 +391,16 @@ pgaspi_dev_write_notify (const gaspi_segment_id_t segment_id_local,
   struct ibv_send_wr swr, swrN;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr +
+  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr +
 			    offset_local);
 
   slist.length = size;
-  slist.lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local][gctx->rank].mr[0])->lkey;
+  slist.lkey = ((struct ibv_mr *)gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
 
-  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].data.addr +
+  swr.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].addr +
 			     offset_remote);
 
-  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[0];
+  swr.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[0];
   swr.sg_list = &slist;
   swr.num_sge = 1;
   swr.wr_id = rank;
@@ -414,16 +416,16 @@ pgaspi_dev_write_notify (const gaspi_segment_id_t segment_id_local,
   slistN.lkey = ((struct ibv_mr *) gctx->nsrc.mr[1])->lkey;
 
 #ifdef GPI2_CUDA
-  if((gctx->rrmd[segment_id_remote][rank].cuda_dev_id >= 0))
+  if((gctx->rrmd[segment_id_remote]->remote[rank].cuda_dev_id >= 0))
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].host_addr + notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].host_rkey;
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].host_addr + notification_id * sizeof(gaspi_notification_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].host_rkey;
     }
   else
 #endif
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].notif_spc.addr + notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[1];
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].notif_addr + notification_id * sizeof(gaspi_notification_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[1];
     }
 
   swrN.sg_list = &slistN;
@@ -438,7 +440,7 @@ pgaspi_dev_write_notify (const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue] += 2;
+  gctx->ne_count_c[queue].count += 2;
 
   return GASPI_SUCCESS;
 }
@@ -466,16 +468,16 @@ pgaspi_dev_write_list_notify (const gaspi_number_t num,
   for (i = 0; i < num; i++)
     {
 
-      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]][gctx->rank].data.addr +
+      slist[i].addr = (uintptr_t) (gctx->rrmd[segment_id_local[i]]->local.data.addr +
 				   offset_local[i]);
 
       slist[i].length = size[i];
-      slist[i].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[i]][gctx->rank].mr[0])->lkey;
+      slist[i].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[i]]->local.mr[0])->lkey;
 
-      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]][rank].data.addr +
+      swr[i].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[i]]->remote[rank].addr +
 				    offset_remote[i]);
 
-      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]][rank].rkey[0];
+      swr[i].wr.rdma.rkey = gctx->rrmd[segment_id_remote[i]]->remote[rank].rkey[0];
       swr[i].sg_list = &slist[i];
       swr[i].num_sge = 1;
       swr[i].wr_id = rank;
@@ -495,17 +497,17 @@ pgaspi_dev_write_list_notify (const gaspi_number_t num,
   slistN.lkey = ((struct ibv_mr *) gctx->nsrc.mr[1])->lkey;
 
 #ifdef GPI2_CUDA
-  if(gctx->rrmd[segment_id_notification][rank].cuda_dev_id >= 0)
+  if(gctx->rrmd[segment_id_notification]->remote[rank].cuda_dev_id >= 0)
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_notification][rank].host_addr + notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_notification][rank].host_rkey;
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_notification]->remote[rank].host_addr + notification_id * sizeof(gaspi_notification_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_notification]->remote[rank].host_rkey;
     }
   else
 #endif
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_notification][rank].notif_spc.addr +
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_notification]->remote[rank].notif_addr +
 				  notification_id * sizeof(gaspi_notification_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_notification][rank].rkey[1];
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_notification]->remote[rank].rkey[1];
     }
 
   swrN.sg_list = &slistN;
@@ -520,7 +522,7 @@ pgaspi_dev_write_list_notify (const gaspi_number_t num,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue] += (int) (num + 1);
+  gctx->ne_count_c[queue].count += (int) (num + 1);
 
   return GASPI_SUCCESS;
 }
@@ -535,7 +537,7 @@ _gaspi_event_send(gaspi_cuda_event_t* event, int queue)
   struct ibv_send_wr *bad_wr;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  swr.wr.rdma.rkey = gctx->rrmd[event->segment_remote][event->rank].rkey[0];
+  swr.wr.rdma.rkey = gctx->rrmd[event->segment_remote]->remote[event->rank].rkey[0];
   swr.sg_list    = &slist;
   swr.num_sge    = 1;
   swr.wr_id      = event->rank;
@@ -543,12 +545,12 @@ _gaspi_event_send(gaspi_cuda_event_t* event, int queue)
   swr.send_flags = IBV_SEND_SIGNALED;
   swr.next       = NULL;
 
-  slist.addr = (uintptr_t) (char*)(gctx->rrmd[event->segment_local][event->rank].host_ptr + NOTIFY_OFFSET + event->offset_local);
+  slist.addr = (uintptr_t) (char*)(gctx->rrmd[event->segment_local]->local.host_ptr + gctx->rrmd[event->segment_local]->local.notif_spc_size + event->offset_local);
 
   slist.length = event->size;
-  slist.lkey = ((struct ibv_mr *)gctx->rrmd[event->segment_local][gctx->rank].host_mr)->lkey;
+  slist.lkey = ((struct ibv_mr *)gctx->rrmd[event->segment_local]->local.host_mr)->lkey;
 
-  swr.wr.rdma.remote_addr = (gctx->rrmd[event->segment_remote][event->rank].data.addr + event->offset_remote);
+  swr.wr.rdma.remote_addr = (gctx->rrmd[event->segment_remote]->remote[event->rank].addr + event->offset_remote);
 
   if( ibv_post_send(glb_gaspi_ctx_ib.qpC[queue][event->rank], &swr, &bad_wr) )
     {
@@ -557,7 +559,7 @@ _gaspi_event_send(gaspi_cuda_event_t* event, int queue)
       return -1;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   event->ib_use = 1;
 
@@ -576,7 +578,7 @@ pgaspi_dev_gpu_write(const gaspi_segment_id_t segment_id_local,
 {
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if( gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id < 0 ||
+  if( gctx->rrmd[segment_id_local]->local.cuda_dev_id < 0 ||
       size <= GASPI_GPU_DIRECT_MAX )
     {
       return pgaspi_dev_write(segment_id_local, offset_local, rank,
@@ -584,11 +586,11 @@ pgaspi_dev_gpu_write(const gaspi_segment_id_t segment_id_local,
 			     queue);
     }
 
-  char* host_ptr = (char*)(gctx->rrmd[segment_id_local][gctx->rank].host_ptr + NOTIFY_OFFSET + offset_local);
-  char* device_ptr = (char*)(gctx->rrmd[segment_id_local][gctx->rank].data.addr + offset_local);
+  char* host_ptr = (char*)(gctx->rrmd[segment_id_local]->local.host_ptr + gctx->rrmd[segment_id_local]->local.notif_spc_size + offset_local);
+  char* device_ptr = (char*)(gctx->rrmd[segment_id_local]->local.data.addr + offset_local);
 
   //TODO: look every time for a gpu? why?
-  gaspi_gpu_t* agpu = _gaspi_find_gpu(gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id);
+  gaspi_gpu_t* agpu = _gaspi_find_gpu(gctx->rrmd[segment_id_local]->local.cuda_dev_id);
   if( !agpu )
     {
       gaspi_print_error("No GPU found or not initialized.");
@@ -626,7 +628,7 @@ pgaspi_dev_gpu_write(const gaspi_segment_id_t segment_id_local,
 	      return GASPI_ERROR;
 	    }
 	  //TODO: not here
-	  gctx->ne_count_c[queue]++;
+	  gctx->ne_count_c[queue].count++;
 
 	  /* Keep track of event to query later on */
 	  agpu->events[queue][i].segment_remote = segment_id_remote;
@@ -661,7 +663,7 @@ pgaspi_dev_gpu_write(const gaspi_segment_id_t segment_id_local,
 	      do
 		{
 		  ne = ibv_poll_cq (glb_gaspi_ctx_ib.scqC[queue], 1, &wc);
-		  gctx->ne_count_c[queue] -= ne; //TODO: this should be done below, when ne > 0
+		  gctx->ne_count_c[queue].count -= ne; //TODO: this should be done below, when ne > 0
 		  if( ne == 0 )
 		    {
 		      const gaspi_cycles_t s1 = gaspi_get_cycles ();
@@ -734,7 +736,7 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
 {
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if( gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id < 0 ||
+  if( gctx->rrmd[segment_id_local]->local.cuda_dev_id < 0 ||
       size <= GASPI_GPU_DIRECT_MAX )
     {
       return pgaspi_dev_write_notify( segment_id_local, offset_local, rank,
@@ -743,11 +745,11 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
 				 queue);
     }
 
-  char *host_ptr = (char*)(gctx->rrmd[segment_id_local][gctx->rank].host_ptr + NOTIFY_OFFSET + offset_local);
-  char* device_ptr =(char*)(gctx->rrmd[segment_id_local][gctx->rank].data.addr + offset_local);
+  char *host_ptr = (char*)(gctx->rrmd[segment_id_local]->local.host_ptr + gctx->rrmd[segment_id_local]->local.notif_spc_size + offset_local);
+  char* device_ptr =(char*)(gctx->rrmd[segment_id_local]->local.data.addr + offset_local);
 
   //TODO: again the look up for the gpu?
-  gaspi_gpu_t* agpu = _gaspi_find_gpu(gctx->rrmd[segment_id_local][gctx->rank].cuda_dev_id);
+  gaspi_gpu_t* agpu = _gaspi_find_gpu(gctx->rrmd[segment_id_local]->local.cuda_dev_id);
   if( !agpu )
     {
       gaspi_print_error("No GPU found or not initialized.");
@@ -784,7 +786,7 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
 	      return GASPI_ERROR;
 	    }
 	  //TODO: not here?
-	  gctx->ne_count_c[queue]++;
+	  gctx->ne_count_c[queue].count++;
 
 	  agpu->events[queue][i].segment_remote = segment_id_remote;
 	  agpu->events[queue][i].segment_local = segment_id_local;
@@ -808,7 +810,7 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
 	      do
 		{
 		  ne = ibv_poll_cq (glb_gaspi_ctx_ib.scqC[queue], 1, &wc);
-		  gctx->ne_count_c[queue] -= ne; //TODO: this should be done below, when ne > 0
+		  gctx->ne_count_c[queue].count -= ne; //TODO: this should be done below, when ne > 0
 		  if( ne == 0 )
 		    {
 		      const gaspi_cycles_t s1 = gaspi_get_cycles ();
@@ -882,15 +884,15 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
   slistN.length = sizeof(gaspi_notification_id_t);
   slistN.lkey =((struct ibv_mr *) gctx->nsrc.mr)->lkey;
 
-  if( gctx->rrmd[segment_id_remote][rank].cuda_dev_id >= 0 )
+  if( gctx->rrmd[segment_id_remote]->remote[rank].cuda_dev_id >= 0 )
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].host_addr + notification_id * sizeof(gaspi_notification_id_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].host_rkey;
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].host_addr + notification_id * sizeof(gaspi_notification_id_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].host_rkey;
     }
   else
     {
-      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote][rank].notif_spc.addr + notification_id * sizeof(gaspi_notification_id_t));
-      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote][rank].rkey[1];
+      swrN.wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].notif_addr + notification_id * sizeof(gaspi_notification_id_t));
+      swrN.wr.rdma.rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[1];
     }
 
   swrN.sg_list = &slistN;
@@ -906,7 +908,7 @@ pgaspi_dev_gpu_write_notify(const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -935,3 +937,550 @@ _gaspi_find_dev_numa_node(void)
 }
 
 #endif //GPI2_CUDA
+
+/* Strided transfers: the blocks on the local side are gathered
+   (write) or scattered (read) with SGE lists. A new work request is
+   needed whenever the remote blocks are not contiguous or the SGE
+   limit of the device is reached. */
+#define GASPI_IB_STRIDED_WR_MAX (64)
+
+/* Number of work requests of a strided transfer (same grouping as
+   _pgaspi_dev_post_strided) */
+static gaspi_size_t
+_pgaspi_dev_strided_wr_num(gaspi_offset_t const * const stride_remote,
+			   gaspi_size_t const * const count,
+			   const gaspi_number_t stride_levels)
+{
+  const gaspi_size_t n1 = count[1];
+  const gaspi_size_t n2 = (stride_levels > 1) ? count[2] : 1;
+
+  gaspi_size_t i1, i2, wrs = 0;
+  int sges = 0;
+  gaspi_offset_t remote_next = 0;
+
+  for(i2 = 0; i2 < n2; i2++)
+    {
+      for(i1 = 0; i1 < n1; i1++)
+	{
+	  gaspi_offset_t raddr = i1 * stride_remote[0];
+	  if( stride_levels > 1 )
+	    {
+	      raddr += i2 * stride_remote[1];
+	    }
+
+	  if( wrs > 0 && raddr == remote_next && sges < glb_gaspi_ctx_ib.max_send_sge )
+	    {
+	      sges++;
+	    }
+	  else
+	    {
+	      wrs++;
+	      sges = 1;
+	    }
+
+	  remote_next = raddr + count[0];
+	}
+    }
+
+  return wrs;
+}
+
+static gaspi_return_t
+_pgaspi_dev_post_strided (const enum ibv_wr_opcode opcode,
+			  const gaspi_segment_id_t segment_id_local,
+			  const gaspi_offset_t offset_local,
+			  gaspi_offset_t const * const stride_local,
+			  const gaspi_rank_t rank,
+			  const gaspi_segment_id_t segment_id_remote,
+			  const gaspi_offset_t offset_remote,
+			  gaspi_offset_t const * const stride_remote,
+			  gaspi_size_t const * const count,
+			  const gaspi_number_t stride_levels,
+			  const gaspi_number_t reserve,
+			  const gaspi_queue_id_t queue)
+{
+  struct ibv_send_wr *bad_wr;
+  struct ibv_sge slist[GASPI_IB_STRIDED_WR_MAX * MAX_SEND_SGE];
+  struct ibv_send_wr swr[GASPI_IB_STRIDED_WR_MAX];
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  const uint32_t lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
+  const uint32_t rkey = gctx->rrmd[segment_id_remote]->remote[rank].rkey[0];
+  const uintptr_t local_base = gctx->rrmd[segment_id_local]->local.data.addr + offset_local;
+  const uintptr_t remote_base = gctx->rrmd[segment_id_remote]->remote[rank].addr + offset_remote;
+
+  const gaspi_size_t n1 = count[1];
+  const gaspi_size_t n2 = (stride_levels > 1) ? count[2] : 1;
+
+  /* All of it or nothing: the queue must take every work request,
+     also the reserve ones posted right after (e.g. a notification) */
+  if( gctx->ne_count_c[queue].count
+      + _pgaspi_dev_strided_wr_num(stride_remote, count, stride_levels)
+      + reserve > glb_gaspi_cfg.queue_size_max )
+    {
+      return GASPI_ERR_MANY_Q_REQS;
+    }
+
+  gaspi_size_t i1, i2;
+  int w = -1, s = 0;
+  uintptr_t remote_next = 0;
+
+  for(i2 = 0; i2 < n2; i2++)
+    {
+      for(i1 = 0; i1 < n1; i1++)
+	{
+	  uintptr_t laddr = local_base + i1 * stride_local[0];
+	  uintptr_t raddr = remote_base + i1 * stride_remote[0];
+
+	  if( stride_levels > 1 )
+	    {
+	      laddr += i2 * stride_local[1];
+	      raddr += i2 * stride_remote[1];
+	    }
+
+	  /* remote block contiguous with previous one: extend SGE list */
+	  if( w >= 0 && raddr == remote_next && swr[w].num_sge < glb_gaspi_ctx_ib.max_send_sge )
+	    {
+	      slist[s].addr = laddr;
+	      slist[s].length = count[0];
+	      slist[s].lkey = lkey;
+	      swr[w].num_sge++;
+	      s++;
+	    }
+	  else
+	    {
+	      if( w == GASPI_IB_STRIDED_WR_MAX - 1 )
+		{
+		  swr[w].next = NULL;
+		  if( ibv_post_send (glb_gaspi_ctx_ib.qpC[queue][rank], &swr[0], &bad_wr) )
+		    {
+		      /* The ones before bad_wr were posted and complete */
+		      gctx->ne_count_c[queue].count += (bad_wr - swr);
+		      return GASPI_ERROR;
+		    }
+
+		  gctx->ne_count_c[queue].count += GASPI_IB_STRIDED_WR_MAX;
+		  w = -1;
+		  s = 0;
+		}
+
+	      if( w >= 0 )
+		{
+		  swr[w].next = &swr[w + 1];
+		}
+	      w++;
+
+	      slist[s].addr = laddr;
+	      slist[s].length = count[0];
+	      slist[s].lkey = lkey;
+
+	      swr[w].wr.rdma.remote_addr = raddr;
+	      swr[w].wr.rdma.rkey = rkey;
+	      swr[w].sg_list = &slist[s];
+	      swr[w].num_sge = 1;
+	      swr[w].wr_id = rank;
+	      swr[w].opcode = opcode;
+	      swr[w].send_flags = IBV_SEND_SIGNALED;
+	      swr[w].next = NULL;
+	      s++;
+	    }
+
+	  remote_next = raddr + count[0];
+	}
+    }
+
+  if( ibv_post_send (glb_gaspi_ctx_ib.qpC[queue][rank], &swr[0], &bad_wr) )
+    {
+      gctx->ne_count_c[queue].count += (bad_wr - swr);
+      return GASPI_ERROR;
+    }
+
+  gctx->ne_count_c[queue].count += (w + 1);
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_write_strided (const gaspi_segment_id_t segment_id_local,
+			  const gaspi_offset_t offset_local,
+			  gaspi_offset_t const * const stride_local,
+			  const gaspi_rank_t rank,
+			  const gaspi_segment_id_t segment_id_remote,
+			  const gaspi_offset_t offset_remote,
+			  gaspi_offset_t const * const stride_remote,
+			  gaspi_size_t const * const count,
+			  const gaspi_number_t stride_levels,
+			  const gaspi_queue_id_t queue)
+{
+  return _pgaspi_dev_post_strided(IBV_WR_RDMA_WRITE,
+				  segment_id_local, offset_local, stride_local,
+				  rank,
+				  segment_id_remote, offset_remote, stride_remote,
+				  count, stride_levels, 0, queue);
+}
+
+gaspi_return_t
+pgaspi_dev_write_strided_notify (const gaspi_segment_id_t segment_id_local,
+				 const gaspi_offset_t offset_local,
+				 gaspi_offset_t const * const stride_local,
+				 const gaspi_rank_t rank,
+				 const gaspi_segment_id_t segment_id_remote,
+				 const gaspi_offset_t offset_remote,
+				 gaspi_offset_t const * const stride_remote,
+				 gaspi_size_t const * const count,
+				 const gaspi_number_t stride_levels,
+				 const gaspi_notification_id_t notification_id,
+				 const gaspi_notification_t notification_value,
+				 const gaspi_queue_id_t queue)
+{
+  const gaspi_return_t eret =
+    _pgaspi_dev_post_strided(IBV_WR_RDMA_WRITE,
+			     segment_id_local, offset_local, stride_local,
+			     rank,
+			     segment_id_remote, offset_remote, stride_remote,
+			     count, stride_levels, 1, queue);
+  if( eret != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  return pgaspi_dev_notify(segment_id_remote, rank, notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+pgaspi_dev_read_strided (const gaspi_segment_id_t segment_id_local,
+			 const gaspi_offset_t offset_local,
+			 gaspi_offset_t const * const stride_local,
+			 const gaspi_rank_t rank,
+			 const gaspi_segment_id_t segment_id_remote,
+			 const gaspi_offset_t offset_remote,
+			 gaspi_offset_t const * const stride_remote,
+			 gaspi_size_t const * const count,
+			 const gaspi_number_t stride_levels,
+			 const gaspi_queue_id_t queue)
+{
+  return _pgaspi_dev_post_strided(IBV_WR_RDMA_READ,
+				  segment_id_local, offset_local, stride_local,
+				  rank,
+				  segment_id_remote, offset_remote, stride_remote,
+				  count, stride_levels, 0, queue);
+}
+
+/* Post the chained requests of a group (to a single rank). On
+   failure the ones before the bad request were posted and are
+   counted as well. */
+static int
+_pgaspi_dev_post_group (const gaspi_queue_id_t queue,
+			const gaspi_rank_t rank,
+			struct ibv_send_wr * const head,
+			const gaspi_number_t num_wr)
+{
+  struct ibv_send_wr *bad_wr;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  if( ibv_post_send(glb_gaspi_ctx_ib.qpC[queue][rank], head, &bad_wr) )
+    {
+      struct ibv_send_wr *wr;
+      for(wr = head; wr != NULL && wr != bad_wr; wr = wr->next)
+	{
+	  gctx->ne_count_c[queue].count++;
+	}
+      return -1;
+    }
+
+  gctx->ne_count_c[queue].count += (int) num_wr;
+
+  return 0;
+}
+
+gaspi_return_t
+pgaspi_dev_write_notify_batch (const gaspi_number_t num,
+			       gaspi_segment_id_t * const segment_id_local,
+			       gaspi_offset_t * const offset_local,
+			       gaspi_rank_t * const rank,
+			       gaspi_segment_id_t * const segment_id_remote,
+			       gaspi_offset_t * const offset_remote,
+			       gaspi_size_t * const size,
+			       gaspi_notification_id_t * const notification_id,
+			       gaspi_notification_t * const notification_value,
+			       const gaspi_queue_id_t queue,
+			       gaspi_rank_t * const rank_failed)
+{
+  struct ibv_sge slist[2 * GASPI_MAX_BATCH];
+  struct ibv_send_wr swr[2 * GASPI_MAX_BATCH];
+  struct ibv_send_wr *head[GASPI_MAX_BATCH], *tail[GASPI_MAX_BATCH];
+  gaspi_rank_t group_rank[GASPI_MAX_BATCH];
+  gaspi_number_t group_num_wr[GASPI_MAX_BATCH];
+  gaspi_notification_t notif_val[GASPI_MAX_BATCH];
+  gaspi_number_t n, g, w = 0, num_groups = 0;
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* Requests to the same rank are chained and posted at once */
+  for(n = 0; n < num; n++)
+    {
+      const gaspi_number_t first = w;
+
+      slist[w].addr = (uintptr_t) (gctx->rrmd[segment_id_local[n]]->local.data.addr +
+				   offset_local[n]);
+      slist[w].length = size[n];
+      slist[w].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[n]]->local.mr[0])->lkey;
+
+      swr[w].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].addr +
+				    offset_remote[n]);
+      swr[w].wr.rdma.rkey = gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].rkey[0];
+      swr[w].sg_list = &slist[w];
+      swr[w].num_sge = 1;
+      swr[w].wr_id = rank[n];
+      swr[w].opcode = IBV_WR_RDMA_WRITE;
+      swr[w].send_flags = IBV_SEND_SIGNALED;
+      swr[w].next = NULL;
+      w++;
+
+      if( notification_value != NULL && notification_value[n] != 0 )
+	{
+	  notif_val[n] = notification_value[n];
+
+	  slist[w].addr = (uintptr_t) &notif_val[n];
+	  slist[w].length = sizeof(gaspi_notification_t);
+	  slist[w].lkey = ((struct ibv_mr *) gctx->nsrc.mr[1])->lkey;
+
+	  swr[w].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].notif_addr +
+					notification_id[n] * sizeof(gaspi_notification_t));
+	  swr[w].wr.rdma.rkey = gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].rkey[1];
+	  swr[w].sg_list = &slist[w];
+	  swr[w].num_sge = 1;
+	  swr[w].wr_id = rank[n];
+	  swr[w].opcode = IBV_WR_RDMA_WRITE;
+	  swr[w].send_flags = IBV_SEND_SIGNALED | IBV_SEND_INLINE;
+	  swr[w].next = NULL;
+	  swr[first].next = &swr[w];
+	  w++;
+	}
+
+      for(g = 0; g < num_groups; g++)
+	{
+	  if( group_rank[g] == rank[n] )
+	    break;
+	}
+
+      if( g == num_groups )
+	{
+	  group_rank[g] = rank[n];
+	  group_num_wr[g] = 0;
+	  head[g] = &swr[first];
+	  num_groups++;
+	}
+      else
+	{
+	  tail[g]->next = &swr[first];
+	}
+
+      tail[g] = &swr[w - 1];
+      group_num_wr[g] += w - first;
+    }
+
+  for(g = 0; g < num_groups; g++)
+    {
+      if( _pgaspi_dev_post_group(queue, group_rank[g], head[g], group_num_wr[g]) != 0 )
+	{
+	  *rank_failed = group_rank[g];
+	  return GASPI_ERROR;
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+/* Persistent plans */
+typedef struct
+{
+  gaspi_number_t num_groups;       /* number of distinct target ranks */
+  gaspi_rank_t *group_rank;        /* target rank of each group */
+  gaspi_number_t *group_num_wr;    /* number of requests of each group */
+  struct ibv_send_wr **group_head; /* first request of each group */
+  struct ibv_send_wr *swr;
+  struct ibv_sge *slist;
+  gaspi_notification_t *notif_val; /* source of the (inlined) notifications */
+} ib_dev_plan_t;
+
+static void
+_pgaspi_dev_plan_free (ib_dev_plan_t *dplan)
+{
+  if( dplan != NULL )
+    {
+      free(dplan->group_rank);
+      free(dplan->group_num_wr);
+      free(dplan->group_head);
+      free(dplan->swr);
+      free(dplan->slist);
+      free(dplan->notif_val);
+      free(dplan);
+    }
+}
+
+gaspi_return_t
+pgaspi_dev_plan_create (gaspi_plan_t plan,
+			gaspi_segment_id_t * const segment_id_local,
+			gaspi_offset_t * const offset_local,
+			gaspi_segment_id_t * const segment_id_remote,
+			gaspi_offset_t * const offset_remote,
+			gaspi_size_t * const size,
+			gaspi_notification_id_t * const notification_id,
+			gaspi_notification_t * const notification_value)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  gaspi_number_t n, g, num_wr = plan->num;
+
+  if( notification_value != NULL )
+    {
+      for(n = 0; n < plan->num; n++)
+	{
+	  if( notification_value[n] != 0 )
+	    {
+	      num_wr++;
+	    }
+	}
+    }
+
+  ib_dev_plan_t *dplan = calloc(1, sizeof(ib_dev_plan_t));
+  if( dplan == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  dplan->group_rank = malloc(plan->num * sizeof(gaspi_rank_t));
+  dplan->group_num_wr = calloc(plan->num, sizeof(gaspi_number_t));
+  dplan->group_head = malloc(plan->num * sizeof(struct ibv_send_wr *));
+  dplan->swr = calloc(num_wr, sizeof(struct ibv_send_wr));
+  dplan->slist = calloc(num_wr, sizeof(struct ibv_sge));
+  dplan->notif_val = malloc(plan->num * sizeof(gaspi_notification_t));
+
+  if( dplan->group_rank == NULL || dplan->group_num_wr == NULL || dplan->group_head == NULL
+      || dplan->swr == NULL || dplan->slist == NULL || dplan->notif_val == NULL )
+    {
+      _pgaspi_dev_plan_free(dplan);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  /* Requests to the same rank are chained (in the given order) and
+     posted with a single call on that rank's queue pair */
+  struct ibv_send_wr **group_tail = malloc(plan->num * sizeof(struct ibv_send_wr *));
+  if( group_tail == NULL )
+    {
+      _pgaspi_dev_plan_free(dplan);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  gaspi_number_t w = 0;
+  for(n = 0; n < plan->num; n++)
+    {
+      const gaspi_rank_t rank = plan->rank[n];
+      const gaspi_number_t first = w;
+
+      dplan->slist[w].addr = (uintptr_t) (gctx->rrmd[segment_id_local[n]]->local.data.addr +
+					  offset_local[n]);
+      dplan->slist[w].length = size[n];
+      dplan->slist[w].lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local[n]]->local.mr[0])->lkey;
+
+      dplan->swr[w].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank].addr +
+					   offset_remote[n]);
+      dplan->swr[w].wr.rdma.rkey = gctx->rrmd[segment_id_remote[n]]->remote[rank].rkey[0];
+      dplan->swr[w].sg_list = &dplan->slist[w];
+      dplan->swr[w].num_sge = 1;
+      dplan->swr[w].wr_id = rank;
+      dplan->swr[w].opcode = IBV_WR_RDMA_WRITE;
+      dplan->swr[w].send_flags = IBV_SEND_SIGNALED;
+      dplan->swr[w].next = NULL;
+      w++;
+
+      if( notification_value != NULL && notification_value[n] != 0 )
+	{
+	  dplan->notif_val[n] = notification_value[n];
+
+	  dplan->slist[w].addr = (uintptr_t) &dplan->notif_val[n];
+	  dplan->slist[w].length = sizeof(gaspi_notification_t);
+	  dplan->slist[w].lkey = ((struct ibv_mr *) gctx->nsrc.mr[1])->lkey;
+
+#ifdef GPI2_CUDA
+	  if(gctx->rrmd[segment_id_remote[n]]->remote[rank].cuda_dev_id >= 0)
+	    {
+	      dplan->swr[w].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank].host_addr +
+						   notification_id[n] * sizeof(gaspi_notification_t));
+	      dplan->swr[w].wr.rdma.rkey = gctx->rrmd[segment_id_remote[n]]->remote[rank].host_rkey;
+	    }
+	  else
+#endif
+	    {
+	      dplan->swr[w].wr.rdma.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank].notif_addr +
+						   notification_id[n] * sizeof(gaspi_notification_t));
+	      dplan->swr[w].wr.rdma.rkey = gctx->rrmd[segment_id_remote[n]]->remote[rank].rkey[1];
+	    }
+
+	  dplan->swr[w].sg_list = &dplan->slist[w];
+	  dplan->swr[w].num_sge = 1;
+	  dplan->swr[w].wr_id = rank;
+	  dplan->swr[w].opcode = IBV_WR_RDMA_WRITE;
+	  dplan->swr[w].send_flags = IBV_SEND_SIGNALED | IBV_SEND_INLINE;
+	  dplan->swr[w].next = NULL;
+	  dplan->swr[first].next = &dplan->swr[w];
+	  w++;
+	}
+
+      for(g = 0; g < dplan->num_groups; g++)
+	{
+	  if( dplan->group_rank[g] == rank )
+	    break;
+	}
+
+      if( g == dplan->num_groups )
+	{
+	  dplan->group_rank[g] = rank;
+	  dplan->group_head[g] = &dplan->swr[first];
+	  dplan->num_groups++;
+	}
+      else
+	{
+	  group_tail[g]->next = &dplan->swr[first];
+	}
+
+      group_tail[g] = &dplan->swr[w - 1];
+      dplan->group_num_wr[g] += w - first;
+    }
+
+  free(group_tail);
+
+  plan->num_wr = num_wr;
+  plan->dev_plan = dplan;
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_plan_start (const gaspi_plan_t plan,
+		       const gaspi_queue_id_t queue,
+		       gaspi_rank_t * const rank_failed)
+{
+  ib_dev_plan_t * const dplan = (ib_dev_plan_t *) plan->dev_plan;
+  gaspi_number_t g;
+
+  for(g = 0; g < dplan->num_groups; g++)
+    {
+      if( _pgaspi_dev_post_group(queue, dplan->group_rank[g],
+				 dplan->group_head[g], dplan->group_num_wr[g]) != 0 )
+	{
+	  *rank_failed = dplan->group_rank[g];
+	  return GASPI_ERROR;
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_plan_delete (gaspi_plan_t plan)
+{
+  _pgaspi_dev_plan_free((ib_dev_plan_t *) plan->dev_plan);
+  plan->dev_plan = NULL;
+
+  return GASPI_SUCCESS;
+}
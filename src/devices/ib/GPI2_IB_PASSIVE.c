@@ -42,10 +42,10 @@ pgaspi_dev_passive_send (const gaspi_segment_id_t segment_id_local,
       goto checkL;
     }
 
-  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr +
+  slist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr +
 			    offset_local);
   slist.length = size;
-  slist.lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local][gctx->rank].mr[0])->lkey;
+  slist.lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
 
   swr.sg_list = &slist;
   swr.num_sge = 1;
@@ -112,10 +112,10 @@ pgaspi_dev_passive_receive (const gaspi_segment_id_t segment_id_local,
   struct timeval tout;
   gaspi_context_t const * const gctx = &glb_gaspi_ctx;
 
-  rlist.addr = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr +
+  rlist.addr = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr +
 			    offset_local);
   rlist.length = size;
-  rlist.lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local][gctx->rank].mr[0])->lkey;
+  rlist.lkey = ((struct ibv_mr *) gctx->rrmd[segment_id_local]->local.mr[0])->lkey;
   rwr.wr_id = gctx->rank;
   rwr.sg_list = &rlist;
   rwr.num_sge = 1;
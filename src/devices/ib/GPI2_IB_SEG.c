@@ -31,6 +31,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GASPI.h"
 #include "GPI2.h"
 #include "GPI2_IB.h"
+#include "GPI2_SEG.h"
 /* #include "GPI2_SN.h" */
 
 int
@@ -103,19 +104,22 @@ pgaspi_dev_segment_alloc (const gaspi_segment_id_t segment_id,
 {
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  if (gctx->rrmd[segment_id] == NULL)
-    {
-      gctx->rrmd[segment_id] = (gaspi_rc_mseg_t *) calloc (gctx->tnc, sizeof (gaspi_rc_mseg_t));
+  if( pgaspi_segment_create_desc(gctx, segment_id) != 0 )
+    goto errL;
 
-      if(!gctx->rrmd[segment_id])
-	goto errL;
+  if (gctx->rrmd[segment_id]->local.size)
+    {
+      goto okL;
     }
 
-  if (gctx->rrmd[segment_id][gctx->rank].size)
+  const size_t notif_size = gaspi_segment_notif_size(alloc_policy);
+  if( notif_size == 0 )
     {
-      goto okL;
+      goto errL;
     }
 
+  gctx->rrmd[segment_id]->local.notif_spc_size = notif_size;
+
   if( alloc_policy & GASPI_MEM_GPU )
     {
       if( size > GASPI_GPU_MAX_SEG )
@@ -124,14 +128,14 @@ pgaspi_dev_segment_alloc (const gaspi_segment_id_t segment_id,
 	  goto errL;
 	}
 
-      cudaError_t cuda_error_id = cudaGetDevice(&gctx->rrmd[segment_id][gctx->rank].cuda_dev_id);
+      cudaError_t cuda_error_id = cudaGetDevice(&gctx->rrmd[segment_id]->local.cuda_dev_id);
       if( cuda_error_id != cudaSuccess )
 	{
 	  gaspi_print_error("Failed cudaGetDevice." );
 	  return GASPI_ERROR;
 	}
 
-      gaspi_gpu_t* agpu =  _gaspi_find_gpu(gctx->rrmd[segment_id][gctx->rank].cuda_dev_id);
+      gaspi_gpu_t* agpu =  _gaspi_find_gpu(gctx->rrmd[segment_id]->local.cuda_dev_id);
       if( !agpu )
 	{
 	  gaspi_print_error("No GPU found. Maybe forgot to call gaspi_init_GPUs?");
@@ -139,90 +143,89 @@ pgaspi_dev_segment_alloc (const gaspi_segment_id_t segment_id,
 	}
 
       /* Allocate device memory for data */
-      if( cudaMalloc((void**)&gctx->rrmd[segment_id][gctx->rank].data.ptr, size ) != 0)
+      if( cudaMalloc((void**)&gctx->rrmd[segment_id]->local.data.ptr, size ) != 0)
 	{
 	  gaspi_print_error("GPU memory allocation (cudaMalloc) failed.");
 	  goto errL;
 	}
 
       /* Allocate host memory for data and notifications */
-      if( cudaMallocHost((void**)&gctx->rrmd[segment_id][gctx->rank].host_ptr, size + NOTIFY_OFFSET ) != 0)
+      if( cudaMallocHost((void**)&gctx->rrmd[segment_id]->local.host_ptr, size + notif_size ) != 0)
 	{
 	  gaspi_print_error("Memory allocattion (cudaMallocHost)  failed.");
 	  goto errL;
 	}
 
-      memset(gctx->rrmd[segment_id][gctx->rank].host_ptr, 0, size + NOTIFY_OFFSET);
+      memset(gctx->rrmd[segment_id]->local.host_ptr, 0, size + notif_size);
 
       /* Register host memory */
-      gctx->rrmd[segment_id][gctx->rank].host_mr =
+      gctx->rrmd[segment_id]->local.host_mr =
 	ibv_reg_mr( glb_gaspi_ctx_ib.pd,
-		    gctx->rrmd[segment_id][gctx->rank].host_ptr,
-		    NOTIFY_OFFSET + size,
+		    gctx->rrmd[segment_id]->local.host_ptr,
+		    notif_size + size,
 		    IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_LOCAL_WRITE |
 		    IBV_ACCESS_REMOTE_READ|IBV_ACCESS_REMOTE_ATOMIC);
 
-      if( gctx->rrmd[segment_id][gctx->rank].host_mr == NULL )
+      if( gctx->rrmd[segment_id]->local.host_mr == NULL )
 	{
 	  gaspi_print_error("Memory registration failed (libibverbs).");
 	  goto errL;
 	}
 
-      if( alloc_policy == GASPI_MEM_INITIALIZED )
+      if( alloc_policy & GASPI_MEM_INITIALIZED )
 	{
-	  cudaMemset(gctx->rrmd[segment_id][gctx->rank].data.ptr, 0, size);
+	  cudaMemset(gctx->rrmd[segment_id]->local.data.ptr, 0, size);
 	}
 
       /* Register device memory */
-      gctx->rrmd[segment_id][gctx->rank].mr[0] =
+      gctx->rrmd[segment_id]->local.mr[0] =
 	ibv_reg_mr( glb_gaspi_ctx_ib.pd,
-		    gctx->rrmd[segment_id][gctx->rank].data.buf,
+		    gctx->rrmd[segment_id]->local.data.buf,
 		    size,
 		    IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_LOCAL_WRITE |
 		    IBV_ACCESS_REMOTE_READ | IBV_ACCESS_REMOTE_ATOMIC);
 
-      if( gctx->rrmd[segment_id][gctx->rank].mr[0] == NULL )
+      if( gctx->rrmd[segment_id]->local.mr[0] == NULL )
 	{
 	  gaspi_print_error ("Memory registration failed (libibverbs)");
 	  goto errL;
 	}
 
-      gctx->rrmd[segment_id][gctx->rank].host_rkey =
-	((struct ibv_mr *) gctx->rrmd[segment_id][gctx->rank].host_mr)->rkey;
+      gctx->rrmd[segment_id]->local.host_rkey =
+	((struct ibv_mr *) gctx->rrmd[segment_id]->local.host_mr)->rkey;
 
-      gctx->rrmd[segment_id][gctx->rank].host_addr = (uintptr_t)gctx->rrmd[segment_id][gctx->rank].host_ptr;
+      gctx->rrmd[segment_id]->local.host_addr = (uintptr_t)gctx->rrmd[segment_id]->local.host_ptr;
     }
   else
     {
-      gctx->rrmd[segment_id][gctx->rank].cuda_dev_id = -1;
-      gctx->rrmd[segment_id][gctx->rank].host_rkey = 0;
-      gctx->rrmd[segment_id][gctx->rank].host_addr = 0;
+      gctx->rrmd[segment_id]->local.cuda_dev_id = -1;
+      gctx->rrmd[segment_id]->local.host_rkey = 0;
+      gctx->rrmd[segment_id]->local.host_addr = 0;
       if( gctx->use_gpus != 0 && gctx->gpu_count == 0 )
 	{
-	  if( cudaMallocHost((void**)&gctx->rrmd[segment_id][gctx->rank].data.ptr, size + NOTIFY_OFFSET))
+	  if( cudaMallocHost((void**)&gctx->rrmd[segment_id]->local.data.ptr, size + notif_size))
 	    {
 	      gaspi_print_error("Memory allocation (cudaMallocHost) failed.");
 	      goto errL;
 	    }
 	}
 
-      memset( gctx->rrmd[segment_id][gctx->rank].data.ptr, 0,
-	      NOTIFY_OFFSET);
+      memset( gctx->rrmd[segment_id]->local.data.ptr, 0,
+	      notif_size);
 
-      if( alloc_policy == GASPI_MEM_INITIALIZED )
+      if( alloc_policy & GASPI_MEM_INITIALIZED )
 	{
-	  memset (gctx->rrmd[segment_id][gctx->rank].data.ptr,
+	  memset (gctx->rrmd[segment_id]->local.data.ptr,
 		  0,
-		  size + NOTIFY_OFFSET);
+		  size + notif_size);
 	}
 
-      gctx->rrmd[segment_id][gctx->rank].size = size;
-      gctx->rrmd[segment_id][gctx->rank].notif_spc_size = NOTIFY_OFFSET;
-      gctx->rrmd[segment_id][gctx->rank].notif_spc.addr = gctx->rrmd[segment_id][gctx->rank].data.addr;
-      gctx->rrmd[segment_id][gctx->rank].data.addr += NOTIFY_OFFSET;
-      gctx->rrmd[segment_id][gctx->rank].user_provided = 0;
+      gctx->rrmd[segment_id]->local.size = size;
+      gctx->rrmd[segment_id]->local.notif_spc.addr = gctx->rrmd[segment_id]->local.data.addr;
+      gctx->rrmd[segment_id]->local.data.addr += notif_size;
+      gctx->rrmd[segment_id]->local.user_provided = 0;
 
-      if( pgaspi_dev_register_mem(&(gctx->rrmd[segment_id][gctx->rank]) ) < 0)
+      if( pgaspi_dev_register_mem(&(gctx->rrmd[segment_id]->local) ) < 0)
 	{
 	  goto errL;
 	}
@@ -242,36 +245,34 @@ pgaspi_dev_segment_delete (const gaspi_segment_id_t segment_id)
 
   if( gctx->use_gpus != 0 && gctx->gpu_count > 0 )
     {
-      if( ibv_dereg_mr (gctx->rrmd[segment_id][gctx->rank].mr[0]) )
+      if( ibv_dereg_mr (gctx->rrmd[segment_id]->local.mr[0]) )
 	{
 	  gaspi_print_error ("Memory de-registration failed (libibverbs)");
 	  goto errL;
 	}
     }
 
-  if( gctx->rrmd[segment_id][gctx->rank].cuda_dev_id >= 0 )
+  if( gctx->rrmd[segment_id]->local.cuda_dev_id >= 0 )
     {
-      if( ibv_dereg_mr (gctx->rrmd[segment_id][gctx->rank].host_mr) )
+      if( ibv_dereg_mr (gctx->rrmd[segment_id]->local.host_mr) )
 	{
 	  gaspi_print_error ("Memory de-registration failed (libibverbs)");
 	  goto errL;
 	}
 
-      cudaFreeHost(gctx->rrmd[segment_id][gctx->rank].host_ptr);
-      gctx->rrmd[segment_id][gctx->rank].host_ptr = NULL;
-      cudaFree(gctx->rrmd[segment_id][gctx->rank].data.buf);
+      cudaFreeHost(gctx->rrmd[segment_id]->local.host_ptr);
+      gctx->rrmd[segment_id]->local.host_ptr = NULL;
+      cudaFree(gctx->rrmd[segment_id]->local.data.buf);
     }
   else if( gctx->use_gpus != 0 && gctx->gpu_count > 0 )
     {
-      cudaFreeHost(gctx->rrmd[segment_id][gctx->rank].data.buf);
+      cudaFreeHost(gctx->rrmd[segment_id]->local.data.buf);
     }
 
-  free (gctx->rrmd[segment_id][gctx->rank].data.buf);
-  gctx->rrmd[segment_id][gctx->rank].data.buf = NULL;
+  free (gctx->rrmd[segment_id]->local.data.buf);
+  gctx->rrmd[segment_id]->local.data.buf = NULL;
 
-  memset(gctx->rrmd[segment_id], 0, gctx->tnc * sizeof (gaspi_rc_mseg_t));
-  free(gctx->rrmd[segment_id]);
-  gctx->rrmd[segment_id] = NULL;
+  pgaspi_segment_free_desc(gctx, segment_id);
 
   return GASPI_SUCCESS;
 
@@ -20,6 +20,7 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #define _GPI2_DEV_H_
 
 #include "GASPI.h"
+#include "GASPI_Ext.h"
 
 /* Device interface */
 
@@ -42,6 +43,24 @@ pgaspi_dev_poll_groups(void);
 int
 pgaspi_dev_post_group_write(void *, int, int, void *, unsigned char);
 
+/* Write between (local and remote) memory of a group, see GPI2_GRP.h */
+int
+pgaspi_dev_post_group_mem_write(const gaspi_rc_mseg_t * const,
+				void *,
+				int,
+				int,
+				const gaspi_rc_mseg_t * const,
+				void *);
+
+/* Write between segments on the collectives (group) connection */
+int
+pgaspi_dev_post_group_seg_write(const gaspi_segment_id_t,
+				const gaspi_offset_t,
+				const int,
+				const gaspi_segment_id_t,
+				const gaspi_offset_t,
+				const unsigned int);
+
 //////////////////////////////////////////////////////////
 
 #ifdef GPI2_CUDA
@@ -159,6 +178,76 @@ pgaspi_dev_write_list_notify (const gaspi_number_t,
 			      const gaspi_notification_t,
 			      const gaspi_queue_id_t);
 
+gaspi_return_t
+pgaspi_dev_write_strided (const gaspi_segment_id_t,
+			  const gaspi_offset_t,
+			  gaspi_offset_t const * const,
+			  const gaspi_rank_t,
+			  const gaspi_segment_id_t,
+			  const gaspi_offset_t,
+			  gaspi_offset_t const * const,
+			  gaspi_size_t const * const,
+			  const gaspi_number_t,
+			  const gaspi_queue_id_t);
+
+gaspi_return_t
+pgaspi_dev_write_strided_notify (const gaspi_segment_id_t,
+				 const gaspi_offset_t,
+				 gaspi_offset_t const * const,
+				 const gaspi_rank_t,
+				 const gaspi_segment_id_t,
+				 const gaspi_offset_t,
+				 gaspi_offset_t const * const,
+				 gaspi_size_t const * const,
+				 const gaspi_number_t,
+				 const gaspi_notification_id_t,
+				 const gaspi_notification_t,
+				 const gaspi_queue_id_t);
+
+gaspi_return_t
+pgaspi_dev_read_strided (const gaspi_segment_id_t,
+			 const gaspi_offset_t,
+			 gaspi_offset_t const * const,
+			 const gaspi_rank_t,
+			 const gaspi_segment_id_t,
+			 const gaspi_offset_t,
+			 gaspi_offset_t const * const,
+			 gaspi_size_t const * const,
+			 const gaspi_number_t,
+			 const gaspi_queue_id_t);
+
+gaspi_return_t
+pgaspi_dev_write_notify_batch (const gaspi_number_t,
+			       gaspi_segment_id_t * const,
+			       gaspi_offset_t * const,
+			       gaspi_rank_t * const,
+			       gaspi_segment_id_t * const,
+			       gaspi_offset_t * const,
+			       gaspi_size_t * const,
+			       gaspi_notification_id_t * const,
+			       gaspi_notification_t * const,
+			       const gaspi_queue_id_t,
+			       gaspi_rank_t * const);
+
+/* Persistent plans */
+gaspi_return_t
+pgaspi_dev_plan_create (gaspi_plan_t,
+			gaspi_segment_id_t * const,
+			gaspi_offset_t * const,
+			gaspi_segment_id_t * const,
+			gaspi_offset_t * const,
+			gaspi_size_t * const,
+			gaspi_notification_id_t * const,
+			gaspi_notification_t * const);
+
+gaspi_return_t
+pgaspi_dev_plan_start (const gaspi_plan_t,
+		       const gaspi_queue_id_t,
+		       gaspi_rank_t * const);
+
+gaspi_return_t
+pgaspi_dev_plan_delete (gaspi_plan_t);
+
 gaspi_return_t
 pgaspi_dev_atomic_fetch_add (const gaspi_segment_id_t,
 			     const gaspi_offset_t,
@@ -33,7 +33,7 @@ pgaspi_dev_atomic_fetch_add (const gaspi_segment_id_t segment_id,
       .source      = gctx->rank,
       .target      = rank,
       .local_addr  = (uintptr_t) (gctx->nsrc.data.buf),
-      .remote_addr = gctx->rrmd[segment_id][rank].data.addr + offset,
+      .remote_addr = gctx->rrmd[segment_id]->remote[rank].addr + offset,
       .length      = sizeof(gaspi_atomic_value_t),
       .swap        = 0,
       .compare_add = val_add,
@@ -88,7 +88,7 @@ pgaspi_dev_atomic_compare_swap (const gaspi_segment_id_t segment_id,
       .source      = gctx->rank,
       .target       = rank,
       .local_addr  = (uintptr_t) (gctx->nsrc.data.buf),
-      .remote_addr = gctx->rrmd[segment_id][rank].data.addr + offset,
+      .remote_addr = gctx->rrmd[segment_id]->remote[rank].addr + offset,
       .length      = sizeof(gaspi_atomic_value_t),
       .swap        = val_new,
       .compare_add = comparator,
@@ -20,7 +20,12 @@ along with GPI-2. If not, see <http://www.gnu.org/licenses/>.
 #include "GPI2_Types.h"
 
 int
-pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_addr, int g)
+pgaspi_dev_post_group_mem_write(const gaspi_rc_mseg_t * const local_mem,
+				void *local_addr,
+				int length,
+				int dst,
+				const gaspi_rc_mseg_t * const remote_mem,
+				void *remote_addr)
 {
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
@@ -48,6 +53,46 @@ pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_
   return 0;
 }
 
+int
+pgaspi_dev_post_group_write(void *local_addr, int length, int dst, void *remote_addr, int g)
+{
+  return pgaspi_dev_post_group_mem_write(NULL, local_addr, length, dst, NULL, remote_addr);
+}
+
+int
+pgaspi_dev_post_group_seg_write(const gaspi_segment_id_t segment_id_local,
+				const gaspi_offset_t offset_local,
+				const int dst,
+				const gaspi_segment_id_t segment_id_remote,
+				const gaspi_offset_t offset_remote,
+				const unsigned int length)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  tcp_dev_wr_t wr =
+    {
+      .cq_handle   = glb_gaspi_ctx_tcp.scqGroups->num,
+      .source      = gctx->rank,
+      .local_addr  = gctx->rrmd[segment_id_local]->local.data.addr + offset_local,
+      .length      = length,
+      .swap        = 0,
+      .compare_add = 0,
+      .opcode      = POST_RDMA_WRITE,
+      .target      = dst,
+      .remote_addr = gctx->rrmd[segment_id_remote]->remote[dst].addr + offset_remote,
+      .wr_id       = dst
+    };
+
+  if( write(glb_gaspi_ctx_tcp.qpGroups->handle, &wr, sizeof(tcp_dev_wr_t)) < (ssize_t) sizeof(tcp_dev_wr_t) )
+    {
+      return 1;
+    }
+
+  gctx->ne_count_grp++;
+
+  return 0;
+}
+
 /* TODO: number of elems to poll as arg */
 int
 pgaspi_dev_poll_groups(void)
@@ -36,8 +36,8 @@ pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
       .cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num,
       .source      = gctx->rank,
       .target      = rank,
-      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr + offset_local),
-      .remote_addr = (gctx->rrmd[segment_id_remote][rank].data.addr + offset_remote),
+      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr + offset_local),
+      .remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].addr + offset_remote),
       .length      = size,
       .swap        = 0,
       .compare_add = 0,
@@ -49,7 +49,7 @@ pgaspi_dev_write (const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
   
   return GASPI_SUCCESS;
 }
@@ -71,8 +71,8 @@ pgaspi_dev_read (const gaspi_segment_id_t segment_id_local,
       .cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num,
       .source      = gctx->rank,
       .target       = rank,
-      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr + offset_local),
-      .remote_addr = (gctx->rrmd[segment_id_remote][rank].data.addr + offset_remote),
+      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr + offset_local),
+      .remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].addr + offset_remote),
       .length      = size,
       .swap        = 0,
       .compare_add = 0,
@@ -84,7 +84,7 @@ pgaspi_dev_read (const gaspi_segment_id_t segment_id_local,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -97,7 +97,7 @@ pgaspi_dev_purge (const gaspi_queue_id_t queue,
   tcp_dev_wc_t wc;
   gaspi_context_t * const gctx = &glb_gaspi_ctx;
 
-  const int nr = gctx->ne_count_c[queue];
+  const int nr = gctx->ne_count_c[queue].count;
 
   const gaspi_cycles_t s0 = gaspi_get_cycles ();
 
@@ -106,7 +106,7 @@ pgaspi_dev_purge (const gaspi_queue_id_t queue,
       do
 	{
 	  ne = tcp_dev_return_wc (glb_gaspi_ctx_tcp.scqC[queue], &wc);
-	  gctx->ne_count_c[queue]-= ne;
+	  gctx->ne_count_c[queue].count-= ne;
 
 	  if( ne == 0 )
 	    {
@@ -135,7 +135,7 @@ pgaspi_dev_wait (const gaspi_queue_id_t queue,
   int ne = 0, i;
   tcp_dev_wc_t wc;
 
-  const int nr = gctx->ne_count_c[queue];
+  const int nr = gctx->ne_count_c[queue].count;
   const gaspi_cycles_t s0 = gaspi_get_cycles ();
 
   for (i = 0; i < nr; i++)
@@ -143,7 +143,7 @@ pgaspi_dev_wait (const gaspi_queue_id_t queue,
       do
 	{
 	  ne = tcp_dev_return_wc (glb_gaspi_ctx_tcp.scqC[queue], &wc);
-	  gctx->ne_count_c[queue] -= ne;
+	  gctx->ne_count_c[queue].count -= ne;
 
 	  if( ne == 0 )
 	    {
@@ -188,7 +188,7 @@ pgaspi_dev_notify (const gaspi_segment_id_t segment_id_remote,
       .source      = gctx->rank,
       .target      = rank,
       .local_addr  = (uintptr_t) not_val_ptr,
-      .remote_addr = (gctx->rrmd[segment_id_remote][rank].notif_spc.addr + notification_id * sizeof(gaspi_notification_t)),
+      .remote_addr = (gctx->rrmd[segment_id_remote]->remote[rank].notif_addr + notification_id * sizeof(gaspi_notification_t)),
       .length      = sizeof(notification_value),
       .swap        = 0,
       .opcode      = POST_RDMA_WRITE_INLINED
@@ -199,7 +199,7 @@ pgaspi_dev_notify (const gaspi_segment_id_t segment_id_remote,
       return GASPI_ERROR;
     }
 
-  gctx->ne_count_c[queue]++;
+  gctx->ne_count_c[queue].count++;
 
   return GASPI_SUCCESS;
 }
@@ -225,8 +225,8 @@ pgaspi_dev_write_list (const gaspi_number_t num,
 	  .cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num,
 	  .source      = gctx->rank,
 	  .target        = rank,
-	  .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[i]][gctx->rank].data.addr + offset_local[i]),
-	  .remote_addr = (gctx->rrmd[segment_id_remote[i]][rank].data.addr + offset_remote[i]),
+	  .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[i]]->local.data.addr + offset_local[i]),
+	  .remote_addr = (gctx->rrmd[segment_id_remote[i]]->remote[rank].addr + offset_remote[i]),
 	  .length      = size[i],
 	  .swap        = 0,
 	  .compare_add = 0,
@@ -239,7 +239,7 @@ pgaspi_dev_write_list (const gaspi_number_t num,
 	}
     }
 
-  gctx->ne_count_c[queue] += num;
+  gctx->ne_count_c[queue].count += num;
 
   return GASPI_SUCCESS;
 }
@@ -265,8 +265,8 @@ pgaspi_dev_read_list (const gaspi_number_t num,
 	  .cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num,
 	  .source      = gctx->rank,
 	  .target        = rank,
-	  .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[i]][gctx->rank].data.addr + offset_local[i]),
-	  .remote_addr = (gctx->rrmd[segment_id_remote[i]][rank].data.addr + offset_remote[i]),
+	  .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[i]]->local.data.addr + offset_local[i]),
+	  .remote_addr = (gctx->rrmd[segment_id_remote[i]]->remote[rank].addr + offset_remote[i]),
 	  .length      = size[i],
 	  .swap        = 0,
 	  .compare_add = 0,
@@ -279,7 +279,7 @@ pgaspi_dev_read_list (const gaspi_number_t num,
 	}
     }
 
-  gctx->ne_count_c[queue] += num;
+  gctx->ne_count_c[queue].count += num;
 
   return GASPI_SUCCESS;
 }
@@ -328,3 +328,353 @@ pgaspi_dev_write_list_notify (const gaspi_number_t num,
 
   return pgaspi_dev_notify(segment_id_notification, rank, notification_id, notification_value, queue);
 }
+
+static inline gaspi_return_t
+_pgaspi_dev_post_strided (const int opcode,
+			  const uint64_t local_addr,
+			  gaspi_offset_t const * const stride_src,
+			  const gaspi_rank_t rank,
+			  const uint64_t remote_addr,
+			  gaspi_offset_t const * const stride_dst,
+			  gaspi_size_t const * const count,
+			  const gaspi_number_t stride_levels,
+			  const gaspi_queue_id_t queue)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* released by the device once the transfer is handled */
+  tcp_dev_strided_t *desc = (tcp_dev_strided_t *) malloc(sizeof(tcp_dev_strided_t));
+  if( desc == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  desc->count[0] = count[0];
+  desc->count[1] = count[1];
+  desc->count[2] = (stride_levels > 1) ? count[2] : 1;
+  desc->stride_src[0] = stride_src[0];
+  desc->stride_src[1] = (stride_levels > 1) ? stride_src[1] : 0;
+  desc->stride_dst[0] = stride_dst[0];
+  desc->stride_dst[1] = (stride_levels > 1) ? stride_dst[1] : 0;
+
+  tcp_dev_wr_t wr =
+    {
+      .wr_id       = rank,
+      .cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num,
+      .source      = gctx->rank,
+      .target      = rank,
+      .local_addr  = local_addr,
+      .remote_addr = remote_addr,
+      .length      = desc->count[0] * desc->count[1] * desc->count[2],
+      .swap        = (uintptr_t) desc,
+      .compare_add = 0,
+      .opcode      = opcode
+    } ;
+
+  if( write(glb_gaspi_ctx_tcp.qpC[queue]->handle, &wr, sizeof(tcp_dev_wr_t)) < (ssize_t) sizeof(tcp_dev_wr_t) )
+    {
+      free(desc);
+      return GASPI_ERROR;
+    }
+
+  gctx->ne_count_c[queue].count++;
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_write_strided (const gaspi_segment_id_t segment_id_local,
+			  const gaspi_offset_t offset_local,
+			  gaspi_offset_t const * const stride_local,
+			  const gaspi_rank_t rank,
+			  const gaspi_segment_id_t segment_id_remote,
+			  const gaspi_offset_t offset_remote,
+			  gaspi_offset_t const * const stride_remote,
+			  gaspi_size_t const * const count,
+			  const gaspi_number_t stride_levels,
+			  const gaspi_queue_id_t queue)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* data flows from local to remote */
+  return _pgaspi_dev_post_strided(POST_RDMA_WRITE_STRIDED,
+				  gctx->rrmd[segment_id_local]->local.data.addr + offset_local,
+				  stride_local,
+				  rank,
+				  gctx->rrmd[segment_id_remote]->remote[rank].addr + offset_remote,
+				  stride_remote,
+				  count, stride_levels, queue);
+}
+
+gaspi_return_t
+pgaspi_dev_write_strided_notify (const gaspi_segment_id_t segment_id_local,
+				 const gaspi_offset_t offset_local,
+				 gaspi_offset_t const * const stride_local,
+				 const gaspi_rank_t rank,
+				 const gaspi_segment_id_t segment_id_remote,
+				 const gaspi_offset_t offset_remote,
+				 gaspi_offset_t const * const stride_remote,
+				 gaspi_size_t const * const count,
+				 const gaspi_number_t stride_levels,
+				 const gaspi_notification_id_t notification_id,
+				 const gaspi_notification_t notification_value,
+				 const gaspi_queue_id_t queue)
+{
+  const gaspi_return_t eret =
+    pgaspi_dev_write_strided(segment_id_local, offset_local, stride_local,
+			     rank,
+			     segment_id_remote, offset_remote, stride_remote,
+			     count, stride_levels, queue);
+  if( eret != GASPI_SUCCESS )
+    {
+      return eret;
+    }
+
+  return pgaspi_dev_notify(segment_id_remote, rank, notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+pgaspi_dev_read_strided (const gaspi_segment_id_t segment_id_local,
+			 const gaspi_offset_t offset_local,
+			 gaspi_offset_t const * const stride_local,
+			 const gaspi_rank_t rank,
+			 const gaspi_segment_id_t segment_id_remote,
+			 const gaspi_offset_t offset_remote,
+			 gaspi_offset_t const * const stride_remote,
+			 gaspi_size_t const * const count,
+			 const gaspi_number_t stride_levels,
+			 const gaspi_queue_id_t queue)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+
+  /* data flows from remote to local */
+  return _pgaspi_dev_post_strided(POST_RDMA_READ_STRIDED,
+				  gctx->rrmd[segment_id_local]->local.data.addr + offset_local,
+				  stride_remote,
+				  rank,
+				  gctx->rrmd[segment_id_remote]->remote[rank].addr + offset_remote,
+				  stride_local,
+				  count, stride_levels, queue);
+}
+
+/* Hand a chunk of requests to the device at once */
+static inline gaspi_return_t
+_pgaspi_dev_post_wr_chunk (const gaspi_queue_id_t queue,
+			   tcp_dev_wr_t const * const wr,
+			   const gaspi_number_t num_wr,
+			   gaspi_rank_t * const rank_failed)
+{
+  const char *buf = (const char *) wr;
+  size_t left = num_wr * sizeof(tcp_dev_wr_t);
+
+  while( left > 0 )
+    {
+      const ssize_t ret = write(glb_gaspi_ctx_tcp.qpC[queue]->handle, buf, left);
+      if( ret <= 0 )
+	{
+	  /* The requests written before were posted and complete */
+	  const gaspi_number_t posted = (num_wr * sizeof(tcp_dev_wr_t) - left) / sizeof(tcp_dev_wr_t);
+
+	  glb_gaspi_ctx.ne_count_c[queue].count += posted;
+	  if( rank_failed != NULL )
+	    {
+	      *rank_failed = wr[posted].target;
+	    }
+	  return GASPI_ERROR;
+	}
+
+      buf += ret;
+      left -= ret;
+    }
+
+  glb_gaspi_ctx.ne_count_c[queue].count += num_wr;
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_write_notify_batch (const gaspi_number_t num,
+			       gaspi_segment_id_t * const segment_id_local,
+			       gaspi_offset_t * const offset_local,
+			       gaspi_rank_t * const rank,
+			       gaspi_segment_id_t * const segment_id_remote,
+			       gaspi_offset_t * const offset_remote,
+			       gaspi_size_t * const size,
+			       gaspi_notification_id_t * const notification_id,
+			       gaspi_notification_t * const notification_value,
+			       const gaspi_queue_id_t queue,
+			       gaspi_rank_t * const rank_failed)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  tcp_dev_wr_t wr[2 * GASPI_MAX_BATCH];
+  gaspi_number_t n, w = 0;
+
+  for(n = 0; n < num; n++)
+    {
+      tcp_dev_wr_t * const wrd = &wr[w++];
+
+      wrd->wr_id       = rank[n];
+      wrd->cq_handle   = glb_gaspi_ctx_tcp.scqC[queue]->num;
+      wrd->source      = gctx->rank;
+      wrd->target      = rank[n];
+      wrd->local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[n]]->local.data.addr + offset_local[n]);
+      wrd->remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].addr + offset_remote[n]);
+      wrd->length      = size[n];
+      wrd->swap        = 0;
+      wrd->compare_add = 0;
+      wrd->opcode      = POST_RDMA_WRITE;
+
+      if( notification_value != NULL && notification_value[n] != 0 )
+	{
+	  /* released by the device */
+	  gaspi_notification_t *not_val_ptr = (gaspi_notification_t *) malloc(sizeof(gaspi_notification_t));
+	  if( not_val_ptr == NULL )
+	    {
+	      if( _pgaspi_dev_post_wr_chunk(queue, wr, w, rank_failed) != GASPI_SUCCESS )
+		{
+		  return GASPI_ERROR;
+		}
+
+	      *rank_failed = rank[n];
+	      return GASPI_ERR_MEMALLOC;
+	    }
+
+	  *not_val_ptr = notification_value[n];
+
+	  tcp_dev_wr_t * const wrn = &wr[w++];
+
+	  *wrn = *wrd;
+	  wrn->local_addr  = (uintptr_t) not_val_ptr;
+	  wrn->remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank[n]].notif_addr
+			      + notification_id[n] * sizeof(gaspi_notification_t));
+	  wrn->length      = sizeof(gaspi_notification_t);
+	  wrn->opcode      = POST_RDMA_WRITE_INLINED;
+	}
+    }
+
+  return _pgaspi_dev_post_wr_chunk(queue, wr, w, rank_failed);
+}
+
+/* Persistent plans */
+typedef struct
+{
+  gaspi_queue_id_t queue;          /* queue the requests are prepared for */
+  gaspi_notification_t *notif_val; /* source of the notification values */
+  tcp_dev_wr_t wr[];
+} tcp_dev_plan_t;
+
+gaspi_return_t
+pgaspi_dev_plan_create (gaspi_plan_t plan,
+			gaspi_segment_id_t * const segment_id_local,
+			gaspi_offset_t * const offset_local,
+			gaspi_segment_id_t * const segment_id_remote,
+			gaspi_offset_t * const offset_remote,
+			gaspi_size_t * const size,
+			gaspi_notification_id_t * const notification_id,
+			gaspi_notification_t * const notification_value)
+{
+  gaspi_context_t * const gctx = &glb_gaspi_ctx;
+  gaspi_number_t n, num_wr = plan->num;
+
+  if( notification_value != NULL )
+    {
+      for(n = 0; n < plan->num; n++)
+	{
+	  if( notification_value[n] != 0 )
+	    {
+	      num_wr++;
+	    }
+	}
+    }
+
+  tcp_dev_plan_t *dplan = malloc(sizeof(tcp_dev_plan_t) + num_wr * sizeof(tcp_dev_wr_t));
+  if( dplan == NULL )
+    {
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  /* The notification values are sent from the plan itself (not
+     inlined) since they do not change between starts */
+  dplan->queue = 0;
+  dplan->notif_val = malloc(plan->num * sizeof(gaspi_notification_t));
+  if( dplan->notif_val == NULL )
+    {
+      free(dplan);
+      return GASPI_ERR_MEMALLOC;
+    }
+
+  gaspi_number_t w = 0;
+  for(n = 0; n < plan->num; n++)
+    {
+      const gaspi_rank_t rank = plan->rank[n];
+
+      tcp_dev_wr_t wr =
+	{
+	  .wr_id       = rank,
+	  .cq_handle   = glb_gaspi_ctx_tcp.scqC[0]->num,
+	  .source      = gctx->rank,
+	  .target      = rank,
+	  .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local[n]]->local.data.addr + offset_local[n]),
+	  .remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank].addr + offset_remote[n]),
+	  .length      = size[n],
+	  .swap        = 0,
+	  .compare_add = 0,
+	  .opcode      = POST_RDMA_WRITE
+	} ;
+
+      dplan->wr[w++] = wr;
+
+      if( notification_value != NULL && notification_value[n] != 0 )
+	{
+	  dplan->notif_val[n] = notification_value[n];
+
+	  wr.local_addr  = (uintptr_t) &dplan->notif_val[n];
+	  wr.remote_addr = (gctx->rrmd[segment_id_remote[n]]->remote[rank].notif_addr
+			    + notification_id[n] * sizeof(gaspi_notification_t));
+	  wr.length      = sizeof(gaspi_notification_t);
+
+	  dplan->wr[w++] = wr;
+	}
+    }
+
+  plan->num_wr = num_wr;
+  plan->dev_plan = dplan;
+
+  return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+pgaspi_dev_plan_start (const gaspi_plan_t plan,
+		       const gaspi_queue_id_t queue,
+		       gaspi_rank_t * const rank_failed)
+{
+  tcp_dev_plan_t * const dplan = (tcp_dev_plan_t *) plan->dev_plan;
+  gaspi_number_t w;
+
+  if( dplan->queue != queue )
+    {
+      for(w = 0; w < plan->num_wr; w++)
+	{
+	  dplan->wr[w].cq_handle = glb_gaspi_ctx_tcp.scqC[queue]->num;
+	}
+      dplan->queue = queue;
+    }
+
+  return _pgaspi_dev_post_wr_chunk(queue, dplan->wr, plan->num_wr, rank_failed);
+}
+
+gaspi_return_t
+pgaspi_dev_plan_delete (gaspi_plan_t plan)
+{
+  tcp_dev_plan_t * const dplan = (tcp_dev_plan_t *) plan->dev_plan;
+
+  if( dplan != NULL )
+    {
+      free(dplan->notif_val);
+      free(dplan);
+    }
+
+  plan->dev_plan = NULL;
+
+  return GASPI_SUCCESS;
+}
@@ -45,7 +45,7 @@ pgaspi_dev_passive_send (const gaspi_segment_id_t segment_id,
       .cq_handle   = glb_gaspi_ctx_tcp.scqP->num,
       .source      = gctx->rank,
       .target      = rank,
-      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id][gctx->rank].data.addr + offset_local),
+      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id]->local.data.addr + offset_local),
       .remote_addr = 0UL,
       .length      = size,
       .swap        = 0,
@@ -111,7 +111,7 @@ pgaspi_dev_passive_receive (const gaspi_segment_id_t segment_id_local,
       .cq_handle   = glb_gaspi_ctx_tcp.rcqP->num,
       .source      = gctx->rank,
       .target      = 0,
-      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local][gctx->rank].data.addr + offset_local),
+      .local_addr  = (uintptr_t) (gctx->rrmd[segment_id_local]->local.data.addr + offset_local),
       .remote_addr = 0UL,
       .length      = size,
       .swap        = 0,
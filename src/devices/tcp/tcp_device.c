@@ -280,6 +280,7 @@ _tcp_dev_add_new_conn(int rank, int conn_sock, int pollfd)
   nstate->read.addr       = (uintptr_t)&nstate->wr_buff;
   nstate->read.length     = sizeof(tcp_dev_wr_t);
   nstate->read.done       = 0;
+  nstate->read.strided    = NULL;
 
   nstate->write.wr_id     = 0;
   nstate->write.opcode    = SEND_DISABLED;
@@ -287,6 +288,7 @@ _tcp_dev_add_new_conn(int rank, int conn_sock, int pollfd)
   nstate->write.addr      = (uintptr_t)NULL;
   nstate->write.length    = 0;
   nstate->write.done      = 0;
+  nstate->write.strided   = NULL;
 
   struct epoll_event nev =
     {
@@ -511,6 +513,56 @@ _tcp_dev_set_default_read_conn_state(tcp_dev_conn_state_t *estate)
   estate->read.addr      = (uintptr_t)&estate->wr_buff;
   estate->read.length    = sizeof(tcp_dev_wr_t);
   estate->read.done      = 0;
+  estate->read.strided   = NULL;
+}
+
+/* Address of a given block of a strided transfer */
+static inline uint64_t
+_tcp_dev_strided_addr(const tcp_dev_strided_t * const desc,
+		      const uint64_t * const stride,
+		      const uint64_t base,
+		      const uint64_t block)
+{
+  return base
+    + (block % desc->count[1]) * stride[0]
+    + (block / desc->count[1]) * stride[1];
+}
+
+/* Move to the next block of a strided transfer. Returns 1 if there
+   is a next block, 0 if all blocks were handled. */
+static inline int
+_tcp_dev_strided_next(const tcp_dev_strided_t * const desc,
+		      const uint64_t * const stride,
+		      const uint64_t base,
+		      uint64_t * const block,
+		      uint64_t * const addr)
+{
+  if( *block + 1 >= desc->count[1] * desc->count[2] )
+    {
+      return 0;
+    }
+
+  (*block)++;
+  *addr = _tcp_dev_strided_addr(desc, stride, base, *block);
+
+  return 1;
+}
+
+/* Strided copy for local operations */
+static inline void
+_tcp_dev_strided_copy(const uint64_t dst,
+		      const uint64_t src,
+		      const tcp_dev_strided_t * const desc)
+{
+  uint64_t b;
+  const uint64_t nblocks = desc->count[1] * desc->count[2];
+
+  for(b = 0; b < nblocks; b++)
+    {
+      memcpy((void *) _tcp_dev_strided_addr(desc, desc->stride_dst, dst, b),
+	     (void *) _tcp_dev_strided_addr(desc, desc->stride_src, src, b),
+	     desc->count[0]);
+    }
 }
 
 static int
@@ -878,9 +930,127 @@ _tcp_dev_process_recv_data(tcp_dev_conn_state_t *estate)
 	  _tcp_dev_set_default_read_conn_state(estate);
 
 	  break;
+
+	  /* STRIDED RDMA OPERATIONS */
+	case POST_RDMA_WRITE_STRIDED:
+	case POST_RDMA_READ_STRIDED:
+	  {
+	    tcp_dev_strided_t *desc = (tcp_dev_strided_t *) estate->wr_buff.swap;
+
+	    if( estate->wr_buff.opcode == POST_RDMA_READ_STRIDED )
+	      {
+		op = TCP_DEV_WC_RDMA_READ;
+	      }
+	    else
+	      {
+		op = TCP_DEV_WC_RDMA_WRITE;
+	      }
+
+	    /* local operation: do it right away */
+	    if( estate->wr_buff.target == tcp_dev_id )
+	      {
+		if( estate->wr_buff.opcode == POST_RDMA_READ_STRIDED )
+		  {
+		    _tcp_dev_strided_copy(estate->wr_buff.local_addr, estate->wr_buff.remote_addr, desc);
+		  }
+		else
+		  {
+		    _tcp_dev_strided_copy(estate->wr_buff.remote_addr, estate->wr_buff.local_addr, desc);
+		  }
+
+		free(desc);
+
+		if( _tcp_dev_post_wc(estate->wr_buff.wr_id,
+				     TCP_WC_SUCCESS,
+				     op,
+				     estate->wr_buff.cq_handle) != 0)
+		  {
+		    return 1;
+		  }
+	      }
+	    else
+	      {
+		tcp_dev_wr_t wr =
+		  {
+		    .wr_id       = estate->wr_buff.wr_id,
+		    .cq_handle   = estate->wr_buff.cq_handle,
+		    .opcode      = (op == TCP_DEV_WC_RDMA_READ) ? REQUEST_RDMA_READ_STRIDED : NOTIFICATION_RDMA_WRITE_STRIDED,
+		    .source      = estate->wr_buff.source,
+		    .target      = estate->wr_buff.target,
+		    .local_addr  = estate->wr_buff.local_addr,
+		    .remote_addr = estate->wr_buff.remote_addr,
+		    .length      = estate->wr_buff.length,
+		    .compare_add = 0,
+		    .swap        = estate->wr_buff.swap
+		  };
+
+		list_insert(&delayedList, &wr);
+	      }
+
+	    _tcp_dev_set_default_read_conn_state(estate);
+	  }
+
+	  break;
+	case NOTIFICATION_RDMA_WRITE_STRIDED:
+	case REQUEST_RDMA_READ_STRIDED:
+	case RESPONSE_RDMA_READ_STRIDED:
+
+	  /* the descriptor follows the header */
+	  estate->read.wr_id     = estate->wr_buff.wr_id;
+	  estate->read.cq_handle = estate->wr_buff.cq_handle;
+	  estate->read.opcode    = RECV_STRIDED_DESC;
+	  estate->read.addr      = (uintptr_t) &estate->strided_buff;
+	  estate->read.length    = sizeof(tcp_dev_strided_t);
+	  estate->read.done      = 0;
+
+	  break;
 	} /* switch opcode */
     } /* if RECV_HEADER*/
 
+  else if( estate->read.opcode == RECV_STRIDED_DESC )
+    {
+      if( estate->wr_buff.opcode == REQUEST_RDMA_READ_STRIDED )
+	{
+	  tcp_dev_strided_t *desc = (tcp_dev_strided_t *) malloc(sizeof(tcp_dev_strided_t));
+	  if( desc == NULL )
+	    {
+	      gaspi_print_error("Failed to allocate strided descriptor.");
+	      return 1;
+	    }
+
+	  *desc = estate->strided_buff;
+
+	  tcp_dev_wr_t wr =
+	    {
+	      .wr_id       = estate->wr_buff.wr_id,
+	      .cq_handle   = estate->wr_buff.cq_handle,
+	      .opcode      = RESPONSE_RDMA_READ_STRIDED,
+	      .source      = estate->wr_buff.target,
+	      .target      = estate->wr_buff.source,
+	      .local_addr  = estate->wr_buff.remote_addr,
+	      .remote_addr = estate->wr_buff.local_addr,
+	      .length      = estate->wr_buff.length,
+	      .compare_add = 0,
+	      .swap        = (uintptr_t) desc
+	    };
+
+	  list_insert(&delayedList, &wr);
+
+	  _tcp_dev_set_default_read_conn_state(estate);
+	}
+      else
+	{
+	  /* scatter the incoming blocks */
+	  estate->read.opcode  = (estate->wr_buff.opcode == RESPONSE_RDMA_READ_STRIDED) ? RECV_RDMA_READ : RECV_RDMA_WRITE;
+	  estate->read.strided = &estate->strided_buff;
+	  estate->read.base    = estate->wr_buff.remote_addr;
+	  estate->read.block   = 0;
+	  estate->read.addr    = estate->read.base;
+	  estate->read.length  = estate->strided_buff.count[0];
+	  estate->read.done    = 0;
+	}
+    }
+
   else if( estate->read.opcode == RECV_RDMA_WRITE )
     {
       _tcp_dev_set_default_read_conn_state(estate);
@@ -935,6 +1105,12 @@ _tcp_dev_process_sent_data(int pollfd, tcp_dev_conn_state_t *estate)
 	}
     }
 
+  if( estate->write.strided != NULL )
+    {
+      free(estate->write.strided);
+      estate->write.strided = NULL;
+    }
+
   struct epoll_event ev =
     {
       .data.ptr = estate,
@@ -981,6 +1157,13 @@ _tcp_dev_process_delayed(int pollfd)
 	      return 1;
 	    }
 
+	  if( wr.opcode == NOTIFICATION_RDMA_WRITE_STRIDED
+	      || wr.opcode == REQUEST_RDMA_READ_STRIDED
+	      || wr.opcode == RESPONSE_RDMA_READ_STRIDED )
+	    {
+	      free((void *) wr.swap);
+	    }
+
 	  delete = element;
 	}
       else if( wr.opcode == NOTIFICATION_SEND && (wr.target == tcp_dev_id) )
@@ -1110,6 +1293,68 @@ _tcp_dev_process_delayed(int pollfd)
 
 	      free((void *) element->wr.local_addr);
 	    }
+	  else if( wr.opcode == NOTIFICATION_RDMA_WRITE_STRIDED
+		   || wr.opcode == REQUEST_RDMA_READ_STRIDED
+		   || wr.opcode == RESPONSE_RDMA_READ_STRIDED )
+	    {
+	      /* the descriptor goes right after the header */
+	      tcp_dev_strided_t *desc = (tcp_dev_strided_t *) wr.swap;
+	      size_t sdone = 0;
+
+	      while( !found_error && sdone < sizeof(tcp_dev_strided_t) )
+		{
+		  const int bytes_sent = write(state->fd, (char *) desc + sdone, sizeof(tcp_dev_strided_t) - sdone);
+
+		  if( bytes_sent <= 0 && !(errno == EAGAIN || errno == EWOULDBLOCK) )
+		    {
+		      gaspi_print_error("writing to %d (total %lu sent %ld remain %lu).",
+					wr.target, sizeof(tcp_dev_strided_t), sdone, sizeof(tcp_dev_strided_t) - sdone);
+
+		      if( _tcp_dev_post_wc(wr.wr_id, TCP_WC_REM_OP_ERROR, TCP_DEV_WC_RDMA_WRITE, wr.cq_handle) != 0 )
+			{
+			  gaspi_print_error("Failed to post completion error.");
+			}
+
+		      found_error = 1;
+		      break;
+		    }
+		  else if( bytes_sent > 0)
+		    {
+		      sdone += bytes_sent;
+		    }
+		}
+
+	      /* a read request carries no data */
+	      if( found_error || wr.opcode == REQUEST_RDMA_READ_STRIDED )
+		{
+		  free(desc);
+		}
+	      else
+		{
+		  /* gather the outgoing blocks */
+		  state->write.opcode    = (wr.opcode == NOTIFICATION_RDMA_WRITE_STRIDED) ? SEND_RDMA_WRITE : SEND_RDMA_READ;
+		  state->write.wr_id     = wr.wr_id;
+		  state->write.cq_handle = wr.cq_handle;
+		  state->write.strided   = desc;
+		  state->write.base      = wr.local_addr;
+		  state->write.block     = 0;
+		  state->write.addr      = wr.local_addr;
+		  state->write.length    = desc->count[0];
+		  state->write.done      = 0;
+
+		  struct epoll_event ev = {
+		    .data.ptr = state,
+		    .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP
+		  };
+
+		  if( epoll_ctl(pollfd, EPOLL_CTL_MOD, state->fd, &ev) < 0 )
+		    {
+		      gaspi_print_error("Failed to modify events instance for %d fd %d.", state->rank, state->fd);
+		      close(state->fd);
+		      exit(EXIT_FAILURE);
+		    }
+		}
+	    }
 	  else if( wr.opcode == NOTIFICATION_RDMA_WRITE
 		   || wr.opcode == RESPONSE_RDMA_READ
 		   || wr.opcode == NOTIFICATION_SEND )
@@ -1691,6 +1936,18 @@ tcp_virt_dev(void *args)
 			      memcpy((void *) estate->read.addr, tmp, sizeof(uint32_t));
 			    }
 
+			  /* strided: continue with next block */
+			  if( estate->read.strided != NULL
+			      && _tcp_dev_strided_next(estate->read.strided,
+						       estate->read.strided->stride_dst,
+						       estate->read.base,
+						       &estate->read.block,
+						       &estate->read.addr) )
+			    {
+			      estate->read.done = 0;
+			      continue;
+			    }
+
 			  int ret = _tcp_dev_process_recv_data(estate);
 
 			  if( ret != 0)
@@ -1734,6 +1991,18 @@ tcp_virt_dev(void *args)
 		      /*  data transfer is complete */
 		      if( estate->write.done == estate->write.length )
 			{
+			  /* strided: continue with next block */
+			  if( estate->write.strided != NULL
+			      && _tcp_dev_strided_next(estate->write.strided,
+						       estate->write.strided->stride_src,
+						       estate->write.base,
+						       &estate->write.block,
+						       &estate->write.addr) )
+			    {
+			      estate->write.done = 0;
+			      continue;
+			    }
+
 			  if( _tcp_dev_process_sent_data(epollfd, estate) != 0 )
 			    {
 			      gaspi_print_error("Failed to process sent data.");
@@ -1780,6 +2049,12 @@ tcp_virt_dev(void *args)
 		  estate->write.addr      = (uintptr_t) NULL;
 		  estate->write.length    = 0;
 		  estate->write.done      = 0;
+
+		  if( estate->write.strided != NULL )
+		    {
+		      free(estate->write.strided);
+		      estate->write.strided = NULL;
+		    }
 		}
 
 	      /* or in the middle of something to read */
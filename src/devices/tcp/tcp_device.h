@@ -73,6 +73,12 @@ typedef struct
       RESPONSE_RDMA_READ,
       NOTIFICATION_SEND,
       RESPONSE_SEND,
+
+      POST_RDMA_WRITE_STRIDED,
+      POST_RDMA_READ_STRIDED,
+      NOTIFICATION_RDMA_WRITE_STRIDED,
+      REQUEST_RDMA_READ_STRIDED,
+      RESPONSE_RDMA_READ_STRIDED
     } opcode;
 
   uint16_t target, source;
@@ -81,6 +87,17 @@ typedef struct
   uint32_t length;
 } tcp_dev_wr_t;
 
+/* Descriptor of a strided transfer. It follows the work request on
+   the wire (the swap field of the work request points to it locally)
+   and allows the sender to gather and the receiver to scatter the
+   blocks without intermediate copies. */
+typedef struct
+{
+  uint64_t count[3];      /* block size (bytes) and number of blocks per level */
+  uint64_t stride_src[2]; /* strides at the source of the data */
+  uint64_t stride_dst[2]; /* strides at the destination of the data */
+} tcp_dev_strided_t;
+
 typedef struct
 {
   int fd, rank;
@@ -92,11 +109,15 @@ typedef struct
 
     enum
       {
-	RECV_HEADER, RECV_TOPOLOGY, RECV_RDMA_WRITE, RECV_RDMA_READ, RECV_SEND
+	RECV_HEADER, RECV_TOPOLOGY, RECV_RDMA_WRITE, RECV_RDMA_READ, RECV_SEND, RECV_STRIDED_DESC
       } opcode;
 
     uint64_t addr;
     uint32_t length, done;
+
+    /* strided transfers */
+    tcp_dev_strided_t *strided;
+    uint64_t base, block;
   } read;
 
   struct
@@ -112,11 +133,17 @@ typedef struct
     uint64_t addr;
     uint32_t length, done;
 
+    /* strided transfers */
+    tcp_dev_strided_t *strided;
+    uint64_t base, block;
   } write;
 
   /* work requests buffer (async) */
   tcp_dev_wr_t wr_buff;
 
+  /* strided descriptor buffer (async) */
+  tcp_dev_strided_t strided_buff;
+
 } tcp_dev_conn_state_t;
 
 enum tcp_dev_wc_status
@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GASPI.h>
+#include <GASPI_Ext.h>
+
+/* Offline tuning of the collective algorithms. Runs the candidate
+   algorithms of each collective for a range of message sizes with the
+   current job shape (ranks, ranks per node) and appends the fastest
+   ones as rules to a tuning file, to be loaded with
+   GASPI_COLL_TUNING=<file>. Run it once per partition and job shape;
+   the rules of several runs can be kept in the same file.
+
+   usage: coll_tune.bin [tuning file (default gpi2_coll.tune)] */
+
+#define ITERS 100
+#define NSIZES 24
+#define SEG_SIZE (16 * 1024 * 1024)
+#define RECV_OFF (SEG_SIZE / 4)
+
+#define GPI2_ASSERT(s) if(s != GASPI_SUCCESS) { gaspi_printf("GASPI error:" #s " %d\n",__LINE__); exit(EXIT_FAILURE);}
+
+enum coll { ALLREDUCE, BARRIER, BCAST, ALLGATHER, REDUCE_SCATTER, NCOLL };
+
+static const char *coll_name[NCOLL] =
+  { "allreduce", "barrier", "bcast", "allgather", "reduce_scatter" };
+
+static const char *candidates[NCOLL][4] =
+  {
+    { "recursive_doubling", "hierarchical", "ring", NULL },
+    { "dissemination", "hierarchical", NULL },
+    { "tree", "chain", NULL },
+    { "bruck", "ring", NULL },
+    { "allreduce", "ring", NULL }
+  };
+
+static gaspi_rank_t nprocs;
+static double vsend[SEG_SIZE / 16 / sizeof(double)], vrecv[SEG_SIZE / 16 / sizeof(double)];
+
+/* Message sizes (bytes) tried for a collective */
+static int
+sizes(int c, gaspi_size_t *s)
+{
+  int n = 0;
+  gaspi_size_t b;
+
+  switch(c)
+    {
+    case ALLREDUCE:
+      for(b = 8; b < 255 * 8; b *= 2)
+	s[n++] = b;
+      s[n++] = 255 * 8;
+      break;
+    case BARRIER:
+      s[n++] = 0;
+      break;
+    case BCAST:
+      for(b = 8; b <= SEG_SIZE / 4 && n < NSIZES; b *= 4)
+	s[n++] = b;
+      break;
+    case ALLGATHER:
+      for(b = 8; b * nprocs <= SEG_SIZE / 2 && n < NSIZES; b *= 4)
+	s[n++] = b;
+      break;
+    case REDUCE_SCATTER:
+      for(b = 4; b * nprocs * 2 <= sizeof(vsend) && n < NSIZES; b *= 4)
+	s[n++] = b;
+      break;
+    }
+
+  return n;
+}
+
+static void
+run(int c, gaspi_size_t bytes)
+{
+  switch(c)
+    {
+    case ALLREDUCE:
+      GPI2_ASSERT( gaspi_allreduce(vsend, vrecv, bytes / sizeof(double), GASPI_OP_SUM, GASPI_TYPE_DOUBLE,
+				   GASPI_GROUP_ALL, GASPI_BLOCK) );
+      break;
+    case BARRIER:
+      GPI2_ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+      break;
+    case BCAST:
+      GPI2_ASSERT( gaspi_bcast(0, 0, bytes, 0, GASPI_GROUP_ALL, GASPI_BLOCK) );
+      break;
+    case ALLGATHER:
+      GPI2_ASSERT( gaspi_allgather(0, 0, 0, RECV_OFF, bytes, GASPI_GROUP_ALL, GASPI_BLOCK) );
+      break;
+    case REDUCE_SCATTER:
+      GPI2_ASSERT( gaspi_reduce_scatter(vsend, vrecv, bytes / sizeof(int), GASPI_OP_SUM, GASPI_TYPE_INT,
+					GASPI_GROUP_ALL, GASPI_BLOCK) );
+      break;
+    }
+}
+
+/* Time per call in usecs, the slowest rank counts */
+static double
+measure(int c, gaspi_size_t bytes, gaspi_float cpu_freq)
+{
+  gaspi_cycles_t t0, t1;
+  int i;
+
+  for(i = 0; i < ITERS / 10; i++)
+    run(c, bytes);
+
+  GPI2_ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  gaspi_time_ticks(&t0);
+  for(i = 0; i < ITERS; i++)
+    run(c, bytes);
+  gaspi_time_ticks(&t1);
+
+  double t = (double) (t1 - t0) / cpu_freq / ITERS;
+  double tmax;
+
+  GPI2_ASSERT( gaspi_coll_algorithm_set("allreduce", NULL) );
+  GPI2_ASSERT( gaspi_allreduce(&t, &tmax, 1, GASPI_OP_MAX, GASPI_TYPE_DOUBLE, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  return tmax;
+}
+
+int
+main(int argc, char *argv[])
+{
+  const char *fname = (argc > 1) ? argv[1] : "gpi2_coll.tune";
+  gaspi_config_t gconf;
+  gaspi_rank_t rank, nlocal;
+  gaspi_float cpu_freq;
+  FILE *f = NULL;
+  int c;
+
+  GPI2_ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  GPI2_ASSERT( gaspi_config_get(&gconf) );
+  GPI2_ASSERT( gaspi_proc_rank(&rank) );
+  GPI2_ASSERT( gaspi_proc_num(&nprocs) );
+  GPI2_ASSERT( gaspi_proc_local_num(&nlocal) );
+  GPI2_ASSERT( gaspi_cpu_frequency(&cpu_freq) );
+
+  GPI2_ASSERT( gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  /* All nodes are assumed to run the same number of ranks */
+  const char *dev = (gconf.network == GASPI_ETHERNET) ? "tcp" : "ib";
+
+  if( 0 == rank )
+    {
+      f = fopen(fname, "a");
+      if( f == NULL )
+	{
+	  printf("Failed to open %s\n", fname);
+	  exit(EXIT_FAILURE);
+	}
+      fprintf(f, "# %s, %d ranks, %d per node\n", dev, nprocs, nlocal);
+    }
+
+  for(c = 0; c < NCOLL; c++)
+    {
+      gaspi_size_t s[NSIZES];
+      const char *best[NSIZES];
+      const int n = sizes(c, s);
+      int i, k;
+
+      for(i = 0; i < n; i++)
+	{
+	  double tbest = 0.0;
+
+	  for(k = 0; candidates[c][k] != NULL; k++)
+	    {
+	      GPI2_ASSERT( gaspi_coll_algorithm_set(coll_name[c], candidates[c][k]) );
+
+	      const double t = measure(c, s[i], cpu_freq);
+	      if( k == 0 || t < tbest )
+		{
+		  tbest = t;
+		  best[i] = candidates[c][k];
+		}
+
+	      if( 0 == rank )
+		printf("%s\t%lu\t%s\t%.2f usecs\n", coll_name[c], s[i], candidates[c][k], t);
+	    }
+	}
+
+      GPI2_ASSERT( gaspi_coll_algorithm_set(coll_name[c], NULL) );
+
+      /* One rule per range of sizes with the same winner */
+      for(i = 0; i < n && 0 == rank; i = k)
+	{
+	  for(k = i + 1; k < n && strcmp(best[k], best[i]) == 0; k++);
+
+	  fprintf(f, "%s\t%s\t%d %d\t%d %d\t%lu ", coll_name[c], dev, nprocs, nprocs, nlocal, nlocal,
+		  (i == 0) ? 0 : s[i]);
+	  if( k < n )
+	    fprintf(f, "%lu\t%s\n", s[k] - 1, best[i]);
+	  else
+	    fprintf(f, "*\t%s\n", best[i]);
+	}
+    }
+
+  if( 0 == rank )
+    {
+      fclose(f);
+      printf("Rules written to %s\n", fname);
+    }
+
+  GPI2_ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  GPI2_ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
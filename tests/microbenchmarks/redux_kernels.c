@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GASPI.h>
+#include <GASPI_Ext.h>
+
+/* The kernel table is internal to the library */
+#include "GPI2_Coll.h"
+
+/* Throughput of the pre-defined reduction kernels alone (no
+   communication) */
+
+#define REPS 16
+#define MAX_ELEMS (1 << 22)
+
+/* MINLOC/MAXLOC elements are (value, index) pairs */
+#define MAX_ELEM_SIZE (2 * sizeof(double))
+
+static const char * const op_name[GASPI_COLL_OPS] = { "MIN", "MAX", "SUM", "MINLOC", "MAXLOC",
+						      "BAND", "BOR", "BXOR", "LAND", "LOR" };
+static const char * const type_name[GASPI_COLL_TYPES] = { "INT", "UINT", "FLOAT", "DOUBLE", "LONG", "ULONG" };
+static const size_t type_size[GASPI_COLL_TYPES] = { sizeof(int), sizeof(unsigned int), sizeof(float),
+				    sizeof(double), sizeof(long), sizeof(unsigned long) };
+
+static int
+mcycles_compare (const void *aptr, const void *bptr)
+{
+  const gaspi_cycles_t *a = (gaspi_cycles_t *) aptr;
+  const gaspi_cycles_t *b = (gaspi_cycles_t *) bptr;
+  if (*a < *b)
+    return -1;
+  if (*a > *b)
+    return 1;
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int op, type, r;
+  gaspi_number_t elems;
+  gaspi_float cpu_freq;
+  gaspi_cycles_t t0, t1, delta[REPS];
+
+  gaspi_init_collectives();
+
+  if( gaspi_cpu_frequency(&cpu_freq) != GASPI_SUCCESS )
+    {
+      printf("Failed to get CPU frequency\n");
+      return EXIT_FAILURE;
+    }
+
+  unsigned char *res = malloc(MAX_ELEMS * MAX_ELEM_SIZE);
+  unsigned char *local = malloc(MAX_ELEMS * MAX_ELEM_SIZE);
+  unsigned char *dst = malloc(MAX_ELEMS * MAX_ELEM_SIZE);
+  if( res == NULL || local == NULL || dst == NULL )
+    {
+      printf("Failed to allocate memory\n");
+      return EXIT_FAILURE;
+    }
+
+  memset(res, 0, MAX_ELEMS * MAX_ELEM_SIZE);
+  memset(local, 1, MAX_ELEMS * MAX_ELEM_SIZE);
+  memset(dst, 2, MAX_ELEMS * MAX_ELEM_SIZE);
+
+  printf("CPU freq: %.2f\n", cpu_freq);
+  printf("#op\ttype\telems\tusecs\tGB/s\n");
+
+  for(op = 0; op < GASPI_COLL_OPS; op++)
+    {
+      for(type = 0; type < GASPI_COLL_TYPES; type++)
+	{
+	  /* Not defined (bitwise operations on floating point) */
+	  if( fctArrayGASPI[op * GASPI_COLL_TYPES + type] == NULL )
+	    {
+	      continue;
+	    }
+
+	  const size_t elem_size = type_size[type] * (GASPI_COLL_IS_LOC(op) ? 2 : 1);
+
+	  for(elems = 256; elems <= MAX_ELEMS; elems *= 4)
+	    {
+	      for(r = 0; r < REPS; r++)
+		{
+		  gaspi_time_ticks(&t0);
+		  fctArrayGASPI[op * GASPI_COLL_TYPES + type] (res, local, dst, elems);
+		  gaspi_time_ticks(&t1);
+		  delta[r] = t1 - t0;
+		}
+
+	      qsort (delta, REPS, sizeof *delta, mcycles_compare);
+
+	      const double usecs = (double) delta[REPS / 2] / cpu_freq;
+	      const double bytes = 3.0 * elems * elem_size;
+
+	      printf("%s\t%s\t%u\t%.2f\t%.2f\n",
+		     op_name[op], type_name[type], elems, usecs, bytes / (usecs * 1000.0));
+	    }
+	}
+    }
+
+  free(dst);
+  free(local);
+  free(res);
+
+  return EXIT_SUCCESS;
+}
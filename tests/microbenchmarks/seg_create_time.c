@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <GASPI.h>
+
+#define SEG_NUM 16
+#define SEG_SIZE (1 << 20)
+
+int main(int argc, char *argv[])
+{
+  struct timeval start_time, end_time;
+  gaspi_rank_t proc_num, proc_rank;
+  double create_time = 0.0f;
+  gaspi_segment_id_t s;
+
+  if(gaspi_proc_init(GASPI_BLOCK) != GASPI_SUCCESS)
+    {
+      printf("Failed proc_init\n");
+      return EXIT_FAILURE;
+    }
+
+  gaspi_proc_num(&proc_num);
+  gaspi_proc_rank(&proc_rank);
+
+  if(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) != GASPI_SUCCESS)
+    {
+      printf("Failed barrier\n");
+      return EXIT_FAILURE;
+    }
+
+  gettimeofday(&start_time, NULL);
+
+  for(s = 0; s < SEG_NUM; s++)
+    {
+      if(gaspi_segment_create(s, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_UNINITIALIZED) != GASPI_SUCCESS)
+	{
+	  printf("Failed segment_create\n");
+	  return EXIT_FAILURE;
+	}
+    }
+
+  gettimeofday(&end_time, NULL);
+
+  create_time = (((double) end_time.tv_sec + (double) end_time.tv_usec * 1.e-6 ) - ((double)start_time.tv_sec + (double)start_time.tv_usec * 1.e-6 ));
+
+  if(proc_rank == 0)
+    printf("gaspi_segment_create time for %d ranks: %.2f ms\n",
+	   proc_num, create_time * 1000.0 / SEG_NUM);
+
+  for(s = 0; s < SEG_NUM; s++)
+    {
+      if(gaspi_segment_delete(s) != GASPI_SUCCESS)
+	{
+	  printf("Failed segment_delete\n");
+	  return EXIT_FAILURE;
+	}
+    }
+
+  if(gaspi_proc_term(GASPI_BLOCK) != GASPI_SUCCESS)
+    {
+      printf("Failed proc_term\n");
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+#include <pthread.h>
+
+#include <test_utils.h>
+
+/* Connect to all ranks at once from two threads with overlapping
+   (and repeated) ranks, then communicate with everyone. */
+
+static gaspi_rank_t nprocs;
+
+static void *
+thread_fun(void *arg)
+{
+  const unsigned long tid = (unsigned long) arg;
+  gaspi_rank_t * const ranks = malloc(2 * nprocs * sizeof(gaspi_rank_t));
+  assert (ranks != NULL);
+
+  gaspi_rank_t i;
+  for (i = 0; i < nprocs; i++)
+    {
+      ranks[i] = (tid == 0) ? i : nprocs - 1 - i;
+      ranks[nprocs + i] = i;
+    }
+
+  ASSERT (gaspi_connect_many(ranks, 2 * nprocs, GASPI_BLOCK));
+
+  free(ranks);
+
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.build_infrastructure = GASPI_TOPOLOGY_NONE;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t myrank;
+  ASSERT (gaspi_proc_rank(&myrank));
+  ASSERT (gaspi_proc_num(&nprocs));
+
+  gaspi_group_t g;
+  ASSERT (gaspi_group_create(&g));
+
+  gaspi_rank_t n;
+  for (n = 0; n < nprocs; n++)
+    {
+      ASSERT (gaspi_group_add(g, n));
+    }
+
+  ASSERT (gaspi_group_commit(g, GASPI_BLOCK));
+
+  ASSERT (gaspi_segment_create(0, nprocs * sizeof(int), g, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  pthread_t threads[2];
+  unsigned long t;
+  for (t = 0; t < 2; t++)
+    {
+      assert (pthread_create(&threads[t], NULL, thread_fun, (void *) t) == 0);
+    }
+
+  for (t = 0; t < 2; t++)
+    {
+      assert (pthread_join(threads[t], NULL) == 0);
+    }
+
+  /* Already connected */
+  ASSERT (gaspi_connect_many(&myrank, 1, GASPI_TEST));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  int * const mem = (int *) ptr;
+  mem[myrank] = myrank + 1;
+
+  for (n = 0; n < nprocs; n++)
+    {
+      if (n != myrank)
+	{
+	  ASSERT (gaspi_write_notify(0, myrank * sizeof(int), n, 0, myrank * sizeof(int),
+				     sizeof(int), myrank, 1, 0, GASPI_BLOCK));
+	}
+    }
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  for (n = 0; n < nprocs; n++)
+    {
+      if (n != myrank)
+	{
+	  gaspi_notification_id_t id;
+	  gaspi_notification_t val;
+	  ASSERT (gaspi_notify_waitsome(0, n, 1, &id, GASPI_BLOCK));
+	  ASSERT (gaspi_notify_reset(0, id, &val));
+	  assert (mem[n] == n + 1);
+	}
+    }
+
+  ASSERT (gaspi_barrier(g, GASPI_BLOCK));
+
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <test_utils.h>
+
+/* Allgather of small (Bruck) and large (ring) blocks, repeated on the
+   same buffers */
+
+#define MAX_BLOCK (1024 * 1024)
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  ASSERT( gaspi_segment_create(0, MAX_BLOCK, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+  ASSERT( gaspi_segment_create(1, (gaspi_size_t) nprocs * MAX_BLOCK, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+  unsigned char * const send = (unsigned char *) _vptr;
+  ASSERT( gaspi_segment_ptr(1, &_vptr) );
+  unsigned char * const recv = (unsigned char *) _vptr;
+
+  const gaspi_size_t sizes[] = { 1, 8, 100, 4096, 70000, MAX_BLOCK };
+
+  unsigned int s;
+  int iter;
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+      for(iter = 0; iter < 10; iter++)
+	{
+	  gaspi_size_t i;
+	  for(i = 0; i < sizes[s]; i++)
+	    {
+	      send[i] = (unsigned char) (myrank * 31 + i + iter);
+	    }
+
+	  ASSERT( gaspi_allgather(0, 0, 1, 0, sizes[s], GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+	  gaspi_rank_t r;
+	  for(r = 0; r < nprocs; r++)
+	    {
+	      for(i = 0; i < sizes[s]; i++)
+		{
+		  assert( recv[r * sizes[s] + i] == (unsigned char) (r * 31 + i + iter) );
+		}
+	    }
+	}
+    }
+
+  /* in place, at an offset */
+  const gaspi_size_t bsize = 24;
+  memset(recv, 0, nprocs * bsize + 64);
+  memset(recv + 64 + myrank * bsize, myrank + 1, bsize);
+
+  ASSERT( gaspi_allgather(1, 64 + myrank * bsize, 1, 64, bsize, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  gaspi_rank_t r;
+  for(r = 0; r < nprocs; r++)
+    {
+      gaspi_size_t i;
+      for(i = 0; i < bsize; i++)
+	{
+	  assert( recv[64 + r * bsize + i] == r + 1 );
+	}
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -63,6 +63,8 @@ INIT_IMPLEM
       case GASPI_OP_SUM:					\
 	expected = (nprocs * (nprocs -1)) / 2;			\
 	break;							\
+      default:							\
+	return 0;						\
       }								\
     for(i = 0; i < n; i++)					\
       if(v[i] != expected)					\
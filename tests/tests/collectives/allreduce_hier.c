@@ -0,0 +1,135 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Node-aware barrier and allreduce: every two ranks are taken as one
+   node (GASPI_DEBUG_NODE_RANKS of the debug library), so that with 3
+   or more ranks there are several nodes even on a single host. Also
+   on a group without rank 0, which shifts the node leaders. */
+
+#define NUM_ELEMS (255)
+#define ITERS (10)
+
+static gaspi_return_t
+max_fun(double * const a,
+	double * const b,
+	double * const r,
+	gaspi_state_t const state,
+	const gaspi_number_t num,
+	const gaspi_size_t elem_size,
+	const gaspi_timeout_t tout)
+{
+  gaspi_number_t i;
+
+  for(i = 0; i < num; i++)
+    {
+      r[i] = (a[i] < b[i]) ? b[i] : a[i];
+    }
+
+  return GASPI_SUCCESS;
+}
+
+static void
+check_group(const gaspi_group_t g)
+{
+  gaspi_number_t gsize;
+  ASSERT( gaspi_group_size(g, &gsize) );
+
+  gaspi_rank_t * const ranks = malloc(gsize * sizeof(gaspi_rank_t));
+  assert( ranks != NULL );
+  ASSERT( gaspi_group_ranks(g, ranks) );
+
+  long sum = 0;
+  gaspi_rank_t min = ranks[0], max = 0;
+  gaspi_number_t k;
+  for(k = 0; k < gsize; k++)
+    {
+      sum += ranks[k];
+      min = (ranks[k] < min) ? ranks[k] : min;
+      max = (ranks[k] > max) ? ranks[k] : max;
+    }
+  free(ranks);
+
+  gaspi_rank_t myrank;
+  ASSERT( gaspi_proc_rank(&myrank) );
+
+  static long a[NUM_ELEMS], b[NUM_ELEMS];
+  static double d[NUM_ELEMS], e[NUM_ELEMS];
+
+  int it, i, n;
+  for(it = 0; it < ITERS; it++)
+    {
+      ASSERT( gaspi_barrier(g, GASPI_BLOCK) );
+
+      for(n = 1; n <= NUM_ELEMS; n += 127)
+	{
+	  for(i = 0; i < n; i++)
+	    {
+	      a[i] = myrank + i + it;
+	      d[i] = (double) (myrank * i);
+	    }
+
+	  ASSERT( gaspi_allreduce(a, b, n, GASPI_OP_SUM, GASPI_TYPE_LONG, g, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( b[i] == sum + (long) gsize * (i + it) );
+	    }
+
+	  ASSERT( gaspi_allreduce(a, b, n, GASPI_OP_MIN, GASPI_TYPE_LONG, g, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( b[i] == min + i + it );
+	    }
+
+	  ASSERT( gaspi_allreduce_user(d, e, n, sizeof(double),
+				       (gaspi_reduce_operation_t) max_fun, NULL,
+				       g, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( e[i] == (double) (max * i) );
+	    }
+	}
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  /* Before the init: GASPI_GROUP_ALL is committed there */
+  assert( setenv("GASPI_DEBUG_NODE_RANKS", "2", 1) == 0 );
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  check_group(GASPI_GROUP_ALL);
+
+  if( nprocs > 2 )
+    {
+      gaspi_group_t g;
+      ASSERT( gaspi_group_create(&g) );
+
+      gaspi_rank_t n;
+      for(n = 1; n < nprocs; n++)
+	{
+	  ASSERT( gaspi_group_add(g, n) );
+	}
+
+      if( myrank > 0 )
+	{
+	  ASSERT( gaspi_group_commit(g, GASPI_BLOCK) );
+	  check_group(g);
+	}
+
+      ASSERT( gaspi_group_delete(g) );
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Allreduce of vectors beyond gaspi_allreduce_elem_max (ring path) */
+
+#define CHECK_TYPE_IMPLEM(ctype)					\
+  static int								\
+  check_##ctype(gaspi_operation_t op, gaspi_datatype_t type, gaspi_number_t n, \
+		gaspi_rank_t myrank, gaspi_rank_t nprocs, int inplace)	\
+  {									\
+    ctype *send = malloc(n * sizeof(ctype));				\
+    ctype *recv = inplace ? send : malloc(n * sizeof(ctype));		\
+    gaspi_number_t i;							\
+    int ok = 1;								\
+									\
+    for(i = 0; i < n; i++)						\
+      send[i] = (ctype) (i % 1000 + myrank);				\
+									\
+    ASSERT( gaspi_allreduce(send, recv, n, op, type, GASPI_GROUP_ALL, GASPI_BLOCK) ); \
+									\
+    for(i = 0; i < n; i++)						\
+      {									\
+	ctype expected = 0;						\
+	switch(op)							\
+	  {								\
+	  case GASPI_OP_MIN:						\
+	    expected = (ctype) (i % 1000);				\
+	    break;							\
+	  case GASPI_OP_MAX:						\
+	    expected = (ctype) (i % 1000 + nprocs - 1);			\
+	    break;							\
+	  case GASPI_OP_SUM:						\
+	    expected = (ctype) (nprocs * (i % 1000) + (nprocs * (nprocs - 1)) / 2); \
+	    break;							\
+	  default:							\
+	    /* Not checked here: fails below */				\
+	    break;							\
+	  }								\
+	if( recv[i] != expected )					\
+	  {								\
+	    gaspi_printf("elem %lu: expected %f got %f\n",		\
+			 (unsigned long) i, (double) expected, (double) recv[i]); \
+	    ok = 0;							\
+	    break;							\
+	  }								\
+      }									\
+									\
+    if( !inplace )							\
+      free(recv);							\
+    free(send);								\
+									\
+    return ok;								\
+  }
+
+CHECK_TYPE_IMPLEM(int)
+CHECK_TYPE_IMPLEM(double)
+CHECK_TYPE_IMPLEM(uint64_t)
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  gaspi_number_t elem_max;
+  ASSERT( gaspi_allreduce_elem_max(&elem_max) );
+
+  const gaspi_number_t sizes[] = { elem_max + 1, 1000, 33333, 1 << 20 };
+
+  unsigned int s;
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+      gaspi_operation_t op;
+      for(op = GASPI_OP_MIN; op <= GASPI_OP_SUM; op++)
+	{
+	  assert( check_int(op, GASPI_TYPE_INT, sizes[s], myrank, nprocs, 0) );
+	  assert( check_double(op, GASPI_TYPE_DOUBLE, sizes[s], myrank, nprocs, 0) );
+	  assert( check_uint64_t(op, GASPI_TYPE_ULONG, sizes[s], myrank, nprocs, 1) );
+	}
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
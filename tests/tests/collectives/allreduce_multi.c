@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <test_utils.h>
+
+/* Fused allreduce of vectors with different operations, types and a
+   user-defined reduction on 3-byte elements */
+
+typedef struct
+{
+  unsigned char v[3];
+} triple_t;
+
+/* Byte-wise maximum */
+gaspi_return_t
+my_triple_max (triple_t * const a,
+	       triple_t * const b,
+	       triple_t * const r,
+	       gaspi_state_t const state,
+	       const gaspi_number_t num,
+	       const gaspi_size_t elem_size,
+	       const gaspi_timeout_t tout)
+{
+  gaspi_number_t i;
+  int k;
+
+  assert( elem_size == sizeof(triple_t) );
+  assert( *(int *) state == 42 );
+
+  for(i = 0; i < num; i++)
+    {
+      for(k = 0; k < 3; k++)
+	{
+	  r[i].v[k] = (a[i].v[k] > b[i].v[k]) ? a[i].v[k] : b[i].v[k];
+	}
+    }
+
+  return GASPI_SUCCESS;
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  double dot, dot_sum;
+  int imax[2], imax_res[2];
+  long lmin[3], lmin_res[3];
+  triple_t t[5], t_res[5];
+  int state = 42;
+  int iter, i, k;
+
+  gaspi_allreduce_entry_t list[4];
+  memset(list, 0, sizeof(list));
+
+  list[0].buffer_send = &dot;
+  list[0].buffer_receive = &dot_sum;
+  list[0].num = 1;
+  list[0].operation = GASPI_OP_SUM;
+  list[0].datatype = GASPI_TYPE_DOUBLE;
+
+  list[1].buffer_send = imax;
+  list[1].buffer_receive = imax_res;
+  list[1].num = 2;
+  list[1].operation = GASPI_OP_MAX;
+  list[1].datatype = GASPI_TYPE_INT;
+
+  list[2].buffer_send = t;
+  list[2].buffer_receive = t_res;
+  list[2].num = 5;
+  list[2].element_size = sizeof(triple_t);
+  list[2].reduce_operation = (gaspi_reduce_operation_t) my_triple_max;
+  list[2].reduce_state = &state;
+
+  list[3].buffer_send = lmin;
+  list[3].buffer_receive = lmin_res;
+  list[3].num = 3;
+  list[3].operation = GASPI_OP_MIN;
+  list[3].datatype = GASPI_TYPE_LONG;
+
+  for(iter = 0; iter < 50; iter++)
+    {
+      dot = 0.5 * myrank + iter;
+      imax[0] = myrank * iter;
+      imax[1] = -myrank;
+      for(i = 0; i < 3; i++)
+	{
+	  lmin[i] = 100 + myrank - i * iter;
+	}
+      for(i = 0; i < 5; i++)
+	{
+	  for(k = 0; k < 3; k++)
+	    {
+	      t[i].v[k] = (unsigned char) ((myrank + i + k + iter) % nprocs);
+	    }
+	}
+
+      ASSERT( gaspi_allreduce_multi(list, 4, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+      assert( dot_sum == 0.25 * nprocs * (nprocs - 1) + (double) nprocs * iter );
+      assert( imax_res[0] == (nprocs - 1) * iter );
+      assert( imax_res[1] == 0 );
+      for(i = 0; i < 3; i++)
+	{
+	  assert( lmin_res[i] == 100 - i * iter );
+	}
+      for(i = 0; i < 5; i++)
+	{
+	  for(k = 0; k < 3; k++)
+	    {
+	      assert( t_res[i].v[k] == nprocs - 1 );
+	    }
+	}
+    }
+
+  /* Does not fit */
+  static double big[256], big_res[256];
+  list[0].buffer_send = big;
+  list[0].buffer_receive = big_res;
+  list[0].num = 255;
+  EXPECT_FAIL( gaspi_allreduce_multi(list, 2, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  ASSERT( gaspi_allreduce_multi(list, 1, GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_allreduce_multi(list, 0, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* MINLOC/MAXLOC, bitwise and logical reductions */
+
+typedef struct
+{
+  double value;
+  long index;
+} double_loc_t;
+
+typedef struct
+{
+  int value;
+  int index;
+} int_loc_t;
+
+#define LARGE 1000
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  int i;
+
+  /* Which rank has the largest residual */
+  const int worst = (nprocs - 1) / 2;
+  double_loc_t res, res_max;
+  res.value = (myrank == worst) ? 1.0e-3 : 1.0e-6 * myrank;
+  res.index = myrank;
+
+  ASSERT( gaspi_allreduce(&res, &res_max, 1, GASPI_OP_MAXLOC, GASPI_TYPE_DOUBLE,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( res_max.value == 1.0e-3 );
+  assert( res_max.index == worst );
+
+  /* Ties go to the lowest index */
+  int_loc_t v[2], v_min[2];
+  v[0].value = 7;
+  v[0].index = myrank;
+  v[1].value = -(myrank % 2);
+  v[1].index = myrank;
+
+  ASSERT( gaspi_allreduce(v, v_min, 2, GASPI_OP_MINLOC, GASPI_TYPE_INT,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( v_min[0].value == 7 && v_min[0].index == 0 );
+  assert( v_min[1].value == ((nprocs > 1) ? -1 : 0) );
+  assert( v_min[1].index == ((nprocs > 1) ? 1 : 0) );
+
+  /* Too large for the small-message algorithms */
+  static double_loc_t big[LARGE], big_res[LARGE];
+  for(i = 0; i < LARGE; i++)
+    {
+      big[i].value = (double) ((myrank + i) % nprocs);
+      big[i].index = myrank;
+    }
+
+  ASSERT( gaspi_allreduce(big, big_res, LARGE, GASPI_OP_MAXLOC, GASPI_TYPE_DOUBLE,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  for(i = 0; i < LARGE; i++)
+    {
+      assert( big_res[i].value == nprocs - 1 );
+      assert( big_res[i].index == (nprocs - 1 - i % nprocs + nprocs) % nprocs );
+    }
+
+  /* Bitwise */
+  unsigned long bits = 1UL << (myrank % 64), bits_or;
+  ASSERT( gaspi_allreduce(&bits, &bits_or, 1, GASPI_OP_BOR, GASPI_TYPE_ULONG,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  for(i = 0; i < 64; i++)
+    {
+      assert( ((bits_or >> i) & 1) == (i < nprocs) );
+    }
+
+  unsigned int mask = ~(1U << (myrank % 32)), mask_and;
+  ASSERT( gaspi_allreduce(&mask, &mask_and, 1, GASPI_OP_BAND, GASPI_TYPE_UINT,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( mask_and == ((nprocs >= 32) ? 0U : ~((1U << nprocs) - 1)) );
+
+  int parity = 1, parity_xor;
+  ASSERT( gaspi_allreduce(&parity, &parity_xor, 1, GASPI_OP_BXOR, GASPI_TYPE_INT,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( parity_xor == nprocs % 2 );
+
+  /* Not defined for floating point */
+  double d = 1.0, d_res;
+  EXPECT_FAIL( gaspi_allreduce(&d, &d_res, 1, GASPI_OP_BAND, GASPI_TYPE_DOUBLE,
+			       GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  /* Logical */
+  double converged[2], all_conv[2], any_conv[2];
+  converged[0] = 1.0;
+  converged[1] = (myrank == nprocs - 1) ? 1.0 : 0.0;
+
+  ASSERT( gaspi_allreduce(converged, all_conv, 2, GASPI_OP_LAND, GASPI_TYPE_DOUBLE,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_allreduce(converged, any_conv, 2, GASPI_OP_LOR, GASPI_TYPE_DOUBLE,
+			  GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( all_conv[0] == 1.0 && any_conv[0] == 1.0 );
+  assert( all_conv[1] == ((nprocs == 1) ? 1.0 : 0.0) );
+  assert( any_conv[1] == 1.0 );
+
+  /* Prefix over the ranks */
+  long flags = 1L << myrank, flags_scan;
+  ASSERT( gaspi_scan(&flags, &flags_scan, 1, GASPI_OP_BOR, GASPI_TYPE_LONG,
+		     GASPI_GROUP_ALL, GASPI_BLOCK) );
+  assert( flags_scan == (1L << (myrank + 1)) - 1 );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
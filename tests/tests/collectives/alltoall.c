@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <test_utils.h>
+
+/* Alltoall with fixed blocks and alltoallv with blocks of different
+   (possibly empty) sizes */
+
+#define MAX_BLOCK (64 * 1024)
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  const gaspi_size_t seg_size = (gaspi_size_t) nprocs * MAX_BLOCK;
+
+  ASSERT( gaspi_segment_create(0, seg_size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+  ASSERT( gaspi_segment_create(1, seg_size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+  unsigned char * const send = (unsigned char *) _vptr;
+  ASSERT( gaspi_segment_ptr(1, &_vptr) );
+  unsigned char * const recv = (unsigned char *) _vptr;
+
+  const gaspi_size_t sizes[] = { 1, 8, 1000, MAX_BLOCK };
+
+  gaspi_rank_t r;
+  gaspi_size_t i;
+  unsigned int s;
+  int iter;
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+      for(iter = 0; iter < 10; iter++)
+	{
+	  /* block for rank r */
+	  for(r = 0; r < nprocs; r++)
+	    {
+	      memset(send + r * sizes[s], myrank * nprocs + r + iter, sizes[s]);
+	    }
+
+	  ASSERT( gaspi_alltoall(0, 0, 1, 0, sizes[s], GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+	  /* block from rank r */
+	  for(r = 0; r < nprocs; r++)
+	    {
+	      for(i = 0; i < sizes[s]; i++)
+		{
+		  assert( recv[r * sizes[s] + i] == (unsigned char) (r * nprocs + myrank + iter) );
+		}
+	    }
+	}
+    }
+
+  gaspi_offset_t *offset_send = malloc(nprocs * sizeof(gaspi_offset_t));
+  gaspi_offset_t *offset_recv = malloc(nprocs * sizeof(gaspi_offset_t));
+  gaspi_size_t *size = malloc(nprocs * sizeof(gaspi_size_t));
+  assert( offset_send != NULL && offset_recv != NULL && size != NULL );
+
+  for(iter = 0; iter < 10; iter++)
+    {
+      memset(recv, 0, seg_size);
+
+      /* rank r receives (myrank + r + iter) % 4 * 1000 bytes from us,
+	 in its slot for us */
+      for(r = 0; r < nprocs; r++)
+	{
+	  size[r] = ((myrank + r + iter) % 4) * 1000;
+	  offset_send[r] = (gaspi_offset_t) (nprocs - 1 - r) * MAX_BLOCK;
+	  offset_recv[r] = (gaspi_offset_t) myrank * MAX_BLOCK;
+	  memset(send + offset_send[r], myrank + 2 * r + 1, size[r]);
+	}
+
+      ASSERT( gaspi_alltoallv(0, offset_send, size, 1, offset_recv, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+      for(r = 0; r < nprocs; r++)
+	{
+	  const gaspi_size_t expected = ((r + myrank + iter) % 4) * 1000;
+	  for(i = 0; i < MAX_BLOCK; i++)
+	    {
+	      assert( recv[r * MAX_BLOCK + i] == (i < expected ? (unsigned char) (r + 2 * myrank + 1) : 0) );
+	    }
+	}
+    }
+
+  free(size);
+  free(offset_recv);
+  free(offset_send);
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
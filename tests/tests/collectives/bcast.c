@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <test_utils.h>
+
+/* Broadcast from every root, small (tree) and large (chain)
+   messages, segment and buffer forms */
+
+#define MAX_BYTES (4 * 1024 * 1024 + 3)
+
+static void
+fill(unsigned char * const p, const gaspi_size_t size, const gaspi_rank_t root, const int iter)
+{
+  gaspi_size_t i;
+  for(i = 0; i < size; i++)
+    {
+      p[i] = (unsigned char) (i * 7 + root * 13 + iter);
+    }
+}
+
+static int
+check(unsigned char const * const p, const gaspi_size_t size, const gaspi_rank_t root, const int iter)
+{
+  gaspi_size_t i;
+  for(i = 0; i < size; i++)
+    {
+      if( p[i] != (unsigned char) (i * 7 + root * 13 + iter) )
+	{
+	  gaspi_printf("Wrong value at %lu (root %u, size %lu)\n", i, root, size);
+	  return 0;
+	}
+    }
+  return 1;
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  ASSERT( gaspi_segment_create(0, MAX_BYTES + 64, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+
+  unsigned char * const seg = (unsigned char *) _vptr;
+  unsigned char * const buf = malloc(MAX_BYTES);
+  assert( buf != NULL );
+
+  const gaspi_size_t sizes[] = { 1, 100, 4096, 131072 + 5, 1000000, MAX_BYTES };
+
+  int iter = 0;
+  unsigned int s;
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+      gaspi_rank_t root;
+      for(root = 0; root < nprocs; root++, iter++)
+	{
+	  /* segment form, at an offset */
+	  memset(seg, 0, MAX_BYTES + 64);
+	  if( myrank == root )
+	    {
+	      fill(seg + 64, sizes[s], root, iter);
+	    }
+
+	  ASSERT( gaspi_bcast(0, 64, sizes[s], root, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  assert( check(seg + 64, sizes[s], root, iter) );
+
+	  /* buffer form */
+	  memset(buf, 0, MAX_BYTES);
+	  if( myrank == root )
+	    {
+	      fill(buf, sizes[s], root, iter + 1);
+	    }
+
+	  ASSERT( gaspi_bcast_buf(buf, sizes[s], root, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  assert( check(buf, sizes[s], root, iter + 1) );
+	}
+    }
+
+  /* mixed with the other collectives */
+  for(iter = 0; iter < 100; iter++)
+    {
+      const gaspi_rank_t root = iter % nprocs;
+      const gaspi_size_t size = (iter % 3 == 0) ? 300000 : 64;
+
+      if( myrank == root )
+	{
+	  fill(buf, size, root, iter);
+	}
+
+      ASSERT( gaspi_bcast_buf(buf, size, root, GASPI_GROUP_ALL, GASPI_BLOCK) );
+      assert( check(buf, size, root, iter) );
+
+      double v[300], r[300];
+      int i;
+      for(i = 0; i < 300; i++)
+	{
+	  v[i] = myrank + i;
+	}
+      ASSERT( gaspi_allreduce(v, r, 300, GASPI_OP_SUM, GASPI_TYPE_DOUBLE, GASPI_GROUP_ALL, GASPI_BLOCK) );
+      assert( r[299] == nprocs * 299.0 + (nprocs * (nprocs - 1)) / 2 );
+
+      ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+    }
+
+  EXPECT_FAIL( gaspi_bcast_buf(buf, 1, nprocs, GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  free(buf);
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Every algorithm of allreduce, barrier and bcast forced in turn,
+   size-dependent lists and invalid settings */
+
+#define NUM 255
+#define BYTES (300000)
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  ASSERT( gaspi_segment_create(0, BYTES, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+  unsigned char * const seg = (unsigned char *) _vptr;
+
+  const char *allreduce_algs[] =
+    { "recursive_doubling", "hierarchical", "ring", "hierarchical:80,ring", "auto" };
+  const char *barrier_algs[] = { "dissemination", "hierarchical", "auto" };
+  const char *bcast_algs[] = { "tree", "chain", "tree:1000,chain" };
+
+  long send[NUM], recv[NUM];
+  unsigned int a;
+  int i, n;
+
+  for(a = 0; a < sizeof(allreduce_algs) / sizeof(allreduce_algs[0]); a++)
+    {
+      ASSERT( gaspi_coll_algorithm_set("allreduce", allreduce_algs[a]) );
+
+      for(n = 1; n <= NUM; n += 127)
+	{
+	  for(i = 0; i < n; i++)
+	    {
+	      send[i] = myrank + i;
+	      recv[i] = -1;
+	    }
+
+	  ASSERT( gaspi_allreduce(send, recv, n, GASPI_OP_SUM, GASPI_TYPE_LONG, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( recv[i] == (long) nprocs * (nprocs - 1) / 2 + (long) nprocs * i );
+	    }
+	}
+    }
+
+  for(a = 0; a < sizeof(barrier_algs) / sizeof(barrier_algs[0]); a++)
+    {
+      ASSERT( gaspi_coll_algorithm_set("barrier", barrier_algs[a]) );
+      for(i = 0; i < 10; i++)
+	{
+	  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+	}
+    }
+
+  for(a = 0; a < sizeof(bcast_algs) / sizeof(bcast_algs[0]); a++)
+    {
+      ASSERT( gaspi_coll_algorithm_set("bcast", bcast_algs[a]) );
+
+      gaspi_size_t size;
+      for(size = 10; size <= BYTES; size *= 30)
+	{
+	  const gaspi_rank_t root = (gaspi_rank_t) ((size + a) % nprocs);
+	  gaspi_size_t j;
+
+	  for(j = 0; j < size; j++)
+	    {
+	      seg[j] = (myrank == root) ? (unsigned char) (j + a) : 0;
+	    }
+
+	  ASSERT( gaspi_bcast(0, 0, size, root, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(j = 0; j < size; j++)
+	    {
+	      assert( seg[j] == (unsigned char) (j + a) );
+	    }
+	}
+    }
+
+  EXPECT_FAIL( gaspi_coll_algorithm_set("allreduce", "tree") );
+  EXPECT_FAIL( gaspi_coll_algorithm_set("allreduce", "ring:100,hierarchical:50") );
+  EXPECT_FAIL( gaspi_coll_algorithm_set("allreduce", "unknown") );
+  EXPECT_FAIL( gaspi_coll_algorithm_set("unknown", "ring") );
+
+  ASSERT( gaspi_coll_algorithm_set("allreduce", NULL) );
+  ASSERT( gaspi_coll_algorithm_set("barrier", NULL) );
+  ASSERT( gaspi_coll_algorithm_set("bcast", NULL) );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
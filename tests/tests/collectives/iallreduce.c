@@ -0,0 +1,112 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Non-blocking barrier and allreduce, several outstanding per group
+   and mixed with blocking collectives */
+
+gaspi_return_t
+my_max (double * const a,
+	double * const b,
+	double * const r,
+	gaspi_state_t const state,
+	const gaspi_number_t num,
+	const gaspi_size_t elem_size,
+	const gaspi_timeout_t tout)
+{
+  gaspi_number_t i;
+  for(i = 0; i < num; i++)
+    {
+      r[i] = (a[i] > b[i]) ? a[i] : b[i];
+    }
+
+  return GASPI_SUCCESS;
+}
+
+#define NUM 255
+#define NREQ 6
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  int send[NUM], recv[NREQ][NUM];
+  double dsend[NUM], drecv[NUM], dsum;
+  gaspi_coll_request_t req[NREQ], breq, ureq;
+
+  int iter;
+  for(iter = 0; iter < 20; iter++)
+    {
+      int r, i;
+
+      /* More requests than can be outstanding: starting the later
+	 ones completes the older ones */
+      for(r = 0; r < NREQ; r++)
+	{
+	  for(i = 0; i < NUM; i++)
+	    {
+	      send[i] = myrank + r + i + iter;
+	      recv[r][i] = -1;
+	    }
+
+	  ASSERT( gaspi_iallreduce(send, recv[r], NUM, GASPI_OP_SUM, GASPI_TYPE_INT,
+				   GASPI_GROUP_ALL, &req[r], GASPI_BLOCK) );
+	}
+
+      ASSERT( gaspi_ibarrier(GASPI_GROUP_ALL, &breq, GASPI_BLOCK) );
+
+      for(i = 0; i < NUM; i++)
+	{
+	  dsend[i] = (double) ((myrank + iter + i) % nprocs);
+	  drecv[i] = -1.0;
+	}
+      ASSERT( gaspi_iallreduce_user(dsend, drecv, NUM, sizeof(double), (gaspi_reduce_operation_t) my_max, NULL,
+				    GASPI_GROUP_ALL, &ureq, GASPI_BLOCK) );
+
+      /* A blocking collective in between */
+      double one = 1.0;
+      ASSERT( gaspi_allreduce(&one, &dsum, 1, GASPI_OP_SUM, GASPI_TYPE_DOUBLE, GASPI_GROUP_ALL, GASPI_BLOCK) );
+      assert( dsum == (double) nprocs );
+
+      /* Completed in any order */
+      gaspi_return_t ret;
+      do
+	{
+	  ret = gaspi_coll_wait(ureq, GASPI_TEST);
+	  assert( ret == GASPI_SUCCESS || ret == GASPI_TIMEOUT );
+	}
+      while( ret != GASPI_SUCCESS );
+
+      for(i = 0; i < NUM; i++)
+	{
+	  assert( drecv[i] == (double) (nprocs - 1) );
+	}
+
+      ASSERT( gaspi_coll_wait(breq, GASPI_BLOCK) );
+
+      for(r = NREQ - 1; r >= 0; r--)
+	{
+	  ASSERT( gaspi_coll_wait(req[r], GASPI_BLOCK) );
+
+	  for(i = 0; i < NUM; i++)
+	    {
+	      assert( recv[r][i] == nprocs * (nprocs - 1) / 2 + nprocs * (r + i + iter) );
+	    }
+	}
+    }
+
+  EXPECT_FAIL( gaspi_iallreduce(send, recv[0], NUM + 1, GASPI_OP_SUM, GASPI_TYPE_INT,
+				GASPI_GROUP_ALL, &req[0], GASPI_BLOCK) );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
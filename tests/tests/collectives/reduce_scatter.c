@@ -0,0 +1,95 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Reduce-scatter of small (allreduce) and large (ring) blocks, with
+   default and user-defined reductions */
+
+gaspi_return_t
+my_max (double * const a,
+	double * const b,
+	double * const r,
+	gaspi_state_t const state,
+	const gaspi_number_t num,
+	const gaspi_size_t elem_size,
+	const gaspi_timeout_t tout)
+{
+  gaspi_number_t i;
+  for(i = 0; i < num; i++)
+    {
+      r[i] = (a[i] < b[i]) ? b[i] : a[i];
+    }
+
+  return GASPI_SUCCESS;
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  const gaspi_number_t nums[] = { 1, 10, 1000, 100000 };
+  const gaspi_number_t num_max = 100000;
+
+  int * const isend = malloc(nprocs * num_max * sizeof(int));
+  int * const irecv = malloc(num_max * sizeof(int));
+  double * const dsend = malloc(nprocs * num_max * sizeof(double));
+  double * const drecv = malloc(num_max * sizeof(double));
+  assert( isend != NULL && irecv != NULL && dsend != NULL && drecv != NULL );
+
+  unsigned int s;
+  int iter;
+  for(s = 0; s < sizeof(nums) / sizeof(nums[0]); s++)
+    {
+      const gaspi_number_t num = nums[s];
+
+      for(iter = 0; iter < 3; iter++)
+	{
+	  gaspi_number_t i;
+	  gaspi_rank_t r;
+	  for(r = 0; r < nprocs; r++)
+	    {
+	      for(i = 0; i < num; i++)
+		{
+		  isend[r * num + i] = myrank + r + i + iter;
+		  dsend[r * num + i] = (double) ((myrank + r + i) % nprocs);
+		}
+	    }
+
+	  ASSERT( gaspi_reduce_scatter(isend, irecv, num, GASPI_OP_SUM, GASPI_TYPE_INT,
+				       GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+	  for(i = 0; i < num; i++)
+	    {
+	      assert( irecv[i] == nprocs * (nprocs - 1) / 2 + nprocs * (int) (myrank + i + iter) );
+	    }
+
+	  ASSERT( gaspi_reduce_scatter_user(dsend, drecv, num, sizeof(double),
+					    (gaspi_reduce_operation_t) my_max, NULL,
+					    GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+	  for(i = 0; i < num; i++)
+	    {
+	      assert( drecv[i] == (double) (nprocs - 1) );
+	    }
+
+	  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+	}
+    }
+
+  free(isend);
+  free(irecv);
+  free(dsend);
+  free(drecv);
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+/* Inclusive and exclusive scans, with default and user-defined
+   reductions */
+
+/* Associative but not commutative: keeps the operand of the higher
+   rank */
+gaspi_return_t
+my_last (int * const a,
+	 int * const b,
+	 int * const r,
+	 gaspi_state_t const state,
+	 const gaspi_number_t num,
+	 const gaspi_size_t elem_size,
+	 const gaspi_timeout_t tout)
+{
+  gaspi_number_t i;
+  for(i = 0; i < num; i++)
+    {
+      r[i] = b[i];
+    }
+
+  return GASPI_SUCCESS;
+}
+
+#define NUM 255
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t myrank, nprocs;
+  ASSERT( gaspi_proc_rank(&myrank) );
+  ASSERT( gaspi_proc_num(&nprocs) );
+
+  long send[NUM], recv[NUM];
+  int isend[NUM], irecv[NUM];
+
+  int n, iter;
+  for(n = 1; n <= NUM; n += 127)
+    {
+      for(iter = 0; iter < 5; iter++)
+	{
+	  int i;
+	  for(i = 0; i < n; i++)
+	    {
+	      send[i] = myrank + 1 + i + iter;
+	      recv[i] = -1;
+	      isend[i] = myrank * NUM + i;
+	      irecv[i] = -1;
+	    }
+
+	  ASSERT( gaspi_scan(send, recv, n, GASPI_OP_SUM, GASPI_TYPE_LONG, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( recv[i] == (long) (myrank + 1) * (myrank + 2) / 2 + (long) (myrank + 1) * (i + iter) );
+	    }
+
+	  ASSERT( gaspi_exscan(send, recv, n, GASPI_OP_MAX, GASPI_TYPE_LONG, GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      if( myrank == 0 )
+		{
+		  assert( recv[i] == (long) (myrank + 1) * (myrank + 2) / 2 + (long) (myrank + 1) * (i + iter) );
+		}
+	      else
+		{
+		  assert( recv[i] == myrank + i + iter );
+		}
+	    }
+
+	  ASSERT( gaspi_scan_user(isend, irecv, n, sizeof(int), (gaspi_reduce_operation_t) my_last, NULL,
+				  GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      assert( irecv[i] == myrank * NUM + i );
+	    }
+
+	  ASSERT( gaspi_exscan_user(isend, irecv, n, sizeof(int), (gaspi_reduce_operation_t) my_last, NULL,
+				    GASPI_GROUP_ALL, GASPI_BLOCK) );
+	  for(i = 0; i < n; i++)
+	    {
+	      if( myrank == 0 )
+		{
+		  assert( irecv[i] == i );
+		}
+	      else
+		{
+		  assert( irecv[i] == (myrank - 1) * NUM + i );
+		}
+	    }
+	}
+    }
+
+  /* limited to the allreduce buffer size */
+  gaspi_size_t buf_size;
+  ASSERT( gaspi_allreduce_buf_size(&buf_size) );
+
+  const gaspi_number_t too_many = buf_size / sizeof(int) + 1;
+  int * const big = malloc(too_many * sizeof(int));
+  assert( big != NULL );
+  EXPECT_FAIL( gaspi_scan(big, big, too_many, GASPI_OP_SUM, GASPI_TYPE_INT, GASPI_GROUP_ALL, GASPI_BLOCK) );
+  free(big);
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include <test_utils.h>
+
+/* 1D ring exchange (left and right neighbours) with double buffering
+   using one persistent plan per buffer */
+
+#define ELEMS 1024
+#define ITERATIONS 100
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t numranks, myrank;
+
+  ASSERT( gaspi_proc_num(&numranks) );
+  ASSERT( gaspi_proc_rank(&myrank) );
+
+  const gaspi_size_t buf_size = ELEMS * sizeof(int);
+
+  /* src[2], from_left[2], from_right[2] */
+  ASSERT( gaspi_segment_create(0, 6 * buf_size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+
+  int *src = (int *) _vptr;
+  int *from_left = src + 2 * ELEMS;
+  int *from_right = src + 4 * ELEMS;
+
+  const gaspi_rank_t left = (myrank + numranks - 1) % numranks;
+  const gaspi_rank_t right = (myrank + 1) % numranks;
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  gaspi_plan_t plan[2];
+
+  EXPECT_FAIL( gaspi_plan_create(&plan[0], 0,
+				 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+				 GASPI_BLOCK) );
+
+  int p;
+  for(p = 0; p < 2; p++)
+    {
+      gaspi_segment_id_t seg_local[2] = { 0, 0 };
+      gaspi_offset_t off_local[2] = { p * buf_size, p * buf_size };
+      gaspi_rank_t ranks[2] = { right, left };
+      gaspi_segment_id_t seg_remote[2] = { 0, 0 };
+      gaspi_offset_t off_remote[2] = { (2 + p) * buf_size, (4 + p) * buf_size };
+      gaspi_size_t sizes[2] = { buf_size, buf_size };
+      gaspi_notification_id_t ids[2] = { p, 2 + p };
+      gaspi_notification_t vals[2] = { 1, 1 };
+
+      ASSERT( gaspi_plan_create(&plan[p], 2,
+				seg_local, off_local, ranks,
+				seg_remote, off_remote, sizes,
+				ids, vals,
+				GASPI_BLOCK) );
+    }
+
+  int i, j;
+  for(i = 0; i < ITERATIONS; i++)
+    {
+      p = i % 2;
+
+      for(j = 0; j < ELEMS; j++)
+	{
+	  src[p * ELEMS + j] = myrank * ITERATIONS + i;
+	}
+
+      ASSERT( gaspi_plan_start(plan[p], 0, GASPI_BLOCK) );
+
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+
+      ASSERT( gaspi_notify_waitsome(0, p, 1, &id, GASPI_BLOCK) );
+      ASSERT( gaspi_notify_reset(0, id, &val) );
+      assert( val == 1 );
+
+      ASSERT( gaspi_notify_waitsome(0, 2 + p, 1, &id, GASPI_BLOCK) );
+      ASSERT( gaspi_notify_reset(0, id, &val) );
+      assert( val == 1 );
+
+      for(j = 0; j < ELEMS; j++)
+	{
+	  assert( from_left[p * ELEMS + j] == left * ITERATIONS + i );
+	  assert( from_right[p * ELEMS + j] == right * ITERATIONS + i );
+	}
+
+      ASSERT( gaspi_wait(0, GASPI_BLOCK) );
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  ASSERT( gaspi_plan_delete(plan[0]) );
+  ASSERT( gaspi_plan_delete(plan[1]) );
+
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
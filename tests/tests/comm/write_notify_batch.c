@@ -0,0 +1,107 @@
+#include <test_utils.h>
+
+/* All ranks write and notify all other ranks with a single batch */
+
+#define ELEMS 512
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t numranks, myrank;
+
+  ASSERT( gaspi_proc_num(&numranks) );
+  ASSERT( gaspi_proc_rank(&myrank) );
+
+  gaspi_number_t elem_max;
+  ASSERT( gaspi_write_notify_batch_elem_max(&elem_max) );
+
+  if( numranks > elem_max )
+    {
+      ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+      return EXIT_SUCCESS;
+    }
+
+  const gaspi_size_t buf_size = ELEMS * sizeof(int);
+
+  /* send buffer followed by one receive buffer per rank */
+  ASSERT( gaspi_segment_create(0, (numranks + 1) * buf_size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+
+  int *src = (int *) _vptr;
+  int *dst = src + ELEMS;
+
+  int i, j;
+  for(j = 0; j < ELEMS; j++)
+    {
+      src[j] = myrank * ELEMS + j;
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  gaspi_segment_id_t seg_local[numranks];
+  gaspi_offset_t off_local[numranks];
+  gaspi_rank_t ranks[numranks];
+  gaspi_segment_id_t seg_remote[numranks];
+  gaspi_offset_t off_remote[numranks];
+  gaspi_size_t sizes[numranks];
+  gaspi_notification_id_t ids[numranks];
+  gaspi_notification_t vals[numranks];
+
+  for(i = 0; i < numranks; i++)
+    {
+      seg_local[i] = 0;
+      off_local[i] = 0;
+      ranks[i] = (myrank + i) % numranks;
+      seg_remote[i] = 0;
+      off_remote[i] = (1 + myrank) * buf_size;
+      sizes[i] = buf_size;
+      ids[i] = myrank;
+      vals[i] = myrank + 1;
+    }
+
+  EXPECT_FAIL( gaspi_write_notify_batch(0,
+					seg_local, off_local, ranks,
+					seg_remote, off_remote, sizes,
+					ids, vals,
+					0, GASPI_BLOCK) );
+
+  EXPECT_FAIL( gaspi_write_notify_batch(elem_max + 1,
+					seg_local, off_local, ranks,
+					seg_remote, off_remote, sizes,
+					ids, vals,
+					0, GASPI_BLOCK) );
+
+  ASSERT( gaspi_write_notify_batch(numranks,
+				   seg_local, off_local, ranks,
+				   seg_remote, off_remote, sizes,
+				   ids, vals,
+				   0, GASPI_BLOCK) );
+
+  ASSERT( gaspi_wait(0, GASPI_BLOCK) );
+
+  for(i = 0; i < numranks; i++)
+    {
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+
+      ASSERT( gaspi_notify_waitsome(0, i, 1, &id, GASPI_BLOCK) );
+      ASSERT( gaspi_notify_reset(0, id, &val) );
+      assert( val == (gaspi_notification_t) (i + 1) );
+
+      for(j = 0; j < ELEMS; j++)
+	{
+	  assert( dst[i * ELEMS + j] == i * ELEMS + j );
+	}
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#include <test_utils.h>
+
+/* Exchange the faces of a 3D block (halo exchange like) with strided
+   write, write_notify and read */
+
+#define NX 16
+#define NY 12
+#define NZ 10
+
+#define IDX(x, y, z) ((z) * NY * NX + (y) * NX + (x))
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  gaspi_rank_t numranks, myrank;
+
+  ASSERT( gaspi_proc_num(&numranks) );
+  ASSERT( gaspi_proc_rank(&myrank) );
+
+  const gaspi_size_t block_bytes = NX * NY * NZ * sizeof(int);
+
+  /* local block, remote block (written), read block */
+  ASSERT( gaspi_segment_create(0, 3 * block_bytes, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  gaspi_pointer_t _vptr;
+  ASSERT( gaspi_segment_ptr(0, &_vptr) );
+
+  int *src = (int *) _vptr;
+  int *dst = src + NX * NY * NZ;
+  int *rd = dst + NX * NY * NZ;
+
+  int x, y, z;
+  for(z = 0; z < NZ; z++)
+    for(y = 0; y < NY; y++)
+      for(x = 0; x < NX; x++)
+	{
+	  src[IDX(x, y, z)] = myrank * NX * NY * NZ + IDX(x, y, z);
+	  dst[IDX(x, y, z)] = -1;
+	  rd[IDX(x, y, z)] = -1;
+	}
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  const gaspi_rank_t rank2send = (myrank + 1) % numranks;
+  const gaspi_rank_t rank2recv = (myrank + numranks - 1) % numranks;
+
+  /* 2D: the x = 1 face (single elements, NY x NZ) goes to x = 0 */
+  gaspi_offset_t stride2[2] = { NX * sizeof(int), NX * NY * sizeof(int) };
+  gaspi_size_t count2[3] = { sizeof(int), NY, NZ };
+
+  ASSERT( gaspi_write_strided(0, IDX(1, 0, 0) * sizeof(int), stride2,
+			      rank2send,
+			      0, block_bytes + IDX(0, 0, 0) * sizeof(int), stride2,
+			      count2, 2,
+			      0, GASPI_BLOCK) );
+
+  /* 1 level: the y = 1 face of the first plane (a row) goes to y = 0 */
+  gaspi_offset_t stride1[1] = { NX * NY * sizeof(int) };
+  gaspi_size_t count1[2] = { NX * sizeof(int), NZ };
+
+  ASSERT( gaspi_write_strided_notify(0, IDX(0, 1, 0) * sizeof(int), stride1,
+				     rank2send,
+				     0, block_bytes + IDX(0, 0, 0) * sizeof(int), stride1,
+				     count1, 1,
+				     (gaspi_notification_id_t) myrank, 1,
+				     0, GASPI_BLOCK) );
+
+  ASSERT( gaspi_wait(0, GASPI_BLOCK) );
+
+  gaspi_notification_id_t id;
+  ASSERT( gaspi_notify_waitsome(0, rank2recv, 1, &id, GASPI_BLOCK) );
+
+  gaspi_notification_t notification_val;
+  ASSERT( gaspi_notify_reset(0, id, &notification_val) );
+  assert( notification_val == 1 );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  /* check written faces */
+  for(z = 0; z < NZ; z++)
+    {
+      for(x = 0; x < NX; x++)
+	{
+	  assert( dst[IDX(x, 0, z)] == rank2recv * NX * NY * NZ + IDX(x, 1, z) );
+	}
+
+      for(y = 1; y < NY; y++)
+	{
+	  assert( dst[IDX(0, y, z)] == rank2recv * NX * NY * NZ + IDX(1, y, z) );
+	  for(x = 1; x < NX; x++)
+	    {
+	      assert( dst[IDX(x, y, z)] == -1 );
+	    }
+	}
+    }
+
+  /* read back the z = NZ - 1 face (contiguous rows of a plane) into a
+     z-strided layout */
+  gaspi_offset_t stride_remote[1] = { NX * sizeof(int) };
+  gaspi_offset_t stride_local[1] = { NX * NY * sizeof(int) };
+  gaspi_size_t count_rd[2] = { NX * sizeof(int), NZ };
+
+  ASSERT( gaspi_read_strided(0, 2 * block_bytes, stride_local,
+			     rank2send,
+			     0, IDX(0, 0, NZ - 1) * sizeof(int), stride_remote,
+			     count_rd, 1,
+			     0, GASPI_BLOCK) );
+
+  ASSERT( gaspi_wait(0, GASPI_BLOCK) );
+
+  for(z = 0; z < NZ; z++)
+    {
+      for(x = 0; x < NX; x++)
+	{
+	  assert( rd[IDX(x, 0, z)] == rank2send * NX * NY * NZ + IDX(x, z, NZ - 1) );
+	}
+    }
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <test_utils.h>
+
+#include <GASPI_Ext.h>
+#include <GASPI_Threads.h>
+
+#define ITERATIONS 100
+
+gaspi_rank_t rank, nprocs;
+gaspi_queue_id_t queues[1024];
+
+void *
+thread_fun(void *args)
+{
+  gaspi_int tid;
+  ASSERT( gaspi_threads_register(&tid) );
+
+  const gaspi_queue_id_t q = queues[tid];
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+
+  ASSERT( gaspi_queue_own(q, GASPI_BLOCK) );
+
+  /* owning twice is fine */
+  ASSERT( gaspi_queue_own(q, GASPI_BLOCK) );
+
+  int i;
+  for(i = 0; i < ITERATIONS; i++)
+    {
+      /* alternate notifications: neighbours can be one step ahead */
+      const gaspi_notification_id_t from_left = (gaspi_notification_id_t) (4 * tid + i % 2);
+      const gaspi_notification_id_t from_right = from_left + 2;
+
+      ASSERT( gaspi_write_notify(0, tid * sizeof(int), right,
+				 0, tid * sizeof(int), sizeof(int),
+				 from_left, 1,
+				 q, GASPI_BLOCK) );
+
+      ASSERT( gaspi_write_notify(0, tid * sizeof(int), left,
+				 0, tid * sizeof(int), sizeof(int),
+				 from_right, 1,
+				 q, GASPI_BLOCK) );
+
+      ASSERT( gaspi_wait(q, GASPI_BLOCK) );
+
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+      ASSERT( gaspi_notify_waitsome(0, from_left, 1, &id, GASPI_BLOCK) );
+      ASSERT( gaspi_notify_reset(0, id, &val) );
+
+      ASSERT( gaspi_notify_waitsome(0, from_right, 1, &id, GASPI_BLOCK) );
+      ASSERT( gaspi_notify_reset(0, id, &val) );
+    }
+
+  ASSERT( gaspi_queue_release(q) );
+  EXPECT_FAIL( gaspi_queue_release(q) );
+
+  gaspi_threads_sync();
+
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT( gaspi_proc_init(GASPI_BLOCK) );
+
+  ASSERT( gaspi_proc_num(&nprocs) );
+  ASSERT( gaspi_proc_rank(&rank) );
+
+  int num_threads = 0;
+  ASSERT( gaspi_threads_init(&num_threads) );
+
+  gaspi_number_t q_num, q_max;
+  ASSERT( gaspi_queue_num(&q_num) );
+  ASSERT( gaspi_queue_max(&q_max) );
+
+  /* one queue per thread (as far as possible), creating more if needed */
+  int i;
+  for(i = 0; i < num_threads; i++)
+    {
+      if( i < (int) q_num )
+	{
+	  queues[i] = (gaspi_queue_id_t) i;
+	}
+      else if( i < (int) q_max )
+	{
+	  ASSERT( gaspi_queue_create(&queues[i], GASPI_BLOCK) );
+	}
+      else
+	{
+	  queues[i] = queues[i % q_max];
+	}
+    }
+
+  ASSERT( gaspi_segment_create(0, num_threads * sizeof(int), GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED) );
+
+  /* not owned */
+  EXPECT_FAIL( gaspi_queue_release(0) );
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  for(i = 1; i < num_threads; i++)
+    ASSERT( gaspi_threads_run(thread_fun, NULL) );
+
+  thread_fun(NULL);
+
+  ASSERT( gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK) );
+
+  ASSERT( gaspi_proc_term(GASPI_BLOCK) );
+
+  return EXIT_SUCCESS;
+}
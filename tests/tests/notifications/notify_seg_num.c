@@ -0,0 +1,69 @@
+#include <test_utils.h>
+
+/* Number of notifications per segment: from the configuration or
+   chosen at creation. */
+
+#define NOTIF_NUM (64)
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.notification_num = 0;
+  EXPECT_FAIL (gaspi_config_set(conf));
+  conf.notification_num = 65537;
+  EXPECT_FAIL (gaspi_config_set(conf));
+  conf.notification_num = NOTIF_NUM;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  gaspi_number_t notif_num;
+  ASSERT (gaspi_notification_num(&notif_num));
+  assert (notif_num == NOTIF_NUM);
+
+  EXPECT_FAIL (gaspi_segment_create(0, 4096, GASPI_GROUP_ALL, GASPI_BLOCK,
+				    GASPI_MEM_INITIALIZED | GASPI_MEM_NOTIFICATIONS(65537)));
+
+  ASSERT (gaspi_segment_create(0, 4096, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+  ASSERT (gaspi_segment_create(1, 4096, GASPI_GROUP_ALL, GASPI_BLOCK,
+			       GASPI_MEM_INITIALIZED | GASPI_MEM_NOTIFICATIONS(65536)));
+
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_notification_id_t high = 60000;
+
+  /* Only the second segment has that many */
+  EXPECT_FAIL (gaspi_notify(0, right, high, 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_notify(0, right, NOTIF_NUM - 1, 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_notify(1, right, high, 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  gaspi_notification_id_t id;
+  gaspi_notification_t val;
+  ASSERT (gaspi_notify_waitsome(0, 0, NOTIF_NUM, &id, GASPI_BLOCK));
+  assert (id == NOTIF_NUM - 1);
+  ASSERT (gaspi_notify_reset(0, id, &val));
+  assert (val == 1);
+
+  EXPECT_FAIL (gaspi_notify_waitsome(0, high, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_waitsome(1, high, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_reset(1, id, &val));
+  assert (val == 1);
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(0));
+  ASSERT (gaspi_segment_delete(1));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
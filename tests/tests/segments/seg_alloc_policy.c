@@ -0,0 +1,86 @@
+#include <test_utils.h>
+
+/* Create segments with the huge page and NUMA allocation policies
+   (which fall back silently where not available), check their
+   initialization and communicate with them. */
+
+#define SEG_SIZE (_128MB + 4096 + 3)
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  const gaspi_alloc_t policies[] =
+    {
+      GASPI_MEM_INITIALIZED,
+      GASPI_MEM_INITIALIZED | GASPI_MEM_HUGE_2M,
+      GASPI_MEM_INITIALIZED | GASPI_MEM_HUGE_1G,
+      GASPI_MEM_INITIALIZED | GASPI_MEM_NUMA_LOCAL,
+      GASPI_MEM_INITIALIZED | GASPI_MEM_NUMA_INTERLEAVE,
+      GASPI_MEM_INITIALIZED | GASPI_MEM_HUGE_2M | GASPI_MEM_NUMA_INTERLEAVE,
+      GASPI_MEM_UNINITIALIZED | GASPI_MEM_HUGE_2M | GASPI_MEM_NUMA_LOCAL
+    };
+
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+  const gaspi_offset_t chunk = 4096;
+
+  unsigned int p;
+  for (p = 0; p < sizeof(policies) / sizeof(policies[0]); p++)
+    {
+      ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, policies[p]));
+
+      gaspi_pointer_t ptr;
+      ASSERT (gaspi_segment_ptr(0, &ptr));
+      unsigned char * const mem = (unsigned char *) ptr;
+
+      gaspi_size_t i;
+      if (policies[p] & GASPI_MEM_INITIALIZED)
+	{
+	  for (i = 0; i < SEG_SIZE; i++)
+	    {
+	      assert (mem[i] == 0);
+	    }
+	}
+
+      /* First and last chunk to the right neighbour */
+      for (i = 0; i < chunk; i++)
+	{
+	  mem[i] = (unsigned char) (rank + i);
+	  mem[SEG_SIZE - 2 * chunk + i] = (unsigned char) (rank + p + i);
+	}
+
+      ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+      ASSERT (gaspi_write(0, 0, right, 0, SEG_SIZE - chunk, chunk, 0, GASPI_BLOCK));
+      ASSERT (gaspi_write_notify(0, SEG_SIZE - 2 * chunk, right, 0, chunk, chunk,
+				 0, 1, 0, GASPI_BLOCK));
+
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+      ASSERT (gaspi_notify_waitsome(0, 0, 1, &id, GASPI_BLOCK));
+      ASSERT (gaspi_notify_reset(0, id, &val));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+      for (i = 0; i < chunk; i++)
+	{
+	  assert (mem[SEG_SIZE - chunk + i] == (unsigned char) (left + i));
+	  assert (mem[chunk + i] == (unsigned char) (left + p + i));
+	}
+
+      ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+      ASSERT (gaspi_segment_delete(0));
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
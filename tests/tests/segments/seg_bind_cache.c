@@ -0,0 +1,95 @@
+#include <test_utils.h>
+
+/* Registration cache: the same application buffer (and parts of it)
+   is used as a segment again and again and keeps communicating, also
+   after its registration was invalidated. */
+
+#define NUM_ELEMS (4096)
+#define ITERS (20)
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.reg_cache = 2;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+
+  int * const buf = (int *) malloc(2 * NUM_ELEMS * sizeof(int));
+  assert (buf != NULL);
+
+  ASSERT (gaspi_segment_create(1, NUM_ELEMS * sizeof(int),
+			       GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(1, &ptr));
+  int * const recv = (int *) ptr;
+
+  int it, i;
+  for (it = 0; it < ITERS; it++)
+    {
+      /* The whole buffer, its second half or the buffer again after
+	 invalidation */
+      int * const mem = buf + (it % 2) * NUM_ELEMS;
+
+      if (it == ITERS / 2)
+	{
+	  ASSERT (gaspi_segment_bind_invalidate(buf, 2 * NUM_ELEMS * sizeof(int)));
+	}
+
+      if (it % 3 == 0)
+	{
+	  ASSERT (gaspi_segment_use(0, mem, NUM_ELEMS * sizeof(int),
+				    GASPI_GROUP_ALL, GASPI_BLOCK, 0));
+	}
+      else
+	{
+	  ASSERT (gaspi_segment_bind(0, mem, NUM_ELEMS * sizeof(int), 0));
+	  ASSERT (gaspi_segment_register(0, right, GASPI_BLOCK));
+	}
+
+      for (i = 0; i < NUM_ELEMS; i++)
+	{
+	  mem[i] = rank * ITERS + it;
+	}
+
+      ASSERT (gaspi_write_notify(0, 0, right, 1, 0, NUM_ELEMS * sizeof(int),
+				 0, 1, 0, GASPI_BLOCK));
+
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+      ASSERT (gaspi_notify_waitsome(1, 0, 1, &id, GASPI_BLOCK));
+      ASSERT (gaspi_notify_reset(1, id, &val));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+      for (i = 0; i < NUM_ELEMS; i++)
+	{
+	  assert (recv[i] == left * ITERS + it);
+	}
+
+      ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+      ASSERT (gaspi_segment_delete(0));
+    }
+
+  ASSERT (gaspi_segment_bind_invalidate(buf, 2 * NUM_ELEMS * sizeof(int)));
+  free(buf);
+
+  ASSERT (gaspi_segment_delete(1));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include <test_utils.h>
+
+/* Lazy segment registration: the remote segments are only known
+   after the first communication or a prefetch. */
+
+#define SEG_SIZE (_2MB)
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.segment_lazy = 1;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+  ASSERT (gaspi_segment_create(1, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+
+  /* Fetched on first use */
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  int * const mem = (int *) ptr;
+  mem[0] = rank;
+
+  ASSERT (gaspi_write_notify(0, 0, right, 0, sizeof(int), sizeof(int),
+			     0, 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  gaspi_notification_id_t id;
+  gaspi_notification_t val;
+  ASSERT (gaspi_notify_waitsome(0, 0, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_reset(0, id, &val));
+  assert (mem[1] == left);
+
+  gaspi_size_t size;
+  ASSERT (gaspi_segment_size(0, right, &size));
+  assert (size == SEG_SIZE);
+
+  /* Prefetched on all ranks */
+  gaspi_rank_t *ranks = malloc(nprocs * sizeof(gaspi_rank_t));
+  assert (ranks != NULL);
+
+  gaspi_rank_t r;
+  for (r = 0; r < nprocs; r++)
+    {
+      ranks[r] = r;
+    }
+  ASSERT (gaspi_segment_prefetch(1, ranks, nprocs, GASPI_BLOCK));
+  ASSERT (gaspi_segment_prefetch(1, ranks, nprocs, GASPI_BLOCK));
+
+  ASSERT (gaspi_read(1, 0, left, 0, 0, sizeof(int), 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  /* Nobody has this one */
+  EXPECT_FAIL (gaspi_segment_prefetch(2, ranks, nprocs, GASPI_BLOCK));
+
+  free(ranks);
+
+  /* A notification alone, to a segment that exists only at its
+     owner */
+  if (rank != 0)
+    {
+      ASSERT (gaspi_segment_alloc(3, SEG_SIZE, GASPI_MEM_INITIALIZED));
+    }
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  if (rank == 0 && nprocs > 1)
+    {
+      ASSERT (gaspi_notify(3, right, 1, 1, 0, GASPI_BLOCK));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+    }
+  else if (rank == 1)
+    {
+      ASSERT (gaspi_notify_waitsome(3, 1, 1, &id, GASPI_BLOCK));
+      ASSERT (gaspi_notify_reset(3, id, &val));
+      assert (val == 1);
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  if (rank != 0)
+    {
+      ASSERT (gaspi_segment_delete(3));
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(0));
+  ASSERT (gaspi_segment_delete(1));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
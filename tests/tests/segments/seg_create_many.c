@@ -0,0 +1,84 @@
+#include <test_utils.h>
+
+/* Raise segment_max above the default, create that many segments
+   (growing the segment table on the way) and use all of them. */
+
+#define SEG_MAX (100)
+#define SEG_SIZE (4096)
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.segment_max = 257;
+  EXPECT_FAIL (gaspi_config_set(conf));
+  conf.segment_max = SEG_MAX;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  gaspi_number_t seg_max;
+  ASSERT (gaspi_segment_max(&seg_max));
+  assert (seg_max == SEG_MAX);
+
+  gaspi_segment_id_t s;
+  for (s = 0; s < SEG_MAX; s++)
+    {
+      ASSERT (gaspi_segment_create(s, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+    }
+
+  gaspi_number_t seg_num;
+  ASSERT (gaspi_segment_num(&seg_num));
+  assert (seg_num == SEG_MAX);
+
+  gaspi_segment_id_t avail;
+  EXPECT_FAIL (gaspi_segment_avail_local(&avail));
+  EXPECT_FAIL (gaspi_segment_create(SEG_MAX, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  /* One value into each segment of the right neighbour */
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+
+  for (s = 0; s < SEG_MAX; s++)
+    {
+      gaspi_pointer_t ptr;
+      ASSERT (gaspi_segment_ptr(s, &ptr));
+      ((int *) ptr)[0] = rank * SEG_MAX + s;
+
+      ASSERT (gaspi_write_notify(s, 0, right, s, sizeof(int), sizeof(int),
+				 0, 1, 0, GASPI_BLOCK));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+    }
+
+  for (s = 0; s < SEG_MAX; s++)
+    {
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+      ASSERT (gaspi_notify_waitsome(s, 0, 1, &id, GASPI_BLOCK));
+      ASSERT (gaspi_notify_reset(s, id, &val));
+
+      gaspi_pointer_t ptr;
+      ASSERT (gaspi_segment_ptr(s, &ptr));
+      assert (((int *) ptr)[1] == left * SEG_MAX + s);
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  for (s = 0; s < SEG_MAX; s++)
+    {
+      ASSERT (gaspi_segment_delete(s));
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include <pthread.h>
+
+#include <test_utils.h>
+
+/* Sub-allocation of a segment by several threads: blocks never
+   overlap, are aligned and can be used for communication. */
+
+#define SEG_SIZE (2 * _8MB)
+#define NTHREADS 4
+#define ITERS 2000
+#define NLIVE 32
+
+static unsigned char *mem;
+
+static void *
+thread_fun(void *arg)
+{
+  const unsigned long tid = (unsigned long) arg;
+  gaspi_offset_t off[NLIVE];
+  gaspi_size_t size[NLIVE];
+  unsigned int seed = (unsigned int) tid;
+  int i, k;
+
+  for (k = 0; k < NLIVE; k++)
+    {
+      size[k] = 0;
+    }
+
+  for (i = 0; i < ITERS; i++)
+    {
+      k = rand_r(&seed) % NLIVE;
+
+      if (size[k] > 0)
+	{
+	  gaspi_size_t j;
+	  for (j = 0; j < size[k]; j++)
+	    {
+	      assert (mem[off[k] + j] == (unsigned char) (tid + k));
+	    }
+
+	  ASSERT (gaspi_segment_free(0, off[k]));
+	  size[k] = 0;
+	}
+      else
+	{
+	  const gaspi_size_t align = (gaspi_size_t) 1 << (rand_r(&seed) % 13);
+
+	  size[k] = 1 + rand_r(&seed) % ((i % 500 == 0) ? 100000 : 2000);
+	  ASSERT (gaspi_segment_malloc(0, size[k], align, &off[k]));
+	  assert (off[k] % align == 0);
+	  assert (off[k] + size[k] <= SEG_SIZE);
+
+	  memset(mem + off[k], (unsigned char) (tid + k), size[k]);
+	}
+    }
+
+  for (k = 0; k < NLIVE; k++)
+    {
+      if (size[k] > 0)
+	{
+	  ASSERT (gaspi_segment_free(0, off[k]));
+	}
+    }
+
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank;
+  ASSERT (gaspi_proc_rank(&rank));
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  mem = (unsigned char *) ptr;
+
+  pthread_t threads[NTHREADS];
+  unsigned long t;
+  for (t = 0; t < NTHREADS; t++)
+    {
+      assert (pthread_create(&threads[t], NULL, thread_fun, (void *) t) == 0);
+    }
+
+  for (t = 0; t < NTHREADS; t++)
+    {
+      assert (pthread_join(threads[t], NULL) == 0);
+    }
+
+  /* Blocks as communication buffers */
+  gaspi_offset_t src, dst;
+  ASSERT (gaspi_segment_malloc(0, 4096, 8, &src));
+  ASSERT (gaspi_segment_malloc(0, 4096, 8, &dst));
+  memset(mem + src, 42, 4096);
+
+  ASSERT (gaspi_write(0, src, rank, 0, dst, 4096, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+  for (t = 0; t < 4096; t++)
+    {
+      assert (mem[dst + t] == 42);
+    }
+
+  ASSERT (gaspi_segment_free(0, src));
+  ASSERT (gaspi_segment_free(0, dst));
+
+  EXPECT_FAIL (gaspi_segment_malloc(0, 64, 3, &src));
+  EXPECT_FAIL (gaspi_segment_malloc(0, SEG_SIZE * 2, 0, &src));
+  EXPECT_FAIL (gaspi_segment_free(0, SEG_SIZE * 2));
+
+  /* Not a symmetric heap as well */
+  EXPECT_FAIL (gaspi_sym_malloc(0, GASPI_GROUP_ALL, 64, &src));
+
+  ASSERT (gaspi_segment_delete(0));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#include <test_utils.h>
+
+/* Lazy segment registration: rank 1 deletes a segment that rank 0
+   has written to and creates it again, larger and elsewhere. Rank 0
+   keeps its own segment and writes again, into the new part. */
+
+#define SEG_SIZE (_1MB)
+
+static void
+wait_and_check(const gaspi_notification_id_t nid,
+	       const gaspi_offset_t off,
+	       const int expected)
+{
+  gaspi_notification_id_t id;
+  gaspi_notification_t val;
+  ASSERT (gaspi_notify_waitsome(0, nid, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_reset(0, id, &val));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+
+  int const * const mem = (int const *) ((char *) ptr + off);
+  size_t i;
+  for (i = 0; i < SEG_SIZE / sizeof(int); i++)
+    {
+      assert (mem[i] == expected);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+  gaspi_config_t conf;
+
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_config_get(&conf));
+  conf.segment_lazy = 1;
+  ASSERT (gaspi_config_set(conf));
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  if (nprocs < 2)
+    {
+      return EXIT_SUCCESS;
+    }
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  int * const src = (int *) ptr;
+  size_t i;
+
+  /* The descriptor of rank 1 is fetched here */
+  if (rank == 0)
+    {
+      for (i = 0; i < SEG_SIZE / sizeof(int); i++)
+	{
+	  src[i] = 1;
+	}
+
+      ASSERT (gaspi_write_notify(0, 0, 1, 0, 0, SEG_SIZE, 0, 1, 0, GASPI_BLOCK));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+    }
+  else if (rank == 1)
+    {
+      wait_and_check(0, 0, 1);
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  if (rank == 1)
+    {
+      ASSERT (gaspi_segment_delete(0));
+      ASSERT (gaspi_segment_alloc(1, SEG_SIZE, GASPI_MEM_INITIALIZED));
+      ASSERT (gaspi_segment_alloc(0, 2 * SEG_SIZE, GASPI_MEM_INITIALIZED));
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  if (rank == 0)
+    {
+      for (i = 0; i < SEG_SIZE / sizeof(int); i++)
+	{
+	  src[i] = 2;
+	}
+
+      ASSERT (gaspi_write_notify(0, 0, 1, 0, SEG_SIZE, SEG_SIZE, 1, 1, 0, GASPI_BLOCK));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+      gaspi_size_t size;
+      ASSERT (gaspi_segment_size(0, 1, &size));
+      assert (size == 2 * SEG_SIZE);
+    }
+  else if (rank == 1)
+    {
+      wait_and_check(1, SEG_SIZE, 2);
+      ASSERT (gaspi_segment_delete(1));
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(0));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
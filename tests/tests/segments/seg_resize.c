@@ -0,0 +1,113 @@
+#include <test_utils.h>
+
+/* Grow a segment twice while it holds data and a pending
+   notification, then communicate into the new part. Rank 0 grows a
+   bit more than the others. */
+
+#define SEG_SIZE (_1MB)
+
+static void
+check_data(const gaspi_rank_t rank)
+{
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+
+  int * const mem = (int *) ptr;
+  size_t i;
+  for (i = 0; i < SEG_SIZE / 2 / sizeof(int); i++)
+    {
+      assert (mem[i] == rank + (int) i);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  size_t i;
+  for (i = 0; i < SEG_SIZE / 2 / sizeof(int); i++)
+    {
+      ((int *) ptr)[i] = rank + (int) i;
+    }
+
+  gaspi_offset_t off;
+  ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, SEG_SIZE / 2, &off));
+
+  /* Left pending across the resizes */
+  ASSERT (gaspi_notify(0, right, 1, rank + 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  EXPECT_FAIL (gaspi_segment_resize(0, SEG_SIZE / 2, GASPI_GROUP_ALL, GASPI_BLOCK));
+
+  gaspi_size_t size = SEG_SIZE;
+  int k;
+  for (k = 1; k <= 2; k++)
+    {
+      size = SEG_SIZE * 4 * k + (rank == 0 ? _1MB : 0);
+      ASSERT (gaspi_segment_resize(0, size, GASPI_GROUP_ALL, GASPI_BLOCK));
+
+      gaspi_size_t seg_size;
+      ASSERT (gaspi_segment_size(0, rank, &seg_size));
+      assert (seg_size == size);
+
+      check_data(rank);
+    }
+
+  gaspi_notification_id_t id;
+  gaspi_notification_t val;
+  ASSERT (gaspi_notify_waitsome(0, 1, 1, &id, GASPI_TEST));
+  ASSERT (gaspi_notify_reset(0, id, &val));
+  assert (val == (gaspi_notification_t) (left + 1));
+
+  /* The symmetric heap takes in the new memory */
+  gaspi_offset_t big;
+  ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, 4 * SEG_SIZE, &big));
+  assert (big + 4 * SEG_SIZE <= SEG_SIZE * 8);
+
+  /* Into the new part of the right neighbour */
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  unsigned char * const mem = (unsigned char *) ptr;
+  memset(mem + big, rank, SEG_SIZE);
+
+  ASSERT (gaspi_write_notify(0, big, right, 0, big + SEG_SIZE, SEG_SIZE,
+			     2, 1, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  ASSERT (gaspi_notify_waitsome(0, 2, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_reset(0, id, &val));
+  for (i = 0; i < SEG_SIZE; i++)
+    {
+      assert (mem[big + SEG_SIZE + i] == (unsigned char) left);
+    }
+
+  /* Not for the memory of the application */
+  void * const buf = malloc(SEG_SIZE);
+  assert (buf != NULL);
+  ASSERT (gaspi_segment_bind(1, buf, SEG_SIZE, 0));
+  EXPECT_FAIL (gaspi_segment_resize(1, 2 * SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(1));
+  free(buf);
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(0));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <test_utils.h>
+
+/* A plan keeps writing to the right neighbour after the segment was
+   grown (and moved) on all ranks. */
+
+#define SEG_SIZE (_1MB)
+#define ELEMS (SEG_SIZE / 2 / sizeof(int))
+
+static void
+start_and_check(const gaspi_plan_t plan,
+		const gaspi_rank_t rank,
+		const gaspi_rank_t left,
+		const int it)
+{
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  int * const mem = (int *) ptr;
+
+  size_t i;
+  for (i = 0; i < ELEMS; i++)
+    {
+      mem[i] = rank + it;
+    }
+
+  ASSERT (gaspi_plan_start(plan, 0, GASPI_BLOCK));
+  ASSERT (gaspi_wait(0, GASPI_BLOCK));
+
+  gaspi_notification_id_t id;
+  gaspi_notification_t val;
+  ASSERT (gaspi_notify_waitsome(0, 0, 1, &id, GASPI_BLOCK));
+  ASSERT (gaspi_notify_reset(0, id, &val));
+
+  for (i = 0; i < ELEMS; i++)
+    {
+      assert (mem[ELEMS + i] == left + it);
+    }
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_segment_id_t seg = 0;
+  gaspi_offset_t off_local = 0;
+  gaspi_offset_t off_remote = SEG_SIZE / 2;
+  gaspi_size_t size = SEG_SIZE / 2;
+  gaspi_notification_id_t nid = 0;
+  gaspi_notification_t nval = 1;
+
+  gaspi_plan_t plan;
+  ASSERT (gaspi_plan_create(&plan, 1, &seg, &off_local, &right,
+			    &seg, &off_remote, &size, &nid, &nval,
+			    GASPI_BLOCK));
+
+  start_and_check(plan, rank, left, 1);
+
+  /* Twice: the first grow moves the memory */
+  int k;
+  for (k = 2; k <= 3; k++)
+    {
+      ASSERT (gaspi_segment_resize(0, SEG_SIZE * 4 * k, GASPI_GROUP_ALL, GASPI_BLOCK));
+      start_and_check(plan, rank, left, k);
+    }
+
+  ASSERT (gaspi_plan_delete(plan));
+
+  ASSERT (gaspi_segment_delete(0));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include <test_utils.h>
+
+/* Symmetric heap: the same offsets on all ranks, usable for one-sided
+   communication without exchanging them. */
+
+#define SEG_SIZE (_4MB)
+#define NALLOC 6
+
+int
+main(int argc, char *argv[])
+{
+  TSUITE_INIT(argc, argv);
+
+  ASSERT (gaspi_proc_init(GASPI_BLOCK));
+
+  gaspi_rank_t rank, nprocs;
+  ASSERT (gaspi_proc_num(&nprocs));
+  ASSERT (gaspi_proc_rank(&rank));
+
+  ASSERT (gaspi_segment_create(0, SEG_SIZE, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+
+  gaspi_pointer_t ptr;
+  ASSERT (gaspi_segment_ptr(0, &ptr));
+  unsigned char * const mem = (unsigned char *) ptr;
+
+  const gaspi_size_t sizes[NALLOC] = { 8, 100, 64, 4096, 70000, 1 };
+  gaspi_offset_t off[NALLOC];
+  int i, j;
+
+  for (i = 0; i < NALLOC; i++)
+    {
+      ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, sizes[i], &off[i]));
+      assert (off[i] + sizes[i] <= SEG_SIZE);
+
+      for (j = 0; j < i; j++)
+	{
+	  assert (off[i] + sizes[i] <= off[j] || off[j] + sizes[j] <= off[i]);
+	}
+    }
+
+  /* The same variable on the right neighbour */
+  const gaspi_rank_t right = (rank + 1) % nprocs;
+  const gaspi_rank_t left = (rank + nprocs - 1) % nprocs;
+  gaspi_offset_t staging;
+  ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, sizes[4], &staging));
+
+  for (i = 1; i < NALLOC; i++)
+    {
+      memset(mem + staging, rank + i, sizes[i]);
+      ASSERT (gaspi_write_notify(0, staging, right, 0, off[i], sizes[i],
+				 (gaspi_notification_id_t) i, 1, 0, GASPI_BLOCK));
+      ASSERT (gaspi_wait(0, GASPI_BLOCK));
+    }
+
+  for (i = 1; i < NALLOC; i++)
+    {
+      gaspi_notification_id_t id;
+      gaspi_notification_t val;
+      ASSERT (gaspi_notify_waitsome(0, (gaspi_notification_id_t) i, 1, &id, GASPI_BLOCK));
+      ASSERT (gaspi_notify_reset(0, id, &val));
+
+      gaspi_size_t k;
+      for (k = 0; k < sizes[i]; k++)
+	{
+	  assert (mem[off[i] + k] == (unsigned char) (left + i));
+	}
+    }
+
+  /* Freed blocks are reused */
+  gaspi_offset_t again;
+  ASSERT (gaspi_sym_free(0, GASPI_GROUP_ALL, off[4]));
+  ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, 65536 + 1, &again));
+  assert (again == off[4]);
+
+  ASSERT (gaspi_sym_free(0, GASPI_GROUP_ALL, off[2]));
+  ASSERT (gaspi_sym_malloc(0, GASPI_GROUP_ALL, 33, &again));
+  assert (again == off[2]);
+
+  /* Not the start of a block */
+  EXPECT_FAIL (gaspi_sym_free(0, GASPI_GROUP_ALL, off[3] + 8));
+
+  /* Exhausted */
+  gaspi_offset_t big;
+  EXPECT_FAIL (gaspi_sym_malloc(0, GASPI_GROUP_ALL, SEG_SIZE, &big));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_segment_delete(0));
+
+  ASSERT (gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+  ASSERT (gaspi_proc_term(GASPI_BLOCK));
+
+  return EXIT_SUCCESS;
+}